@@ -9,6 +9,7 @@ module lysa.application;
 import lysa.input;
 import lysa.loader;
 import lysa.scene;
+import lysa.shader_modules;
 import lysa.type_registry;
 import lysa.nodes.camera;
 import lysa.nodes.collision_area;
@@ -34,7 +35,8 @@ namespace lysa {
         transferQueue{vireo->createSubmitQueue(vireo::CommandType::TRANSFER, "Main transfer Queue")},
         resources{*vireo, config.resourcesConfig, *graphicQueue},
         asyncQueue{vireo, transferQueue, graphicQueue},
-        physicsEngine{PhysicsEngine::create(config.physicsConfig)} {
+        jobSystem{config.jobThreadsCount, config.ioThreadsCount},
+        physicsEngine{PhysicsEngine::create(config.physicsConfig, jobSystem)} {
 
         assert([&]{ return instance == nullptr;}, "Global Application instance already defined");
         instance = this;
@@ -51,13 +53,21 @@ namespace lysa {
         transferQueue->waitIdle();
         computeQueue->waitIdle();
         asyncQueue.cleanup();
-        for(auto&t : threadedCalls) {
-            t.join();
+        // Async calls can launch other async calls
+        while (true) {
+            auto jobs = std::vector<JobHandle>{};
+            {
+                auto lock = std::lock_guard(asyncJobsMutex);
+                jobs.swap(asyncJobs);
+            }
+            if (jobs.empty()) { break; }
+            jobSystem.wait(jobs);
         }
         windows.clear();
         Scene::destroyDescriptorLayouts();
         resources.cleanup();
         Loader::clearCache();
+        ShaderModules::clearCache();
         vireo.reset();
         if constexpr (isLoggingEnabled()) {
             Log::close();
@@ -100,24 +110,14 @@ namespace lysa {
         resources.update();
 
         // Physics events & others deferred calls
-        if (!deferredCalls.empty()) {
-            std::ranges::for_each(deferredCalls, [](const std::function<void()>& call) {
-                call();
-            });
-            auto lock = std::lock_guard(deferredCallsMutex);
-            deferredCalls.clear();
-        }
+        deferredCalls.process(config.maxDeferredCallsPerFrame);
 
         // Clean up the async calls
-        if (!threadedCalls.empty()) {
-            auto lock = std::lock_guard(threadedCallsMutex);
-            for (auto it = threadedCalls.begin(); it != threadedCalls.end();) {
-                if (it->joinable()) {
-                    ++it;
-                } else {
-                    it = threadedCalls.erase(it);
-                }
-            }
+        if (!asyncJobs.empty()) {
+            auto lock = std::lock_guard(asyncJobsMutex);
+            std::erase_if(asyncJobs, [](const JobHandle& job) {
+                return job->isFinished();
+            });
         }
 
         const double newTime = std::chrono::duration_cast<std::chrono::duration<double>>(
@@ -131,6 +131,13 @@ namespace lysa {
         }
         currentTime = newTime;
         accumulator += frameTime;
+
+        // Shaders hot-reload, at the frame boundary
+        if (config.shaderHotReload && (newTime - shadersCheckTime) >= config.shaderHotReloadDelay) {
+            shadersCheckTime = newTime;
+            reloadShaders();
+        }
+
         {
             while (accumulator >= FIXED_DELTA_TIME) {
                 for (const auto& window : windows) {
@@ -152,6 +159,26 @@ namespace lysa {
         }
     }
 
+    void Application::reloadShaders() const {
+        const auto shaderNames = ShaderModules::getModifiedShaders();
+        if (shaderNames.empty()) { return; }
+        for (const auto& shaderName : shaderNames) {
+            INFO("Reloading shader ", shaderName);
+        }
+        graphicQueue->waitIdle();
+        auto reloadedShaders = std::set<std::string>{};
+        for (const auto& window : windows) {
+            window->reloadShaders(shaderNames, reloadedShaders);
+        }
+        // The frustum culling & depth reduction compute pipelines and the vector & debug renderers
+        // are not reloaded : the modified shaders are only used by the pipelines created after the reload
+        for (const auto& shaderName : shaderNames) {
+            if (!reloadedShaders.contains(shaderName)) {
+                WARNING("Shader ", shaderName, " has no reloadable owner, the existing pipelines keep the previous version");
+            }
+        }
+    }
+
     void Application::registerTypes() const {
         TypeRegistry::registerType<Camera>("Camera");
         TypeRegistry::registerType<CollisionArea>("CollisionArea");
@@ -8,6 +8,8 @@ export module lysa.application;
 
 import vireo;
 import lysa.configuration;
+import lysa.deferred_calls;
+import lysa.job_system;
 import lysa.exception;
 import lysa.log;
 import lysa.types;
@@ -103,6 +105,12 @@ export namespace lysa {
             return *instance->physicsEngine;
         }
 
+        /** Returns the engine-wide job system. */
+        static JobSystem& getJobSystem() {
+            assert([&]{ return instance != nullptr;}, "Global Application instance not set");
+            return instance->jobSystem;
+        }
+
         /** Returns the asynchronous queue helper used for background GPU work. */
         static AsyncQueue& getAsyncQueue() {
             assert([&]{ return instance != nullptr;}, "Global Application instance not set");
@@ -112,22 +120,25 @@ export namespace lysa {
         /**
         * Add a lambda expression in the deferred calls queue.<br>
         * They will be called before the next frame, after the scene pre-drawing updates
-        * where nodes are added/removed from the drawing lists (for all the frames in flight).
+        * where nodes are added/removed from the drawing lists (for all the frames in flight).<br>
+        * Lock-free and thread safe, the calls of each thread are executed in order. At most
+        * ApplicationConfiguration::maxDeferredCallsPerFrame calls are executed per frame.
         */
         template<typename Lambda>
-        static auto callDeferred(Lambda lambda) {
-            auto lock = std::lock_guard(instance->deferredCallsMutex);
-            instance->deferredCalls.push_back(lambda);
+        static void callDeferred(Lambda&& lambda) {
+            instance->deferredCalls.push(DeferredCall{std::forward<Lambda>(lambda)});
         }
 
         /**
-         * Starts a new thread that need access the GPU/VRAM.<br>
+         * Executes a lambda that need access the GPU/VRAM in the job system, on the I/O threads.<br>
          * Use this instead of starting a thread manually because the rendering system needs
-         * to wait for all the threads completion before releasing resources.
+         * to wait for all the calls completion before releasing resources.
          */
         template <typename Lambda>
-        static auto callAsync(Lambda lambda) {
-            instance->threadedCalls.push_back(std::jthread(lambda));
+        static void callAsync(Lambda&& lambda) {
+            auto job = instance->jobSystem.schedule(std::forward<Lambda>(lambda), JobPriority::BLOCKING);
+            auto lock = std::lock_guard(instance->asyncJobsMutex);
+            instance->asyncJobs.push_back(job);
         }
 
         virtual ~Application();
@@ -156,23 +167,28 @@ export namespace lysa {
         // Logging facility used by the application and subsystems.
         std::shared_ptr<Log> log;
         // Callbacks to be executed before the next frame (deferred to a safe point).
-        std::list<std::function<void()>> deferredCalls;
-        // Synchronizes access to the deferred calls list.
-        std::mutex deferredCallsMutex;
-        // Background threads launched via callAsync that must finish before shutdown.
-        std::list<std::jthread> threadedCalls;
-        // Synchronizes access to the threadedCalls list.
-        std::mutex threadedCallsMutex;
+        DeferredCallQueue deferredCalls;
+        // Worker threads shared by the engine subsystems, physics included.
+        JobSystem jobSystem;
+        // Jobs launched via callAsync that must finish before shutdown.
+        std::vector<JobHandle> asyncJobs;
+        // Synchronizes access to the asyncJobs list.
+        std::mutex asyncJobsMutex;
         // Physics engine instance owned by the application.
         std::unique_ptr<PhysicsEngine> physicsEngine;
 
         // Fixed delta time bookkeeping for the physics update loop
         double currentTime{0.0};
         double accumulator{0.0};
+        // Time of the last check of the shaders files, for the shaders hot-reload
+        double shadersCheckTime{0.0};
 
         // Records and presents a single frame for all active windows.
         void drawFrame();
 
+        // Recreates the pipelines using the shaders modified since the last check.
+        void reloadShaders() const;
+
         // Drives the per-frame update, physics stepping, and rendering.
         void mainLoop();
 
@@ -10,12 +10,14 @@ import vireo;
 import lysa.application;
 import lysa.exception;
 import lysa.log;
+import lysa.texture_streamer;
 import lysa.types;
 import lysa.virtual_fs;
 import lysa.nodes.animation_player;
 import lysa.nodes.mesh_instance;
 import lysa.resources.animation;
 import lysa.resources.animation_library;
+import lysa.resources.block_compression;
 import lysa.resources.image;
 import lysa.resources.material;
 import lysa.resources.mesh;
@@ -25,7 +27,9 @@ namespace lysa {
 
     void AssetsPack::load(Node& rootNode, const std::string &filename) {
         auto stream = VirtualFS::openReadStream(filename);
-        return load(rootNode, stream);
+        AssetsPack loader;
+        loader.filename = filename;
+        loader.loadScene(rootNode, stream);
     }
 
     void AssetsPack::load(Node& rootNode, std::ifstream &stream) {
@@ -193,7 +197,7 @@ namespace lysa {
                         vireo::ResourceState::COPY_DST,
                         vireo::ResourceState::SHADER_READ,
                         0,
-                        imageHeader.mipLevels);
+                        imageHeader.mipLevels - texturesFirstMip[textureIndex]);
                 }
             }
             asyncQueue.endCommand(barriersCommand);
@@ -368,6 +372,58 @@ namespace lysa {
         Application::getInstance().updatePipelines(pipelineIds);
     }
 
+    std::vector<AssetsPack::MipLevelInfo> AssetsPack::cookImage(
+        const std::string& name,
+        const uint8* rgba,
+        const uint32 width, const uint32 height,
+        const vireo::ImageFormat format,
+        ImageHeader& header,
+        std::vector<uint8>& data) {
+        static const auto blockFormats = std::map<vireo::ImageFormat, BlockFormat> {
+            { vireo::ImageFormat::BC1_UNORM, BlockFormat::BC1 },
+            { vireo::ImageFormat::BC1_UNORM_SRGB, BlockFormat::BC1 },
+            { vireo::ImageFormat::BC3_UNORM, BlockFormat::BC3 },
+            { vireo::ImageFormat::BC3_UNORM_SRGB, BlockFormat::BC3 },
+            { vireo::ImageFormat::BC4_UNORM, BlockFormat::BC4 },
+            { vireo::ImageFormat::BC5_UNORM, BlockFormat::BC5 },
+            { vireo::ImageFormat::BC7_UNORM, BlockFormat::BC7 },
+            { vireo::ImageFormat::BC7_UNORM_SRGB, BlockFormat::BC7 },
+        };
+        const auto blockFormat = blockFormats.find(format);
+        if (blockFormat == blockFormats.end()) {
+            throw Exception("Unsupported format ", static_cast<uint32>(format), " for the cooked image ", name);
+        }
+        // The sRGB levels are averaged in linear space
+        const auto sRGB =
+            format == vireo::ImageFormat::BC1_UNORM_SRGB ||
+            format == vireo::ImageFormat::BC3_UNORM_SRGB ||
+            format == vireo::ImageFormat::BC7_UNORM_SRGB;
+        const auto mipLevels = Image::getMipLevelsCount(width, height);
+        auto levels = std::vector<uint8>(rgba, rgba + static_cast<size_t>(width) * height * 4);
+        const auto levelsOffsets = Image::generateMips(levels, width, height, mipLevels, sRGB);
+
+        const auto dataOffset = data.size();
+        const auto blocksOffsets = BlockCompression::compressLevels(
+            blockFormat->second, levels, levelsOffsets, width, height, data);
+        header = {};
+        name.copy(header.name, NAME_SIZE - 1);
+        header.format = static_cast<uint32>(format);
+        header.width = width;
+        header.height = height;
+        header.mipLevels = mipLevels;
+        header.dataOffset = dataOffset;
+        header.dataSize = data.size() - dataOffset;
+        auto levelInfos = std::vector<MipLevelInfo>(mipLevels);
+        for (auto level = 0u; level < mipLevels; level++) {
+            const auto end = level + 1 < mipLevels ? blocksOffsets[level + 1] : data.size();
+            levelInfos[level] = {
+                .offset = blocksOffsets[level] - dataOffset,
+                .size = end - blocksOffsets[level],
+            };
+        }
+        return levelInfos;
+    }
+
     std::vector<std::shared_ptr<vireo::Image>> AssetsPack::loadImagesAndTextures(
         const vireo::Buffer& stagingBuffer,
         const vireo::CommandList& commandList,
@@ -376,9 +432,13 @@ namespace lysa {
         const std::vector<std::vector<MipLevelInfo>>&levelHeaders,
         const std::vector<TextureHeader>& textureHeaders) {
         const auto& vireo = Application::getVireo();
+        auto& textureStreamer = Application::getResources().getTextureStreamer();
+        const auto streaming = Application::getConfiguration().resourcesConfig.textureStreamingEnabled && !filename.empty();
         std::vector<std::shared_ptr<vireo::Image>> images(header.texturesCount);
+        texturesFirstMip.resize(header.texturesCount, 0);
 
         // Create images upload buffer
+        const auto imagesDataStart = static_cast<uint64>(stream.tellg());
         static constexpr size_t BLOCK_SIZE = 64 * 1024;
         auto transferBuffer = std::vector<char> (BLOCK_SIZE);
         auto transferOffset = size_t{0};
@@ -397,11 +457,17 @@ namespace lysa {
                 // INFO("Loading image ", imageHeader.name, " ", imageHeader.width, "x", imageHeader.height, " ", imageHeader.format);
                 // print(imageHeader);
                 const auto& name = imageHeader.name;
+                // Only the coarse mip levels are uploaded for the streamed textures
+                const auto firstMip = streaming ?
+                    textureStreamer.getInitialMip(imageHeader.width, imageHeader.height, imageHeader.mipLevels) :
+                    0;
+                const auto mipLevels = imageHeader.mipLevels - firstMip;
+                texturesFirstMip[textureIndex] = firstMip;
                 const auto image = vireo.createImage(
                     static_cast<vireo::ImageFormat>(imageHeader.format),
-                    imageHeader.width,
-                    imageHeader.height,
-                    imageHeader.mipLevels,
+                    std::max(1u, imageHeader.width >> firstMip),
+                    std::max(1u, imageHeader.height >> firstMip),
+                    mipLevels,
                     1,
                     name);
                 commandList.barrier(
@@ -409,10 +475,10 @@ namespace lysa {
                     vireo::ResourceState::UNDEFINED,
                     vireo::ResourceState::COPY_DST,
                     0,
-                    imageHeader.mipLevels);
-                auto sourceOffsets = std::vector<size_t>(imageHeader.mipLevels);
-                for (int mipLevel = 0; mipLevel < imageHeader.mipLevels; ++mipLevel) {
-                    sourceOffsets[mipLevel] = imageHeader.dataOffset + levelHeaders[texture.imageIndex][mipLevel].offset;
+                    mipLevels);
+                auto sourceOffsets = std::vector<size_t>(mipLevels);
+                for (int mipLevel = 0; mipLevel < mipLevels; ++mipLevel) {
+                    sourceOffsets[mipLevel] = imageHeader.dataOffset + levelHeaders[texture.imageIndex][firstMip + mipLevel].offset;
                 }
                 commandList.copy(
                     stagingBuffer,
@@ -430,7 +496,25 @@ namespace lysa {
                     static_cast<vireo::Filter>(texture.magFilter),
                     static_cast<vireo::AddressMode>(texture.samplerAddressModeU),
                     static_cast<vireo::AddressMode>(texture.samplerAddressModeV));
-                textures.push_back(std::make_shared<ImageTexture>(std::make_shared<Image>(image, name), samplerIndex));
+                const auto lysaImage = std::make_shared<Image>(image, name);
+                if (streaming) {
+                    auto source = TextureStreamer::Source {
+                        .filename = filename,
+                        .format = static_cast<vireo::ImageFormat>(imageHeader.format),
+                        .width = imageHeader.width,
+                        .height = imageHeader.height,
+                        .mipLevels = std::vector<TextureStreamer::MipLevel>(imageHeader.mipLevels),
+                    };
+                    for (int mipLevel = 0; mipLevel < imageHeader.mipLevels; ++mipLevel) {
+                        const auto& levelHeader = levelHeaders[texture.imageIndex][mipLevel];
+                        source.mipLevels[mipLevel] = {
+                            .offset = imagesDataStart + imageHeader.dataOffset + levelHeader.offset,
+                            .size = levelHeader.size,
+                        };
+                    }
+                    textureStreamer.add(lysaImage, source, firstMip);
+                }
+                textures.push_back(std::make_shared<ImageTexture>(lysaImage, samplerIndex));
             }
         }
         return images;
@@ -260,6 +260,20 @@ export namespace lysa {
          */
         static void load(Node& rootNode, std::ifstream &stream);
 
+        /*
+         * Cooks a RGBA8 image for the images data block : generates its full mip chain and
+         * compresses all the levels in `format`, one of the BC1, BC3, BC4, BC5 & BC7 formats.<br>
+         * The levels are appended to `data`, they are described by `header` and the returned
+         * levels infos as loadImagesAndTextures() reads them back.
+         */
+        static std::vector<MipLevelInfo> cookImage(
+            const std::string& name,
+            const uint8* rgba,
+            uint32 width, uint32 height,
+            vireo::ImageFormat format,
+            ImageHeader& header,
+            std::vector<uint8>& data);
+
         AssetsPack() = default;
 
         static void print(const Header& header);
@@ -274,6 +288,10 @@ export namespace lysa {
     protected:
         Header header{};
         std::vector<std::shared_ptr<Texture>> textures{};
+        //! Source file name, needed to stream the textures mip levels
+        std::string filename{};
+        //! Finest mip level uploaded for each texture, 0 if the texture is not streamed
+        std::vector<uint32> texturesFirstMip{};
 
         void loadScene(Node& rootNode, std::ifstream& stream);
 
@@ -64,6 +64,32 @@ export namespace lysa {
         uint32 maxMaterialInstances{1000};
         uint32 maxIndexInstances{5000000*2};
         uint32 maxMeshSurfaceInstances{200000};
+        //! Size of the textures descriptor array
+        uint32 maxTextures{500};
+        //! Maximum number of frames in flight of all the windows. The textures descriptor sets are recycled
+        //! after this number of frames instead of waiting for the GPU when the textures change.
+        uint32 maxFramesInFlight{3};
+        //! Load only the coarse mip levels of the assets packs textures and stream the finer ones on demand
+        bool   textureStreamingEnabled{false};
+        //! Memory budget in bytes for the streamed textures
+        uint64 textureStreamingBudget{512ull * 1024 * 1024};
+        //! Maximum width & height in texels of the mip levels loaded with a streamed texture
+        uint32 textureStreamingInitialSize{128};
+        //! Maximum number of mip levels loads in progress
+        uint32 textureStreamingMaxLoads{4};
+        //! Memory budget in bytes of the shaped texts cache of each font
+        uint64 shapedTextCacheBudget{256 * 1024};
+        //! Width & height in pixels of the glyph atlas shared by the fonts without a precomputed atlas
+        uint32 glyphAtlasSize{1024};
+        //! Size of one em in pixels in the glyph atlas
+        float  glyphAtlasGlyphSize{48.0f};
+        //! Distance field range in pixels of the glyph atlas
+        float  glyphAtlasPixelRange{4.0f};
+        //! Maximum number of glyphs generation jobs in progress
+        uint32 glyphAtlasMaxJobs{2};
+        //! Maximum number of frames a generated glyph waits for the upload of the glyph atlas. The glyphs
+        //! generated in the meantime are uploaded together, the atlas is uploaded earlier when no glyph is coming.
+        uint32 glyphAtlasUploadDelay{10};
     };
 
     struct ApplicationConfiguration {
@@ -71,6 +97,10 @@ export namespace lysa {
         std::filesystem::path  appDir{"."};
         //! Directory to search for compiled shaders inside app://
         std::string           shaderDir{"shaders"};
+        //! Recreates the pipelines when the compiled shaders files are modified, for shaders development
+        bool                  shaderHotReload{false};
+        //! Delay in seconds between two checks of the compiled shaders files
+        double                shaderHotReloadDelay{0.5};
         PhysicsConfiguration   physicsConfig{};
         //! Where to log a message using Logger
         int                    loggingMode{LOGGING_MODE_NONE};
@@ -80,6 +110,12 @@ export namespace lysa {
         vireo::Backend         backend{vireo::Backend::VULKAN};
         //! Global resources configuration
         ResourcesConfiguration resourcesConfig;
+        //! Maximum number of deferred calls executed per frame, the remaining calls are executed in the next frames
+        uint32                 maxDeferredCallsPerFrame{10000};
+        //! Number of worker threads of the job system, 0 for the number of hardware threads minus one
+        uint32                 jobThreadsCount{0};
+        //! Number of I/O threads of the job system, executing the jobs waiting for files or the GPU
+        uint32                 ioThreadsCount{2};
     };
 
     struct SceneConfiguration {
@@ -87,6 +123,10 @@ export namespace lysa {
         uint32 maxAsyncNodesUpdatedPerFrame{50};
         uint32 maxModelsPerScene{10000};
         uint32 maxMeshSurfacePerPipeline{100000};
+        //! Width & height in texels of the square shadow maps budget shared by all the lights of a scene
+        uint32 shadowMapBudgetSize{8192};
+        //! Smallest shadow map size in texels, used for lights covering a small part of the screen
+        uint32 shadowMapMinSize{128};
     };
 
     struct RenderingConfiguration {
@@ -105,6 +145,8 @@ export namespace lysa {
         float3             clearColor{DEFAULT_CLEAR_COLOR};
         //! Number of simultaneous frames during rendering
         uint32             framesInFlight{2};
+        //! Number of parallel jobs recording the shadow maps command lists, the lights are spread over the jobs
+        uint32             shadowMapsRecordingJobs{4};
         //! Gamma correction factor when using *_UNORM, *_SNORM or *_SFLOAT format
         float              gamma{2.4f};
         //! Exposure correction factor
@@ -136,6 +178,9 @@ export namespace lysa {
         float              ssaoBias{0.025f};
         //! SSAO strength
         float              ssaoStrength{2.0f};
+        //! Fit the directional lights shadow cascades to the visible depth range (sample distribution shadow maps).
+        //! Only used without MSAA, the depth range is reduced on the GPU from the depth pre-pass
+        bool               sdsmEnabled{false};
     };
 
     /**
@@ -149,6 +194,10 @@ export namespace lysa {
         //! Debug configuration for this viewport
         DebugConfig        debugConfig{};
         bool               useVectorRenderer{false};
+        //! Calls the process callbacks of the thread-safe nodes (see Node::setThreadSafeProcess()) in the job system
+        bool               parallelProcess{false};
+        //! Number of thread-safe nodes processed per job
+        uint32             parallelProcessBatchSize{256};
     };
 
     /**
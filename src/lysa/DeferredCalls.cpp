@@ -0,0 +1,123 @@
+/*
+* Copyright (c) 2025-present Henri Michelon
+*
+* This software is released under the MIT License.
+* https://opensource.org/licenses/MIT
+*/
+module lysa.deferred_calls;
+
+namespace lysa {
+
+    DeferredCallQueue::DeferredCallQueue() {
+        head = new Block();
+        tail.store(head);
+    }
+
+    DeferredCallQueue::~DeferredCallQueue() {
+        // Pending calls are destroyed without being executed
+        auto* block = head;
+        while (block) {
+            auto* next = block->next.load();
+            delete block;
+            block = next;
+        }
+        for (const auto* retired : retiredBlocks) { delete retired; }
+        delete spareBlock.load();
+    }
+
+    void DeferredCallQueue::push(DeferredCall&& call) {
+        activeProducers.fetch_add(1);
+        while (true) {
+            auto* block = tail.load();
+            const auto index = block->reserved.fetch_add(1, std::memory_order_relaxed);
+            if (index < BLOCK_SIZE) {
+                auto& slot = block->slots[index];
+                slot.call = std::move(call);
+                slot.ready.store(true, std::memory_order_release);
+                break;
+            }
+            // The block is full : link a new block if no other producer did it, then move the tail
+            auto* next = block->next.load(std::memory_order_acquire);
+            if (!next) {
+                auto* newBlock = allocateBlock();
+                if (block->next.compare_exchange_strong(next, newBlock, std::memory_order_acq_rel)) {
+                    next = newBlock;
+                } else {
+                    // Another producer linked its block first
+                    Block* empty{nullptr};
+                    if (!spareBlock.compare_exchange_strong(empty, newBlock)) {
+                        delete newBlock;
+                    }
+                }
+            }
+            tail.compare_exchange_strong(block, next);
+        }
+        activeProducers.fetch_sub(1);
+    }
+
+    uint32 DeferredCallQueue::process(const uint32 maxCalls) {
+        auto count = 0u;
+        while (count < maxCalls) {
+            if (headIndex == BLOCK_SIZE) {
+                auto* next = head->next.load(std::memory_order_acquire);
+                if (!next) { break; }
+                // Makes sure the producers can't reach the consumed block from the tail anymore
+                auto* consumed = head;
+                tail.compare_exchange_strong(consumed, next);
+                retiredBlocks.push_back(head);
+                head = next;
+                headIndex = 0;
+                continue;
+            }
+            auto& slot = head->slots[headIndex];
+            // Stops at the first call not yet written to keep the order of the calls
+            if (!slot.ready.load(std::memory_order_acquire)) { break; }
+            auto call = std::move(slot.call);
+            slot.ready.store(false, std::memory_order_relaxed);
+            headIndex++;
+            call();
+            count++;
+        }
+        recycleBlocks();
+        return count;
+    }
+
+    bool DeferredCallQueue::empty() const {
+        if (headIndex == BLOCK_SIZE) {
+            const auto* next = head->next.load(std::memory_order_acquire);
+            return !next || !next->slots[0].ready.load(std::memory_order_acquire);
+        }
+        return !head->slots[headIndex].ready.load(std::memory_order_acquire);
+    }
+
+    DeferredCallQueue::Block* DeferredCallQueue::allocateBlock() {
+        if (auto* block = spareBlock.exchange(nullptr)) {
+            return block;
+        }
+        return new Block();
+    }
+
+    void DeferredCallQueue::recycleBlocks() {
+        // A producer entering push() from now on loads a tail past the retired blocks
+        if (retiredBlocks.empty() || activeProducers.load() != 0) {
+            return;
+        }
+        // The producers fill the linked blocks before allocating new ones
+        auto* last = tail.load();
+        for (auto* block : retiredBlocks) {
+            block->reserved.store(0, std::memory_order_relaxed);
+            block->next.store(nullptr, std::memory_order_relaxed);
+            while (true) {
+                Block* next{nullptr};
+                if (last->next.compare_exchange_strong(next, block, std::memory_order_acq_rel)) {
+                    last = block;
+                    break;
+                }
+                // Blocks linked after the tail, by a producer or before
+                last = next;
+            }
+        }
+        retiredBlocks.clear();
+    }
+
+}
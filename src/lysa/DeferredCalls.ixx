@@ -0,0 +1,192 @@
+/*
+* Copyright (c) 2025-present Henri Michelon
+*
+* This software is released under the MIT License.
+* https://opensource.org/licenses/MIT
+*/
+export module lysa.deferred_calls;
+
+import std;
+import lysa.types;
+
+export namespace lysa {
+
+    /**
+     * Move-only type-erased `void()` callable.<br>
+     * Callables up to INLINE_SIZE bytes, like the lambdas of the physics contact events,
+     * are stored inline without any allocation.
+     */
+    class DeferredCall {
+    public:
+        static constexpr std::size_t INLINE_SIZE{96};
+        // 16 for the SIMD vectors & matrices
+        static constexpr std::size_t INLINE_ALIGNMENT{16};
+
+        DeferredCall() = default;
+
+        template<typename Lambda> requires (!std::same_as<std::decay_t<Lambda>, DeferredCall>)
+        DeferredCall(Lambda&& lambda) {
+            using F = std::decay_t<Lambda>;
+            if constexpr (isInline<F>()) {
+                new (buffer) F(std::forward<Lambda>(lambda));
+                operations = &inlineOperations<F>;
+            } else {
+                *reinterpret_cast<F**>(buffer) = new F(std::forward<Lambda>(lambda));
+                operations = &heapOperations<F>;
+            }
+        }
+
+        DeferredCall(DeferredCall&& other) noexcept {
+            moveFrom(other);
+        }
+
+        DeferredCall& operator=(DeferredCall&& other) noexcept {
+            if (this != &other) {
+                reset();
+                moveFrom(other);
+            }
+            return *this;
+        }
+
+        DeferredCall(const DeferredCall&) = delete;
+        DeferredCall& operator=(const DeferredCall&) = delete;
+
+        ~DeferredCall() { reset(); }
+
+        void operator()() {
+            operations->invoke(buffer);
+        }
+
+        explicit operator bool() const { return operations != nullptr; }
+
+        /** Returns true if the callable is stored inline */
+        bool isInline() const { return operations != nullptr && operations->inlined; }
+
+        /** Returns true if a callable of type F is stored inline */
+        template<typename F>
+        static constexpr bool isInline() {
+            return sizeof(F) <= INLINE_SIZE &&
+                   alignof(F) <= INLINE_ALIGNMENT &&
+                   std::is_nothrow_move_constructible_v<F>;
+        }
+
+        /** Destroys the callable */
+        void reset() {
+            if (operations) {
+                operations->destroy(buffer);
+                operations = nullptr;
+            }
+        }
+
+    private:
+        struct Operations {
+            void (*invoke)(std::byte*);
+            // Move constructs the callable in `to` and destroys the one in `from`
+            void (*move)(std::byte* from, std::byte* to);
+            void (*destroy)(std::byte*);
+            bool inlined;
+        };
+
+        template<typename F>
+        static constexpr Operations inlineOperations {
+            .invoke = [](std::byte* buffer) { (*std::launder(reinterpret_cast<F*>(buffer)))(); },
+            .move = [](std::byte* from, std::byte* to) {
+                auto* f = std::launder(reinterpret_cast<F*>(from));
+                new (to) F(std::move(*f));
+                f->~F();
+            },
+            .destroy = [](std::byte* buffer) { std::launder(reinterpret_cast<F*>(buffer))->~F(); },
+            .inlined = true,
+        };
+
+        template<typename F>
+        static constexpr Operations heapOperations {
+            .invoke = [](std::byte* buffer) { (**reinterpret_cast<F**>(buffer))(); },
+            .move = [](std::byte* from, std::byte* to) {
+                *reinterpret_cast<F**>(to) = *reinterpret_cast<F**>(from);
+            },
+            .destroy = [](std::byte* buffer) { delete *reinterpret_cast<F**>(buffer); },
+            .inlined = false,
+        };
+
+        alignas(INLINE_ALIGNMENT) std::byte buffer[INLINE_SIZE];
+        const Operations* operations{nullptr};
+
+        void moveFrom(DeferredCall& other) noexcept {
+            if (other.operations) {
+                other.operations->move(other.buffer, buffer);
+                operations = other.operations;
+                other.operations = nullptr;
+            }
+        }
+    };
+
+    /**
+     * Lock-free multiple producers, single consumer queue of DeferredCall.
+     *  - push() can be called from any thread and never blocks : it reserves a slot with one
+     *    atomic increment in the current block of slots. The calls of each producer are
+     *    executed in the order they were pushed.
+     *  - process() must only be called from one thread at a time (the main thread).
+     *  - Slots are stored in blocks of BLOCK_SIZE calls, the blocks consumed are linked again
+     *    at the end of the queue once no producer can still reference them, so the queue does
+     *    not allocate memory once warmed up (callables too large to be stored inline excepted).
+     */
+    class DeferredCallQueue {
+    public:
+        static constexpr uint32 BLOCK_SIZE{512};
+
+        DeferredCallQueue();
+
+        ~DeferredCallQueue();
+
+        /** Adds a call at the end of the queue, thread safe */
+        void push(DeferredCall&& call);
+
+        /**
+         * Executes the calls in the queue order, including the calls pushed by the executed calls
+         * @param maxCalls  Maximum number of calls executed, the remaining calls are kept for the next call
+         * @return the number of calls executed
+         */
+        uint32 process(uint32 maxCalls = std::numeric_limits<uint32>::max());
+
+        /** Returns true if there is no call ready to be executed, only reliable from the consumer thread */
+        bool empty() const;
+
+        DeferredCallQueue(DeferredCallQueue&) = delete;
+        DeferredCallQueue& operator=(DeferredCallQueue&) = delete;
+
+    private:
+        struct Slot {
+            DeferredCall call;
+            // Set by the producer when the call is written
+            std::atomic<bool> ready{false};
+        };
+
+        struct Block {
+            std::array<Slot, BLOCK_SIZE> slots;
+            // Number of slots reserved by the producers, can exceed BLOCK_SIZE when the block is full
+            std::atomic<uint32> reserved{0};
+            std::atomic<Block*> next{nullptr};
+        };
+
+        // Block the producers are writing to
+        std::atomic<Block*> tail;
+        // Number of producers inside push(), the consumed blocks are only reused when zero
+        std::atomic<uint32> activeProducers{0};
+        // Empty block the producers use before allocating a new one
+        std::atomic<Block*> spareBlock{nullptr};
+
+        // Consumer side
+        Block* head;
+        uint32 headIndex{0};
+        // Consumed blocks possibly still referenced by a producer
+        std::vector<Block*> retiredBlocks;
+
+        // Gets an empty block, from the spare block if any
+        Block* allocateBlock();
+
+        // Links the retired blocks at the end of the queue if no producer can reference them
+        void recycleBlocks();
+    };
+
+}
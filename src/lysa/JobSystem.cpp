@@ -0,0 +1,217 @@
+/*
+* Copyright (c) 2025-present Henri Michelon
+*
+* This software is released under the MIT License.
+* https://opensource.org/licenses/MIT
+*/
+module lysa.job_system;
+
+namespace lysa {
+
+    static constexpr auto NO_WORKER = std::numeric_limits<uint32>::max();
+
+    // Job system and worker index of the calling thread
+    static thread_local const JobSystem* currentJobSystem{nullptr};
+    static thread_local uint32 currentWorkerIndex{NO_WORKER};
+    // Nested wait() calls of the calling thread helping only the higher priorities
+    static thread_local uint32 currentPriorityWaits{0};
+
+    JobSystem::JobSystem(uint32 threadsCount, const uint32 ioThreadsCount) {
+        if (threadsCount == 0) {
+            // The main thread also executes jobs while waiting for them.
+            // hardware_concurrency() returns 0 when the number of threads is not known.
+            const auto hardwareThreads = std::thread::hardware_concurrency();
+            threadsCount = hardwareThreads > 1 ? hardwareThreads - 1 : 1;
+        }
+        for (auto i = 0u; i < threadsCount; i++) {
+            workers.push_back(std::make_unique<Worker>());
+        }
+        for (auto i = 0u; i < threadsCount; i++) {
+            threads.emplace_back([this, i] { workerMain(i); });
+        }
+        for (auto i = 0u; i < std::max(1u, ioThreadsCount); i++) {
+            ioThreads.emplace_back([this] { ioMain(); });
+        }
+    }
+
+    JobSystem::~JobSystem() {
+        stopping.store(true);
+        queuedJobs.fetch_add(1);
+        queuedJobs.notify_all();
+        queuedIoJobs.fetch_add(1);
+        queuedIoJobs.notify_all();
+        threads.clear();
+        ioThreads.clear();
+    }
+
+    JobHandle JobSystem::schedule(
+        DeferredCall&& function,
+        const JobPriority priority,
+        const std::span<const JobHandle> dependencies) {
+        auto job = std::make_shared<Job>();
+        job->function = std::move(function);
+        job->priority = priority;
+        for (const auto& dependency : dependencies) {
+            if (!dependency) { continue; }
+            auto lock = std::lock_guard{dependency->dependentsMutex};
+            if (!dependency->finished.load(std::memory_order_relaxed)) {
+                job->pendingDependencies.fetch_add(1, std::memory_order_relaxed);
+                dependency->dependents.push_back(job);
+            }
+        }
+        // Removes the scheduling reference, the job is queued now if all the dependencies are finished
+        if (job->pendingDependencies.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+            enqueue(job);
+        }
+        return job;
+    }
+
+    void JobSystem::wait(const JobHandle& job) {
+        const auto workerIndex = currentJobSystem == this ? currentWorkerIndex : NO_WORKER;
+        // A lower priority job could be long and delay the end of the wait
+        const auto maxPriority = std::min(job->priority, JobPriority::LOW);
+        const auto restricted = workerIndex != NO_WORKER && maxPriority != JobPriority::LOW;
+        if (restricted && currentPriorityWaits++ == 0) {
+            priorityWaitingWorkers.fetch_add(1, std::memory_order_relaxed);
+        }
+        while (!job->isFinished()) {
+            auto other = findJob(workerIndex, maxPriority);
+            if (!other && maxPriority != JobPriority::LOW &&
+                priorityWaitingWorkers.load(std::memory_order_relaxed) >= workers.size()) {
+                // No worker is free to execute the lower priority jobs, like a dependency of `job`
+                other = findJob(workerIndex);
+            }
+            if (other) {
+                execute(other);
+            } else {
+                std::this_thread::yield();
+            }
+        }
+        if (restricted && --currentPriorityWaits == 0) {
+            priorityWaitingWorkers.fetch_sub(1, std::memory_order_relaxed);
+        }
+    }
+
+    void JobSystem::wait(const std::span<const JobHandle> jobs) {
+        for (const auto& job : jobs) {
+            wait(job);
+        }
+    }
+
+    bool JobSystem::isWorkerThread() const {
+        return currentJobSystem == this;
+    }
+
+    void JobSystem::enqueue(JobHandle job) {
+        if (job->priority == JobPriority::BLOCKING) {
+            {
+                auto lock = std::lock_guard{ioQueueMutex};
+                ioQueue.push_back(std::move(job));
+            }
+            queuedIoJobs.fetch_add(1, std::memory_order_release);
+            queuedIoJobs.notify_one();
+            return;
+        }
+        const auto priority = static_cast<uint32>(job->priority);
+        if (currentJobSystem == this) {
+            auto& worker = *workers[currentWorkerIndex];
+            auto lock = std::lock_guard{worker.mutex};
+            worker.queues[priority].push_back(std::move(job));
+        } else {
+            auto lock = std::lock_guard{sharedQueuesMutex};
+            sharedQueues[priority].push_back(std::move(job));
+        }
+        queuedJobs.fetch_add(1, std::memory_order_release);
+        queuedJobs.notify_one();
+    }
+
+    JobHandle JobSystem::findJob(const uint32 workerIndex, const JobPriority maxPriority) {
+        auto job = JobHandle{};
+        const auto workersCount = static_cast<uint32>(workers.size());
+        for (auto priority = 0u; priority <= static_cast<uint32>(maxPriority) && !job; priority++) {
+            if (workerIndex != NO_WORKER) {
+                // Most recent job first, its data is probably still in the cache
+                auto& worker = *workers[workerIndex];
+                auto lock = std::lock_guard{worker.mutex};
+                if (auto& queue = worker.queues[priority]; !queue.empty()) {
+                    job = std::move(queue.back());
+                    queue.pop_back();
+                    break;
+                }
+            }
+            {
+                auto lock = std::lock_guard{sharedQueuesMutex};
+                if (auto& queue = sharedQueues[priority]; !queue.empty()) {
+                    job = std::move(queue.front());
+                    queue.pop_front();
+                    break;
+                }
+            }
+            // Steals the oldest job of another worker, starting with the next one
+            const auto first = workerIndex == NO_WORKER ? 0 : workerIndex + 1;
+            for (auto i = 0u; i < workersCount && !job; i++) {
+                const auto victimIndex = (first + i) % workersCount;
+                if (victimIndex == workerIndex) { continue; }
+                auto& victim = *workers[victimIndex];
+                auto lock = std::lock_guard{victim.mutex};
+                if (auto& queue = victim.queues[priority]; !queue.empty()) {
+                    job = std::move(queue.front());
+                    queue.pop_front();
+                }
+            }
+        }
+        if (job) {
+            queuedJobs.fetch_sub(1, std::memory_order_relaxed);
+        }
+        return job;
+    }
+
+    void JobSystem::execute(const JobHandle& job) {
+        job->function();
+        // Releases the captured objects now, the handle can be kept for a long time
+        job->function.reset();
+        auto dependents = std::vector<JobHandle>{};
+        {
+            auto lock = std::lock_guard{job->dependentsMutex};
+            job->finished.store(true, std::memory_order_release);
+            dependents.swap(job->dependents);
+        }
+        for (auto& dependent : dependents) {
+            if (dependent->pendingDependencies.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+                enqueue(std::move(dependent));
+            }
+        }
+    }
+
+    void JobSystem::workerMain(const uint32 workerIndex) {
+        currentJobSystem = this;
+        currentWorkerIndex = workerIndex;
+        while (!stopping.load(std::memory_order_acquire)) {
+            if (const auto job = findJob(workerIndex)) {
+                execute(job);
+            } else {
+                queuedJobs.wait(0, std::memory_order_acquire);
+            }
+        }
+    }
+
+    void JobSystem::ioMain() {
+        while (!stopping.load(std::memory_order_acquire)) {
+            auto job = JobHandle{};
+            {
+                auto lock = std::lock_guard{ioQueueMutex};
+                if (!ioQueue.empty()) {
+                    job = std::move(ioQueue.front());
+                    ioQueue.pop_front();
+                }
+            }
+            if (job) {
+                queuedIoJobs.fetch_sub(1, std::memory_order_relaxed);
+                execute(job);
+            } else {
+                queuedIoJobs.wait(0, std::memory_order_acquire);
+            }
+        }
+    }
+
+}
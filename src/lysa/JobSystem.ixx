@@ -0,0 +1,185 @@
+/*
+* Copyright (c) 2025-present Henri Michelon
+*
+* This software is released under the MIT License.
+* https://opensource.org/licenses/MIT
+*/
+export module lysa.job_system;
+
+import std;
+import lysa.deferred_calls;
+import lysa.types;
+
+export namespace lysa {
+
+    /** Order in which the queued jobs are executed */
+    enum class JobPriority : uint8 {
+        //! Frame critical work, the main thread is waiting for it
+        HIGH,
+        NORMAL,
+        //! Background work like glyphs generation
+        LOW,
+        //! Work waiting for files or the GPU, like assets loading. Only executed by the I/O threads.
+        BLOCKING,
+    };
+
+    /**
+     * %A unit of work scheduled in the JobSystem.<br>
+     * %A job is queued once all its dependencies are finished, then executed only once.
+     */
+    class Job {
+    public:
+        /** Returns true once the job has been executed */
+        bool isFinished() const { return finished.load(std::memory_order_acquire); }
+
+        auto getPriority() const { return priority; }
+
+    private:
+        friend class JobSystem;
+        DeferredCall function;
+        JobPriority priority{JobPriority::NORMAL};
+        // Dependencies not yet finished, plus one while the job is being scheduled
+        std::atomic<uint32> pendingDependencies{1};
+        std::atomic<bool> finished{false};
+        // Jobs to queue when this job is finished
+        std::vector<std::shared_ptr<Job>> dependents;
+        std::mutex dependentsMutex;
+    };
+
+    using JobHandle = std::shared_ptr<Job>;
+
+    /**
+     * Engine-wide pool of worker threads with work stealing.
+     *  - Each worker has its own queues, one per priority. %A worker executes the jobs it queued
+     *    last first and, when idle, steals the oldest jobs of the other workers.
+     *  - Jobs scheduled from outside the workers (the main thread) go in a shared queue.
+     *  - Dependencies are continuations : a job is only queued when its last dependency is
+     *    finished, nothing is blocked waiting for it.
+     *  - wait() executes the queued jobs with the same or a higher priority while waiting,
+     *    it can be called from a job. When all the workers are waiting, the waiting threads
+     *    execute the lower priority jobs too, since nobody else would.
+     *  - BLOCKING jobs are only executed by the I/O threads, in the order they are queued, so
+     *    they never keep a worker from the computing jobs.
+     *  - Jobs must not throw exceptions.
+     */
+    class JobSystem {
+    public:
+        static constexpr uint32 PRIORITIES_COUNT{3};
+
+        /**
+         * Starts the worker threads
+         * @param threadsCount      Number of worker threads, 0 for the number of hardware threads minus one
+         * @param ioThreadsCount    Number of threads executing the BLOCKING jobs, at least one
+         */
+        JobSystem(uint32 threadsCount = 0, uint32 ioThreadsCount = 2);
+
+        /** Stops the worker threads, the jobs not yet executed are discarded */
+        ~JobSystem();
+
+        /**
+         * Schedules a job, thread safe
+         * @param function      Work to execute
+         * @param priority      Order of execution relative to the other queued jobs
+         * @param dependencies  Jobs to finish before executing this job, null handles are ignored
+         */
+        JobHandle schedule(
+            DeferredCall&& function,
+            JobPriority priority = JobPriority::NORMAL,
+            std::span<const JobHandle> dependencies = {});
+
+        JobHandle schedule(
+            DeferredCall&& function,
+            const JobPriority priority,
+            const std::initializer_list<JobHandle> dependencies) {
+            return schedule(std::move(function), priority, std::span{dependencies.begin(), dependencies.size()});
+        }
+
+        /**
+         * Executes the queued jobs with the same or a higher priority than `job` until `job` is
+         * finished. BLOCKING jobs are never executed by the waiting thread.<br>
+         * The lower priority dependencies of `job` are executed by the other threads, or by the
+         * waiting thread if all the workers are waiting for higher priority jobs.
+         */
+        void wait(const JobHandle& job);
+
+        /** Waits for all the `jobs`, see wait(const JobHandle&) */
+        void wait(std::span<const JobHandle> jobs);
+
+        /**
+         * Calls `function(index)` for each index in [0, count), by batches of `batchSize` indices
+         * executed in parallel. Returns when all the calls are done.
+         */
+        template<typename Function>
+        void parallelFor(
+            const uint32 count,
+            const uint32 batchSize,
+            const Function& function,
+            const JobPriority priority = JobPriority::HIGH) {
+            if (count == 0) { return; }
+            const auto batchesCount = (count + batchSize - 1) / batchSize;
+            auto jobs = std::vector<JobHandle>{};
+            jobs.reserve(batchesCount - 1);
+            for (auto batch = 1u; batch < batchesCount; batch++) {
+                jobs.push_back(schedule([&function, batch, batchSize, count] {
+                    const auto end = std::min(count, (batch + 1) * batchSize);
+                    for (auto index = batch * batchSize; index < end; index++) {
+                        function(index);
+                    }
+                }, priority));
+            }
+            // The first batch is executed by the calling thread
+            for (auto index = 0u; index < std::min(count, batchSize); index++) {
+                function(index);
+            }
+            wait(jobs);
+        }
+
+        /** Returns the number of worker threads */
+        auto getThreadsCount() const { return static_cast<uint32>(threads.size()); }
+
+        /** Returns the number of I/O threads */
+        auto getIoThreadsCount() const { return static_cast<uint32>(ioThreads.size()); }
+
+        /** Returns true if the calling thread is one of the worker threads */
+        bool isWorkerThread() const;
+
+        JobSystem(JobSystem&) = delete;
+        JobSystem& operator=(JobSystem&) = delete;
+
+    private:
+        struct Worker {
+            std::array<std::deque<JobHandle>, PRIORITIES_COUNT> queues;
+            std::mutex mutex;
+        };
+
+        std::vector<std::unique_ptr<Worker>> workers;
+        std::vector<std::jthread> threads;
+        // Jobs scheduled from outside the workers
+        std::array<std::deque<JobHandle>, PRIORITIES_COUNT> sharedQueues;
+        std::mutex sharedQueuesMutex;
+        // Number of jobs in the queues, the idle workers sleep while zero
+        std::atomic<uint32> queuedJobs{0};
+        // Number of workers in a wait() helping only the higher priorities
+        std::atomic<uint32> priorityWaitingWorkers{0};
+        // BLOCKING jobs, executed by the I/O threads
+        std::deque<JobHandle> ioQueue;
+        std::mutex ioQueueMutex;
+        // Number of jobs in the I/O queue, the idle I/O threads sleep while zero
+        std::atomic<uint32> queuedIoJobs{0};
+        std::vector<std::jthread> ioThreads;
+        std::atomic<bool> stopping{false};
+
+        void enqueue(JobHandle job);
+
+        // Pops a job with a priority up to `maxPriority` from the worker queues, the shared queues,
+        // then steals one from the other workers
+        JobHandle findJob(uint32 workerIndex, JobPriority maxPriority = JobPriority::LOW);
+
+        void execute(const JobHandle& job);
+
+        void workerMain(uint32 workerIndex);
+
+        void ioMain();
+    };
+
+}
@@ -14,11 +14,13 @@ export import lysa.application;
 export import lysa.assets_pack;
 export import lysa.configuration;
 export import lysa.constants;
+export import lysa.deferred_calls;
 export import lysa.enums;
 export import lysa.exception;
 export import lysa.global;
 export import lysa.input;
 export import lysa.input_event;
+export import lysa.job_system;
 export import lysa.loader;
 export import lysa.log;
 export import lysa.math;
@@ -95,6 +95,22 @@ namespace lysa {
         stagingBufferCurrentOffset += destination.size;
     }
 
+    void DeviceMemoryArray::write(
+        const MemoryBlock& destination,
+        const void* source,
+        const size_t offset,
+        const size_t size) {
+        assert([&]{ return offset + size <= destination.size; }, "Write out of the memory block");
+        auto lock = std::lock_guard{mutex};
+        stagingBuffer->write(source, size, stagingBufferCurrentOffset);
+        pendingWrites.push_back({
+            stagingBufferCurrentOffset,
+            destination.offset + offset,
+            size,
+        });
+        stagingBufferCurrentOffset += size;
+    }
+
     void DeviceMemoryArray::flush(const vireo::CommandList& commandList) {
         auto lock = std::lock_guard{mutex};
         if (!pendingWrites.empty()) {
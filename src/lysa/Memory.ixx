@@ -22,6 +22,35 @@ export namespace lysa {
         }
     };
 
+    /**
+     * Compares two copies of `size` bytes by chunks of `chunkSize` bytes and calls `write(offset, size)`
+     * once per contiguous range of modified chunks. `size` must be a multiple of `chunkSize`.
+     */
+    template<typename Write>
+    void forEachModifiedRange(
+        const void* current,
+        const void* previous,
+        const std::size_t size,
+        const std::size_t chunkSize,
+        const Write& write) {
+        const auto* currentBytes = static_cast<const std::byte*>(current);
+        const auto* previousBytes = static_cast<const std::byte*>(previous);
+        auto rangeStart = std::size_t{0};
+        auto inRange = false;
+        for (auto offset = std::size_t{0}; offset <= size; offset += chunkSize) {
+            const auto modified =
+                offset < size &&
+                std::memcmp(currentBytes + offset, previousBytes + offset, chunkSize) != 0;
+            if (modified && !inRange) {
+                rangeStart = offset;
+                inRange = true;
+            } else if (!modified && inRange) {
+                write(rangeStart, offset - rangeStart);
+                inRange = false;
+            }
+        }
+    }
+
     class MemoryArray {
     public:
         MemoryBlock alloc(std::size_t instanceCount);
@@ -67,6 +96,11 @@ export namespace lysa {
 
         void write(const MemoryBlock& destination, const void* source) override;
 
+        /**
+         * Writes `size` bytes at `offset` inside a block
+         */
+        void write(const MemoryBlock& destination, const void* source, std::size_t offset, std::size_t size);
+
         void flush(const vireo::CommandList& commandList);
 
         void postBarrier(const vireo::CommandList& commandList) const;
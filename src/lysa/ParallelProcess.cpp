@@ -0,0 +1,70 @@
+/*
+* Copyright (c) 2025-present Henri Michelon
+*
+* This software is released under the MIT License.
+* https://opensource.org/licenses/MIT
+*/
+module lysa.parallel_process;
+
+namespace lysa {
+
+    // Node whose callback is executed by the calling thread
+    static thread_local Node* currentNode{nullptr};
+
+    ParallelProcess::ParallelProcess(JobSystem& jobSystem, const uint32 batchSize):
+        jobSystem{jobSystem},
+        batchSize{std::max(1u, batchSize)} {
+    }
+
+    Node* ParallelProcess::getCurrentNode() {
+        return currentNode;
+    }
+
+    void ParallelProcess::add(Node* node) {
+        if (node->parallelProcessIndex != Node::NOT_PARALLEL_PROCESSED) { return; }
+        node->parallelProcessIndex = static_cast<uint32>(nodes.size());
+        nodes.push_back(node);
+    }
+
+    void ParallelProcess::remove(Node* node) {
+        const auto index = node->parallelProcessIndex;
+        if (index == Node::NOT_PARALLEL_PROCESSED) { return; }
+        // Swaps with the last node, the order of the nodes does not matter
+        nodes[index] = nodes.back();
+        nodes[index]->parallelProcessIndex = index;
+        nodes.pop_back();
+        node->parallelProcessIndex = Node::NOT_PARALLEL_PROCESSED;
+    }
+
+    void ParallelProcess::process(const std::function<void(Node*)>& callback) {
+        processedNodes.clear();
+        for (auto* node : nodes) {
+            if (node->isProcessed()) {
+                processedNodes.push_back(node);
+            }
+        }
+        if (!processedNodes.empty()) {
+            // The nodes are kept alive by the tree, which is not modified until the end of the parallel process
+            jobSystem.parallelFor(
+                static_cast<uint32>(processedNodes.size()),
+                batchSize,
+                [&](const uint32 index) {
+                    // A callback waiting for a job can execute the callback of another node
+                    const auto previousNode = currentNode;
+                    currentNode = processedNodes[index];
+                    callback(currentNode);
+                    currentNode = previousNode;
+                });
+            // A parent updates the global transforms of its children again : the order of the nodes does not matter
+            for (auto* node : processedNodes) {
+                if (node->globalTransformPending) {
+                    node->globalTransformPending = false;
+                    node->updateGlobalTransform();
+                }
+            }
+        }
+        // Structural changes requested by the thread-safe nodes
+        calls.process();
+    }
+
+}
@@ -0,0 +1,73 @@
+/*
+* Copyright (c) 2025-present Henri Michelon
+*
+* This software is released under the MIT License.
+* https://opensource.org/licenses/MIT
+*/
+export module lysa.parallel_process;
+
+import std;
+import lysa.deferred_calls;
+import lysa.job_system;
+import lysa.types;
+import lysa.nodes.node;
+
+export namespace lysa {
+
+    /**
+     * Thread-safe nodes of a viewport, processed in parallel after the node tree traversal
+     * (see Node::setThreadSafeProcess()).
+     *  - The nodes are kept in a flat list updated when they enter or leave the viewport :
+     *    the tree is not traversed to find them.
+     *  - The callbacks of the processed nodes (see Node::isProcessed()) are called in jobs,
+     *    by batches of nodes.
+     *  - The global transforms are read-only during the parallel process : the transforms
+     *    changes of the nodes are propagated by the calling thread once all the callbacks
+     *    are done.
+     *  - The calls pushed with callAfter() are executed last, by the calling thread.
+     */
+    class ParallelProcess {
+    public:
+        /**
+         * @param jobSystem     Job system executing the callbacks
+         * @param batchSize     Number of nodes processed per job
+         */
+        ParallelProcess(JobSystem& jobSystem, uint32 batchSize);
+
+        /** Adds a node to the list, not thread safe */
+        void add(Node* node);
+
+        /** Removes a node from the list if present, not thread safe */
+        void remove(Node* node);
+
+        /** Returns the number of nodes in the list */
+        auto getNodesCount() const { return static_cast<uint32>(nodes.size()); }
+
+        /**
+         * Calls `callback` for the processed nodes of the list in the job system, propagates
+         * their transforms changes, then executes the calls pushed with callAfter()
+         */
+        void process(const std::function<void(Node*)>& callback);
+
+        /** Adds a lambda executed by process() once the nodes are processed, thread safe */
+        template<typename Lambda>
+        void callAfter(Lambda&& lambda) {
+            calls.push(DeferredCall{std::forward<Lambda>(lambda)});
+        }
+
+        /** Returns the node processed by the calling thread, or `nullptr` outside the parallel callbacks */
+        static Node* getCurrentNode();
+
+        ParallelProcess(ParallelProcess&) = delete;
+        ParallelProcess& operator=(ParallelProcess&) = delete;
+
+    private:
+        JobSystem& jobSystem;
+        const uint32 batchSize;
+        std::vector<Node*> nodes;
+        // Nodes processed by the last process(), reused to avoid allocations
+        std::vector<Node*> processedNodes;
+        DeferredCallQueue calls;
+    };
+
+}
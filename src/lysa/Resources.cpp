@@ -26,6 +26,13 @@ namespace lysa {
             config.maxVertexInstances,
             vireo::BufferType::VERTEX,
             "Vertex Array"},
+        vertexPositionArray {
+            vireo,
+            sizeof(VertexPositionData),
+            config.maxVertexInstances,
+            config.maxVertexInstances,
+            vireo::BufferType::VERTEX,
+            "Vertex Position Array"},
         indexArray {
             vireo,
             sizeof(uint32),
@@ -47,13 +54,16 @@ namespace lysa {
             config.maxMeshSurfaceInstances,
             vireo::BufferType::DEVICE_STORAGE,
             "MeshSurface Array"},
-        samplers{vireo},
-        textures{MAX_TEXTURES} {
+        samplers{vireo, config.maxFramesInFlight + 2},
+        textureStreamer{config},
+        glyphAtlas{config},
+        descriptorSets{config.maxFramesInFlight + 2},
+        textures{config.maxFramesInFlight + 2} {
         if (descriptorLayout == nullptr) {
             descriptorLayout = vireo.createDescriptorLayout("Resources");
             descriptorLayout->add(BINDING_MATERIAL, vireo::DescriptorType::DEVICE_STORAGE);
             descriptorLayout->add(BINDING_SURFACES, vireo::DescriptorType::DEVICE_STORAGE);
-            descriptorLayout->add(BINDING_TEXTURE, vireo::DescriptorType::SAMPLED_IMAGE, textures.size());
+            descriptorLayout->add(BINDING_TEXTURE, vireo::DescriptorType::SAMPLED_IMAGE, config.maxTextures);
             descriptorLayout->build();
         }
 
@@ -96,60 +106,124 @@ namespace lysa {
         graphicQueue.submit({commandList});
         graphicQueue.waitIdle();
 
-        for (int i = 0; i < textures.size(); i++) {
-            textures[i] = blankImage;
+        textures.reset(config.maxTextures, blankImage);
+        const auto blankTextures = std::vector(config.maxTextures, blankImage);
+        for (auto& descriptorSet : descriptorSets) {
+            descriptorSet = vireo.createDescriptorSet(descriptorLayout, "Resources");
+            descriptorSet->update(BINDING_MATERIAL, materialArray.getBuffer());
+            descriptorSet->update(BINDING_SURFACES, meshSurfaceArray.getBuffer());
+            descriptorSet->update(BINDING_TEXTURE, blankTextures);
         }
-
-        descriptorSet = vireo.createDescriptorSet(descriptorLayout, "Resources");
-        descriptorSet->update(BINDING_MATERIAL, materialArray.getBuffer());
-        descriptorSet->update(BINDING_SURFACES, meshSurfaceArray.getBuffer());
-        descriptorSet->update(BINDING_TEXTURE, textures);
     }
 
     uint32 Resources::addTexture(const Image& image) {
-        auto lock = std::lock_guard(mutex);
-        for (uint32 index = 0; index < textures.size(); index++) {
-            if (textures[index] == blankImage) {
-                textures[index] = image.getImage();
-                textureUpdated = true;
-                return index;
-            }
-        }
-        throw Exception("Out of memory for textures");
+        auto lock = std::lock_guard(texturesMutex);
+        return textures.add(image.getImage());
+    }
+
+    void Resources::removeTexture(const uint32 index) {
+        auto lock = std::lock_guard(texturesMutex);
+        // The textures are already released when called from the images destructors after cleanup()
+        if (textures.getCount() == 0) { return; }
+        textures.remove(index);
+    }
+
+    void Resources::addUpdatedMaterial(Material& material, const MaterialData& data) {
+        auto lock = std::lock_guard(materialsMutex);
+        material.pendingData = data;
+        updatedMaterials.insert(&material);
+    }
+
+    void Resources::removeUpdatedMaterial(Material& material) {
+        auto lock = std::lock_guard(materialsMutex);
+        updatedMaterials.erase(&material);
     }
 
     void Resources::update() {
         auto lock = std::lock_guard(mutex);
-        if (textureUpdated) {
-            Application::getGraphicQueue()->waitIdle();
-            descriptorSet->update(BINDING_TEXTURE, textures);
-            textureUpdated = false;
+        {
+            // Upload the materials modified during the last frame, once
+            auto materialsLock = std::lock_guard(materialsMutex);
+            if (!updatedMaterials.empty()) {
+                for (auto* material : updatedMaterials) {
+                    material->writeData(materialArray);
+                }
+                updatedMaterials.clear();
+                updated = true;
+            }
+        }
+        if (updated) {
+            flushArrays();
+        }
+        // Released after the textures lock : destroying an image frees its slot in removeTexture().
+        // The glyph atlas never releases its image during the update.
+        auto updatedImages = std::vector<std::shared_ptr<Image>>{};
+        auto texturesLock = std::lock_guard(texturesMutex);
+        if (config.textureStreamingEnabled) {
+            textureStreamer.update(textures, updatedImages);
+        }
+        glyphAtlas.update(textures);
+        // The next set of the ring was last used maxFramesInFlight + 1 frames ago,
+        // the GPU no longer reads it and the images it references can be released.
+        // Its copy of the textures is only patched with the slots changed since it was written,
+        // Vireo only writes whole descriptor arrays.
+        if (const auto* updatedTextures = textures.update()) {
+            descriptorSets[textures.getCurrent()]->update(BINDING_TEXTURE, *updatedTextures);
         }
         if (samplers.isUpdated()) {
             samplers.update();
         }
     }
 
+    MemoryBlock Resources::allocVertices(const std::size_t count) {
+        auto lock = std::lock_guard{verticesMutex};
+        const auto block = vertexArray.alloc(count);
+        const auto positionsBlock = vertexPositionArray.alloc(count);
+        assert([&]{ return block.instanceIndex == positionsBlock.instanceIndex; },
+            "Vertex arrays allocations out of sync");
+        return block;
+    }
+
+    void Resources::writeVertices(
+        const MemoryBlock& destination,
+        const VertexData* vertexData,
+        const VertexPositionData* vertexPositionData) {
+        vertexArray.write(destination, vertexData);
+        vertexPositionArray.write({
+            destination.instanceIndex,
+            destination.instanceIndex * sizeof(VertexPositionData),
+            (destination.size / sizeof(VertexData)) * sizeof(VertexPositionData)},
+            vertexPositionData);
+    }
+
     void Resources::cleanup() {
+        textureStreamer.cleanup();
+        glyphAtlas.cleanup();
         samplers.cleanup();
         textures.clear();
+        descriptorSets.clear();
         blankImage.reset();
         blankCubeMap.reset();
         indexArray.cleanup();
         vertexArray.cleanup();
+        vertexPositionArray.cleanup();
         materialArray.cleanup();
         meshSurfaceArray.cleanup();
         descriptorLayout.reset();
-        descriptorSet.reset();
     }
 
     void Resources::flush() {
         // INFO("Resources::flush");
         auto lock = std::unique_lock(mutex, std::try_to_lock);
+        flushArrays();
+    }
+
+    void Resources::flushArrays() {
         auto& asyncQueue = Application::getAsyncQueue();
         const auto command = asyncQueue.beginCommand(vireo::CommandType::TRANSFER);
         indexArray.flush(*command.commandList);
         vertexArray.flush(*command.commandList);
+        vertexPositionArray.flush(*command.commandList);
         materialArray.flush(*command.commandList);
         meshSurfaceArray.flush(*command.commandList);
         updated = false;
@@ -10,8 +10,12 @@ import vireo;
 import lysa.configuration;
 import lysa.memory;
 import lysa.samplers;
+import lysa.texture_slots;
+import lysa.texture_streamer;
 import lysa.types;
+import lysa.resources.glyph_atlas;
 import lysa.resources.image;
+import lysa.resources.material;
 import lysa.resources.mesh;
 
 export namespace lysa {
@@ -24,19 +28,20 @@ export namespace lysa {
      * used by draw pipelines, and texture images including fallback (blank) assets.
      *  - Allocate and provide access to large device-side arrays used by the renderers.
      *  - Maintain a descriptor set exposing materials, surfaces and textures to shaders.
-     *  - Manage a pool of sampled images with a fixed upper bound (MAX_TEXTURES).
+     *  - Manage a pool of sampled images with a configured upper bound and O(1) slot allocation.
+     *  - Recycle a ring of textures descriptor sets so that textures changes never wait for the GPU.
      *  - Provide default blank 2D and cube textures to avoid null bindings.
      *  - Track and expose an "updated" flag so dependent systems can react.
      *
      * Thread-safety:
-     *  - Public methods that mutate internal state should be guarded by the provided mutex.
+     *  - Command lists recording holds a shared lock on the provided mutex, so several
+     *    recording jobs can use the resources concurrently.
+     *  - Public methods that mutate the buffers or the descriptor set hold an exclusive lock.
+     *  - Textures registration only locks the textures list and does not wait for the recording.
      *  - Read-only getters may be called concurrently once initialization is complete.
      */
     class Resources {
     public:
-        /** Maximum number of textures managed and bound by this container. */
-        static constexpr auto MAX_TEXTURES{500};
-
         /** Descriptor set index used by pipelines to bind shared resources. */
         static constexpr uint32 SET_RESOURCES{0};
         /** Descriptor binding index for the material buffer. */
@@ -63,6 +68,18 @@ export namespace lysa {
         /** Returns the device memory array storing vertex data. */
         DeviceMemoryArray& getVertexArray() { return vertexArray; }
 
+        /** Returns the device memory array storing the positions-only vertex stream. */
+        DeviceMemoryArray& getVertexPositionArray() { return vertexPositionArray; }
+
+        /**
+         * Allocates vertices in both the vertex and the positions-only arrays,
+         * at the same vertex index.
+         */
+        MemoryBlock allocVertices(std::size_t count);
+
+        /** Writes vertices in both the vertex and the positions-only arrays. */
+        void writeVertices(const MemoryBlock& destination, const VertexData* vertexData, const VertexPositionData* vertexPositionData);
+
         /** Returns the device memory array storing index data. */
         DeviceMemoryArray& getIndexArray() { return indexArray; }
 
@@ -75,18 +92,40 @@ export namespace lysa {
         /** Returns the global sampler collection used by the renderer. */
         Samplers& getSamplers() { return samplers; }
 
+        /** Returns the mip levels streamer of the assets packs textures. */
+        TextureStreamer& getTextureStreamer() { return textureStreamer; }
+
+        /** Returns the glyphs atlas shared by the fonts without a precomputed atlas. */
+        GlyphAtlas& getGlyphAtlas() { return glyphAtlas; }
+
         /**
-         * Adds a texture to the internal textures list and uploads it to the GPU.
-         * If the capacity MAX_TEXTURES is reached, an engine-defined policy applies
-         * (typically reuse or replace); callers should not rely on indices beyond the limit.
+         * Adds a texture to the internal textures list, the descriptors are updated on the next update().
+         * Throws an Exception if ResourcesConfiguration::maxTextures is reached.
          *
          * @param image CPU-side image data to upload.
          * @return Texture index suitable for shader/resource binding.
          */
         uint32 addTexture(const Image& image);
 
-        /** Returns the descriptor set that exposes resources to shaders. */
-        const auto& getDescriptorSet() const { return descriptorSet; }
+        /**
+         * Releases a texture slot, the slot is bound to the blank image on the next update().
+         *
+         * @param index Texture index returned by addTexture().
+         */
+        void removeTexture(uint32 index);
+
+        /**
+         * Schedules the upload of the data of a material on the next update().<br>
+         * `data` is a snapshot of the material taken by the thread modifying it,
+         * update() never reads the material properties.
+         */
+        void addUpdatedMaterial(Material& material, const MaterialData& data);
+
+        /** Cancels the upload of the data of a destroyed material. */
+        void removeUpdatedMaterial(Material& material);
+
+        /** Returns the descriptor set that exposes resources to shaders for the current frame. */
+        const auto& getDescriptorSet() const { return descriptorSets[textures.getCurrent()]; }
 
         /**
          * Flushes pending uploads to the device. Typically enqueues copy/transfer
@@ -94,7 +133,12 @@ export namespace lysa {
          */
         void flush();
 
-        /** Applies incremental updates to buffers, images, and descriptors if needed. */
+        /**
+         * Applies incremental updates to buffers, images, and descriptors if needed.
+         * The materials data modified since the last call are written and the arrays are flushed.
+         * Called once per frame : when the textures changed the next descriptor set of the ring,
+         * no longer used by the frames in flight, is written and becomes the current one.
+         */
         void update();
 
         /** Releases all GPU and CPU-side resources owned by this container. */
@@ -106,7 +150,7 @@ export namespace lysa {
         /** Returns true when an update has been flagged since the last processing. */
         bool isUpdated() const { return updated; }
 
-        /** Provides access to the internal mutex used to guard mutations. */
+        /** Provides access to the internal mutex used to guard mutations (exclusive) and recording (shared). */
         auto& getMutex() { return mutex; }
 
         /** Returns the default 2D blank image used as a safe fallback. */
@@ -123,6 +167,10 @@ export namespace lysa {
         const ResourcesConfiguration& config;
         /** Device memory array that stores all vertex buffers. */
         DeviceMemoryArray vertexArray;
+        /** Device memory array that stores the positions-only vertex stream, with the same indices. */
+        DeviceMemoryArray vertexPositionArray;
+        /** Keeps the allocations of the two vertex arrays in the same order. */
+        std::mutex verticesMutex;
         /** Device memory array that stores all index buffers. */
         DeviceMemoryArray indexArray;
         /** Device memory array that stores material parameter blocks. */
@@ -131,20 +179,37 @@ export namespace lysa {
         DeviceMemoryArray meshSurfaceArray;
         /** Collection of pre-created sampler objects shared across materials. */
         Samplers samplers;
-        /** Descriptor set bound at SET_RESOURCES with material/surfaces/textures. */
-        std::shared_ptr<vireo::DescriptorSet> descriptorSet;
-        /** List of GPU texture images managed by this container. */
-        std::vector<std::shared_ptr<vireo::Image>> textures;
+        /** Streams the finer mip levels of the textures, see ResourcesConfiguration::textureStreamingEnabled. */
+        TextureStreamer textureStreamer;
+        /** Glyphs generated on demand for the fonts without a precomputed atlas. */
+        GlyphAtlas glyphAtlas;
+        /**
+         * Ring of descriptor sets bound at SET_RESOURCES with material/surfaces/textures,
+         * one more than the frames in flight plus the frame being recorded.
+         */
+        std::vector<std::shared_ptr<vireo::DescriptorSet>> descriptorSets;
+        /**
+         * Slots of the GPU texture images managed by this container, with one copy per descriptor set
+         * keeping the images written in the set alive while the frames in flight can use them.
+         */
+        TextureSlots<std::shared_ptr<vireo::Image>> textures;
         /** Default 2D image used when a texture is missing. */
         std::shared_ptr<vireo::Image> blankImage;
         /** Default cubemap image used when a cubemap is missing. */
         std::shared_ptr<vireo::Image> blankCubeMap;
         /** Flag indicating the container has pending updates. */
         bool updated{false};
-        /** Flag indicating that one or more textures changed and need syncing. */
-        bool textureUpdated{false};
-        /** Mutex to guard mutations to textures, buffers, and descriptor set. */
-        std::mutex mutex;
+        /** Guards mutations to buffers and descriptor set against command lists recording. */
+        std::shared_mutex mutex;
+        /** Guards the textures list, shared with the textures loading threads. */
+        std::mutex texturesMutex;
+        /** Materials with data modified since the last update(). */
+        std::unordered_set<Material*> updatedMaterials;
+        /** Guards the list of modified materials. */
+        std::mutex materialsMutex;
+
+        /** Records the copy of the pending writes of the arrays. */
+        void flushArrays();
 
         /** Creates a small in-memory JPEG used to initialize blank textures. */
         static std::vector<uint8> createBlankJPEG();
@@ -10,14 +10,16 @@ import lysa.exception;
 
 namespace lysa {
 
-    Samplers::Samplers(const vireo::Vireo& vireo):
+    Samplers::Samplers(const vireo::Vireo& vireo, const uint32 descriptorSetsCount):
         vireo{vireo},
-        samplers(MAX_SAMPLERS),
-        samplersInfo(MAX_SAMPLERS) {
+        table{MAX_SAMPLERS, descriptorSetsCount},
+        descriptorSets(descriptorSetsCount) {
         descriptorLayout = vireo.createSamplerDescriptorLayout("Static Samplers");
         descriptorLayout->add(0, vireo::DescriptorType::SAMPLER, MAX_SAMPLERS);
         descriptorLayout->build();
-        descriptorSet = vireo.createDescriptorSet(descriptorLayout, "Static Samplers");
+        for (auto& descriptorSet : descriptorSets) {
+            descriptorSet = vireo.createDescriptorSet(descriptorLayout, "Static Samplers");
+        }
 
         // Used for frame buffers/screen sample
         addSampler(
@@ -47,15 +49,37 @@ namespace lysa {
             vireo::Filter::NEAREST,
             vireo::AddressMode::REPEAT,
             vireo::AddressMode::REPEAT);
-        for (int i = samplerCount; i < samplers.size(); i++) {
-            samplers[i] = samplers[0];
+        table.fillEmptySlots(table.getSamplers()[0]);
+        // Goes around the ring once, back to the first set
+        for (auto i = 0u; i < descriptorSets.size(); i++) {
+            const auto set = table.next();
+            descriptorSets[set]->update(0, table.getSetSamplers(set));
         }
     }
 
+    size_t SamplerInfoHash::operator()(const SamplerInfo& info) const {
+        auto hash = size_t{0};
+        const auto combine = [&hash](const size_t value) {
+            hash ^= value + 0x9e3779b9 + (hash << 6) + (hash >> 2);
+        };
+        combine(std::hash<int>{}(static_cast<int>(info.minFilter)));
+        combine(std::hash<int>{}(static_cast<int>(info.maxFilter)));
+        combine(std::hash<int>{}(static_cast<int>(info.samplerAddressModeU)));
+        combine(std::hash<int>{}(static_cast<int>(info.samplerAddressModeV)));
+        combine(std::hash<float>{}(info.minLod));
+        combine(std::hash<float>{}(info.maxLod));
+        combine(std::hash<bool>{}(info.anisotropyEnable));
+        combine(std::hash<int>{}(static_cast<int>(info.mipMapMode)));
+        combine(std::hash<int>{}(static_cast<int>(info.samplerCompareOp)));
+        return hash;
+    }
+
     void Samplers::update() {
         auto lock = std::lock_guard{mutex};
-        descriptorSet->update(0, samplers);
-        samplersUpdated = false;
+        // The next set of the ring is no longer used by the frames in flight,
+        // the samplers released since it was last written are destroyed now
+        const auto set = table.next();
+        descriptorSets[set]->update(0, table.getSetSamplers(set));
     }
 
     uint32 Samplers::addSampler(
@@ -69,41 +93,36 @@ namespace lysa {
         const vireo::MipMapMode mipMapMode,
         const vireo::CompareOp compareOp) {
         auto lock = std::lock_guard{mutex};
-        if (samplerCount >= MAX_SAMPLERS) {
-            throw Exception("Too many samplers");
-        }
         const auto samplerInfo = SamplerInfo{
             minFilter, maxFilter,
             samplerAddressModeU, samplerAddressModeV,
             minLod, maxLod,
             anisotropyEnable,
             mipMapMode,compareOp};
-        for (int i = 0; i < samplerCount; i++) {
-            if (samplersInfo[i] == samplerInfo) {
-                return i;
-            }
-        }
-        const auto index = samplerCount;
-        samplers[index] = vireo.createSampler(
-            minFilter,
-            maxFilter,
-            samplerAddressModeU,
-            samplerAddressModeV,
-            samplerAddressModeV,
-            minLod,
-            maxLod,
-            anisotropyEnable,
-            mipMapMode,
-            compareOp);
-        samplersInfo[index] = samplerInfo;
-        samplersUpdated = true;
-        samplerCount++;
-        return index;
+        return table.add(samplerInfo, [&] {
+            return vireo.createSampler(
+                minFilter,
+                maxFilter,
+                samplerAddressModeU,
+                samplerAddressModeV,
+                samplerAddressModeV,
+                minLod,
+                maxLod,
+                anisotropyEnable,
+                mipMapMode,
+                compareOp);
+        });
+    }
+
+    void Samplers::releaseSampler(const uint32 index) {
+        if (index < STATIC_SAMPLERS) { return; }
+        auto lock = std::lock_guard{mutex};
+        table.release(index);
     }
 
     void Samplers::cleanup() {
-        samplers.clear();
-        descriptorSet.reset();
+        table.clear();
+        descriptorSets.clear();
         descriptorLayout.reset();
     }
 
@@ -7,15 +7,189 @@ export module lysa.samplers;
 
 import std;
 import vireo;
+import lysa.exception;
 import lysa.types;
 
 export namespace lysa {
 
+    /**
+     * Human-readable description of sampler creation parameters.
+     * Two SamplerInfo values are considered equal if all fields match;
+     * this allows avoiding duplicate samplers.
+     */
+    struct SamplerInfo {
+        /** Minification filter used by the sampler. */
+        vireo::Filter minFilter;
+        /** Magnification filter used by the sampler. */
+        vireo::Filter maxFilter;
+        /** Addressing mode for the U (S) texture coordinate. */
+        vireo::AddressMode samplerAddressModeU;
+        /** Addressing mode for the V (T) texture coordinate. */
+        vireo::AddressMode samplerAddressModeV;
+        /** Minimum mip level to sample from (LOD clamp). */
+        float minLod;
+        /** Maximum mip level to sample from (LOD clamp). */
+        float maxLod;
+        /** Enables anisotropic filtering if supported by the backend. */
+        bool anisotropyEnable;
+        /** Mip level sampling mode (nearest/linear). */
+        vireo::MipMapMode mipMapMode;
+        /** Optional comparison operation (useful for shadow samplers). */
+        vireo::CompareOp samplerCompareOp;
+
+        friend bool operator==(const SamplerInfo&l, const SamplerInfo&r) {
+            return l.minFilter == r.minFilter &&
+                l.maxFilter == r.maxFilter &&
+                l.samplerAddressModeU == r.samplerAddressModeU &&
+                l.samplerAddressModeV == r.samplerAddressModeV &&
+                l.minLod == r.minLod &&
+                l.maxLod == r.maxLod &&
+                l.anisotropyEnable == r.anisotropyEnable &&
+                l.mipMapMode == r.mipMapMode &&
+                l.samplerCompareOp == r.samplerCompareOp;
+        }
+    };
+
+    /** Hash of a sampler description, for the samplers cache. */
+    struct SamplerInfoHash {
+        size_t operator()(const SamplerInfo& info) const;
+    };
+
+    /**
+     * Slots of the samplers table, without the GPU objects creation so that it can be used without a device.
+     *  - The samplers are deduplicated by description and reference counted, the released slots are reused.
+     *  - Each set of a ring of descriptor sets keeps a reference to the samplers written in it :
+     *    a released sampler stays alive until the last set referencing it is recycled, even if its slot
+     *    has been reused by another sampler in the meantime.
+     */
+    template<typename Sampler>
+    class SamplersTable {
+    public:
+        /**
+         * @param size      Number of slots
+         * @param ringSize  Number of descriptor sets of the ring
+         */
+        SamplersTable(const uint32 size, const uint32 ringSize):
+            samplers(size),
+            samplersInfo(size),
+            samplersReferences(size),
+            setsSamplers(ringSize) {
+            // Lowest indices first
+            for (auto i = static_cast<int>(size) - 1; i >= 0; i--) {
+                freeSamplersIndices.push_back(i);
+            }
+        }
+
+        /**
+         * Adds a reference to the sampler described by `info` and returns its slot.<br>
+         * The sampler is created with `create()` if it does not already exist.
+         * Throws an Exception if the table is full.
+         */
+        template<typename Create>
+        uint32 add(const SamplerInfo& info, const Create& create) {
+            if (const auto it = samplersIndices.find(info); it != samplersIndices.end()) {
+                samplersReferences[it->second]++;
+                return it->second;
+            }
+            if (freeSamplersIndices.empty()) {
+                throw Exception("Too many samplers");
+            }
+            const auto index = freeSamplersIndices.back();
+            samplers[index] = create();
+            freeSamplersIndices.pop_back();
+            samplersInfo[index] = info;
+            samplersReferences[index] = 1;
+            samplersIndices[info] = index;
+            updated = true;
+            return index;
+        }
+
+        /**
+         * Releases a reference to a sampler.<br>
+         * The sampler stays in its slot until the slot is reused. Returns true if the slot is free.
+         */
+        bool release(const uint32 index) {
+            // The samplers are already released when called from the textures destructors after clear()
+            if (samplers.empty()) { return false; }
+            assert([&]{ return samplersReferences[index] > 0; }, "Sampler already released");
+            samplersReferences[index]--;
+            if (samplersReferences[index] > 0) {
+                return false;
+            }
+            samplersIndices.erase(samplersInfo[index]);
+            freeSamplersIndices.push_back(index);
+            return true;
+        }
+
+        /** Uses `sampler` for the slots never used, since the descriptors arrays can not have null entries. */
+        void fillEmptySlots(const std::shared_ptr<Sampler>& sampler) {
+            for (auto& slot : samplers) {
+                if (!slot) { slot = sampler; }
+            }
+        }
+
+        /**
+         * Moves to the next set of the ring, which is no longer used by the frames in flight,
+         * and references the current samplers with it. Returns the index of the set.
+         */
+        uint32 next() {
+            currentSet = (currentSet + 1) % setsSamplers.size();
+            // Releases the samplers only referenced by the recycled set
+            setsSamplers[currentSet] = samplers;
+            updated = false;
+            return currentSet;
+        }
+
+        /** Returns the current samplers of the slots */
+        const auto& getSamplers() const { return samplers; }
+
+        /** Returns the samplers referenced by a set of the ring */
+        const auto& getSetSamplers(const uint32 set) const { return setsSamplers[set]; }
+
+        /** Returns the index of the set used by the frames being recorded */
+        auto getCurrentSet() const { return currentSet; }
+
+        /** Returns the number of references of a slot, 0 for the free slots */
+        auto getReferences(const uint32 index) const { return samplersReferences[index]; }
+
+        /** Returns true if samplers were created since the last call to next() */
+        bool isUpdated() const { return updated; }
+
+        /** Releases all the samplers */
+        void clear() {
+            samplers.clear();
+            samplersIndices.clear();
+            freeSamplersIndices.clear();
+            setsSamplers.clear();
+        }
+
+    private:
+        /** Sampler objects of the slots. */
+        std::vector<std::shared_ptr<Sampler>> samplers;
+        /** Creation parameters of each slot, used to remove the released samplers from the cache. */
+        std::vector<SamplerInfo>              samplersInfo;
+        /** Number of references to each slot, 0 for the free slots. */
+        std::vector<uint32>                   samplersReferences;
+        /** Index of the existing samplers by creation parameters. */
+        std::unordered_map<SamplerInfo, uint32, SamplerInfoHash> samplersIndices;
+        /** Stack of the free slots. */
+        std::vector<uint32>                   freeSamplersIndices;
+        /** Samplers referenced by each set of the ring. */
+        std::vector<std::vector<std::shared_ptr<Sampler>>> setsSamplers;
+        /** Index of the set used by the frames being recorded. */
+        uint32 currentSet{0};
+        /** Flag set when samplers were created and descriptors must be updated. */
+        bool updated{false};
+    };
+
     /**
      * Manages a small, shared collection of GPU sampler objects.
      *  - Provide a fixed-size pool of samplers that materials/shaders can reuse.
+     *  - Deduplicate the samplers with a hashed cache keyed by their full description,
+     *    and reference count them so that released slots can be reused.
      *  - Create and track descriptor layout and descriptor set for binding samplers.
-     *  - Expose an update mechanism to (re)write descriptors when the set changes.
+     *  - Expose an update mechanism to (re)write descriptors when the set changes, using a ring of
+     *    descriptor sets so that the sets used by the frames in flight are never modified.
      *
      * Notes:
      *  - This class is typically owned by the Resources container and is not
@@ -29,48 +203,14 @@ export namespace lysa {
         static constexpr auto MAX_SAMPLERS{20};
         /** Descriptor set index used by pipelines to bind the samplers set. */
         static constexpr uint32 SET_SAMPLERS{1};
-
-        /**
-         * Human-readable description of sampler creation parameters.
-         * Two SamplerInfo values are considered equal if all fields match;
-         * this allows avoiding duplicate samplers.
-         */
-        struct SamplerInfo {
-            /** Minification filter used by the sampler. */
-            vireo::Filter minFilter;
-            /** Magnification filter used by the sampler. */
-            vireo::Filter maxFilter;
-            /** Addressing mode for the U (S) texture coordinate. */
-            vireo::AddressMode samplerAddressModeU;
-            /** Addressing mode for the V (T) texture coordinate. */
-            vireo::AddressMode samplerAddressModeV;
-            /** Minimum mip level to sample from (LOD clamp). */
-            float minLod;
-            /** Maximum mip level to sample from (LOD clamp). */
-            float maxLod;
-            /** Enables anisotropic filtering if supported by the backend. */
-            bool anisotropyEnable;
-            /** Mip level sampling mode (nearest/linear). */
-            vireo::MipMapMode mipMapMode;
-            /** Optional comparison operation (useful for shadow samplers). */
-            vireo::CompareOp samplerCompareOp;
-
-            friend bool operator==(const SamplerInfo&l, const SamplerInfo&r) {
-                return l.minFilter == r.minFilter &&
-                    l.maxFilter == r.maxFilter &&
-                    l.samplerAddressModeU == r.samplerAddressModeU &&
-                    l.samplerAddressModeV == r.samplerAddressModeV &&
-                    l.minLod == r.minLod &&
-                    l.maxLod == r.maxLod &&
-                    l.anisotropyEnable == r.anisotropyEnable &&
-                    l.mipMapMode == r.mipMapMode &&
-                    l.samplerCompareOp == r.samplerCompareOp;
-            }
-        };
+        /** Number of samplers created by the pool itself, never released. */
+        static constexpr uint32 STATIC_SAMPLERS{5};
 
         /**
          * Adds a sampler to the pool, creating it if an equivalent one does not
-         * already exist, and returns its index for binding.
+         * already exist, and returns its index for binding.<br>
+         * Each call adds a reference to the sampler, released with releaseSampler().
+         * Throws an Exception if the sampler does not exist and the pool is full.
          *
          * @param minFilter          Minification filter.
          * @param maxFilter          Magnification filter.
@@ -94,8 +234,15 @@ export namespace lysa {
             vireo::MipMapMode mipMapMode = vireo::MipMapMode::LINEAR,
             vireo::CompareOp compareOp = vireo::CompareOp::NEVER);
 
+        /**
+         * Releases a reference to a sampler returned by addSampler().
+         * The slot is reused by the next new sampler when no references are left.
+         * The static samplers are never released.
+         */
+        void releaseSampler(uint32 index);
+
         /** Returns true if the samplers descriptor set needs to be updated. */
-        bool isUpdated() const { return samplersUpdated; }
+        bool isUpdated() const { return table.isUpdated(); }
 
         /** Writes pending sampler bindings to the descriptor set if needed. */
         void update();
@@ -103,30 +250,27 @@ export namespace lysa {
         /** Returns the descriptor layout used for the samplers set. */
         const auto& getDescriptorLayout() const { return descriptorLayout; }
 
-        /** Returns the descriptor set that binds the samplers to shaders. */
-        const auto& getDescriptorSet() const { return descriptorSet; }
+        /** Returns the descriptor set that binds the samplers to shaders for the current frame. */
+        const auto& getDescriptorSet() const { return descriptorSets[table.getCurrentSet()]; }
 
     private:
         /** Reference to the graphics backend entry point. */
         const vireo::Vireo& vireo;
-        /** Number of active samplers in the pool. */
-        uint32 samplerCount{0};
-        /** Sampler objects owned by this pool. */
-        std::vector<std::shared_ptr<vireo::Sampler>> samplers;
-        /** Cached creation parameters to detect duplicates and changes. */
-        std::vector<SamplerInfo>                     samplersInfo;
+        /** Sampler objects owned by this pool and referenced by the descriptor sets. */
+        SamplersTable<vireo::Sampler> table;
         /** Descriptor layout describing the samplers binding. */
         std::shared_ptr<vireo::DescriptorLayout>     descriptorLayout;
-        /** Descriptor set that holds the array of samplers. */
-        std::shared_ptr<vireo::DescriptorSet>        descriptorSet;
-        /** Flag set when samplers were added/changed and descriptors must be updated. */
-        bool samplersUpdated{false};
+        /** Ring of descriptor sets that hold the array of samplers. */
+        std::vector<std::shared_ptr<vireo::DescriptorSet>> descriptorSets;
         /** Mutex that guards modifications to the pool and descriptor set. */
         std::mutex mutex;
 
         friend class Resources;
-        /** Creates a Samplers pool bound to the given backend (Resources owns it). */
-        Samplers(const vireo::Vireo& vireo);
+        /**
+         * Creates a Samplers pool bound to the given backend (Resources owns it).
+         * @param descriptorSetsCount Size of the descriptor sets ring, greater than the number of frames in flight.
+         */
+        Samplers(const vireo::Vireo& vireo, uint32 descriptorSetsCount);
         /** Destroys all sampler objects and releases descriptor resources. */
         void cleanup();
 
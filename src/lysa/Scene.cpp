@@ -12,6 +12,7 @@ import lysa.exception;
 import lysa.log;
 import lysa.viewport;
 import lysa.window;
+import lysa.nodes.omni_light;
 import lysa.renderers.renderpass.shadow_map_pass;
 
 namespace lysa {
@@ -57,6 +58,7 @@ namespace lysa {
             config.maxModelsPerScene,
             vireo::BufferType::DEVICE_STORAGE,
             "meshInstances Data"},
+        shadowMapBudget{config.shadowMapBudgetSize, config.shadowMapMinSize},
         sceneUniformBuffer{Application::getVireo().createBuffer(
             vireo::BufferType::UNIFORM,
             sizeof(SceneData), 1,
@@ -86,6 +88,16 @@ namespace lysa {
         lightsBuffer->map();
     }
 
+    CullingStatistics Scene::getCullingStatistics() const {
+        auto statistics = CullingStatistics{};
+        for (const auto* pipelinesData : { &opaquePipelinesData, &shaderMaterialPipelinesData, &transparentPipelinesData }) {
+            for (const auto& pipelineData : std::views::values(*pipelinesData)) {
+                statistics += pipelineData->frustumCullingPipeline.getStatistics();
+            }
+        }
+        return statistics;
+    }
+
     void Scene::compute(vireo::CommandList& commandList) const {
         compute(commandList, opaquePipelinesData);
         compute(commandList, shaderMaterialPipelinesData);
@@ -127,11 +139,15 @@ namespace lysa {
         if (!removedLights.empty()) {
             for (const auto& light : removedLights) {
                 lights.remove(light);
+                shadowMapRefusedLights.remove(light);
                 disableLightShadowCasting(light);
             }
         }
         if (!removedMeshInstances.empty()) {
             for (const auto& meshInstance : removedMeshInstances) {
+                if (meshInstance->isStaticShadowCaster()) {
+                    staticShadowCastersUpdated = true;
+                }
                 meshInstancesDataArray.free(meshInstancesDataMemoryBlocks.at(meshInstance));
                 meshInstancesDataMemoryBlocks.erase(meshInstance);
             }
@@ -139,6 +155,7 @@ namespace lysa {
             removedMeshInstances.clear();
         }
 
+        updateShadowMapsSizes();
         if (shadowMapsUpdated) {
             descriptorSet->update(BINDING_SHADOW_MAPS, shadowMaps);
             descriptorSetOpt1->update(BINDING_SHADOW_MAP_TRANSPARENCY_COLOR, shadowTransparencyColorMaps);
@@ -159,11 +176,22 @@ namespace lysa {
         }
         sceneUniformBuffer->write(&sceneUniform);
 
+        if (Application::getConfiguration().resourcesConfig.textureStreamingEnabled) {
+            requestTexturesMips();
+        }
+
+        auto staticCastersCount = 0u;
         for (const auto& meshInstance : std::views::keys(meshInstancesDataMemoryBlocks)) {
+            if (meshInstance->isStaticShadowCaster()) {
+                staticCastersCount += 1;
+            }
             if (meshInstance->isUpdated()) {
                 const auto modelData = meshInstance->getModelData();
                 meshInstancesDataArray.write(meshInstancesDataMemoryBlocks[meshInstance], &modelData);
                 meshInstancesDataUpdated = true;
+                if (meshInstance->isStaticShadowCaster()) {
+                    staticShadowCastersUpdated = true;
+                }
                 meshInstance->decrementUpdates();
             }
         }
@@ -174,6 +202,20 @@ namespace lysa {
             meshInstancesDataUpdated = false;
         }
 
+        // Also catches the mesh instances no longer flagged as static casters
+        if (staticCastersCount != staticShadowCastersCount) {
+            staticShadowCastersCount = staticCastersCount;
+            staticShadowCastersUpdated = true;
+        }
+        if (staticShadowCastersUpdated) {
+            for (const auto& renderer : std::views::values(shadowMapRenderers)) {
+                const auto& shadowMapRenderer = std::static_pointer_cast<ShadowMapPass>(renderer);
+                shadowMapRenderer->setStaticCastersEnabled(staticShadowCastersCount > 0);
+                shadowMapRenderer->invalidateStaticCache();
+            }
+            staticShadowCastersUpdated = false;
+        }
+
         // const auto start = std::chrono::high_resolution_clock::now();
         updatePipelinesData(commandList, opaquePipelinesData);
         updatePipelinesData(commandList, shaderMaterialPipelinesData);
@@ -379,79 +421,56 @@ namespace lysa {
         const std::map<pipeline_id, std::shared_ptr<vireo::Buffer>>& culledDrawCommandsBuffers,
         const std::map<pipeline_id, std::shared_ptr<vireo::Buffer>>& culledDrawCommandsCountBuffers,
         const std::map<pipeline_id, std::shared_ptr<FrustumCulling>>& frustumCullingPipelines) const {
-        for (const auto& [pipelineId, pipelineData] : opaquePipelinesData) {
-            if (pipelineData->drawCommandsCount == 0 ||
-                frustumCullingPipelines.at(pipelineId)->getDrawCommandsCount() == 0) { continue; }
-            commandList.bindDescriptor(pipelineData->descriptorSet, set);
-            // commandList.drawIndexedIndirect(
-                // pipelineData->drawCommandsBuffer,
-                // 0,
-                // pipelineData->drawCommandsCount,
-                // sizeof(DrawCommand),
-                // sizeof(uint32));
-            commandList.drawIndexedIndirectCount(
-                culledDrawCommandsBuffers.at(pipelineId),
-                0,
-                culledDrawCommandsCountBuffers.at(pipelineId),
-                0,
-                pipelineData->drawCommandsCount,
-                sizeof(DrawCommand),
-                sizeof(uint32));
-        }
-        for (const auto& [pipelineId, pipelineData] : shaderMaterialPipelinesData) {
-            if (pipelineData->drawCommandsCount == 0 ||
-                frustumCullingPipelines.at(pipelineId)->getDrawCommandsCount() == 0) { continue; }
-            commandList.bindDescriptor(pipelineData->descriptorSet, set);
-            commandList.drawIndexedIndirectCount(
-                culledDrawCommandsBuffers.at(pipelineId),
-                0,
-                culledDrawCommandsCountBuffers.at(pipelineId),
-                0,
-                pipelineData->drawCommandsCount,
-                sizeof(DrawCommand),
-                sizeof(uint32));
+        // The pipeline and the shared descriptor sets are bound once by the caller
+        for (const auto* pipelinesData : { &opaquePipelinesData, &shaderMaterialPipelinesData, &transparentPipelinesData }) {
+            for (const auto& [pipelineId, pipelineData] : *pipelinesData) {
+                if (pipelineData->drawCommandsCount == 0 ||
+                    frustumCullingPipelines.at(pipelineId)->getDrawCommandsCount() == 0) { continue; }
+                commandList.bindDescriptor(pipelineData->descriptorSet, set);
+                commandList.drawIndexedIndirectCount(
+                    culledDrawCommandsBuffers.at(pipelineId),
+                    0,
+                    culledDrawCommandsCountBuffers.at(pipelineId),
+                    0,
+                    pipelineData->drawCommandsCount,
+                    sizeof(DrawCommand),
+                    sizeof(uint32));
+            }
         }
-        for (const auto& [pipelineId, pipelineData] : transparentPipelinesData) {
+    }
+
+    void Scene::buildDrawList(
+        const std::unordered_map<uint32, std::unique_ptr<PipelineData>>& pipelinesData,
+        DrawList<PipelineData>& drawList) const {
+        drawList.clear();
+        for (const auto& pipelineData : std::views::values(pipelinesData)) {
             if (pipelineData->drawCommandsCount == 0 ||
-                frustumCullingPipelines.at(pipelineId)->getDrawCommandsCount() == 0) { continue; }
-            commandList.bindDescriptor(pipelineData->descriptorSet, set);
-            commandList.drawIndexedIndirectCount(
-                culledDrawCommandsBuffers.at(pipelineId),
-                0,
-                culledDrawCommandsCountBuffers.at(pipelineId),
-                0,
-                pipelineData->drawCommandsCount,
-                sizeof(DrawCommand),
-                sizeof(uint32));
+                pipelineData->frustumCullingPipeline.getDrawCommandsCount() == 0) { continue; }
+            drawList.add(*pipelineData);
         }
+        drawList.sort();
     }
 
     void Scene::drawModels(
         vireo::CommandList& commandList,
         const std::unordered_map<uint32, std::shared_ptr<vireo::GraphicPipeline>>& pipelines,
         const std::unordered_map<uint32, std::unique_ptr<PipelineData>>& pipelinesData) const {
-        for (const auto& [pipelineId, pipelineData] : pipelinesData) {
-            if (pipelineData->drawCommandsCount == 0 ||
-                pipelineData->frustumCullingPipeline.getDrawCommandsCount() == 0) { continue; }
-            const auto& pipeline = pipelines.at(pipelineId);
-            commandList.bindPipeline(pipeline);
+        auto drawList = DrawList<PipelineData>{};
+        buildDrawList(pipelinesData, drawList);
+        drawList.record(
+            commandList,
+            pipelines,
+            [&](const PipelineData& pipelineData) {
                 commandList.bindDescriptors({
                     Application::getResources().getDescriptorSet(),
                     Application::getResources().getSamplers().getDescriptorSet(),
                     descriptorSet,
-                    pipelineData->descriptorSet,
+                    pipelineData.descriptorSet,
                     descriptorSetOpt1,
                 });
-
-            commandList.drawIndexedIndirectCount(
-                pipelineData->culledDrawCommandsBuffer,
-                0,
-                pipelineData->culledDrawCommandsCountBuffer,
-                0,
-                pipelineData->drawCommandsCount,
-                sizeof(DrawCommand),
-                sizeof(uint32));
-        }
+            },
+            SET_PIPELINE,
+            sizeof(DrawCommand));
     }
 
     void Scene::activateCamera(const std::shared_ptr<Camera>& camera) {
@@ -468,6 +487,14 @@ namespace lysa {
         }
     }
 
+    void Scene::reloadShaders(const std::set<std::string>& shaderNames, std::set<std::string>& reloadedShaders) const {
+        for (const auto& renderer : std::views::values(shadowMapRenderers)) {
+            if (renderer->isUsingShaders(shaderNames, reloadedShaders)) {
+                std::static_pointer_cast<ShadowMapPass>(renderer)->reloadPipelines();
+            }
+        }
+    }
+
     Scene::PipelineData::PipelineData(
         const SceneConfiguration& config,
         const uint32 pipelineId,
@@ -609,18 +636,22 @@ namespace lysa {
                     light,
                     meshInstancesDataArray);
                 // INFO("enableLightShadowCasting for ", std::to_string(light->getName()));
+                const auto requestedSize = getRequestedShadowMapSize(light);
+                if (!allocateShadowMaps(light, shadowMapRenderer, requestedSize)) {
+                    WARNING("Shadow maps budget exhausted, no shadows for ", light->getName());
+                    shadowMapRefusedLights.push_back(light);
+                    return;
+                }
                 materialsUpdated = true; // force update pipelines
                 shadowMapRenderers[light] = shadowMapRenderer;
+                shadowMapRequestedSizes[light] = requestedSize;
                 shadowMapRenderer->setCurrentCamera(currentCamera);
+                shadowMapRenderer->setStaticCastersEnabled(staticShadowCastersCount > 0);
                 const auto& blankImage = Application::getResources().getBlankImage();
                 for (uint32 index = 0; index < shadowMaps.size(); index += 6) {
                     if (shadowMaps[index] == blankImage) {
                         shadowMapIndex[light] = index;
-                        for (int i = 0; i < shadowMapRenderer->getShadowMapCount(); i++) {
-                            shadowMaps[index + i] = shadowMapRenderer->getShadowMap(i)->getImage();
-                            shadowTransparencyColorMaps[index + i] = shadowMapRenderer->getTransparencyColorMap(i)->getImage();
-                        }
-                        shadowMapsUpdated = true;
+                        setShadowMapsImages(light, shadowMapRenderer);
                         return;
                     }
                 }
@@ -639,10 +670,160 @@ namespace lysa {
                 shadowMaps[index + i] = blankImage;
                 shadowTransparencyColorMaps[index + i] = blankImage;
             }
+            for (const auto& tile : shadowMapTiles[light]) {
+                shadowMapBudget.free(tile);
+            }
+            shadowMapTilesReleased |= !shadowMapTiles[light].empty();
+            shadowMapTiles.erase(light);
+            shadowMapRequestedSizes.erase(light);
             shadowMapsUpdated = true;
             shadowMapIndex.erase(light);
             shadowMapRenderers.erase(light);
         }
     }
 
+    uint32 Scene::getRequestedShadowMapSize(const std::shared_ptr<Light>& light) const {
+        const auto maxSize = ShadowMapBudget::roundUpPowerOfTwo(light->getShadowMapSize());
+        const auto& omniLight = std::dynamic_pointer_cast<OmniLight>(light);
+        if (omniLight == nullptr || currentCamera == nullptr) {
+            return maxSize;
+        }
+        const auto range = omniLight->getRange();
+        const float distance = length(currentCamera->getPositionGlobal() - light->getPositionGlobal());
+        if (distance <= range) {
+            return maxSize;
+        }
+        // Ratio between the projected radius of the light bounding sphere and the half height of the screen
+        const auto coverage = range / (distance * std::tan(radians(currentCamera->getFov()) * 0.5f));
+        const auto size = static_cast<uint32>(static_cast<float>(maxSize) * std::min(coverage, 1.0f));
+        return std::clamp(ShadowMapBudget::roundUpPowerOfTwo(size), std::min(config.shadowMapMinSize, maxSize), maxSize);
+    }
+
+    void Scene::updateShadowMapsSizes() {
+        // Lights removed after the loop, disableLightShadowCasting() erases from shadowMapRenderers
+        auto exhaustedLights = std::vector<std::shared_ptr<Light>>{};
+        for (const auto& [light, renderer] : shadowMapRenderers) {
+            if (!light->isVisible() || !light->getCastShadows()) { continue; }
+            const auto& shadowMapRenderer = std::static_pointer_cast<ShadowMapPass>(renderer);
+            const auto currentSize = shadowMapRenderer->getShadowMapSize();
+            const auto requestedSize = getRequestedShadowMapSize(light);
+            auto& lastRequestedSize = shadowMapRequestedSizes[light];
+            // Grow immediately but only shrink when the light covers less than a quarter
+            // of its resolution to avoid re-allocations on small camera moves.
+            // A light granted less than its request is only grown again when its request
+            // grows or when budget tiles are released, not every frame.
+            const auto grow = requestedSize > currentSize && requestedSize > lastRequestedSize;
+            lastRequestedSize = requestedSize;
+            if (grow || requestedSize * 4 <= currentSize) {
+                if (!allocateShadowMaps(light, renderer, requestedSize)) {
+                    exhaustedLights.push_back(light);
+                } else if (shadowMapRenderer->getShadowMapSize() != currentSize) {
+                    setShadowMapsImages(light, renderer);
+                }
+            }
+        }
+        const auto tilesReleased = shadowMapTilesReleased;
+        shadowMapTilesReleased = false;
+        if (tilesReleased) {
+            // Degraded lights first since they already cast shadows
+            for (const auto& [light, renderer] : shadowMapRenderers) {
+                const auto& shadowMapRenderer = std::static_pointer_cast<ShadowMapPass>(renderer);
+                const auto currentSize = shadowMapRenderer->getShadowMapSize();
+                const auto requestedSize = shadowMapRequestedSizes.at(light);
+                // Skips the lights exhausted above, their tiles are already released
+                if (currentSize < requestedSize && shadowMapTiles.contains(light)) {
+                    if (!allocateShadowMaps(light, renderer, requestedSize)) {
+                        exhaustedLights.push_back(light);
+                    } else if (shadowMapRenderer->getShadowMapSize() != currentSize) {
+                        setShadowMapsImages(light, renderer);
+                    }
+                }
+            }
+        }
+        for (const auto& light : exhaustedLights) {
+            WARNING("Shadow maps budget exhausted, no shadows for ", light->getName());
+            disableLightShadowCasting(light);
+            shadowMapRefusedLights.push_back(light);
+        }
+        if (tilesReleased) {
+            // Refused again by enableLightShadowCasting() if the budget is still full
+            auto refusedLights = std::move(shadowMapRefusedLights);
+            shadowMapRefusedLights.clear();
+            for (const auto& light : refusedLights) {
+                enableLightShadowCasting(light);
+            }
+        }
+    }
+
+    void Scene::requestTexturesMips() const {
+        auto& textureStreamer = Application::getResources().getTextureStreamer();
+        const auto cameraPosition = currentCamera->getPositionGlobal();
+        const auto tanHalfFov = std::tan(radians(currentCamera->getFov()) * 0.5f);
+        for (const auto& meshInstance : std::views::keys(meshInstancesDataMemoryBlocks)) {
+            if (!meshInstance->isVisible()) { continue; }
+            const auto& aabb = meshInstance->getAABB();
+            const auto radius = length(aabb.max - aabb.min) * 0.5f;
+            const auto distance = std::max(length((aabb.min + aabb.max) * 0.5f - cameraPosition), radius);
+            // Projected diameter of the bounding sphere, in pixels
+            const auto screenSize = viewport.height * radius / (distance * tanHalfFov);
+            for (const auto& material : meshInstance->getMesh()->getMaterials()) {
+                if (material->getType() != Material::STANDARD) { continue; }
+                const auto& standardMaterial = std::static_pointer_cast<StandardMaterial>(material);
+                for (const auto* textureInfo : {
+                    &standardMaterial->getDiffuseTexture(),
+                    &standardMaterial->getNormalTexture(),
+                    &standardMaterial->getMetallicTexture(),
+                    &standardMaterial->getRoughnessTexture(),
+                    &standardMaterial->getEmissiveTexture()}) {
+                    if (textureInfo->texture) {
+                        textureStreamer.request(*textureInfo->texture->getImage(), screenSize);
+                    }
+                }
+            }
+        }
+    }
+
+    bool Scene::allocateShadowMaps(
+        const std::shared_ptr<Light>& light,
+        const std::shared_ptr<Renderpass>& renderer,
+        const uint32 size) {
+        const auto& shadowMapRenderer = std::static_pointer_cast<ShadowMapPass>(renderer);
+        auto& tiles = shadowMapTiles[light];
+        const auto usedTexels = shadowMapBudget.getUsedTexels();
+        for (const auto& tile : tiles) {
+            shadowMapBudget.free(tile);
+        }
+        tiles.clear();
+        const auto minSize = std::min(config.shadowMapMinSize, size);
+        for (auto currentSize = size; currentSize >= minSize && currentSize > 0; currentSize /= 2) {
+            for (int i = 0; i < shadowMapRenderer->getShadowMapCount(); i++) {
+                const auto tile = shadowMapBudget.allocate(shadowMapRenderer->getSubpassShadowMapSize(currentSize, i));
+                if (!tile.isValid()) { break; }
+                tiles.push_back(tile);
+            }
+            if (tiles.size() == shadowMapRenderer->getShadowMapCount()) {
+                shadowMapRenderer->setShadowMapSize(currentSize);
+                shadowMapTilesReleased |= shadowMapBudget.getUsedTexels() < usedTexels;
+                return true;
+            }
+            for (const auto& tile : tiles) {
+                shadowMapBudget.free(tile);
+            }
+            tiles.clear();
+        }
+        shadowMapTiles.erase(light);
+        shadowMapTilesReleased |= shadowMapBudget.getUsedTexels() < usedTexels;
+        return false;
+    }
+
+    void Scene::setShadowMapsImages(const std::shared_ptr<Light>& light, const std::shared_ptr<Renderpass>& renderer) {
+        const auto& shadowMapRenderer = std::static_pointer_cast<ShadowMapPass>(renderer);
+        const auto index = shadowMapIndex.at(light);
+        for (int i = 0; i < shadowMapRenderer->getShadowMapCount(); i++) {
+            shadowMaps[index + i] = shadowMapRenderer->getShadowMap(i)->getImage();
+            shadowTransparencyColorMaps[index + i] = shadowMapRenderer->getTransparencyColorMap(i)->getImage();
+        }
+        shadowMapsUpdated = true;
+    }
+
 }
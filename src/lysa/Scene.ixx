@@ -17,7 +17,9 @@ import lysa.nodes.light;
 import lysa.nodes.mesh_instance;
 import lysa.nodes.node;
 import lysa.pipelines.frustum_culling;
+import lysa.renderers.draw_list;
 import lysa.renderers.renderpass;
+import lysa.renderers.shadow_map_budget;
 import lysa.resources.material;
 import lysa.resources.mesh;
 
@@ -83,6 +85,9 @@ export namespace lysa {
      *  - Build and maintain per-pipeline instance data and indirect draw commands.
      *  - Perform frustum culling via compute pipelines and submit culled draws.
      *  - Manage shadow-map renderers and their images.
+     *  - Share the shadow maps texels budget between the lights with a quad-tree allocator,
+     *    the resolution of each light depending on its screen coverage. Lights that do not
+     *    fit in the budget do not cast shadows.
      *
      * Thread-safety: unless stated otherwise, methods are intended to be called
      * only from the render thread.
@@ -92,6 +97,9 @@ export namespace lysa {
         /** Maximum number of shadow maps supported by the scene. */
         static constexpr uint32 MAX_SHADOW_MAPS{20};
 
+        /** Descriptor set index of the pipeline-local set in the scene pipelines. */
+        static constexpr uint32 SET_PIPELINE{3};
+
         /** Descriptor binding for SceneData uniform buffer. */
         static constexpr vireo::DescriptorIndex BINDING_SCENE{0};
         /** Descriptor binding for per-model/instance data buffer. */
@@ -205,6 +213,12 @@ export namespace lysa {
            const std::map<pipeline_id, std::shared_ptr<vireo::Buffer>>& culledDrawCommandsCountBuffers,
            const std::map<pipeline_id, std::shared_ptr<FrustumCulling>>& frustumCullingPipelines) const;
 
+        /**
+         * Returns the camera culling statistics of the last completed frame using this scene,
+         * summed over all the pipelines. They lag behind the recorded frame by the number of frames in flight.
+         */
+        CullingStatistics getCullingStatistics() const;
+
         /** Returns the mapping of pipeline identifiers to their materials. */
         const auto& getPipelineIds() const { return pipelineIds; }
 
@@ -223,6 +237,12 @@ export namespace lysa {
         /** Returns a view over the shadow map renderers values. */
         auto getShadowMapRenderers() const { return std::views::values(shadowMapRenderers); }
 
+        /**
+         * Recreates the pipelines of the shadow map renderers using one of the modified shaders,
+         * see Renderer::reloadShaders().
+         */
+        void reloadShaders(const std::set<std::string>& shaderNames, std::set<std::string>& reloadedShaders) const;
+
         virtual ~Scene() = default;
         Scene(Scene&) = delete;
         Scene& operator=(Scene&) = delete;
@@ -329,6 +349,20 @@ export namespace lysa {
         std::vector<std::shared_ptr<vireo::Image>> shadowTransparencyColorMaps;
         /** Associates each light with a shadow map index. */
         std::map<std::shared_ptr<Light>, uint32> shadowMapIndex;
+        /** Shadow maps texels budget shared by all the lights. */
+        ShadowMapBudget shadowMapBudget;
+        /** Budget tiles allocated for the shadow maps of each light. */
+        std::map<std::shared_ptr<Light>, std::vector<ShadowMapBudget::Tile>> shadowMapTiles;
+        /** Shadow map size requested by each light, the granted size is lower when the budget is short. */
+        std::map<std::shared_ptr<Light>, uint32> shadowMapRequestedSizes;
+        /** Lights refused because the budget was full, retried when tiles are released. */
+        std::list<std::shared_ptr<Light>> shadowMapRefusedLights;
+        /** True if budget tiles were released since the last retry of the degraded and refused lights. */
+        bool shadowMapTilesReleased{false};
+        /** True if a static shadow caster changed and the shadow maps cached layers must be redrawn. */
+        bool staticShadowCastersUpdated{false};
+        /** Number of static shadow casters, the shadow maps cached layers are only used when not zero. */
+        uint32 staticShadowCastersCount{0};
         /** Lights scheduled for removal (deferred to safe points). */
         std::list<std::shared_ptr<Light>> removedLights;
         /** True if the set of shadow maps has changed and descriptors must be updated. */
@@ -375,6 +409,14 @@ export namespace lysa {
             const std::shared_ptr<MeshInstance>& meshInstance,
             std::unordered_map<uint32, std::unique_ptr<PipelineData>>& pipelinesData);
 
+        /**
+         * Collects the pipelines with visible draw commands, sorted by pipeline id
+         * so the draws are recorded in the same order every frame.
+         */
+        void buildDrawList(
+            const std::unordered_map<uint32, std::unique_ptr<PipelineData>>& pipelinesData,
+            DrawList<PipelineData>& drawList) const;
+
         void drawModels(
             vireo::CommandList& commandList,
             const std::unordered_map<uint32, std::shared_ptr<vireo::GraphicPipeline>>& pipelines,
@@ -384,6 +426,28 @@ export namespace lysa {
 
         void disableLightShadowCasting(const std::shared_ptr<Light>&light);
 
+        /** Returns the shadow map resolution of a light depending on its screen coverage. */
+        uint32 getRequestedShadowMapSize(const std::shared_ptr<Light>& light) const;
+
+        /**
+         * Re-allocates the shadow maps of the lights when their screen coverage changes and
+         * retries the degraded and refused lights when budget tiles were released.
+         */
+        void updateShadowMapsSizes();
+
+        /**
+         * Allocates the budget tiles of a light, halving the resolution until they fit.
+         * Returns false if the budget is exhausted even at the smallest resolution.
+         * Sets shadowMapTilesReleased if the light uses fewer texels than before.
+         */
+        bool allocateShadowMaps(const std::shared_ptr<Light>& light, const std::shared_ptr<Renderpass>& renderer, uint32 size);
+
+        /** Binds the shadow maps images of a light to its slots in the descriptor arrays. */
+        void setShadowMapsImages(const std::shared_ptr<Light>& light, const std::shared_ptr<Renderpass>& renderer);
+
+        /** Requests the textures mip levels needed by the visible models from their screen size. */
+        void requestTexturesMips() const;
+
     };
 
 }
@@ -0,0 +1,141 @@
+/*
+* Copyright (c) 2025-present Henri Michelon
+*
+* This software is released under the MIT License.
+* https://opensource.org/licenses/MIT
+*/
+export module lysa.shader_module_cache;
+
+import std;
+import lysa.log;
+
+export namespace lysa {
+
+    /**
+     * Cache of the shader modules, keyed by shader name, and watcher of their compiled files.
+     *  - A cached module is reloaded when its file has been modified since it was loaded.
+     *  - getModifiedShaders() polls the files of the cached modules for the shaders hot-reload.
+     *
+     * The files and the device are only accessed through the functions given to the constructor,
+     * ShaderModules uses the virtual file system and the Vireo device. `Module` is the shader module type.
+     *
+     * Thread-safety: all methods can be called from any thread.
+     */
+    template<typename Module>
+    class ShaderModuleCache {
+    public:
+        using WriteTime = std::filesystem::file_time_type;
+        //! Returns the last write time of the compiled file of a shader, or nothing if the file can't be checked
+        using GetWriteTime = std::function<std::optional<WriteTime>(const std::string&)>;
+        //! Creates the shader module from the compiled file of a shader, throws on failure
+        using Load = std::function<std::shared_ptr<Module>(const std::string&)>;
+
+        ShaderModuleCache(GetWriteTime getWriteTime, Load load) :
+            getWriteTime{std::move(getWriteTime)},
+            load{std::move(load)} {}
+
+        /**
+         * Returns the shader module of a shader, loading it if it is not in the cache or if the file changed.
+         * A cached module is returned as is while its file can't be checked.
+         */
+        std::shared_ptr<Module> get(const std::string& shaderName) {
+            const auto writeTime = getWriteTime(shaderName);
+            auto lock = std::lock_guard{mutex};
+            if (const auto it = shaderModules.find(shaderName);
+                it != shaderModules.end() && (!writeTime || it->second.lastWriteTime == *writeTime)) {
+                return it->second.shaderModule;
+            }
+            const auto shaderModule = load(shaderName);
+            const auto lastWriteTime = writeTime.value_or(WriteTime{});
+            shaderModules[shaderName] = { shaderModule, lastWriteTime, lastWriteTime };
+            return shaderModule;
+        }
+
+        /**
+         * Checks the files of the cached shader modules and returns the names of the shaders
+         * modified since the last check. Each modification is reported only once, even if
+         * the modified shader fails to load.
+         */
+        std::set<std::string> getModifiedShaders() {
+            auto modifiedShaders = std::set<std::string>{};
+            auto lock = std::lock_guard{mutex};
+            for (auto& [shaderName, entry] : shaderModules) {
+                const auto writeTime = getWriteTime(shaderName);
+                if (writeTime && *writeTime != entry.checkedWriteTime) {
+                    entry.checkedWriteTime = *writeTime;
+                    modifiedShaders.insert(shaderName);
+                }
+            }
+            return modifiedShaders;
+        }
+
+        /**
+         * Clears the cache. The modules used by existing pipelines stay alive with them.
+         */
+        void clear() {
+            auto lock = std::lock_guard{mutex};
+            shaderModules.clear();
+        }
+
+    private:
+        struct Entry {
+            std::shared_ptr<Module> shaderModule;
+            //! Write time of the file when the module was loaded
+            WriteTime               lastWriteTime;
+            //! Write time of the file at the last getModifiedShaders()
+            WriteTime               checkedWriteTime;
+        };
+
+        const GetWriteTime getWriteTime;
+        const Load load;
+        std::unordered_map<std::string, Entry> shaderModules;
+        std::mutex mutex;
+    };
+
+    /**
+     * Names of the shaders loaded by a pipelines owner, used by the shaders hot-reload
+     * to select the pipelines to recreate.
+     */
+    class ShaderDependencies {
+    public:
+        /** Records a shader loaded by the owner */
+        void add(const std::string& shaderName) { shaderNames.insert(shaderName); }
+
+        /**
+         * Returns true if the owner loaded one of the modified shaders,
+         * and adds the modified shaders it loaded to `usedShaders`.
+         */
+        bool isUsing(const std::set<std::string>& modifiedShaders, std::set<std::string>& usedShaders) const {
+            auto used = false;
+            for (const auto& shaderName : modifiedShaders) {
+                if (shaderNames.contains(shaderName)) {
+                    usedShaders.insert(shaderName);
+                    used = true;
+                }
+            }
+            return used;
+        }
+
+    private:
+        std::set<std::string> shaderNames;
+    };
+
+    /**
+     * Recreates the pipelines stored in `pipelines` by calling `create`.
+     * If the creation fails (e.g. a shader being edited), logs the error, restores the previous
+     * pipelines and returns false.
+     */
+    template<typename T>
+    bool reloadOrKeep(const std::string& owner, T& pipelines, const std::function<void()>& create) {
+        auto previous = pipelines;
+        try {
+            create();
+            return true;
+        } catch (const std::exception& e) {
+            ERROR(owner, " : shaders reload failed, keeping the previous pipelines : ", e.what());
+            pipelines = std::move(previous);
+            return false;
+        }
+    }
+
+}
@@ -0,0 +1,45 @@
+/*
+* Copyright (c) 2025-present Henri Michelon
+*
+* This software is released under the MIT License.
+* https://opensource.org/licenses/MIT
+*/
+module lysa.shader_modules;
+
+import lysa.application;
+import lysa.virtual_fs;
+
+namespace lysa {
+
+    ShaderModuleCache<vireo::ShaderModule> ShaderModules::cache{
+        [](const std::string& shaderName) -> std::optional<std::filesystem::file_time_type> {
+            auto error = std::error_code{};
+            const auto lastWriteTime = std::filesystem::last_write_time(VirtualFS::getPath(getFilepath(shaderName)), error);
+            if (error) { return std::nullopt; }
+            return lastWriteTime;
+        },
+        [](const std::string& shaderName) {
+            auto tempBuffer = std::vector<char>{};
+            VirtualFS::loadBinaryData(getFilepath(shaderName), tempBuffer);
+            return Application::getVireo().createShaderModule(tempBuffer);
+        }
+    };
+
+    std::shared_ptr<vireo::ShaderModule> ShaderModules::get(const std::string& shaderName) {
+        return cache.get(shaderName);
+    }
+
+    std::set<std::string> ShaderModules::getModifiedShaders() {
+        return cache.getModifiedShaders();
+    }
+
+    std::string ShaderModules::getFilepath(const std::string& shaderName) {
+        return "app://" + Application::getConfiguration().shaderDir + "/" +
+            shaderName + Application::getVireo().getShaderFileExtension();
+    }
+
+    void ShaderModules::clearCache() {
+        cache.clear();
+    }
+
+}
@@ -0,0 +1,56 @@
+/*
+* Copyright (c) 2025-present Henri Michelon
+*
+* This software is released under the MIT License.
+* https://opensource.org/licenses/MIT
+*/
+export module lysa.shader_modules;
+
+import std;
+import vireo;
+import lysa.shader_module_cache;
+
+export namespace lysa {
+
+    /**
+     * Global cache of the shader modules, keyed by shader name.
+     *  - Shader modules are loaded from the compiled shaders directory of the application
+     *    (ApplicationConfiguration::shaderDir) with the backend specific file extension.
+     *  - A cached module is reloaded when its file has been modified since it was loaded.
+     *  - getModifiedShaders() polls the files of the cached modules for the shaders hot-reload
+     *    (see ApplicationConfiguration::shaderHotReload).
+     *
+     * Notes:
+     *  - All entry points are static; the class is used as a singleton-like
+     *    utility (no instance needed).
+     *  - Access is thread-safe via the mutex of the cache, see ShaderModuleCache.
+     */
+    class ShaderModules {
+    public:
+        /**
+         * Returns the shader module for a shader name (file name without the extension),
+         * loading it if it is not in the cache or if the file changed.
+         */
+        static std::shared_ptr<vireo::ShaderModule> get(const std::string& shaderName);
+
+        /**
+         * Checks the files of the cached shader modules and returns the names of the shaders
+         * modified since the last check. Each modification is reported only once, even if
+         * the modified shader fails to load.
+         */
+        static std::set<std::string> getModifiedShaders();
+
+        /**
+         * Clears the cache. The modules used by existing pipelines stay alive with them.
+         */
+        static void clearCache();
+
+    private:
+        /** Loaded shader modules by shader name, with the write times of their files. */
+        static ShaderModuleCache<vireo::ShaderModule> cache;
+
+        /** Returns the app:// path of the compiled shader file */
+        static std::string getFilepath(const std::string& shaderName);
+    };
+
+}
@@ -0,0 +1,155 @@
+/*
+* Copyright (c) 2025-present Henri Michelon
+*
+* This software is released under the MIT License.
+* https://opensource.org/licenses/MIT
+*/
+export module lysa.texture_slots;
+
+import std;
+import lysa.exception;
+import lysa.types;
+
+export namespace lysa {
+
+    /**
+     * Slots of the textures array exposed to the shaders, and the ring of copies of the array
+     * written in the descriptor sets.
+     *  - The slots are allocated from a free list : add() and remove() are O(1).
+     *  - update() patches the next copy of the ring with the slots changed since that copy was
+     *    last written, instead of copying the whole array.
+     *  - The copy written by update() was last used ringSize - 1 updates ago : with a ring of the
+     *    frames in flight plus two copies, the GPU no longer reads it and nothing waits for the GPU.
+     *
+     * `T` is the texture handle, a shared pointer to a device image for Resources.
+     */
+    template<typename T>
+    class TextureSlots {
+    public:
+        /**
+         * @param ringSize Number of copies of the array, one per descriptor set of the ring
+         */
+        explicit TextureSlots(const uint32 ringSize) : ring(ringSize) {}
+
+        /** Frees all the slots and binds them to `blank`, in the slots and all the copies */
+        void reset(const uint32 count, const T& blank) {
+            this->blank = blank;
+            slots.assign(count, blank);
+            freeIndices.clear();
+            freeIndices.reserve(count);
+            for (auto i = 0u; i < count; i++) {
+                // Lowest indices first
+                freeIndices.push_back(count - 1 - i);
+            }
+            changes.clear();
+            changesStart = 0;
+            for (auto& copy : ring) {
+                copy.textures = slots;
+                copy.version = 0;
+            }
+            current = 0;
+        }
+
+        /** Releases all the slots and copies */
+        void clear() {
+            blank = {};
+            slots.clear();
+            freeIndices.clear();
+            changes.clear();
+            for (auto& copy : ring) {
+                copy.textures.clear();
+            }
+        }
+
+        /**
+         * Binds a texture to a free slot and returns its index.<br>
+         * Throws an Exception if all the slots are used.
+         */
+        uint32 add(const T& texture) {
+            if (freeIndices.empty()) {
+                throw Exception("Out of memory for textures");
+            }
+            const auto index = freeIndices.back();
+            freeIndices.pop_back();
+            set(index, texture);
+            return index;
+        }
+
+        /** Binds a slot to the blank texture and frees it */
+        void remove(const uint32 index) {
+            assert([&]{ return slots[index] != blank; }, "Texture slot already free");
+            set(index, blank);
+            freeIndices.push_back(index);
+        }
+
+        /** Replaces the texture of a used slot */
+        void set(const uint32 index, const T& texture) {
+            slots[index] = texture;
+            changes.push_back(index);
+        }
+
+        const T& get(const uint32 index) const { return slots[index]; }
+
+        /** Returns the number of slots, used or free */
+        auto getCount() const { return static_cast<uint32>(slots.size()); }
+
+        /** Returns the number of free slots */
+        auto getFreeCount() const { return static_cast<uint32>(freeIndices.size()); }
+
+        /** Returns the index in the ring of the copy used by the frames being recorded */
+        auto getCurrent() const { return current; }
+
+        /** Returns the number of slots copied by the last update() */
+        auto getLastCopiedCount() const { return lastCopiedCount; }
+
+        /**
+         * When slots changed, patches the next copy of the ring and makes it the current one.<br>
+         * Returns the copy to write in the descriptor set of the current index, or nullptr
+         * if nothing changed since the last update.
+         */
+        const std::vector<T>* update() {
+            const auto end = changesStart + changes.size();
+            if (ring[current].version == end) {
+                return nullptr;
+            }
+            current = (current + 1) % ring.size();
+            auto& copy = ring[current];
+            if (end - copy.version >= slots.size()) {
+                // Same slot changed many times since this copy was written
+                copy.textures = slots;
+                lastCopiedCount = getCount();
+            } else {
+                for (auto change = copy.version; change < end; change++) {
+                    const auto index = changes[change - changesStart];
+                    copy.textures[index] = slots[index];
+                }
+                lastCopiedCount = static_cast<uint32>(end - copy.version);
+            }
+            copy.version = end;
+            // Forgets the changes written in all the copies
+            const auto oldest = std::ranges::min(ring, {}, &Copy::version).version;
+            changes.erase(changes.begin(), changes.begin() + static_cast<std::ptrdiff_t>(oldest - changesStart));
+            changesStart = oldest;
+            return &copy.textures;
+        }
+
+    private:
+        struct Copy {
+            std::vector<T> textures;
+            // Number of changes written in the copy
+            uint64 version{0};
+        };
+
+        T blank{};
+        std::vector<T> slots;
+        // Stack of the free slots
+        std::vector<uint32> freeIndices;
+        // Indices of the changed slots, changes[i] is the change number changesStart + i
+        std::deque<uint32> changes;
+        uint64 changesStart{0};
+        std::vector<Copy> ring;
+        uint32 current{0};
+        uint32 lastCopiedCount{0};
+    };
+
+}
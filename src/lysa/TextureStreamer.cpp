@@ -0,0 +1,380 @@
+/*
+* Copyright (c) 2025-present Henri Michelon
+*
+* This software is released under the MIT License.
+* https://opensource.org/licenses/MIT
+*/
+module lysa.texture_streamer;
+
+import lysa.application;
+import lysa.exception;
+import lysa.log;
+import lysa.virtual_fs;
+
+namespace lysa {
+
+    TextureResidency::TextureResidency(const uint64 budget, const uint32 unusedFramesDelay):
+        budget{budget},
+        unusedFramesDelay{unusedFramesDelay} {
+    }
+
+    TextureResidency::Handle TextureResidency::add(const std::vector<uint64>& mipSizes, const uint32 initialMip) {
+        assert([&]{ return !mipSizes.empty(); }, "Streamed texture without mip levels");
+        Handle handle;
+        if (freeHandles.empty()) {
+            handle = static_cast<Handle>(entries.size());
+            entries.emplace_back();
+        } else {
+            handle = freeHandles.back();
+            freeHandles.pop_back();
+        }
+        const auto mip = std::min(initialMip, static_cast<uint32>(mipSizes.size()) - 1);
+        entries[handle] = Entry{
+            .valid = true,
+            .mipSizes = mipSizes,
+            .initialMip = mip,
+            .residentMip = mip,
+            .requestedMip = mip,
+        };
+        usedSize += getSize(entries[handle], mip);
+        return handle;
+    }
+
+    void TextureResidency::remove(const Handle handle) {
+        auto& entry = entries[handle];
+        if (!entry.valid) { return; }
+        usedSize -= getSize(entry, entry.residentMip);
+        entry = Entry{};
+        freeHandles.push_back(handle);
+    }
+
+    void TextureResidency::request(const Handle handle, const uint32 mip, const uint64 frame) {
+        auto& entry = entries[handle];
+        if (entry.lastUsedFrame != frame) {
+            entry.requestedMip = mip;
+            entry.lastUsedFrame = frame;
+        } else {
+            entry.requestedMip = std::min(entry.requestedMip, mip);
+        }
+    }
+
+    void TextureResidency::complete(const Handle handle) {
+        entries[handle].pending = false;
+    }
+
+    void TextureResidency::cancel(const Handle handle, const uint32 residentMip) {
+        auto& entry = entries[handle];
+        usedSize -= getSize(entry, entry.residentMip);
+        entry.residentMip = residentMip;
+        usedSize += getSize(entry, entry.residentMip);
+        entry.pending = false;
+    }
+
+    void TextureResidency::update(
+        const uint64 frame,
+        const uint32 maxPending,
+        std::vector<Decision>& loads,
+        std::vector<Decision>& evictions) {
+        loads.clear();
+        evictions.clear();
+        auto pendingCount = static_cast<uint32>(std::ranges::count_if(entries, [](const Entry& entry) {
+            return entry.valid && entry.pending;
+        }));
+
+        // The budget may have been reduced
+        if (usedSize > budget) {
+            makeRoom(0, std::numeric_limits<Handle>::max(), frame, pendingCount, evictions);
+        }
+
+        // Textures needing finer mip levels, the most recently used and the most degraded first
+        auto candidates = std::vector<Handle>{};
+        for (auto handle = Handle{0}; handle < entries.size(); handle++) {
+            const auto& entry = entries[handle];
+            if (entry.valid && !entry.pending && getWantedMip(entry, frame) < entry.residentMip) {
+                candidates.push_back(handle);
+            }
+        }
+        std::ranges::sort(candidates, [&](const Handle a, const Handle b) {
+            const auto& entryA = entries[a];
+            const auto& entryB = entries[b];
+            if (entryA.lastUsedFrame != entryB.lastUsedFrame) {
+                return entryA.lastUsedFrame > entryB.lastUsedFrame;
+            }
+            return (entryA.residentMip - getWantedMip(entryA, frame)) > (entryB.residentMip - getWantedMip(entryB, frame));
+        });
+
+        for (const auto handle : candidates) {
+            if (pendingCount >= maxPending) { break; }
+            auto& entry = entries[handle];
+            // Fall back to coarser levels when the finest one does not fit in the budget
+            auto mip = getWantedMip(entry, frame);
+            for (; mip < entry.residentMip; mip++) {
+                const auto extraSize = getSize(entry, mip) - getSize(entry, entry.residentMip);
+                if (makeRoom(extraSize, handle, frame, pendingCount, evictions)) { break; }
+            }
+            if (mip == entry.residentMip) { continue; }
+            usedSize += getSize(entry, mip) - getSize(entry, entry.residentMip);
+            entry.residentMip = mip;
+            entry.pending = true;
+            pendingCount += 1;
+            loads.push_back({ handle, mip });
+        }
+    }
+
+    bool TextureResidency::makeRoom(
+        const uint64 size,
+        const Handle exclude,
+        const uint64 frame,
+        uint32& pendingCount,
+        std::vector<Decision>& evictions) {
+        if (usedSize + size <= budget) { return true; }
+
+        // Textures with more levels than wanted, and the size that can be reclaimed
+        auto evictable = std::vector<Handle>{};
+        auto reclaimableSize = uint64{0};
+        for (auto handle = Handle{0}; handle < entries.size(); handle++) {
+            const auto& entry = entries[handle];
+            if (!entry.valid || entry.pending || handle == exclude) { continue; }
+            const auto wantedMip = getWantedMip(entry, frame);
+            if (wantedMip > entry.residentMip) {
+                evictable.push_back(handle);
+                reclaimableSize += getSize(entry, entry.residentMip) - getSize(entry, wantedMip);
+            }
+        }
+        if (usedSize + size > budget + reclaimableSize) { return false; }
+
+        // Least recently used first
+        std::ranges::sort(evictable, [&](const Handle a, const Handle b) {
+            return entries[a].lastUsedFrame < entries[b].lastUsedFrame;
+        });
+        for (const auto handle : evictable) {
+            if (usedSize + size <= budget) { break; }
+            auto& entry = entries[handle];
+            const auto wantedMip = getWantedMip(entry, frame);
+            usedSize -= getSize(entry, entry.residentMip) - getSize(entry, wantedMip);
+            entry.residentMip = wantedMip;
+            entry.pending = true;
+            pendingCount += 1;
+            evictions.push_back({ handle, wantedMip });
+        }
+        return true;
+    }
+
+    uint64 TextureResidency::getSize(const Entry& entry, const uint32 mip) {
+        auto size = uint64{0};
+        for (auto level = mip; level < entry.mipSizes.size(); level++) {
+            size += entry.mipSizes[level];
+        }
+        return size;
+    }
+
+    uint32 TextureResidency::getWantedMip(const Entry& entry, const uint64 frame) const {
+        if (frame - entry.lastUsedFrame > unusedFramesDelay) {
+            return entry.initialMip;
+        }
+        return std::min(entry.requestedMip, entry.initialMip);
+    }
+
+    TextureStreamer::TextureStreamer(const ResourcesConfiguration& config):
+        config{config},
+        residency{config.textureStreamingBudget} {
+    }
+
+    uint32 TextureStreamer::getInitialMip(const uint32 width, const uint32 height, const uint32 mipLevels) const {
+        auto mip = 0u;
+        while ((mip + 1) < mipLevels && std::max(width >> mip, height >> mip) > config.textureStreamingInitialSize) {
+            mip += 1;
+        }
+        return mip;
+    }
+
+    void TextureStreamer::add(const std::shared_ptr<Image>& image, const Source& source, const uint32 initialMip) {
+        auto lock = std::lock_guard{mutex};
+        auto mipSizes = std::vector<uint64>(source.mipLevels.size());
+        for (auto level = 0; level < source.mipLevels.size(); level++) {
+            mipSizes[level] = source.mipLevels[level].size;
+        }
+        const auto handle = residency.add(mipSizes, initialMip);
+        images[image->getId()] = {
+            .image = image,
+            .source = source,
+            .handle = handle,
+            .residentMip = residency.getResidentMip(handle),
+        };
+        imagesByHandle[handle] = image->getId();
+    }
+
+    void TextureStreamer::request(const Image& image, const float screenSize) {
+        auto lock = std::lock_guard{mutex};
+        const auto it = images.find(image.getId());
+        if (it == images.end()) { return; }
+        const auto& source = it->second.source;
+        // One texel per pixel : each mip level halves the size
+        const auto size = static_cast<float>(std::max(source.width, source.height));
+        const auto mip = screenSize >= size ?
+            0u :
+            static_cast<uint32>(std::floor(std::log2(size / std::max(screenSize, 1.0f))));
+        residency.request(
+            it->second.handle,
+            std::min(mip, static_cast<uint32>(source.mipLevels.size()) - 1),
+            frame);
+    }
+
+    bool TextureStreamer::update(
+        TextureSlots<std::shared_ptr<vireo::Image>>& textures,
+        std::vector<std::shared_ptr<Image>>& updatedImages) {
+        auto lock = std::lock_guard{mutex};
+        auto updated = false;
+        frame += 1;
+
+        // Replace the images with the loaded mip levels
+        for (auto it = loads.begin(); it != loads.end();) {
+            if (!it->job->isFinished()) {
+                ++it;
+                continue;
+            }
+            auto image = it->image.lock();
+            if (image && images.contains(image->getId())) {
+                auto& streamedImage = images.at(image->getId());
+                try {
+                    if (it->result->error) {
+                        std::rethrow_exception(it->result->error);
+                    }
+                    const auto newImage = upload(streamedImage.source, it->mip, it->result->data, image->getName());
+                    image->setImage(newImage);
+                    textures.set(image->getIndex(), newImage);
+                    streamedImage.residentMip = it->mip;
+                    residency.complete(streamedImage.handle);
+                    updated = true;
+                } catch (const Exception& e) {
+                    ERROR("Texture streaming failed for ", image->getName(), " : ", e.what());
+                    residency.cancel(streamedImage.handle, streamedImage.residentMip);
+                }
+            }
+            if (image) {
+                // The last reference may be this one
+                updatedImages.push_back(std::move(image));
+            }
+            it = loads.erase(it);
+        }
+
+        // Release the budget of the destroyed images
+        for (auto it = images.begin(); it != images.end();) {
+            if (it->second.image.expired()) {
+                residency.remove(it->second.handle);
+                imagesByHandle.erase(it->second.handle);
+                it = images.erase(it);
+            } else {
+                ++it;
+            }
+        }
+
+        residency.update(frame, config.textureStreamingMaxLoads, loadDecisions, evictionDecisions);
+        for (const auto& decision : evictionDecisions) {
+            startLoad(decision);
+        }
+        for (const auto& decision : loadDecisions) {
+            startLoad(decision);
+        }
+        return updated;
+    }
+
+    void TextureStreamer::startLoad(const TextureResidency::Decision& decision) {
+        const auto& streamedImage = images.at(imagesByHandle.at(decision.handle));
+        auto result = std::make_shared<LoadResult>();
+        // Jobs must not throw, the error is reported by update()
+        auto job = Application::getJobSystem().schedule(
+            [result, source = streamedImage.source, mip = decision.mip] {
+                try {
+                    result->data = read(source, mip);
+                } catch (...) {
+                    result->error = std::current_exception();
+                }
+            },
+            JobPriority::BLOCKING);
+        loads.push_back({
+            .image = streamedImage.image,
+            .mip = decision.mip,
+            .job = std::move(job),
+            .result = std::move(result),
+        });
+    }
+
+    std::vector<char> TextureStreamer::read(const Source& source, const uint32 mip) {
+        auto size = uint64{0};
+        for (auto level = mip; level < source.mipLevels.size(); level++) {
+            size += source.mipLevels[level].size;
+        }
+        auto data = std::vector<char>(size);
+        auto stream = VirtualFS::openReadStream(source.filename);
+        auto offset = uint64{0};
+        for (auto level = mip; level < source.mipLevels.size(); level++) {
+            const auto& mipLevel = source.mipLevels[level];
+            stream.seekg(static_cast<std::streamoff>(mipLevel.offset));
+            stream.read(data.data() + offset, static_cast<std::streamsize>(mipLevel.size));
+            if (!stream) {
+                throw Exception("Error reading mip level ", std::to_string(level), " from ", source.filename);
+            }
+            offset += mipLevel.size;
+        }
+        return data;
+    }
+
+    std::shared_ptr<vireo::Image> TextureStreamer::upload(
+        const Source& source,
+        const uint32 mip,
+        const std::vector<char>& data,
+        const std::string& name) {
+        const auto& vireo = Application::getVireo();
+        auto& asyncQueue = Application::getAsyncQueue();
+        const auto mipLevels = static_cast<uint32>(source.mipLevels.size()) - mip;
+        const auto image = vireo.createImage(
+            source.format,
+            std::max(1u, source.width >> mip),
+            std::max(1u, source.height >> mip),
+            mipLevels,
+            1,
+            name);
+
+        const auto command = asyncQueue.beginCommand(vireo::CommandType::GRAPHIC);
+        const auto stagingBuffer = asyncQueue.createBuffer(
+            command,
+            vireo::BufferType::IMAGE_UPLOAD,
+            data.size(),
+            1);
+        stagingBuffer->map();
+        stagingBuffer->write(data.data(), data.size(), 0);
+        auto sourceOffsets = std::vector<size_t>(mipLevels);
+        auto offset = size_t{0};
+        for (auto level = 0; level < mipLevels; level++) {
+            sourceOffsets[level] = offset;
+            offset += source.mipLevels[mip + level].size;
+        }
+        command.commandList->barrier(
+            image,
+            vireo::ResourceState::UNDEFINED,
+            vireo::ResourceState::COPY_DST,
+            0,
+            mipLevels);
+        command.commandList->copy(*stagingBuffer, *image, sourceOffsets);
+        command.commandList->barrier(
+            image,
+            vireo::ResourceState::COPY_DST,
+            vireo::ResourceState::SHADER_READ,
+            0,
+            mipLevels);
+        asyncQueue.endCommand(command);
+        return image;
+    }
+
+    void TextureStreamer::cleanup() {
+        auto lock = std::lock_guard{mutex};
+        for (const auto& load : loads) {
+            Application::getJobSystem().wait(load.job);
+        }
+        loads.clear();
+        imagesByHandle.clear();
+        images.clear();
+    }
+
+}
@@ -0,0 +1,226 @@
+/*
+* Copyright (c) 2025-present Henri Michelon
+*
+* This software is released under the MIT License.
+* https://opensource.org/licenses/MIT
+*/
+export module lysa.texture_streamer;
+
+import std;
+import vireo;
+import lysa.configuration;
+import lysa.job_system;
+import lysa.texture_slots;
+import lysa.types;
+import lysa.resources.image;
+
+export namespace lysa {
+
+    /**
+     * Residency policy of the streamed textures mip levels, without any GPU dependency.
+     *  - Each texture keeps its coarsest mip levels resident (the initial mip), the finer
+     *    levels are loaded on request.
+     *  - Requests are made each frame with the finest mip level needed, the texture is then
+     *    considered used for this frame.
+     *  - Loads are accepted under a memory budget, evicting the least recently used textures
+     *    back to their requested (or initial) mip level when needed.
+     *
+     * Mip level 0 is the finest level : a lower mip index means more memory.
+     */
+    class TextureResidency {
+    public:
+        using Handle = uint32;
+
+        /** A change of resident mip level decided by update() */
+        struct Decision {
+            Handle handle;
+            //! New finest resident mip level
+            uint32 mip;
+        };
+
+        /**
+         * @param budget            Memory budget in bytes for all the textures
+         * @param unusedFramesDelay Number of frames without request before a texture is considered unused
+         */
+        TextureResidency(uint64 budget, uint32 unusedFramesDelay = 60);
+
+        /**
+         * Registers a texture
+         * @param mipSizes      Size in bytes of each mip level, finest first
+         * @param initialMip    Finest mip level already resident, the coarser levels are never evicted
+         */
+        Handle add(const std::vector<uint64>& mipSizes, uint32 initialMip);
+
+        /** Unregisters a texture and releases its budget */
+        void remove(Handle handle);
+
+        /** Requests a mip level for the current frame, the finest request of the frame wins */
+        void request(Handle handle, uint32 mip, uint64 frame);
+
+        /** Notifies the completion of a load or an eviction decided by update() */
+        void complete(Handle handle);
+
+        /**
+         * Notifies a load or an eviction that failed, with the mip level that is really resident.
+         */
+        void cancel(Handle handle, uint32 residentMip);
+
+        /**
+         * Decides the loads and evictions for this frame.
+         * The budget is reserved at decision time, until complete() or cancel() is called.
+         * @param maxPending Maximum number of loads in progress, including the evictions
+         */
+        void update(uint64 frame, uint32 maxPending, std::vector<Decision>& loads, std::vector<Decision>& evictions);
+
+        /** Returns the finest mip level resident (or being loaded) */
+        uint32 getResidentMip(Handle handle) const { return entries[handle].residentMip; }
+
+        /** Returns true if a load or an eviction is in progress */
+        bool isPending(Handle handle) const { return entries[handle].pending; }
+
+        /** Returns the memory used, including the loads in progress */
+        auto getUsedSize() const { return usedSize; }
+
+        auto getBudget() const { return budget; }
+
+        /** Changes the budget, textures are evicted on the next update() if needed */
+        void setBudget(const uint64 budget) { this->budget = budget; }
+
+    private:
+        struct Entry {
+            bool   valid{false};
+            bool   pending{false};
+            std::vector<uint64> mipSizes;
+            uint32 initialMip;
+            uint32 residentMip;
+            uint32 requestedMip;
+            uint64 lastUsedFrame{0};
+        };
+
+        uint64 budget;
+        const uint32 unusedFramesDelay;
+        uint64 usedSize{0};
+        std::vector<Entry> entries;
+        std::vector<Handle> freeHandles;
+
+        // Memory used by a texture with all the levels from `mip` to the coarsest
+        static uint64 getSize(const Entry& entry, uint32 mip);
+
+        // Mip level that should be resident for a texture : the requested level for the textures
+        // recently used, the initial level for the others
+        uint32 getWantedMip(const Entry& entry, uint64 frame) const;
+
+        // Evicts the least recently used textures until `size` more bytes fits in the budget.
+        // Nothing is evicted if the budget can't be reached.
+        bool makeRoom(uint64 size, Handle exclude, uint64 frame, uint32& pendingCount, std::vector<Decision>& evictions);
+    };
+
+    /**
+     * Streams the mip levels of the textures loaded from assets packs.
+     *  - The textures are created with only their coarse mip levels, see getInitialMip().
+     *  - Each frame the scenes request the mip levels needed from the screen size of the
+     *    models, and the TextureResidency policy decides the loads and evictions.
+     *  - The mip levels are read from the assets pack file in background jobs, then the
+     *    GPU image is re-created with the new levels and replaces the previous one in the
+     *    textures table.
+     *
+     * Thread-safety: request() can be called from the rendering threads, update() is called
+     * by Resources::update() from the main thread.
+     */
+    class TextureStreamer {
+    public:
+        /** Location of a mip level in the source file */
+        struct MipLevel {
+            //! Absolute offset in the file
+            uint64 offset;
+            //! Size in bytes
+            uint64 size;
+        };
+
+        /** Source of a streamed image */
+        struct Source {
+            std::string filename;
+            vireo::ImageFormat format;
+            //! Width & height of mip level 0
+            uint32 width;
+            uint32 height;
+            std::vector<MipLevel> mipLevels;
+        };
+
+        TextureStreamer(const ResourcesConfiguration& config);
+
+        /** Returns the finest mip level to load with a new texture */
+        uint32 getInitialMip(uint32 width, uint32 height, uint32 mipLevels) const;
+
+        /**
+         * Registers an image created with all the mip levels starting at `initialMip`
+         */
+        void add(const std::shared_ptr<Image>& image, const Source& source, uint32 initialMip);
+
+        /**
+         * Requests the mip level of an image needed to display it on `screenSize` pixels.
+         * Images not registered are ignored.
+         */
+        void request(const Image& image, float screenSize);
+
+        /**
+         * Completes the loads, starts new ones and updates the textures table.
+         * The images updated are added to `updatedImages` : the caller releases them once the
+         * textures table is unlocked since the destruction of an image frees its texture slot.
+         * Returns true if the textures table has been modified.
+         */
+        bool update(
+            TextureSlots<std::shared_ptr<vireo::Image>>& textures,
+            std::vector<std::shared_ptr<Image>>& updatedImages);
+
+        /** Waits for the loads in progress and releases all the images */
+        void cleanup();
+
+    private:
+        struct StreamedImage {
+            std::weak_ptr<Image> image;
+            Source source;
+            TextureResidency::Handle handle;
+            //! Finest mip level of the current GPU image
+            uint32 residentMip;
+        };
+
+        // Written by the load job, read once the job is finished
+        struct LoadResult {
+            std::vector<char> data;
+            std::exception_ptr error;
+        };
+
+        struct Load {
+            std::weak_ptr<Image> image;
+            uint32 mip;
+            JobHandle job;
+            std::shared_ptr<LoadResult> result;
+        };
+
+        const ResourcesConfiguration& config;
+        TextureResidency residency;
+        uint64 frame{0};
+        // Keyed by the resource id : the address of a destroyed image can be reused by a new one
+        std::unordered_map<unique_id, StreamedImage> images;
+        std::unordered_map<TextureResidency::Handle, unique_id> imagesByHandle;
+        std::list<Load> loads;
+        std::vector<TextureResidency::Decision> loadDecisions;
+        std::vector<TextureResidency::Decision> evictionDecisions;
+        std::mutex mutex;
+
+        // Starts reading the mip levels in a background job
+        void startLoad(const TextureResidency::Decision& decision);
+
+        // Reads the mip levels from `mip` to the coarsest, packed in one block
+        static std::vector<char> read(const Source& source, uint32 mip);
+
+        // Creates the new GPU image and records the upload of the levels
+        static std::shared_ptr<vireo::Image> upload(
+            const Source& source,
+            uint32 mip,
+            const std::vector<char>& data,
+            const std::string& name);
+    };
+
+}
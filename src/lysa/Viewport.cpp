@@ -16,7 +16,8 @@ namespace lysa {
         config{config},
         viewport{config.viewport},
         scissors{config.scissors},
-        physicsScene{Application::getPhysicsEngine().createScene(config.debugConfig)} {
+        physicsScene{Application::getPhysicsEngine().createScene(config.debugConfig)},
+        parallelProcess{Application::getJobSystem(), config.parallelProcessBatchSize} {
     }
 
     Viewport::~Viewport() {
@@ -115,19 +116,29 @@ namespace lysa {
         }
     }
 
-    void Viewport::physicsProcess(const float delta) const {
+    void Viewport::physicsProcess(const float delta) {
         if (rootNode) {
             if (displayDebug) {
-                debugRenderer->restart();
+                debugRenderer->restart(delta);
             }
             physicsScene->update(delta);
             rootNode->physicsProcess(delta);
+            if (config.parallelProcess) {
+                parallelProcess.process([delta](Node* node) {
+                    node->onPhysicsProcess(delta);
+                });
+            }
         }
     }
 
-    void Viewport::process(const float alpha) const {
+    void Viewport::process(const float alpha) {
         if (rootNode) {
             rootNode->process(alpha);
+            if (config.parallelProcess) {
+                parallelProcess.process([alpha](Node* node) {
+                    node->onProcess(alpha);
+                });
+            }
         }
     }
 
@@ -10,10 +10,12 @@ import vireo;
 import lysa.configuration;
 import lysa.exception;
 import lysa.input_event;
+import lysa.parallel_process;
 import lysa.scene;
 import lysa.types;
 import lysa.nodes.camera;
 import lysa.nodes.node;
+import lysa.pipelines.frustum_culling;
 import lysa.physics.engine;
 import lysa.renderers.debug;
 import lysa.renderers.vector;
@@ -175,18 +177,36 @@ export namespace lysa {
             return config;
         }
 
+        /**
+         * Returns the camera culling statistics of the last frame rendered by this viewport.
+         * The values are read back from the GPU after the frame completion and lag behind
+         * the displayed frame by the number of frames in flight.
+         */
+        const auto& getCullingStatistics() const { return cullingStatistics; }
+
         /** Returns true when debug overlays are enabled. */
         auto getDisplayDebug() const { return displayDebug;}
 
         /** Enables or disables debug overlays rendering. */
         void setDisplayDebug(const bool displayDebug) { this->displayDebug = displayDebug; }
 
+        /**
+         * Adds a lambda executed on the main thread once the thread-safe nodes are processed,
+         * for the changes they can't do from a worker thread (adding or removing nodes, ...).
+         * Thread safe, see Node::setThreadSafeProcess().
+         */
+        template<typename Lambda>
+        void callAfterParallelProcess(Lambda&& lambda) {
+            parallelProcess.callAfter(std::forward<Lambda>(lambda));
+        }
+
         virtual ~Viewport();
         Viewport(Viewport&) = delete;
         Viewport& operator=(Viewport&) = delete;
 
     private:
         friend class Window;
+        friend class Node;
 
         /** Per‑frame state and deferred operations processed at frame boundaries. */
         struct FrameData {
@@ -235,6 +255,10 @@ export namespace lysa {
         std::shared_ptr<VectorRenderer> vectorRenderer;
         /** Toggles debug overlays rendering. */
         bool displayDebug{false};
+        /** Culling statistics copied from the scene of the last computed frame. */
+        CullingStatistics cullingStatistics;
+        /** Thread-safe nodes attached to this viewport, processed in parallel after the node tree traversal. */
+        ParallelProcess parallelProcess;
 
         /** Returns the Scene object associated with the specified frame. */
         auto& getScene(const uint32 frameIndex) const { return framesData[frameIndex].scene; }
@@ -252,10 +276,10 @@ export namespace lysa {
         void update(uint32 frameIndex);
 
         /** Steps the physics simulation. */
-        void physicsProcess(float delta) const;
+        void physicsProcess(float delta);
 
         /** Updates nodes with the given alpha (interpolation factor). */
-        void process(float alpha) const;
+        void process(float alpha);
 
         /** Issues draw calls for the current frame. */
         void render(uint32 frameIndex) const;
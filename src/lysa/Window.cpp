@@ -33,6 +33,8 @@ namespace lysa {
         windowManager{*this, uiRenderer,config.defaultFontName, config.defaultFontScale, config.defaultTextColor},
         rootNode{rootNode} {
         assert([&]{return config.renderingConfig.framesInFlight > 0;}, "Must have at least 1 frame in flight");
+        assert([&]{return config.renderingConfig.framesInFlight <= Application::getConfiguration().resourcesConfig.maxFramesInFlight;},
+            "Too many frames in flight for the resources configuration");
         framesData.resize(config.renderingConfig.framesInFlight);
         auto& vireo = Application::getVireo();
         for (auto& frame : framesData) {
@@ -125,6 +127,24 @@ namespace lysa {
         windowManager.drawFrame();
     }
 
+    void Window::reloadShaders(const std::set<std::string>& shaderNames, std::set<std::string>& reloadedShaders) const {
+        if (stopped) { return; }
+        waitIdle();
+        // The renderer pipelines are shared by the scenes of all the viewports & frames in flight
+        auto pipelineIds = std::unordered_map<pipeline_id, std::vector<std::shared_ptr<Material>>>{};
+        for (const auto& viewport : viewports) {
+            for (uint32 frameIndex = 0; frameIndex < config.renderingConfig.framesInFlight; frameIndex++) {
+                const auto& scene = viewport->getScene(frameIndex);
+                for (const auto& [pipelineId, materials] : scene->getPipelineIds()) {
+                    pipelineIds.try_emplace(pipelineId, materials);
+                }
+                // Each scene has its own shadow map renderers
+                scene->reloadShaders(shaderNames, reloadedShaders);
+            }
+        }
+        renderer->reloadShaders(shaderNames, pipelineIds, reloadedShaders);
+    }
+
     void Window::physicsProcess(const float delta) const {
         if (stopped) { return; }
         for (const auto& viewport : viewports) {
@@ -152,6 +172,7 @@ namespace lysa {
         for (const auto& viewport : viewports) {
             auto& scene = *viewport->getScene(frameIndex);
             renderer->compute(*frame.computeCommandList, scene, frameIndex);
+            viewport->cullingStatistics = scene.getCullingStatistics();
         }
         frame.computeCommandList->end();
         Application::getGraphicQueue()->submit(
@@ -159,6 +180,12 @@ namespace lysa {
             frame.computeSemaphore,
             {frame.computeCommandList});
 
+        // The shadow maps are recorded in background jobs while recording the pre-render command list
+        auto scenes = std::vector<std::shared_ptr<Scene>>{};
+        for (const auto& viewport : viewports) {
+            scenes.push_back(viewport->getScene(frameIndex));
+        }
+        renderer->beginShadowMaps(scenes, frameIndex);
         frame.preRenderCommandList->begin();
         for (const auto& viewport : viewports) {
             auto& scene = *viewport->getScene(frameIndex);
@@ -168,12 +195,14 @@ namespace lysa {
         uiRenderer.update(*frame.preRenderCommandList, frameIndex);
 
         frame.preRenderCommandList->end();
+        auto preRenderCommandLists = renderer->endShadowMaps(frameIndex);
+        preRenderCommandLists.push_back(frame.preRenderCommandList);
         Application::getGraphicQueue()->submit(
             frame.computeSemaphore,
             vireo::WaitStage::VERTEX_INPUT,
             vireo::WaitStage::ALL_COMMANDS,
             frame.preRenderSemaphore,
-            {frame.preRenderCommandList});
+            preRenderCommandLists);
 
         auto& commandList = frame.renderCommandList;
         commandList->begin();
@@ -239,6 +239,12 @@ export namespace lysa {
         /** Records and submits GPU commands for the current frame. */
         void drawFrame();
 
+        /**
+         * Recreates the renderer & shadow maps pipelines using one of the modified shaders.
+         * The names of the modified shaders used by the recreated pipelines are added to `reloadedShaders`.
+         */
+        void reloadShaders(const std::set<std::string>& shaderNames, std::set<std::string>& reloadedShaders) const;
+
         /** Steps the physics simulation for all attached viewports. */
         void physicsProcess(float delta) const;
 
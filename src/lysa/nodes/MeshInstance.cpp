@@ -25,6 +25,7 @@ namespace lysa {
             .aabbMax = worldAABB.max,
             .visible = isVisible() ? 1u : 0u,
             .castShadows = castShadows ? 1u : 0u,
+            .staticShadowCaster = staticShadowCaster ? 1u : 0u,
         };
     }
 
@@ -76,6 +77,11 @@ namespace lysa {
         setUpdated();
     }
 
+    void MeshInstance::setStaticShadowCaster(const bool staticShadowCaster) {
+        this->staticShadowCaster = staticShadowCaster;
+        setUpdated();
+    }
+
     std::shared_ptr<Node> MeshInstance::duplicateInstance() const {
         return std::make_shared<MeshInstance>(*this);
     }
@@ -89,6 +95,8 @@ namespace lysa {
         Node::setProperty(property, value);
        if (property == "cast_shadows") {
             setCastShadows(value == "true");
+        } else if (property == "static_shadow_caster") {
+            setStaticShadowCaster(value == "true");
         }
     }
 
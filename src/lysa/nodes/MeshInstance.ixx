@@ -20,6 +20,7 @@ export namespace lysa {
         float3   aabbMax;
         uint     visible;
         uint     castShadows;
+        uint     staticShadowCaster;
     };
 
     /**
@@ -71,6 +72,15 @@ export namespace lysa {
 
         auto getCastShadows() const { return castShadows; }
 
+        /**
+         * Sets to `true` if the mesh instance never moves.<br>
+         * Static shadow casters are rendered once in the cached layer of the shadow maps
+         * and only redrawn when the light or another static caster changes.
+         */
+        void setStaticShadowCaster(bool staticShadowCaster);
+
+        auto isStaticShadowCaster() const { return staticShadowCaster; }
+
     protected:
         std::shared_ptr<Node> duplicateInstance() const override;
 
@@ -78,6 +88,7 @@ export namespace lysa {
 
     private:
         bool castShadows{true};
+        bool staticShadowCaster{false};
         AABB worldAABB;
         std::shared_ptr<Mesh> mesh;
         std::unordered_map<uint32, std::shared_ptr<Material>> overrideMaterials;
@@ -10,6 +10,7 @@ import lysa.constants;
 import lysa.exception;
 import lysa.global;
 import lysa.log;
+import lysa.parallel_process;
 import lysa.viewport;
 
 namespace lysa {
@@ -22,6 +23,7 @@ namespace lysa {
         localTransform  = node.localTransform;
         globalTransform = node.globalTransform;
         processMode     = node.processMode;
+        threadSafeProcess = node.threadSafeProcess;
         type            = node.type;
     }
 
@@ -72,7 +74,7 @@ namespace lysa {
         for (const auto& child : children) {
             child->physicsProcess(delta);
         }
-        if (isProcessed()) {
+        if (isProcessed() && !isParallelProcessed()) {
             onPhysicsProcess(delta);
         }
     }
@@ -81,13 +83,40 @@ namespace lysa {
         for (const auto& child : children) {
             child->process(alpha);
         }
-        if (isProcessed()) {
+        if (isProcessed() && !isParallelProcessed()) {
             onProcess(alpha);
         }
     }
 
     void Node::setTransformLocal(const float4x4 &transform) {
         localTransform = transform;
+        localTransformChanged();
+    }
+
+    bool Node::isParallelProcessed() const {
+        return threadSafeProcess && viewport && viewport->config.parallelProcess;
+    }
+
+    void Node::setThreadSafeProcess(const bool threadSafe) {
+        assert([&]{ return ParallelProcess::getCurrentNode() == nullptr; }, "setThreadSafeProcess() called during the parallel process");
+        if (threadSafe == threadSafeProcess) { return; }
+        threadSafeProcess = threadSafe;
+        if (viewport) {
+            if (threadSafe) {
+                viewport->parallelProcess.add(this);
+            } else {
+                viewport->parallelProcess.remove(this);
+            }
+        }
+    }
+
+    void Node::localTransformChanged() {
+        if (ParallelProcess::getCurrentNode()) {
+            // The other nodes can read the global transforms of the node and its children
+            assert([&]{ return ParallelProcess::getCurrentNode() == this; }, "A thread-safe node can only modify itself during the parallel process");
+            globalTransformPending = true;
+            return;
+        }
         updateGlobalTransform();
     }
 
@@ -111,12 +140,18 @@ namespace lysa {
     void Node::attachToViewport(Viewport* viewport) {
         assert([&]{ return this->viewport == nullptr; }, "Node already attached to a viewport");
         this->viewport = viewport;
+        if (threadSafeProcess) {
+            viewport->parallelProcess.add(this);
+        }
         for (const auto& child : children) {
             child->attachToViewport(viewport);
         }
     }
 
     void Node::detachFromViewport() {
+        if (viewport && threadSafeProcess) {
+            viewport->parallelProcess.remove(this);
+        }
         this->viewport = nullptr;
         for (const auto& child : children) {
             child->detachFromViewport();
@@ -137,7 +172,7 @@ namespace lysa {
     void Node::setPosition(const float3& position) {
         if (any(position != getPosition())) {
             localTransform[3] = float4{position, 1.0f};
-            updateGlobalTransform();
+            localTransformChanged();
         }
     }
 
@@ -148,7 +183,7 @@ namespace lysa {
                 return;
             }
             localTransform[3] = mul(float4{position, 1.0}, inverse(parent->globalTransform));
-            updateGlobalTransform();
+            localTransformChanged();
         }
     }
 
@@ -162,7 +197,7 @@ namespace lysa {
 
     void Node::translate(const float3& localOffset) {
         localTransform = mul(localTransform, float4x4::translation(localOffset));
-        updateGlobalTransform();
+        localTransformChanged();
     }
 
     void Node::translate(const float x, const float y, const float z) {
@@ -171,7 +206,7 @@ namespace lysa {
 
     void Node::scale(const float scale) {
         localTransform = mul(float4x4::scale(scale), localTransform);
-        updateGlobalTransform();
+        localTransformChanged();
     }
 
     void Node::setVisible(const bool visible) {
@@ -286,24 +321,24 @@ namespace lysa {
             const auto rm = float4x4{quat};
             const auto sm = float4x4::scale(getScale());
             localTransform = mul(mul(rm, sm), tm);
-            updateGlobalTransform();
+            localTransformChanged();
         }
     }
 
     void Node::rotateX(const float angle) {
         localTransform = mul(float4x4::rotation_x(angle), localTransform);
-        updateGlobalTransform();
+        localTransformChanged();
     }
 
     void Node::rotateY(const float angle) {
         // INFO("rotate Y ", angle, " ", lysa::to_string(getName()));
         localTransform = mul(float4x4::rotation_y(angle), localTransform);
-        updateGlobalTransform();
+        localTransformChanged();
     }
 
     void Node::rotateZ(const float angle) {
         localTransform = mul(float4x4::rotation_z(angle), localTransform);
-        updateGlobalTransform();
+        localTransformChanged();
     }
 
     void Node::setRotationGlobal(const quaternion& quat) {
@@ -317,7 +352,7 @@ namespace lysa {
             const auto sm = float4x4::scale(getScaleGlobal());
             const auto newGlobalTransform = mul(mul(rm, sm), tm);
             localTransform = mul(newGlobalTransform, inverse(parent->globalTransform));
-            updateGlobalTransform();
+            localTransformChanged();
         }
     }
 
@@ -336,7 +371,7 @@ namespace lysa {
         } else {
             localTransform = newGlobalTransform;
         }
-        updateGlobalTransform();
+        localTransformChanged();
     }
 
     float3 Node::toGlobal(const float3& local) const {
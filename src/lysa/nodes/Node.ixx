@@ -12,6 +12,7 @@ import lysa.input_event;
 import lysa.object;
 import lysa.math;
 import lysa.tween;
+import lysa.types;
 
 export namespace lysa {
 
@@ -483,6 +484,22 @@ export namespace lysa {
          */
         bool isProcessed() const;
 
+        /**
+         * Allows onProcess() and onPhysicsProcess() to be called from a worker thread, in parallel
+         * with the other thread-safe nodes, when the viewport enables it (see ViewportConfiguration::parallelProcess).<br>
+         * The callbacks of a thread-safe node are called after the callbacks of the other nodes.
+         * They must only modify the node itself and use Viewport::callAfterParallelProcess() for the
+         * other changes, like adding or removing nodes.<br>
+         * The transform changes made by the callbacks are propagated to the global transforms of
+         * the node and its children after the parallel process, see ParallelProcess.
+         */
+        void setThreadSafeProcess(bool threadSafe);
+
+        /**
+         * Returns true if the process callbacks of the node can be called from a worker thread
+         */
+        auto isThreadSafeProcess() const { return threadSafeProcess; }
+
         /**
          * Returns the node type
          */
@@ -629,6 +646,7 @@ export namespace lysa {
         bool             visible{true};
         bool             isReady{false};
         ProcessMode      processMode{ProcessMode::INHERIT};
+        bool             threadSafeProcess{false};
 
         std::list<std::shared_ptr<Tween>> tweens;
         std::list<std::string>           groups;
@@ -642,6 +660,20 @@ export namespace lysa {
 
         friend class Loader;
         void setParent(Node *p) { parent = p; }
+
+        friend class ParallelProcess;
+        static constexpr uint32 NOT_PARALLEL_PROCESSED{std::numeric_limits<uint32>::max()};
+        // Index in the thread-safe nodes list of the viewport
+        uint32           parallelProcessIndex{NOT_PARALLEL_PROCESSED};
+        // Local transform changed during the parallel process, see localTransformChanged()
+        bool             globalTransformPending{false};
+
+        // Updates the global transforms after a change of the local transform, after the
+        // parallel process when called from the callback of a thread-safe node
+        void localTransformChanged();
+
+        // Returns true if the callbacks are called by the parallel process of the viewport
+        bool isParallelProcessed() const;
     };
 
 }
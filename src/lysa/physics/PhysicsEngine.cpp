@@ -26,9 +26,9 @@ namespace lysa {
         throw Exception("Not implemented");
     }
 
-    std::unique_ptr<PhysicsEngine> PhysicsEngine::create(const PhysicsConfiguration& config) {
+    std::unique_ptr<PhysicsEngine> PhysicsEngine::create(const PhysicsConfiguration& config, JobSystem& jobSystem) {
 #ifdef PHYSIC_ENGINE_JOLT
-        return std::make_unique<JoltPhysicsEngine>(config.layerCollisionTable);
+        return std::make_unique<JoltPhysicsEngine>(config.layerCollisionTable, jobSystem);
 #endif
 #ifdef PHYSIC_ENGINE_PHYSX
         return std::make_unique<PhysXPhysicsEngine>(config.layerCollisionTable);
@@ -9,6 +9,7 @@ export module lysa.physics.engine;
 import std;
 import lysa.configuration;
 import lysa.enums;
+import lysa.job_system;
 import lysa.math;
 import lysa.physics.configuration;
 import lysa.physics.physics_material;
@@ -63,9 +64,10 @@ export namespace lysa {
         /**
          * Creates a physics engine using the active backend.
          * @param config Physics configuration (layers/collision table, etc.).
+         * @param jobSystem Job system executing the physics jobs, when supported by the backend.
          * @return A heap‑allocated engine instance.
          */
-        static std::unique_ptr<PhysicsEngine> create(const PhysicsConfiguration& config);
+        static std::unique_ptr<PhysicsEngine> create(const PhysicsConfiguration& config, JobSystem& jobSystem);
 
         /**
          * Creates a new physics scene/world with optional debug settings.
@@ -119,7 +119,58 @@ namespace lysa {
         restitution(restitution) {
     }
 
-    JoltPhysicsEngine::JoltPhysicsEngine(const LayerCollisionTable& layerCollisionTable):
+    JoltJobSystem::JoltJobSystem(lysa::JobSystem& jobSystem, const uint32 maxJobs, const uint32 maxBarriers) :
+        JobSystemWithBarrier{maxBarriers},
+        jobSystem{jobSystem} {
+        jobs.Init(maxJobs, maxJobs);
+    }
+
+    int JoltJobSystem::GetMaxConcurrency() const {
+        // The thread waiting on a barrier also executes the jobs
+        return static_cast<int>(jobSystem.getThreadsCount()) + 1;
+    }
+
+    JoltJobSystem::JobHandle JoltJobSystem::CreateJob(
+        const char* inName,
+        const JPH::ColorArg inColor,
+        const JobFunction& inJobFunction,
+        const JPH::uint32 inNumDependencies) {
+        auto index = jobs.ConstructObject(inName, inColor, this, inJobFunction, inNumDependencies);
+        while (index == JPH::FixedSizeFreeList<Job>::cInvalidObjectIndex) {
+            // All the jobs are in use, wait for some to finish
+            std::this_thread::sleep_for(std::chrono::microseconds(100));
+            index = jobs.ConstructObject(inName, inColor, this, inJobFunction, inNumDependencies);
+        }
+        auto* job = &jobs.Get(index);
+        // Keeps a reference, the job can be executed and released before returning
+        auto handle = JobHandle{job};
+        // The jobs with dependencies are queued by Jolt when their dependencies are finished
+        if (inNumDependencies == 0) {
+            QueueJob(job);
+        }
+        return handle;
+    }
+
+    void JoltJobSystem::QueueJob(Job* inJob) {
+        // Reference released once executed
+        inJob->AddRef();
+        jobSystem.schedule([inJob] {
+            inJob->Execute();
+            inJob->Release();
+        }, JobPriority::HIGH);
+    }
+
+    void JoltJobSystem::QueueJobs(Job** inJobs, const JPH::uint inNumJobs) {
+        for (auto i = 0u; i < inNumJobs; i++) {
+            QueueJob(inJobs[i]);
+        }
+    }
+
+    void JoltJobSystem::FreeJob(Job* inJob) {
+        jobs.DestructObject(inJob);
+    }
+
+    JoltPhysicsEngine::JoltPhysicsEngine(const LayerCollisionTable& layerCollisionTable, JobSystem& jobSystem):
         objectVsObjectLayerFilter{layerCollisionTable.layersCount} {
         // The layer vs layer collision table initialization
         for (const auto &layerCollide : layerCollisionTable.layersCollideWith) {
@@ -132,7 +183,7 @@ namespace lysa {
         JPH::Factory::sInstance = new JPH::Factory();
         JPH::RegisterTypes();
         tempAllocator = std::make_unique<JPH::TempAllocatorImpl>(10 * 1024 * 1024);
-        jobSystem = std::make_unique<JPH::JobSystemThreadPool>(JPH::cMaxPhysicsJobs, JPH::cMaxPhysicsBarriers);
+        this->jobSystem = std::make_unique<JoltJobSystem>(jobSystem, JPH::cMaxPhysicsJobs, JPH::cMaxPhysicsBarriers);
         defaultMaterial = JoltPhysicsEngine::createMaterial();
         JPH::PhysicsMaterial::sDefault = reinterpret_cast<JPH::PhysicsMaterial*>(defaultMaterial);
     }
@@ -167,7 +218,7 @@ namespace lysa {
     JoltPhysicsScene::JoltPhysicsScene(
         const DebugConfig& debugConfig,
         JPH::TempAllocatorImpl& tempAllocator,
-        JPH::JobSystemThreadPool& jobSystem,
+        JPH::JobSystem& jobSystem,
         ContactListener& contactListener,
         const BPLayerInterfaceImpl& broadphaseLayerInterface,
         const ObjectVsBroadPhaseLayerFilterImpl& objectVsBroadphaseLayerFilter,
@@ -6,13 +6,15 @@
 */
 module;
 #include <Jolt/Jolt.h>
-#include <Jolt/Core/JobSystemThreadPool.h>
+#include <Jolt/Core/FixedSizeFreeList.h>
+#include <Jolt/Core/JobSystemWithBarrier.h>
 #include <Jolt/Physics/PhysicsSystem.h>
 #include <Jolt/Physics/Collision/ObjectLayerPairFilterTable.h>
 export module lysa.physics.jolt.engine;
 
 import std;
 import lysa.configuration;
+import lysa.job_system;
 import lysa.math;
 import lysa.signal;
 import lysa.types;
@@ -23,6 +25,36 @@ import lysa.renderers.debug;
 
 export namespace lysa {
 
+    /**
+     * Jolt job system executing the physics jobs in the engine JobSystem.<br>
+     * Jolt counts the jobs dependencies itself and only queues the jobs ready to execute,
+     * the barriers are the ones of JPH::JobSystemWithBarrier.
+     */
+    class JoltJobSystem : public JPH::JobSystemWithBarrier {
+    public:
+        JoltJobSystem(lysa::JobSystem& jobSystem, uint32 maxJobs, uint32 maxBarriers);
+
+        int GetMaxConcurrency() const override;
+
+        JobHandle CreateJob(
+            const char* inName,
+            JPH::ColorArg inColor,
+            const JobFunction& inJobFunction,
+            JPH::uint32 inNumDependencies = 0) override;
+
+    protected:
+        void QueueJob(Job* inJob) override;
+
+        void QueueJobs(Job** inJobs, JPH::uint inNumJobs) override;
+
+        void FreeJob(Job* inJob) override;
+
+    private:
+        // JobSystem alone names the Jolt base class here
+        lysa::JobSystem& jobSystem;
+        JPH::FixedSizeFreeList<Job> jobs;
+    };
+
     /**
      * Object layer collision filter for the Jolt backend.
      * Decides if two object layers are allowed to collide (narrow phase hint).
@@ -90,7 +122,7 @@ export namespace lysa {
         JoltPhysicsScene(
             const DebugConfig& debugConfig,
             JPH::TempAllocatorImpl& tempAllocator,
-            JPH::JobSystemThreadPool& jobSystem,
+            JPH::JobSystem& jobSystem,
             ContactListener& contactListener,
             const BPLayerInterfaceImpl& broadphaseLayerInterface,
             const ObjectVsBroadPhaseLayerFilterImpl& objectVsBroadphaseLayerFilter,
@@ -116,7 +148,7 @@ export namespace lysa {
         const DebugConfig& debugConfig;
         JPH::PhysicsSystem physicsSystem;
         JPH::TempAllocatorImpl& tempAllocator;
-        JPH::JobSystemThreadPool& jobSystem;
+        JPH::JobSystem& jobSystem;
         // Debug view config
         JPH::BodyManager::DrawSettings bodyDrawSettings{};
     };
@@ -127,7 +159,7 @@ export namespace lysa {
      */
     class JoltPhysicsEngine : public PhysicsEngine {
     public:
-        JoltPhysicsEngine(const LayerCollisionTable& layerCollisionTable);
+        JoltPhysicsEngine(const LayerCollisionTable& layerCollisionTable, JobSystem& jobSystem);
 
         std::unique_ptr<PhysicsScene> createScene(const DebugConfig& debugConfig) override;
 
@@ -148,7 +180,7 @@ export namespace lysa {
         ObjectVsBroadPhaseLayerFilterImpl objectVsBroadphaseLayerFilter;
         ObjectLayerPairFilterImpl objectVsObjectLayerFilter;
         std::unique_ptr<JPH::TempAllocatorImpl> tempAllocator;
-        std::unique_ptr<JPH::JobSystemThreadPool> jobSystem;
+        std::unique_ptr<JoltJobSystem> jobSystem;
         PhysicsMaterial* defaultMaterial;
     };
 
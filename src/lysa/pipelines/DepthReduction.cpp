@@ -0,0 +1,108 @@
+/*
+* Copyright (c) 2025-present Henri Michelon
+*
+* This software is released under the MIT License.
+* https://opensource.org/licenses/MIT
+*/
+module lysa.pipelines.depth_reduction;
+
+import lysa.application;
+import lysa.log;
+import lysa.shader_modules;
+
+namespace lysa {
+    DepthReduction::DepthReduction(const RenderingConfiguration& config, const float clearDepth) :
+        depthStage{
+            config.depthStencilFormat == vireo::ImageFormat::D32_SFLOAT_S8_UINT ||
+            config.depthStencilFormat == vireo::ImageFormat::D24_UNORM_S8_UINT   ?
+            vireo::ResourceState::RENDER_TARGET_DEPTH_STENCIL :
+            vireo::ResourceState::RENDER_TARGET_DEPTH} {
+        const auto& vireo = Application::getVireo();
+        // Depth values are positive floats, their bits patterns can be compared as unsigned integers
+        constexpr auto clearValue = Bounds{ .minDepth = std::numeric_limits<uint32>::max(), .maxDepth = 0 };
+        clearBoundsBuffer = vireo.createBuffer(vireo::BufferType::BUFFER_UPLOAD, sizeof(Bounds));
+        clearBoundsBuffer->map();
+        clearBoundsBuffer->write(&clearValue);
+        clearBoundsBuffer->unmap();
+        const auto global = Global{ .clearDepth = clearDepth };
+        globalBuffer = vireo.createBuffer(vireo::BufferType::UNIFORM, sizeof(Global), 1, DEBUG_NAME);
+        globalBuffer->map();
+        globalBuffer->write(&global);
+        globalBuffer->unmap();
+
+        descriptorLayout = vireo.createDescriptorLayout(DEBUG_NAME);
+        descriptorLayout->add(BINDING_DEPTH, vireo::DescriptorType::SAMPLED_IMAGE);
+        descriptorLayout->add(BINDING_BOUNDS, vireo::DescriptorType::READWRITE_STORAGE);
+        descriptorLayout->add(BINDING_GLOBAL, vireo::DescriptorType::UNIFORM);
+        descriptorLayout->build();
+
+        framesData.resize(config.framesInFlight);
+        for (auto& frame : framesData) {
+            frame.boundsBuffer = vireo.createBuffer(vireo::BufferType::READWRITE_STORAGE, sizeof(Bounds), 1, DEBUG_NAME);
+            frame.downloadBoundsBuffer = vireo.createBuffer(vireo::BufferType::BUFFER_DOWNLOAD, sizeof(Bounds), 1, DEBUG_NAME);
+            frame.downloadBoundsBuffer->map();
+            frame.descriptorSet = vireo.createDescriptorSet(descriptorLayout, DEBUG_NAME);
+            frame.descriptorSet->update(BINDING_BOUNDS, frame.boundsBuffer);
+            frame.descriptorSet->update(BINDING_GLOBAL, globalBuffer);
+        }
+
+        const auto pipelineResources = vireo.createPipelineResources(
+            { descriptorLayout },
+            {},
+            DEBUG_NAME);
+        const auto shader = ShaderModules::get(SHADER);
+        pipeline = vireo.createComputePipeline(pipelineResources, shader, DEBUG_NAME);
+    }
+
+    void DepthReduction::dispatch(
+        vireo::CommandList& commandList,
+        const std::shared_ptr<vireo::RenderTarget>& depthAttachment,
+        const uint32 frameIndex) {
+        auto& frame = framesData[frameIndex];
+        const auto& image = depthAttachment->getImage();
+        frame.descriptorSet->update(BINDING_DEPTH, image);
+
+        commandList.barrier(
+            *frame.boundsBuffer,
+            vireo::ResourceState::UNDEFINED,
+            vireo::ResourceState::COPY_DST);
+        commandList.copy(*clearBoundsBuffer, *frame.boundsBuffer);
+        commandList.barrier(
+            *frame.boundsBuffer,
+            vireo::ResourceState::COPY_DST,
+            vireo::ResourceState::COMPUTE_WRITE);
+        commandList.barrier(
+            depthAttachment,
+            depthStage,
+            vireo::ResourceState::SHADER_READ);
+
+        commandList.bindPipeline(pipeline);
+        commandList.bindDescriptors({ frame.descriptorSet });
+        commandList.dispatch(
+            (image->getWidth() + GROUP_SIZE - 1) / GROUP_SIZE,
+            (image->getHeight() + GROUP_SIZE - 1) / GROUP_SIZE,
+            1);
+
+        commandList.barrier(
+            depthAttachment,
+            vireo::ResourceState::SHADER_READ,
+            depthStage);
+        commandList.barrier(
+            *frame.boundsBuffer,
+            vireo::ResourceState::COMPUTE_WRITE,
+            vireo::ResourceState::COPY_SRC);
+        commandList.copy(*frame.boundsBuffer, *frame.downloadBoundsBuffer);
+        frame.dispatched = true;
+    }
+
+    bool DepthReduction::getDepthBounds(const uint32 frameIndex, float& minDepth, float& maxDepth) const {
+        const auto& frame = framesData[frameIndex];
+        if (!frame.dispatched) { return false; }
+        const auto bounds = *static_cast<const Bounds*>(frame.downloadBoundsBuffer->getMappedAddress());
+        if (bounds.minDepth > bounds.maxDepth) { return false; }
+        minDepth = std::bit_cast<float>(bounds.minDepth);
+        maxDepth = std::bit_cast<float>(bounds.maxDepth);
+        return true;
+    }
+
+}
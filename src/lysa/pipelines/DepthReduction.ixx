@@ -0,0 +1,80 @@
+/*
+* Copyright (c) 2025-present Henri Michelon
+*
+* This software is released under the MIT License.
+* https://opensource.org/licenses/MIT
+*/
+export module lysa.pipelines.depth_reduction;
+
+import vireo;
+import lysa.configuration;
+import lysa.types;
+
+export namespace lysa {
+
+    /**
+     * Reduces a depth buffer to its min/max values in a compute shader.
+     * Used by the sample distribution shadow maps to fit the cascades to the visible depth range.
+     * The results are read back by the CPU when the frame that produced them has been completed.
+     */
+    class DepthReduction {
+    public:
+        /**
+         * @param config        Rendering configuration
+         * @param clearDepth    Depth of the background pixels, ignored by the reduction
+         */
+        DepthReduction(const RenderingConfiguration& config, float clearDepth);
+
+        /**
+         * Records the reduction of the depth attachment.
+         * The depth attachment is expected in the depth rendering state and is restored after the dispatch.
+         */
+        void dispatch(
+            vireo::CommandList& commandList,
+            const std::shared_ptr<vireo::RenderTarget>& depthAttachment,
+            uint32 frameIndex);
+
+        /**
+         * Returns the non-linear depth bounds reduced the last time this frame in flight was rendered.
+         * Returns false if no result is available (first frames or nothing rendered).
+         * Must be called after the frame in flight fence has been signaled.
+         */
+        bool getDepthBounds(uint32 frameIndex, float& minDepth, float& maxDepth) const;
+
+        virtual ~DepthReduction() = default;
+        DepthReduction(DepthReduction&) = delete;
+        DepthReduction& operator=(DepthReduction&) = delete;
+
+    private:
+        static constexpr vireo::DescriptorIndex BINDING_DEPTH{0};
+        static constexpr vireo::DescriptorIndex BINDING_BOUNDS{1};
+        static constexpr vireo::DescriptorIndex BINDING_GLOBAL{2};
+        static constexpr uint32 GROUP_SIZE{16};
+
+        const std::string DEBUG_NAME{"DepthReduction"};
+        const std::string SHADER{"depth_reduction.comp"};
+
+        struct Global {
+            float clearDepth;
+        };
+
+        struct Bounds {
+            uint32 minDepth;
+            uint32 maxDepth;
+        };
+
+        struct FrameData {
+            bool dispatched{false};
+            std::shared_ptr<vireo::Buffer>        boundsBuffer;
+            std::shared_ptr<vireo::Buffer>        downloadBoundsBuffer;
+            std::shared_ptr<vireo::DescriptorSet> descriptorSet;
+        };
+
+        const vireo::ResourceState depthStage;
+        std::vector<FrameData>                   framesData;
+        std::shared_ptr<vireo::DescriptorLayout> descriptorLayout;
+        std::shared_ptr<vireo::Buffer>           clearBoundsBuffer;
+        std::shared_ptr<vireo::Buffer>           globalBuffer;
+        std::shared_ptr<vireo::Pipeline>         pipeline;
+    };
+}
@@ -8,7 +8,7 @@ module lysa.pipelines.frustum_culling;
 
 import lysa.application;
 import lysa.log;
-import lysa.virtual_fs;
+import lysa.shader_modules;
 
 namespace lysa {
     FrustumCulling::FrustumCulling(
@@ -26,6 +26,15 @@ namespace lysa {
         downloadCounterBuffer = vireo.createBuffer(vireo::BufferType::BUFFER_DOWNLOAD, sizeof(uint32));
         downloadCounterBuffer->map();
 
+        constexpr auto clearCounters = Counters{ .frustumCulled = 0 };
+        clearCountersBuffer = vireo.createBuffer(vireo::BufferType::BUFFER_UPLOAD, sizeof(Counters));
+        clearCountersBuffer->map();
+        clearCountersBuffer->write(&clearCounters);
+        clearCountersBuffer->unmap();
+        countersBuffer = vireo.createBuffer(vireo::BufferType::READWRITE_STORAGE, sizeof(Counters), 1, DEBUG_NAME);
+        downloadCountersBuffer = vireo.createBuffer(vireo::BufferType::BUFFER_DOWNLOAD, sizeof(Counters));
+        downloadCountersBuffer->map();
+
         descriptorLayout = vireo.createDescriptorLayout(DEBUG_NAME);
         descriptorLayout->add(BINDING_GLOBAL, vireo::DescriptorType::UNIFORM);
         descriptorLayout->add(BINDING_MESHINSTANCES, vireo::DescriptorType::DEVICE_STORAGE);
@@ -33,22 +42,19 @@ namespace lysa {
         descriptorLayout->add(BINDING_INPUT, vireo::DescriptorType::DEVICE_STORAGE);
         descriptorLayout->add(BINDING_OUTPUT, vireo::DescriptorType::READWRITE_STORAGE);
         descriptorLayout->add(BINDING_COUNTER, vireo::DescriptorType::READWRITE_STORAGE);
+        descriptorLayout->add(BINDING_STATISTICS, vireo::DescriptorType::READWRITE_STORAGE);
         descriptorLayout->build();
 
         descriptorSet = vireo.createDescriptorSet(descriptorLayout, DEBUG_NAME);
         descriptorSet->update(BINDING_GLOBAL, globalBuffer);
         descriptorSet->update(BINDING_MESHINSTANCES, meshInstancesArray.getBuffer());
+        descriptorSet->update(BINDING_STATISTICS, countersBuffer);
 
         const auto pipelineResources = vireo.createPipelineResources(
             { descriptorLayout },
             {},
             DEBUG_NAME);
-        auto tempBuffer = std::vector<char>{};
-        const auto& ext = vireo.getShaderFileExtension();
-        VirtualFS::loadBinaryData("app://" + Application::getConfiguration().shaderDir + "/" +
-            (isForScene ? SHADER_SCENE : SHADER_SHADOWMAP)
-            + ext, tempBuffer);
-        const auto shader = vireo.createShaderModule(tempBuffer);
+        const auto shader = ShaderModules::get(isForScene ? SHADER_SCENE : SHADER_SHADOWMAP);
         pipeline = vireo.createComputePipeline(pipelineResources, shader, DEBUG_NAME);
     }
 
@@ -60,7 +66,10 @@ namespace lysa {
         const vireo::Buffer& instances,
         const vireo::Buffer& input,
         const vireo::Buffer& output,
-        const vireo::Buffer& counter) {
+        const vireo::Buffer& counter,
+        const ShadowCasters shadowCasters) {
+        // The frame fence has been signaled : the results of the previous dispatch are available
+        readStatistics();
         commandList.barrier(
             counter,
             vireo::ResourceState::INDIRECT_DRAW,
@@ -70,11 +79,17 @@ namespace lysa {
             counter,
             vireo::ResourceState::COPY_DST,
             vireo::ResourceState::COMPUTE_WRITE);
-        if (drawCommandsCount == 0) { return; }
+        if (drawCommandsCount == 0) {
+            // Nothing to cull : the results are known without reading them back
+            statistics = {};
+            statisticsPending = false;
+            return;
+        }
 
         auto global = Global{
             .drawCommandsCount = drawCommandsCount,
             .viewMatrix = inverse(view),
+            .shadowCasters = shadowCasters,
         };
         Frustum::extractPlanes(global.planes, mul(global.viewMatrix, projection));
         globalBuffer->write(&global);
@@ -92,6 +107,15 @@ namespace lysa {
             output,
             vireo::ResourceState::INDIRECT_DRAW,
             vireo::ResourceState::COMPUTE_WRITE);
+        commandList.barrier(
+            *countersBuffer,
+            vireo::ResourceState::UNDEFINED,
+            vireo::ResourceState::COPY_DST);
+        commandList.copy(*clearCountersBuffer, *countersBuffer);
+        commandList.barrier(
+            *countersBuffer,
+            vireo::ResourceState::COPY_DST,
+            vireo::ResourceState::COMPUTE_WRITE);
         commandList.bindPipeline(pipeline);
         commandList.bindDescriptors({ descriptorSet });
         commandList.dispatch((drawCommandsCount + 63) / 64, 1, 1);
@@ -113,10 +137,20 @@ namespace lysa {
             counter,
             vireo::ResourceState::COPY_SRC,
             vireo::ResourceState::INDIRECT_DRAW);
+        commandList.barrier(
+            *countersBuffer,
+            vireo::ResourceState::COMPUTE_WRITE,
+            vireo::ResourceState::COPY_SRC);
+        commandList.copy(*countersBuffer, *downloadCountersBuffer);
+        statisticsPending = true;
     }
 
-    uint32 FrustumCulling::getDrawCommandsCount() const {
-        return *reinterpret_cast<uint32*>(downloadCounterBuffer->getMappedAddress());
+    void FrustumCulling::readStatistics() {
+        if (!statisticsPending) { return; }
+        const auto counters = *static_cast<const Counters*>(downloadCountersBuffer->getMappedAddress());
+        statistics.visibleInstances = *static_cast<const uint32*>(downloadCounterBuffer->getMappedAddress());
+        statistics.frustumCulled = counters.frustumCulled;
+        statisticsPending = false;
     }
 
 }
\ No newline at end of file
@@ -15,8 +15,38 @@ import lysa.types;
 import lysa.nodes.camera;
 
 export namespace lysa {
+
+    /** Culling results of the previous completed frame(s) */
+    struct CullingStatistics {
+        //! Number of instances drawn after culling
+        uint32 visibleInstances{0};
+        //! Number of instances rejected by the frustum test
+        uint32 frustumCulled{0};
+
+        CullingStatistics& operator+=(const CullingStatistics& other) {
+            visibleInstances += other.visibleInstances;
+            frustumCulled += other.frustumCulled;
+            return *this;
+        }
+    };
+
+    /**
+     * Frustum culling of the indirect draw commands in a compute shader.
+     * The results are copied to host memory by each dispatch and read back at the beginning
+     * of the next dispatch of the same instance. Since each frame in flight uses its own Scene
+     * (and its own culling pipelines), the previous dispatch is completed when the frame fence is
+     * signaled : the CPU never reads a counter that the GPU may still be writing.<br>
+     * The statistics therefore lag behind the last recorded dispatch by the number of frames in flight.
+     */
     class FrustumCulling {
     public:
+        /** Shadow casters selection used by the shadow maps culling */
+        enum class ShadowCasters : uint32 {
+            ALL     = 0,
+            STATIC  = 1,
+            DYNAMIC = 2,
+        };
+
         FrustumCulling(
             bool isForScene,
             const DeviceMemoryArray& meshInstancesArray);
@@ -29,9 +59,26 @@ export namespace lysa {
             const vireo::Buffer& instances,
             const vireo::Buffer& input,
             const vireo::Buffer& output,
-            const vireo::Buffer& counter);
+            const vireo::Buffer& counter,
+            ShadowCasters shadowCasters = ShadowCasters::ALL);
 
-        uint32 getDrawCommandsCount() const;
+        /**
+         * Returns the number of draw commands produced by the last completed dispatch,
+         * recorded the number of frames in flight ago
+         */
+        uint32 getDrawCommandsCount() const { return statistics.visibleInstances; }
+
+        /**
+         * Returns the culling statistics of the last completed dispatch,
+         * recorded the number of frames in flight ago
+         */
+        const auto& getStatistics() const { return statistics; }
+
+        /**
+         * Reads back the results of the last dispatch, once its frame fence is signaled.
+         * Called by dispatch(), must be called by the owner in the frames the pipeline is not dispatched.
+         */
+        void readStatistics();
 
         virtual ~FrustumCulling() = default;
         FrustumCulling(FrustumCulling&) = delete;
@@ -44,6 +91,7 @@ export namespace lysa {
         static constexpr vireo::DescriptorIndex BINDING_INPUT{3};
         static constexpr vireo::DescriptorIndex BINDING_OUTPUT{4};
         static constexpr vireo::DescriptorIndex BINDING_COUNTER{5};
+        static constexpr vireo::DescriptorIndex BINDING_STATISTICS{6};
 
         const std::string DEBUG_NAME{"FrustumCulling"};
         const std::string SHADER_SCENE{"frustum_culling.comp"};
@@ -53,13 +101,26 @@ export namespace lysa {
             uint32 drawCommandsCount;
             Frustum::Plane planes[6];
             float4x4 viewMatrix;
+            ShadowCasters shadowCasters;
         };
 
+        // Counters written by the shader, the visible instances count is the output buffer counter
+        struct Counters {
+            uint32 frustumCulled;
+        };
+
+        CullingStatistics statistics;
+        // True when a dispatch copied its results to the download buffers
+        bool statisticsPending{false};
+
         std::shared_ptr<vireo::DescriptorLayout> descriptorLayout;
         std::shared_ptr<vireo::DescriptorSet>    descriptorSet;
         std::shared_ptr<vireo::Buffer>           globalBuffer;
         std::shared_ptr<vireo::Buffer>           commandClearCounterBuffer;
         std::shared_ptr<vireo::Buffer>           downloadCounterBuffer;
+        std::shared_ptr<vireo::Buffer>           countersBuffer;
+        std::shared_ptr<vireo::Buffer>           clearCountersBuffer;
+        std::shared_ptr<vireo::Buffer>           downloadCountersBuffer;
         std::shared_ptr<vireo::Pipeline>         pipeline;
     };
 }
\ No newline at end of file
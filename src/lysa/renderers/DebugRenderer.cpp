@@ -19,7 +19,9 @@ module;
 module lysa.renderers.debug;
 
 import lysa.application;
+import lysa.shader_modules;
 import lysa.nodes.ray_cast;
+import lysa.resources.mesh;
 
 namespace lysa {
 
@@ -28,6 +30,264 @@ namespace lysa {
         const RenderingConfiguration& renderingConfiguration) :
         VectorRenderer{config.depthTestEnable, false, false, renderingConfiguration, "Debug Renderer"},
         config{config}{
+        const auto& vireo = Application::getVireo();
+        uploadMeshes();
+
+        shapesDescriptorLayout = vireo.createDescriptorLayout("Debug shapes");
+        shapesDescriptorLayout->add(BINDING_GLOBAL, vireo::DescriptorType::UNIFORM);
+        shapesDescriptorLayout->add(BINDING_INSTANCES, vireo::DescriptorType::DEVICE_STORAGE);
+        shapesDescriptorLayout->build();
+
+        constexpr auto drawCommandsSize = sizeof(DrawCommand) * DebugShapes::SHAPES_COUNT * DebugShapes::MODES_COUNT;
+        constexpr auto drawCommandsCountSize = sizeof(uint32) * DebugShapes::MODES_COUNT;
+        shapesFramesData.resize(renderingConfiguration.framesInFlight);
+        for (auto& frame : shapesFramesData) {
+            frame.globalUniform = vireo.createBuffer(vireo::BufferType::UNIFORM, sizeof(GlobalUniform), 1, "Debug shapes");
+            frame.globalUniform->map();
+            frame.descriptorSet = vireo.createDescriptorSet(shapesDescriptorLayout, "Debug shapes");
+            frame.descriptorSet->update(BINDING_GLOBAL, frame.globalUniform);
+            frame.drawCommandsStagingBuffer = vireo.createBuffer(vireo::BufferType::BUFFER_UPLOAD, drawCommandsSize);
+            frame.drawCommandsStagingBuffer->map();
+            frame.drawCommandsBuffer = vireo.createBuffer(vireo::BufferType::INDIRECT, drawCommandsSize, 1, "Debug shapes draw commands");
+            frame.drawCommandsCountStagingBuffer = vireo.createBuffer(vireo::BufferType::BUFFER_UPLOAD, drawCommandsCountSize);
+            frame.drawCommandsCountStagingBuffer->map();
+            frame.drawCommandsCountBuffer = vireo.createBuffer(vireo::BufferType::INDIRECT, drawCommandsCountSize, 1, "Debug shapes draw commands counter");
+        }
+
+        auto pipelineConfig = vireo::GraphicPipelineConfiguration {
+            .colorBlendDesc = {{ }},
+            .cullMode = vireo::CullMode::NONE,
+        };
+        pipelineConfig.colorRenderFormats.push_back(renderingConfiguration.swapChainFormat);
+        pipelineConfig.depthStencilImageFormat = renderingConfiguration.depthStencilFormat;
+        pipelineConfig.resources = vireo.createPipelineResources(
+            { shapesDescriptorLayout },
+            Scene::instanceIndexConstantDesc,
+            "Debug shapes");
+        pipelineConfig.vertexInputLayout = vireo.createVertexLayout(sizeof(VertexPositionData), VertexPositionData::vertexAttributes);
+        pipelineConfig.vertexShader = ShaderModules::get(std::string{SHAPES_SHADER} + ".vert");
+        pipelineConfig.fragmentShader = ShaderModules::get(std::string{SHAPES_SHADER} + ".frag");
+        pipelineConfig.polygonMode = vireo::PolygonMode::WIREFRAME;
+        pipelineConfig.primitiveTopology = vireo::PrimitiveTopology::LINE_LIST;
+        pipelineConfig.depthTestEnable = true;
+        pipelineConfig.depthWriteEnable = true;
+        shapesPipelines[static_cast<uint32>(DebugDrawMode::DEPTH_TESTED)] =
+            vireo.createGraphicPipeline(pipelineConfig, "Debug shapes");
+        pipelineConfig.depthTestEnable = false;
+        pipelineConfig.depthWriteEnable = false;
+        shapesPipelines[static_cast<uint32>(DebugDrawMode::OVERLAY)] =
+            vireo.createGraphicPipeline(pipelineConfig, "Debug shapes overlay");
+    }
+
+    void DebugRenderer::uploadMeshes() {
+        auto positions = std::vector<float3>{};
+        auto indices = std::vector<uint32>{};
+        DebugShapes::buildMeshes(positions, indices, meshesRanges);
+
+        // The unit meshes are stored with the scene meshes, for the lifetime of the application
+        auto& resources = Application::getResources();
+        meshesVerticesMemoryBlock = resources.allocVertices(positions.size());
+        meshesIndicesMemoryBlock = resources.getIndexArray().alloc(indices.size());
+        auto vertexData = std::vector<VertexData>(positions.size());
+        auto vertexPositionData = std::vector<VertexPositionData>(positions.size());
+        for (int i = 0; i < positions.size(); i++) {
+            const auto x = static_cast<float>(positions[i].x);
+            const auto y = static_cast<float>(positions[i].y);
+            const auto z = static_cast<float>(positions[i].z);
+            vertexData[i] = { .position = { x, y, z } };
+            vertexPositionData[i] = { .position = { x, y, z } };
+        }
+        resources.writeVertices(meshesVerticesMemoryBlock, vertexData.data(), vertexPositionData.data());
+        resources.getIndexArray().write(meshesIndicesMemoryBlock, indices.data());
+        resources.setUpdated();
+    }
+
+    void DebugRenderer::drawBox(
+        const float3& center,
+        const float3& halfExtents,
+        const quaternion& rotation,
+        const float4& color,
+        const float duration,
+        const DebugDrawMode mode) {
+        const auto transform = mul(mul(float4x4::scale(halfExtents), float4x4{rotation}), float4x4::translation(center));
+        shapes.add(DebugShape::BOX, transform, color, duration, mode);
+    }
+
+    void DebugRenderer::drawSphere(
+        const float3& center,
+        const float radius,
+        const float4& color,
+        const float duration,
+        const DebugDrawMode mode) {
+        const auto transform = mul(float4x4::scale(float3{radius}), float4x4::translation(center));
+        shapes.add(DebugShape::SPHERE, transform, color, duration, mode);
+    }
+
+    void DebugRenderer::drawCapsule(
+        const float3& center,
+        const float halfHeight,
+        const float radius,
+        const quaternion& rotation,
+        const float4& color,
+        const float duration,
+        const DebugDrawMode mode) {
+        const auto rm = float4x4{rotation};
+        const auto axis = mul(float4{0.0f, halfHeight, 0.0f, 0.0f}, rm).xyz;
+        shapes.add(
+            DebugShape::CYLINDER,
+            mul(mul(float4x4::scale(float3{radius, halfHeight, radius}), rm), float4x4::translation(center)),
+            color, duration, mode);
+        shapes.add(
+            DebugShape::HEMISPHERE,
+            mul(mul(float4x4::scale(float3{radius}), rm), float4x4::translation(center + axis)),
+            color, duration, mode);
+        // The bottom half sphere is the top one mirrored along the capsule axis
+        shapes.add(
+            DebugShape::HEMISPHERE,
+            mul(mul(float4x4::scale(float3{radius, -radius, radius}), rm), float4x4::translation(center - axis)),
+            color, duration, mode);
+    }
+
+    void DebugRenderer::drawArrow(
+        const float3& from,
+        const float3& to,
+        const float4& color,
+        const float duration,
+        const DebugDrawMode mode) {
+        const auto arrowLength = static_cast<float>(length(to - from));
+        if (arrowLength <= 0.0f) { return; }
+        // Orthonormal basis with the Y axis along the arrow
+        const auto y = (to - from) / arrowLength;
+        const auto reference = std::abs(static_cast<float>(y.y)) < 0.99f ? AXIS_Y : AXIS_X;
+        const auto x = normalize(cross(reference, y));
+        const auto z = cross(x, y);
+        const auto headLength = arrowLength * 0.2f;
+        const auto headRadius = headLength * 0.35f;
+        shapes.add(
+            DebugShape::SEGMENT,
+            float4x4{ float4{x, 0.0f}, float4{y * (arrowLength - headLength), 0.0f}, float4{z, 0.0f}, float4{from, 1.0f} },
+            color, duration, mode);
+        shapes.add(
+            DebugShape::CONE,
+            float4x4{ float4{x * headRadius, 0.0f}, float4{y * headLength, 0.0f}, float4{z * headRadius, 0.0f}, float4{to - y * headLength, 1.0f} },
+            color, duration, mode);
+    }
+
+    void DebugRenderer::restart(const float delta) {
+        VectorRenderer::restart();
+        shapes.expire(delta);
+    }
+
+    void DebugRenderer::update(const vireo::CommandList& commandList, const uint32 frameIndex) {
+        VectorRenderer::update(commandList, frameIndex);
+        auto& frame = shapesFramesData[frameIndex];
+        if (frame.shapesVersion == shapes.getVersion()) {
+            return;
+        }
+        const auto firstUpload = frame.shapesVersion == std::numeric_limits<uint64>::max();
+        frame.shapesVersion = shapes.getVersion();
+        frame.drawCommandsCount = {};
+        shapes.build(instances, batches);
+        if (instances.empty()) {
+            return;
+        }
+
+        const auto instanceCount = static_cast<uint32>(instances.size());
+        if (instanceCount > frame.instanceCapacity) {
+            // Grow the buffers by doubling their capacity. The previous buffers are not used
+            // by the GPU anymore since they belong to this frame
+            frame.instanceCapacity = std::max(frame.instanceCapacity, MIN_INSTANCE_CAPACITY);
+            while (frame.instanceCapacity < instanceCount) {
+                frame.instanceCapacity *= 2;
+            }
+            const auto& vireo = Application::getVireo();
+            frame.instancesStagingBuffer = vireo.createBuffer(vireo::BufferType::BUFFER_UPLOAD, sizeof(DebugShapes::Instance), frame.instanceCapacity, "Debug shapes staging");
+            frame.instancesStagingBuffer->map();
+            frame.instancesBuffer = vireo.createBuffer(vireo::BufferType::DEVICE_STORAGE, sizeof(DebugShapes::Instance), frame.instanceCapacity, "Debug shapes");
+            frame.descriptorSet->update(BINDING_INSTANCES, frame.instancesBuffer);
+        } else {
+            commandList.barrier(*frame.instancesBuffer, vireo::ResourceState::SHADER_READ, vireo::ResourceState::COPY_DST);
+        }
+        frame.instancesStagingBuffer->write(instances.data(), instances.size() * sizeof(DebugShapes::Instance));
+        commandList.copy(frame.instancesStagingBuffer, frame.instancesBuffer, instances.size() * sizeof(DebugShapes::Instance));
+        commandList.barrier(*frame.instancesBuffer, vireo::ResourceState::COPY_DST, vireo::ResourceState::SHADER_READ);
+
+        // One instanced draw per batch, the commands of each draw mode start at mode * SHAPES_COUNT
+        const auto& meshesIndices = meshesIndicesMemoryBlock.instanceIndex;
+        auto drawCommands = std::array<DrawCommand, DebugShapes::SHAPES_COUNT * DebugShapes::MODES_COUNT>{};
+        for (const auto& batch : batches) {
+            const auto mode = static_cast<uint32>(batch.mode);
+            const auto& range = meshesRanges[static_cast<uint32>(batch.shape)];
+            drawCommands[mode * DebugShapes::SHAPES_COUNT + frame.drawCommandsCount[mode]] = {
+                .instanceIndex = batch.firstInstance,
+                .command = {
+                    .indexCount = range.indexCount,
+                    .instanceCount = batch.instanceCount,
+                    .firstIndex = meshesIndices + range.firstIndex,
+                    .vertexOffset = static_cast<int32>(meshesVerticesMemoryBlock.instanceIndex),
+                    .firstInstance = batch.firstInstance,
+                }
+            };
+            frame.drawCommandsCount[mode]++;
+        }
+        if (!firstUpload) {
+            commandList.barrier(*frame.drawCommandsBuffer, vireo::ResourceState::INDIRECT_DRAW, vireo::ResourceState::COPY_DST);
+            commandList.barrier(*frame.drawCommandsCountBuffer, vireo::ResourceState::INDIRECT_DRAW, vireo::ResourceState::COPY_DST);
+        }
+        frame.drawCommandsStagingBuffer->write(drawCommands.data(), sizeof(drawCommands));
+        commandList.copy(frame.drawCommandsStagingBuffer, frame.drawCommandsBuffer, sizeof(drawCommands));
+        frame.drawCommandsCountStagingBuffer->write(frame.drawCommandsCount.data(), sizeof(frame.drawCommandsCount));
+        commandList.copy(frame.drawCommandsCountStagingBuffer, frame.drawCommandsCountBuffer, sizeof(frame.drawCommandsCount));
+        commandList.barrier(*frame.drawCommandsBuffer, vireo::ResourceState::COPY_DST, vireo::ResourceState::INDIRECT_DRAW);
+        commandList.barrier(*frame.drawCommandsCountBuffer, vireo::ResourceState::COPY_DST, vireo::ResourceState::INDIRECT_DRAW);
+    }
+
+    void DebugRenderer::render(
+        vireo::CommandList& commandList,
+        const Scene& scene,
+        const std::shared_ptr<vireo::RenderTarget>& colorAttachment,
+        const std::shared_ptr<vireo::RenderTarget>& depthAttachment,
+        const uint32 frameIndex) {
+        VectorRenderer::render(commandList, scene, colorAttachment, depthAttachment, frameIndex);
+        const auto& frame = shapesFramesData[frameIndex];
+        if (std::ranges::all_of(frame.drawCommandsCount, [](const uint32 count) { return count == 0; })) {
+            return;
+        }
+        const auto globalUbo = GlobalUniform {
+            .projection = scene.getCurrentCamera()->getProjection(),
+            .view = inverse(scene.getCurrentCamera()->getTransformGlobal()),
+        };
+        frame.globalUniform->write(&globalUbo, sizeof(GlobalUniform));
+        shapesRenderingConfig.colorRenderTargets[0].renderTarget = colorAttachment;
+        shapesRenderingConfig.depthStencilRenderTarget = depthAttachment;
+
+        const auto& resources = Application::getResources();
+        commandList.barrier(
+            colorAttachment,
+            vireo::ResourceState::UNDEFINED,
+            vireo::ResourceState::RENDER_TARGET_COLOR);
+        commandList.bindVertexBuffer(resources.getVertexPositionArray().getBuffer());
+        commandList.bindIndexBuffer(resources.getIndexArray().getBuffer());
+        commandList.beginRendering(shapesRenderingConfig);
+        // Overlay shapes are drawn last, over the depth-tested ones
+        for (auto mode = 0u; mode < DebugShapes::MODES_COUNT; mode++) {
+            if (frame.drawCommandsCount[mode] == 0) { continue; }
+            commandList.bindPipeline(shapesPipelines[mode]);
+            commandList.bindDescriptors({ frame.descriptorSet });
+            commandList.drawIndexedIndirectCount(
+                frame.drawCommandsBuffer,
+                mode * DebugShapes::SHAPES_COUNT * sizeof(DrawCommand),
+                frame.drawCommandsCountBuffer,
+                mode * sizeof(uint32),
+                DebugShapes::SHAPES_COUNT,
+                sizeof(DrawCommand),
+                sizeof(uint32));
+        }
+        commandList.endRendering();
+        commandList.barrier(
+            colorAttachment,
+            vireo::ResourceState::RENDER_TARGET_COLOR,
+            vireo::ResourceState::UNDEFINED);
     }
 
 #ifdef PHYSIC_ENGINE_JOLT
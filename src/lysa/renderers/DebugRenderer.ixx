@@ -27,12 +27,24 @@ import std;
 import vireo;
 import lysa.global;
 import lysa.configuration;
+import lysa.math;
+import lysa.memory;
 import lysa.scene;
+import lysa.types;
 import lysa.nodes.node;
+import lysa.renderers.debug_shapes;
 import lysa.renderers.vector;
 
 export namespace lysa {
 
+    /**
+     * Debug visualization renderer.
+     *  - Lines and triangles (physics engine debug, ray casts) are drawn by the VectorRenderer
+     *    and cleared by restart().
+     *  - Boxes, spheres, capsules and arrows are instances of unit wireframe meshes, kept for
+     *    a duration and drawn depth-tested or over the scene (see DebugShapes). All the shapes
+     *    of a draw mode are drawn with one multi-draw indirect call, one instanced draw per shape.
+     */
     class DebugRenderer : public VectorRenderer
 #ifdef PHYSIC_ENGINE_JOLT
         , public JPH::DebugRendererSimple
@@ -45,6 +57,70 @@ export namespace lysa {
 
         void drawRayCasts(const std::shared_ptr<Node>& scene, const float4& rayColor, const float4& collidingRayColor);
 
+        /**
+         * Adds a box
+         * @param halfExtents   Half size of the box along each axis
+         * @param duration      Duration in seconds, zero to draw the box only until the next restart()
+         */
+        void drawBox(
+            const float3& center,
+            const float3& halfExtents,
+            const quaternion& rotation,
+            const float4& color,
+            float duration = 0.0f,
+            DebugDrawMode mode = DebugDrawMode::DEPTH_TESTED);
+
+        /** Adds a sphere, see drawBox() for the duration */
+        void drawSphere(
+            const float3& center,
+            float radius,
+            const float4& color,
+            float duration = 0.0f,
+            DebugDrawMode mode = DebugDrawMode::DEPTH_TESTED);
+
+        /**
+         * Adds a capsule along its local Y axis, see drawBox() for the duration
+         * @param halfHeight    Half height of the cylinder between the two half spheres
+         */
+        void drawCapsule(
+            const float3& center,
+            float halfHeight,
+            float radius,
+            const quaternion& rotation,
+            const float4& color,
+            float duration = 0.0f,
+            DebugDrawMode mode = DebugDrawMode::DEPTH_TESTED);
+
+        /** Adds an arrow pointing to `to`, see drawBox() for the duration */
+        void drawArrow(
+            const float3& from,
+            const float3& to,
+            const float4& color,
+            float duration = 0.0f,
+            DebugDrawMode mode = DebugDrawMode::DEPTH_TESTED);
+
+        /**
+         * Clears the lines and triangles and removes the shapes whose duration is elapsed
+         * @param delta     Time elapsed since the last call, in seconds
+         */
+        void restart(float delta);
+
+        /** Removes all the shapes, whatever their duration */
+        void clearShapes() { shapes.clear(); }
+
+        const auto& getShapes() const { return shapes; }
+
+        void update(const vireo::CommandList& commandList, uint32 frameIndex) override;
+
+        using VectorRenderer::render;
+
+        void render(
+            vireo::CommandList& commandList,
+            const Scene& scene,
+            const std::shared_ptr<vireo::RenderTarget>& colorAttachment,
+            const std::shared_ptr<vireo::RenderTarget>& depthAttachment,
+            uint32 frameIndex) override;
+
         const auto& getConfiguration() const { return config; }
 
 #ifdef PHYSIC_ENGINE_JOLT
@@ -56,6 +132,46 @@ export namespace lysa {
 #endif
 
     private:
+        static constexpr vireo::DescriptorIndex BINDING_GLOBAL{0};
+        static constexpr vireo::DescriptorIndex BINDING_INSTANCES{1};
+        static constexpr auto SHAPES_SHADER{"debug_shapes"};
+        // Minimum number of instances of the instances buffers
+        static constexpr uint32 MIN_INSTANCE_CAPACITY{256};
+
+        struct ShapesFrameData {
+            std::shared_ptr<vireo::Buffer> globalUniform;
+            std::shared_ptr<vireo::DescriptorSet> descriptorSet;
+            // Number of instances the buffers can hold, the buffers are only recreated when they are too small
+            uint32 instanceCapacity{0};
+            std::shared_ptr<vireo::Buffer> instancesStagingBuffer;
+            std::shared_ptr<vireo::Buffer> instancesBuffer;
+            // Draw commands of each draw mode, SHAPES_COUNT commands per mode
+            std::shared_ptr<vireo::Buffer> drawCommandsStagingBuffer;
+            std::shared_ptr<vireo::Buffer> drawCommandsBuffer;
+            // Number of draw commands of each draw mode
+            std::shared_ptr<vireo::Buffer> drawCommandsCountStagingBuffer;
+            std::shared_ptr<vireo::Buffer> drawCommandsCountBuffer;
+            std::array<uint32, DebugShapes::MODES_COUNT> drawCommandsCount{};
+            // Version of the shapes uploaded in the buffers
+            uint64 shapesVersion{std::numeric_limits<uint64>::max()};
+        };
+
         const DebugConfig& config;
+        DebugShapes shapes;
+        // Unit meshes, in the global vertex & index arrays
+        MemoryBlock meshesVerticesMemoryBlock;
+        MemoryBlock meshesIndicesMemoryBlock;
+        std::array<DebugShapes::MeshRange, DebugShapes::SHAPES_COUNT> meshesRanges;
+        std::vector<ShapesFrameData> shapesFramesData;
+        std::shared_ptr<vireo::DescriptorLayout> shapesDescriptorLayout;
+        std::shared_ptr<vireo::GraphicPipeline> shapesPipelines[DebugShapes::MODES_COUNT];
+        vireo::RenderingConfiguration shapesRenderingConfig {
+            .colorRenderTargets = {{ }},
+        };
+        // Temporary lists used by update()
+        std::vector<DebugShapes::Instance> instances;
+        std::vector<DebugShapes::Batch> batches;
+
+        void uploadMeshes();
     };
 }
\ No newline at end of file
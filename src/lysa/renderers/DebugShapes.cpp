@@ -0,0 +1,168 @@
+/*
+* Copyright (c) 2025-present Henri Michelon
+*
+* This software is released under the MIT License.
+* https://opensource.org/licenses/MIT
+*/
+module lysa.renderers.debug_shapes;
+
+namespace lysa {
+
+    // Adds the lines of an arc of radius 1 in the plane (u, v)
+    static void addArc(
+        std::vector<float3>& positions,
+        std::vector<uint32>& indices,
+        const float3& center,
+        const float3& u,
+        const float3& v,
+        const float startAngle,
+        const float endAngle,
+        const uint32 segments) {
+        const auto first = static_cast<uint32>(positions.size());
+        for (auto i = 0u; i <= segments; i++) {
+            const auto angle = startAngle + (endAngle - startAngle) * static_cast<float>(i) / static_cast<float>(segments);
+            positions.push_back(center + u * std::cos(angle) + v * std::sin(angle));
+            if (i > 0) {
+                indices.push_back(first + i - 1);
+                indices.push_back(first + i);
+            }
+        }
+    }
+
+    static void addLine(
+        std::vector<float3>& positions,
+        std::vector<uint32>& indices,
+        const float3& from,
+        const float3& to) {
+        indices.push_back(static_cast<uint32>(positions.size()));
+        positions.push_back(from);
+        indices.push_back(static_cast<uint32>(positions.size()));
+        positions.push_back(to);
+    }
+
+    void DebugShapes::add(
+        const DebugShape shape,
+        const float4x4& transform,
+        const float4& color,
+        const float duration,
+        const DebugDrawMode mode) {
+        shapes.push_back({ shape, mode, duration, { transform, color } });
+        version++;
+    }
+
+    void DebugShapes::expire(const float delta) {
+        const auto count = shapes.size();
+        std::erase_if(shapes, [&](Entry& entry) {
+            entry.remaining -= delta;
+            return entry.remaining <= 0.0f;
+        });
+        if (shapes.size() != count) {
+            version++;
+        }
+    }
+
+    void DebugShapes::clear() {
+        if (!shapes.empty()) {
+            shapes.clear();
+            version++;
+        }
+    }
+
+    void DebugShapes::build(std::vector<Instance>& instances, std::vector<Batch>& batches) const {
+        // Counting sort by batch, the order of the shapes is kept inside a batch
+        auto offsets = std::array<uint32, MODES_COUNT * SHAPES_COUNT>{};
+        for (const auto& entry : shapes) {
+            offsets[getBatchIndex(entry.mode, entry.shape)]++;
+        }
+        batches.clear();
+        auto firstInstance = 0u;
+        for (auto batchIndex = 0u; batchIndex < offsets.size(); batchIndex++) {
+            const auto count = offsets[batchIndex];
+            if (count > 0) {
+                batches.push_back({
+                    .shape = static_cast<DebugShape>(batchIndex % SHAPES_COUNT),
+                    .mode = static_cast<DebugDrawMode>(batchIndex / SHAPES_COUNT),
+                    .firstInstance = firstInstance,
+                    .instanceCount = count,
+                });
+            }
+            offsets[batchIndex] = firstInstance;
+            firstInstance += count;
+        }
+        instances.resize(shapes.size());
+        for (const auto& entry : shapes) {
+            instances[offsets[getBatchIndex(entry.mode, entry.shape)]++] = entry.instance;
+        }
+    }
+
+    void DebugShapes::buildMeshes(
+        std::vector<float3>& positions,
+        std::vector<uint32>& indices,
+        std::array<MeshRange, SHAPES_COUNT>& ranges) {
+        const auto x = float3{1.0f, 0.0f, 0.0f};
+        const auto y = float3{0.0f, 1.0f, 0.0f};
+        const auto z = float3{0.0f, 0.0f, 1.0f};
+        constexpr auto pi = std::numbers::pi_v<float>;
+        const auto origin = float3{0.0f};
+        positions.clear();
+        indices.clear();
+        const auto beginShape = [&](const DebugShape shape) {
+            ranges[static_cast<uint32>(shape)].firstIndex = static_cast<uint32>(indices.size());
+        };
+        const auto endShape = [&](const DebugShape shape) {
+            auto& range = ranges[static_cast<uint32>(shape)];
+            range.indexCount = static_cast<uint32>(indices.size()) - range.firstIndex;
+        };
+
+        beginShape(DebugShape::BOX);
+        const auto first = static_cast<uint32>(positions.size());
+        for (auto corner = 0u; corner < 8; corner++) {
+            positions.push_back({
+                (corner & 1) ? 1.0f : -1.0f,
+                (corner & 2) ? 1.0f : -1.0f,
+                (corner & 4) ? 1.0f : -1.0f });
+        }
+        // Corners differing by one axis bit are linked by an edge
+        for (auto corner = 0u; corner < 8; corner++) {
+            for (const auto bit : { 1u, 2u, 4u }) {
+                if ((corner & bit) == 0) {
+                    indices.push_back(first + corner);
+                    indices.push_back(first + (corner | bit));
+                }
+            }
+        }
+        endShape(DebugShape::BOX);
+
+        beginShape(DebugShape::SPHERE);
+        addArc(positions, indices, origin, x, y, 0.0f, 2.0f * pi, CIRCLE_SEGMENTS);
+        addArc(positions, indices, origin, y, z, 0.0f, 2.0f * pi, CIRCLE_SEGMENTS);
+        addArc(positions, indices, origin, z, x, 0.0f, 2.0f * pi, CIRCLE_SEGMENTS);
+        endShape(DebugShape::SPHERE);
+
+        beginShape(DebugShape::HEMISPHERE);
+        addArc(positions, indices, origin, z, x, 0.0f, 2.0f * pi, CIRCLE_SEGMENTS);
+        addArc(positions, indices, origin, x, y, 0.0f, pi, CIRCLE_SEGMENTS / 2);
+        addArc(positions, indices, origin, z, y, 0.0f, pi, CIRCLE_SEGMENTS / 2);
+        endShape(DebugShape::HEMISPHERE);
+
+        beginShape(DebugShape::CYLINDER);
+        addArc(positions, indices, y, z, x, 0.0f, 2.0f * pi, CIRCLE_SEGMENTS);
+        addArc(positions, indices, -y, z, x, 0.0f, 2.0f * pi, CIRCLE_SEGMENTS);
+        for (const auto& side : { x, -x, z, -z }) {
+            addLine(positions, indices, side - y, side + y);
+        }
+        endShape(DebugShape::CYLINDER);
+
+        beginShape(DebugShape::CONE);
+        addArc(positions, indices, origin, z, x, 0.0f, 2.0f * pi, CIRCLE_SEGMENTS);
+        for (const auto& side : { x, -x, z, -z }) {
+            addLine(positions, indices, side, y);
+        }
+        endShape(DebugShape::CONE);
+
+        beginShape(DebugShape::SEGMENT);
+        addLine(positions, indices, origin, y);
+        endShape(DebugShape::SEGMENT);
+    }
+
+}
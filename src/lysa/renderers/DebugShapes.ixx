@@ -0,0 +1,124 @@
+/*
+* Copyright (c) 2025-present Henri Michelon
+*
+* This software is released under the MIT License.
+* https://opensource.org/licenses/MIT
+*/
+export module lysa.renderers.debug_shapes;
+
+import std;
+import lysa.math;
+import lysa.types;
+
+export namespace lysa {
+
+    /** Unit wireframe meshes instanced by the debug shapes */
+    enum class DebugShape : uint8 {
+        //! Cube from -1 to 1 on each axis
+        BOX,
+        //! Sphere of radius 1
+        SPHERE,
+        //! Upper half (y >= 0) of a sphere of radius 1
+        HEMISPHERE,
+        //! Cylinder of radius 1 along the Y axis, from -1 to 1
+        CYLINDER,
+        //! Cone along the Y axis with a base of radius 1 at 0 and the apex at 1
+        CONE,
+        //! Segment along the Y axis from 0 to 1
+        SEGMENT,
+    };
+
+    /** Depth testing of the debug shapes */
+    enum class DebugDrawMode : uint8 {
+        //! Hidden by the scene geometry
+        DEPTH_TESTED,
+        //! Drawn over the scene geometry
+        OVERLAY,
+    };
+
+    /**
+     * List of the debug shapes to draw, without any GPU dependency.
+     *  - Shapes are instances of unit wireframe meshes (see DebugShape) with a transform
+     *    and a color.
+     *  - Shapes are kept for a duration in seconds, a shape with a zero duration is
+     *    drawn once, until the next call of expire().
+     *  - build() sorts the instances by draw mode and shape : each batch of instances is
+     *    drawn with one instanced draw.
+     */
+    class DebugShapes {
+    public:
+        static constexpr uint32 SHAPES_COUNT{6};
+        static constexpr uint32 MODES_COUNT{2};
+
+        /** Instance data read by the shaders */
+        struct Instance {
+            float4x4 transform;
+            float4   color;
+        };
+
+        /** Instances of one shape with one draw mode, contiguous in the built instances */
+        struct Batch {
+            DebugShape    shape;
+            DebugDrawMode mode;
+            uint32        firstInstance;
+            uint32        instanceCount;
+        };
+
+        /** Range of a unit mesh in the built meshes */
+        struct MeshRange {
+            uint32 firstIndex;
+            uint32 indexCount;
+        };
+
+        /** Adds a shape */
+        void add(DebugShape shape, const float4x4& transform, const float4& color, float duration, DebugDrawMode mode);
+
+        /** Removes the shapes whose duration is elapsed */
+        void expire(float delta);
+
+        /** Removes all the shapes */
+        void clear();
+
+        /**
+         * Writes the instances sorted by draw mode then by shape, and the non-empty batches
+         * in the same order
+         */
+        void build(std::vector<Instance>& instances, std::vector<Batch>& batches) const;
+
+        auto getCount() const { return static_cast<uint32>(shapes.size()); }
+
+        /** Returns a number incremented each time the list changes */
+        auto getVersion() const { return version; }
+
+        /**
+         * Builds the line lists of the unit meshes, one after the other in DebugShape order
+         * @param positions     Vertices positions
+         * @param indices       Lines vertices indices, two per line
+         * @param ranges        Indices range of each shape
+         */
+        static void buildMeshes(
+            std::vector<float3>& positions,
+            std::vector<uint32>& indices,
+            std::array<MeshRange, SHAPES_COUNT>& ranges);
+
+    private:
+        // Number of segments of the circles
+        static constexpr uint32 CIRCLE_SEGMENTS{32};
+
+        struct Entry {
+            DebugShape    shape;
+            DebugDrawMode mode;
+            // Remaining duration in seconds
+            float         remaining;
+            Instance      instance;
+        };
+
+        std::vector<Entry> shapes;
+        uint64 version{0};
+
+        static uint32 getBatchIndex(const DebugDrawMode mode, const DebugShape shape) {
+            return static_cast<uint32>(mode) * SHAPES_COUNT + static_cast<uint32>(shape);
+        }
+    };
+
+}
@@ -41,6 +41,17 @@ namespace lysa {
         gBufferPass.updatePipelines(pipelineIds);
     }
 
+    void DeferredRenderer::reloadShaders(
+        const std::set<std::string>& shaderNames,
+        const std::unordered_map<pipeline_id, std::vector<std::shared_ptr<Material>>>& pipelineIds,
+        std::set<std::string>& reloadedShaders) {
+        Renderer::reloadShaders(shaderNames, pipelineIds, reloadedShaders);
+        if (gBufferPass.isUsingShaders(shaderNames, reloadedShaders)) { gBufferPass.reloadPipelines(pipelineIds); }
+        if (lightingPass.isUsingShaders(shaderNames, reloadedShaders)) { lightingPass.reloadPipelines(); }
+        if (config.ssaoEnabled && ssaoPass->isUsingShaders(shaderNames, reloadedShaders)) { ssaoPass->reloadPipelines(); }
+        if (config.ssaoEnabled && ssaoBlurPass->isUsingShaders(shaderNames, reloadedShaders)) { ssaoBlurPass->reloadPipelines(); }
+    }
+
     void DeferredRenderer::colorPass(
         vireo::CommandList& commandList,
         const Scene& scene,
@@ -45,6 +45,13 @@ export namespace lysa {
             const std::unordered_map<pipeline_id,
             std::vector<std::shared_ptr<Material>>>& pipelineIds) override;
 
+        /** Recreates the pipelines of the passes using one of the modified shaders. */
+        void reloadShaders(
+            const std::set<std::string>& shaderNames,
+            const std::unordered_map<pipeline_id,
+            std::vector<std::shared_ptr<Material>>>& pipelineIds,
+            std::set<std::string>& reloadedShaders) override;
+
         /** Recreates attachments/pipelines after a resize. */
         void resize(const vireo::Extent& extent, const std::shared_ptr<vireo::CommandList>& commandList) override;
 
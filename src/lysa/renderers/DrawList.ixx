@@ -0,0 +1,82 @@
+/*
+* Copyright (c) 2025-present Henri Michelon
+*
+* This software is released under the MIT License.
+* https://opensource.org/licenses/MIT
+*/
+export module lysa.renderers.draw_list;
+
+import std;
+import lysa.types;
+
+export namespace lysa {
+
+    /**
+     * Pipelines drawn by a pass, recorded in the pipelines id order.<br>
+     * All the pipelines of a pass share the same pipeline resources : the descriptor sets
+     * common to all the draws are bound once, with the first pipeline, then only the set
+     * of each pipeline is bound before its indirect draw.
+     *
+     * `Draw` provides `pipelineId`, `descriptorSet`, `drawCommandsCount`,
+     * `culledDrawCommandsBuffer` and `culledDrawCommandsCountBuffer`.
+     * The command list type is a template parameter of record(), the recording can be
+     * counted without a device.
+     */
+    template<typename Draw>
+    class DrawList {
+    public:
+        /** Removes all the draws, keeps the allocated memory */
+        void clear() { draws.clear(); }
+
+        /** Adds a pipeline to draw, the draws are sorted by sort() */
+        void add(const Draw& draw) { draws.push_back(&draw); }
+
+        /** Sorts the draws by pipeline id, the hash maps iteration order is not stable between frames */
+        void sort() { std::ranges::sort(draws, {}, &Draw::pipelineId); }
+
+        bool empty() const { return draws.empty(); }
+
+        auto getDrawsCount() const { return static_cast<uint32>(draws.size()); }
+
+        const auto& getDraws() const { return draws; }
+
+        /**
+         * Records the draws.
+         * @param commandList       Command list recording the draws
+         * @param pipelines         Graphic pipelines indexed by pipeline id
+         * @param bindSharedSets    Called with the first draw to bind all the descriptor sets
+         * @param pipelineSet       Index of the per-pipeline descriptor set
+         * @param stride            Size of one indirect draw command
+         */
+        template<typename CommandList, typename Pipelines, typename BindSharedSets>
+        void record(
+            CommandList& commandList,
+            const Pipelines& pipelines,
+            BindSharedSets&& bindSharedSets,
+            const uint32 pipelineSet,
+            const uint32 stride) const {
+            auto firstDraw{true};
+            for (const auto* draw : draws) {
+                commandList.bindPipeline(pipelines.at(draw->pipelineId));
+                if (firstDraw) {
+                    bindSharedSets(*draw);
+                    firstDraw = false;
+                } else {
+                    commandList.bindDescriptor(draw->descriptorSet, pipelineSet);
+                }
+                commandList.drawIndexedIndirectCount(
+                    draw->culledDrawCommandsBuffer,
+                    0,
+                    draw->culledDrawCommandsCountBuffer,
+                    0,
+                    draw->drawCommandsCount,
+                    stride,
+                    sizeof(uint32));
+            }
+        }
+
+    private:
+        std::vector<const Draw*> draws;
+    };
+
+}
@@ -28,6 +28,14 @@ namespace lysa {
         forwardColorPass.updatePipelines(pipelineIds);
     }
 
+    void ForwardRenderer::reloadShaders(
+        const std::set<std::string>& shaderNames,
+        const std::unordered_map<pipeline_id, std::vector<std::shared_ptr<Material>>>& pipelineIds,
+        std::set<std::string>& reloadedShaders) {
+        Renderer::reloadShaders(shaderNames, pipelineIds, reloadedShaders);
+        if (forwardColorPass.isUsingShaders(shaderNames, reloadedShaders)) { forwardColorPass.reloadPipelines(pipelineIds); }
+    }
+
     void ForwardRenderer::colorPass(
         vireo::CommandList& commandList,
         const Scene& scene,
@@ -43,6 +43,13 @@ export namespace lysa {
             const std::unordered_map<pipeline_id,
             std::vector<std::shared_ptr<Material>>>& pipelineIds) override;
 
+        /** Recreates the pipelines of the passes using one of the modified shaders. */
+        void reloadShaders(
+            const std::set<std::string>& shaderNames,
+            const std::unordered_map<pipeline_id,
+            std::vector<std::shared_ptr<Material>>>& pipelineIds,
+            std::set<std::string>& reloadedShaders) override;
+
         /** Returns the brightness buffer used for bloom extraction. */
         std::shared_ptr<vireo::RenderTarget> getBloomColorAttachment(const uint32 frameIndex) const override {
             return forwardColorPass.getBrightnessBuffer(frameIndex);
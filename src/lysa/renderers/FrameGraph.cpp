@@ -0,0 +1,190 @@
+/*
+* Copyright (c) 2025-present Henri Michelon
+*
+* This software is released under the MIT License.
+* https://opensource.org/licenses/MIT
+*/
+module lysa.renderers.frame_graph;
+
+import lysa.exception;
+
+namespace lysa {
+
+    FrameGraph::ResourceId FrameGraph::importResource(
+        const std::string& name,
+        const vireo::ResourceState initialState,
+        const vireo::ResourceState finalState) {
+        resources.push_back({
+            .name = name,
+            .imported = true,
+            .initialState = initialState,
+            .finalState = finalState,
+        });
+        return static_cast<ResourceId>(resources.size() - 1);
+    }
+
+    FrameGraph::ResourceId FrameGraph::createResource(const std::string& name, const vireo::ImageFormat format) {
+        resources.push_back({
+            .name = name,
+            .imported = false,
+            .format = format,
+        });
+        return static_cast<ResourceId>(resources.size() - 1);
+    }
+
+    FrameGraph::PassId FrameGraph::addPass(const std::string& name) {
+        passes.push_back({ .name = name });
+        return static_cast<PassId>(passes.size() - 1);
+    }
+
+    void FrameGraph::read(const PassId pass, const ResourceId resource, const vireo::ResourceState state) {
+        assert([&]{ return pass < passes.size() && resource < resources.size(); }, "Invalid frame graph pass or resource");
+        passes[pass].accesses.push_back({ resource, state, false });
+    }
+
+    void FrameGraph::write(const PassId pass, const ResourceId resource, const vireo::ResourceState state) {
+        assert([&]{ return pass < passes.size() && resource < resources.size(); }, "Invalid frame graph pass or resource");
+        passes[pass].accesses.push_back({ resource, state, true });
+    }
+
+    void FrameGraph::setOutput(const ResourceId resource, const vireo::ResourceState finalState) {
+        assert([&]{ return resource < resources.size(); }, "Invalid frame graph resource");
+        resources[resource].output = true;
+        resources[resource].finalState = finalState;
+    }
+
+    void FrameGraph::clear() {
+        passes.clear();
+        resources.clear();
+        physicalResources.clear();
+        finalBarriers.clear();
+    }
+
+    void FrameGraph::compile() {
+        cullPasses();
+        aliasResources();
+        computeBarriers();
+    }
+
+    void FrameGraph::cullPasses() {
+        // Walks the passes backward from the outputs : a pass is needed if it writes
+        // a resource read by a needed pass, an output or an imported resource
+        auto neededResources = std::vector<bool>(resources.size(), false);
+        for (auto resource = 0; resource < resources.size(); resource++) {
+            neededResources[resource] = resources[resource].output;
+        }
+        for (auto& pass : std::views::reverse(passes)) {
+            pass.culled = std::ranges::none_of(pass.accesses, [&](const Access& access) {
+                return access.write && (neededResources[access.resource] || resources[access.resource].imported);
+            });
+            if (!pass.culled) {
+                for (const auto& access : pass.accesses) {
+                    if (!access.write) { neededResources[access.resource] = true; }
+                }
+            }
+        }
+    }
+
+    void FrameGraph::aliasResources() {
+        // Lifetime of the transient resources, in passes indices
+        constexpr auto UNUSED = std::numeric_limits<uint32>::max();
+        auto firstUse = std::vector<uint32>(resources.size(), UNUSED);
+        auto lastUse = std::vector<uint32>(resources.size(), 0);
+        for (auto passIndex = 0u; passIndex < passes.size(); passIndex++) {
+            if (passes[passIndex].culled) { continue; }
+            for (const auto& access : passes[passIndex].accesses) {
+                if (firstUse[access.resource] == UNUSED) {
+                    assert([&]{ return access.write || resources[access.resource].imported; },
+                        "Transient frame graph resource read before being written");
+                    firstUse[access.resource] = passIndex;
+                }
+                lastUse[access.resource] = passIndex;
+            }
+        }
+        for (auto resource = 0; resource < resources.size(); resource++) {
+            if (resources[resource].output) {
+                // Used after the graph execution
+                lastUse[resource] = static_cast<uint32>(passes.size());
+            }
+        }
+
+        // Transient resources are assigned in order of first use to the first free
+        // physical resource of the same format
+        auto transientResources = std::vector<ResourceId>{};
+        for (auto resource = 0u; resource < resources.size(); resource++) {
+            resources[resource].physicalResource = NO_PHYSICAL_RESOURCE;
+            if (!resources[resource].imported && firstUse[resource] != UNUSED) {
+                transientResources.push_back(resource);
+            }
+        }
+        std::ranges::stable_sort(transientResources, {}, [&](const ResourceId resource) {
+            return firstUse[resource];
+        });
+        physicalResources.clear();
+        for (const auto resource : transientResources) {
+            auto& desc = resources[resource];
+            for (auto physical = 0u; physical < physicalResources.size(); physical++) {
+                if (physicalResources[physical].format == desc.format &&
+                    physicalResources[physical].lastUse < firstUse[resource]) {
+                    desc.physicalResource = physical;
+                    break;
+                }
+            }
+            if (desc.physicalResource == NO_PHYSICAL_RESOURCE) {
+                desc.physicalResource = static_cast<uint32>(physicalResources.size());
+                physicalResources.push_back({ desc.format, 0 });
+            }
+            physicalResources[desc.physicalResource].lastUse = lastUse[resource];
+        }
+    }
+
+    void FrameGraph::computeBarriers() {
+        // States are tracked per imported resource and per physical resource
+        auto importedStates = std::vector<vireo::ResourceState>(resources.size());
+        for (auto resource = 0; resource < resources.size(); resource++) {
+            importedStates[resource] = resources[resource].initialState;
+        }
+        auto physicalStates = std::vector<vireo::ResourceState>(physicalResources.size(), vireo::ResourceState::UNDEFINED);
+        // Last logical resource using each physical resource, for the final barriers
+        auto physicalUsers = std::vector<ResourceId>(physicalResources.size());
+        auto written = std::vector<bool>(resources.size(), false);
+
+        for (auto& pass : passes) {
+            pass.barriers.clear();
+            if (pass.culled) { continue; }
+            for (const auto& access : pass.accesses) {
+                const auto& resource = resources[access.resource];
+                auto& state = resource.imported ?
+                    importedStates[access.resource] :
+                    physicalStates[resource.physicalResource];
+                // The first write of a transient resource discards the content of the previous user
+                // of the physical resource
+                const auto before = !resource.imported && access.write && !written[access.resource] ?
+                    vireo::ResourceState::UNDEFINED :
+                    state;
+                if (before != access.state) {
+                    pass.barriers.push_back({ access.resource, before, access.state });
+                }
+                state = access.state;
+                if (access.write) { written[access.resource] = true; }
+                if (!resource.imported) { physicalUsers[resource.physicalResource] = access.resource; }
+            }
+        }
+
+        finalBarriers.clear();
+        for (auto resource = 0u; resource < resources.size(); resource++) {
+            if (resources[resource].imported && importedStates[resource] != resources[resource].finalState) {
+                finalBarriers.push_back({ resource, importedStates[resource], resources[resource].finalState });
+            }
+        }
+        for (auto physical = 0u; physical < physicalResources.size(); physical++) {
+            // An output is the last user of its physical resource since it is never aliased after its last write
+            const auto& user = resources[physicalUsers[physical]];
+            const auto finalState = user.output ? user.finalState : vireo::ResourceState::UNDEFINED;
+            if (physicalStates[physical] != finalState) {
+                finalBarriers.push_back({ physicalUsers[physical], physicalStates[physical], finalState });
+            }
+        }
+    }
+
+}
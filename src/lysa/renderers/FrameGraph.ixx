@@ -0,0 +1,146 @@
+/*
+* Copyright (c) 2025-present Henri Michelon
+*
+* This software is released under the MIT License.
+* https://opensource.org/licenses/MIT
+*/
+export module lysa.renderers.frame_graph;
+
+import std;
+import vireo;
+import lysa.types;
+
+export namespace lysa {
+
+    /**
+     * Declarative description of a chain of render passes, compiled without any GPU dependency.
+     *  - Passes are declared in execution order, with the resources they read and write
+     *    and the state they need them in.
+     *  - compile() culls the passes that do not contribute to an output (or to an imported
+     *    resource), computes the barriers needed before each pass and after the last one,
+     *    and assigns the transient resources to physical resources.
+     *  - Transient resources with the same format and disjoint lifetimes share the same
+     *    physical resource. Their content is undefined before their first write and after
+     *    the graph execution.
+     *  - Imported resources and outputs are brought to their final state after the last pass,
+     *    the other transient resources are left UNDEFINED.
+     *
+     * The caller owns the physical resources and records the passes and the barriers.
+     */
+    class FrameGraph {
+    public:
+        using ResourceId = uint32;
+        using PassId = uint32;
+
+        static constexpr uint32 NO_PHYSICAL_RESOURCE{std::numeric_limits<uint32>::max()};
+
+        /** A resource state transition */
+        struct Barrier {
+            ResourceId           resource;
+            vireo::ResourceState before;
+            vireo::ResourceState after;
+        };
+
+        /**
+         * Declares a resource created outside the graph
+         * @param initialState  State of the resource before the first pass
+         * @param finalState    State of the resource expected after the last pass
+         */
+        ResourceId importResource(
+            const std::string& name,
+            vireo::ResourceState initialState,
+            vireo::ResourceState finalState);
+
+        /** Declares a transient resource created by the caller from the compiled physical resources */
+        ResourceId createResource(const std::string& name, vireo::ImageFormat format);
+
+        /** Declares a pass, passes are executed in declaration order */
+        PassId addPass(const std::string& name);
+
+        /** Declares a resource read by a pass */
+        void read(PassId pass, ResourceId resource, vireo::ResourceState state = vireo::ResourceState::SHADER_READ);
+
+        /** Declares a resource written by a pass */
+        void write(PassId pass, ResourceId resource, vireo::ResourceState state = vireo::ResourceState::RENDER_TARGET_COLOR);
+
+        /**
+         * Marks a resource as used after the graph execution, the passes writing it are not culled
+         * and it is never aliased after its last write.
+         * @param finalState    State of the resource expected after the last pass
+         */
+        void setOutput(ResourceId resource, vireo::ResourceState finalState = vireo::ResourceState::SHADER_READ);
+
+        /** Culls the passes, computes the barriers and aliases the transient resources */
+        void compile();
+
+        /** Removes all the passes and resources */
+        void clear();
+
+        /** Returns true if the pass does not contribute to the outputs and must not be executed */
+        bool isCulled(const PassId pass) const { return passes[pass].culled; }
+
+        /** Returns the barriers to record before a pass */
+        const auto& getBarriers(const PassId pass) const { return passes[pass].barriers; }
+
+        /** Returns the barriers to record after the last pass */
+        const auto& getFinalBarriers() const { return finalBarriers; }
+
+        /**
+         * Returns the physical resource index of a transient resource,
+         * NO_PHYSICAL_RESOURCE for an imported or unused resource
+         */
+        uint32 getPhysicalResource(const ResourceId resource) const { return resources[resource].physicalResource; }
+
+        /** Returns the number of physical resources needed by the transient resources */
+        auto getPhysicalResourcesCount() const { return static_cast<uint32>(physicalResources.size()); }
+
+        /** Returns the format of a physical resource */
+        auto getPhysicalResourceFormat(const uint32 physicalResource) const { return physicalResources[physicalResource].format; }
+
+        auto getPassesCount() const { return static_cast<uint32>(passes.size()); }
+
+        auto getResourcesCount() const { return static_cast<uint32>(resources.size()); }
+
+    private:
+        struct Access {
+            ResourceId           resource;
+            vireo::ResourceState state;
+            bool                 write;
+        };
+
+        struct Pass {
+            std::string          name;
+            std::vector<Access>  accesses;
+            bool                 culled{false};
+            std::vector<Barrier> barriers;
+        };
+
+        struct Resource {
+            std::string          name;
+            bool                 imported;
+            vireo::ImageFormat   format{vireo::ImageFormat::R8G8B8A8_UNORM};
+            vireo::ResourceState initialState{vireo::ResourceState::UNDEFINED};
+            vireo::ResourceState finalState{vireo::ResourceState::UNDEFINED};
+            bool                 output{false};
+            uint32               physicalResource{NO_PHYSICAL_RESOURCE};
+        };
+
+        struct PhysicalResource {
+            vireo::ImageFormat format;
+            // Index of the last pass using the physical resource
+            uint32             lastUse;
+        };
+
+        std::vector<Pass> passes;
+        std::vector<Resource> resources;
+        std::vector<PhysicalResource> physicalResources;
+        std::vector<Barrier> finalBarriers;
+
+        void cullPasses();
+
+        void aliasResources();
+
+        void computeBarriers();
+    };
+
+}
@@ -0,0 +1,104 @@
+/*
+* Copyright (c) 2025-present Henri Michelon
+*
+* This software is released under the MIT License.
+* https://opensource.org/licenses/MIT
+*/
+export module lysa.renderers.growable_buffers;
+
+import std;
+import lysa.types;
+
+export namespace lysa {
+
+    /** GPU buffers statistics, cumulated since the creation of the buffers */
+    struct GrowableBuffersStatistics {
+        //! Bytes copied from the staging buffers to the GPU buffers
+        uint64 uploadedBytes{0};
+        //! Number of buffers (re)allocations
+        uint32 reallocations{0};
+    };
+
+    /**
+     * Buffers streamed from the CPU, one set of buffers per frame in flight.
+     *  - The buffers of a frame are only recreated when they are too small, their capacity
+     *    doubles until it can hold the elements.
+     *  - After invalidate(), each frame uploads the elements once, when it is reused : the buffers
+     *    of the other frames in flight are never written while the GPU reads them.
+     *
+     * The device is only accessed through the functions given to upload(), VectorRenderer
+     * uses a staging and a vertex buffer. `Buffers` is the set of buffers of a frame.
+     */
+    template<typename Buffers>
+    class GrowableBuffers {
+    public:
+        /**
+         * @param framesInFlight Number of frames in flight, one set of buffers per frame
+         * @param elementSize    Size of an element in bytes
+         * @param minCapacity    Minimum number of elements of the buffers
+         */
+        GrowableBuffers(const uint32 framesInFlight, const uint32 elementSize, const uint32 minCapacity) :
+            elementSize{elementSize},
+            minCapacity{minCapacity},
+            frames(framesInFlight) {}
+
+        /** The elements changed, the buffers of all the frames must be uploaded again */
+        void invalidate() {
+            for (auto& frame : frames) {
+                frame.dirty = true;
+            }
+        }
+
+        /**
+         * Uploads `count` elements in the buffers of a frame if they were invalidated since the last
+         * upload of this frame.<br>
+         * `create(capacity)` returns new buffers for `capacity` elements, called when the buffers are too small.<br>
+         * `upload(buffers, size, created)` copies the first `size` bytes, `created` is true for new buffers.<br>
+         * Returns true if the elements were uploaded.
+         */
+        template<typename Create, typename Upload>
+        bool upload(const uint32 frameIndex, const uint32 count, const Create& create, const Upload& upload) {
+            auto& frame = frames[frameIndex];
+            if (count == 0 || !frame.dirty) {
+                return false;
+            }
+            const auto created = count > frame.capacity;
+            if (created) {
+                // The previous buffers are not used by the GPU anymore since they belong to this frame
+                frame.capacity = std::max(frame.capacity, minCapacity);
+                while (frame.capacity < count) {
+                    frame.capacity *= 2;
+                }
+                frame.buffers = create(frame.capacity);
+                statistics.reallocations++;
+            }
+            const auto size = static_cast<uint64>(count) * elementSize;
+            upload(frame.buffers, size, created);
+            statistics.uploadedBytes += size;
+            frame.dirty = false;
+            return true;
+        }
+
+        /** Returns the buffers of a frame */
+        const Buffers& get(const uint32 frameIndex) const { return frames[frameIndex].buffers; }
+
+        /** Returns the number of elements the buffers of a frame can hold */
+        auto getCapacity(const uint32 frameIndex) const { return frames[frameIndex].capacity; }
+
+        const auto& getStatistics() const { return statistics; }
+
+    private:
+        struct Frame {
+            Buffers buffers{};
+            uint32 capacity{0};
+            // The buffers of this frame need to be uploaded
+            bool dirty{true};
+        };
+
+        const uint32 elementSize;
+        const uint32 minCapacity;
+        std::vector<Frame> frames;
+        GrowableBuffersStatistics statistics;
+    };
+
+}
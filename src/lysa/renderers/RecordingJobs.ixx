@@ -0,0 +1,86 @@
+/*
+* Copyright (c) 2025-present Henri Michelon
+*
+* This software is released under the MIT License.
+* https://opensource.org/licenses/MIT
+*/
+export module lysa.renderers.recording_jobs;
+
+import std;
+import lysa.exception;
+import lysa.job_system;
+import lysa.types;
+
+export namespace lysa {
+
+    /**
+     * Passes recorded in parallel by HIGH priority jobs, one command list per job.<br>
+     * The passes are spread evenly over the jobs by contiguous ranges so the command lists,
+     * submitted in the jobs order, keep the passes order.
+     *
+     * The recording function is a template parameter of start(), the jobs can record
+     * into command lists stubs without a device.
+     */
+    template<typename Pass>
+    class RecordingJobs {
+    public:
+        /**
+         * Starts the recording jobs
+         * @param jobSystem     Job system executing the jobs
+         * @param passesToRecord Passes to record, kept until finish()
+         * @param maxJobsCount  Maximum number of jobs, one per available command list
+         * @param record        Called by each job with the job index and its passes :
+         *                      `void(uint32 jobIndex, std::span<const Pass> passes)`
+         */
+        template<typename Record>
+        void start(
+            JobSystem& jobSystem,
+            std::vector<Pass>&& passesToRecord,
+            const uint32 maxJobsCount,
+            const Record& record) {
+            assert([&]{ return jobs.empty(); }, "Recording jobs already started");
+            passes = std::move(passesToRecord);
+            const auto jobsCount = std::min(maxJobsCount, static_cast<uint32>(passes.size()));
+            if (jobsCount == 0) { return; }
+            const auto passesCount = static_cast<uint32>(passes.size());
+            errors.assign(jobsCount, nullptr);
+            for (auto jobIndex = 0u; jobIndex < jobsCount; jobIndex++) {
+                // Ranges sizes differ by one pass at most, no job is left without passes
+                const auto first = jobIndex * passesCount / jobsCount;
+                const auto last = (jobIndex + 1) * passesCount / jobsCount;
+                jobs.push_back(jobSystem.schedule([this, jobIndex, first, last, record] {
+                    // Jobs must not throw, the exception is rethrown by finish()
+                    try {
+                        record(jobIndex, std::span<const Pass>{passes.begin() + first, passes.begin() + last});
+                    } catch (...) {
+                        errors[jobIndex] = std::current_exception();
+                    }
+                }, JobPriority::HIGH));
+            }
+        }
+
+        /**
+         * Waits for the jobs, the calling thread records the jobs not yet started by the workers.<br>
+         * Rethrows the first exception thrown by a job.
+         * @return the number of jobs started, the command lists of the jobs [0, count) are recorded
+         */
+        uint32 finish(JobSystem& jobSystem) {
+            jobSystem.wait(jobs);
+            const auto jobsCount = static_cast<uint32>(jobs.size());
+            jobs.clear();
+            passes.clear();
+            const auto error = std::ranges::find_if(errors, [](const auto& e) { return e != nullptr; });
+            const auto exception = error == errors.end() ? nullptr : *error;
+            errors.clear();
+            if (exception) { std::rethrow_exception(exception); }
+            return jobsCount;
+        }
+
+    private:
+        std::vector<Pass> passes;
+        std::vector<JobHandle> jobs;
+        // Exceptions thrown by the jobs, one per job
+        std::vector<std::exception_ptr> errors;
+    };
+
+}
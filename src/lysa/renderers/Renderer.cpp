@@ -68,7 +68,17 @@ namespace lysa {
             default:
                 break;
         }
+        if (config.sdsmEnabled && config.msaa == vireo::MSAA::NONE) {
+            depthReduction = std::make_unique<DepthReduction>(config, DEPTH_CLEAR_VALUE);
+        }
         framesData.resize(config.framesInFlight);
+        for (auto& frame : framesData) {
+            for (auto i = 0; i < std::max(1u, config.shadowMapsRecordingJobs); i++) {
+                const auto commandAllocator = Application::getVireo().createCommandAllocator(vireo::CommandType::GRAPHIC);
+                frame.shadowMapsCommandAllocators.push_back(commandAllocator);
+                frame.shadowMapsCommandLists.push_back(commandAllocator->createCommandList());
+            }
+        }
     }
 
     void Renderer::update(const uint32 frameIndex) {
@@ -93,30 +103,88 @@ namespace lysa {
         transparencyPass.updatePipelines(pipelineIds);
     }
 
+    void Renderer::reloadShaders(
+        const std::set<std::string>& shaderNames,
+        const std::unordered_map<pipeline_id, std::vector<std::shared_ptr<Material>>>& pipelineIds,
+        std::set<std::string>& reloadedShaders) {
+        if (depthPrePass.isUsingShaders(shaderNames, reloadedShaders)) { depthPrePass.reloadPipelines(pipelineIds); }
+        if (shaderMaterialPass.isUsingShaders(shaderNames, reloadedShaders)) { shaderMaterialPass.reloadPipelines(pipelineIds); }
+        if (transparencyPass.isUsingShaders(shaderNames, reloadedShaders)) { transparencyPass.reloadPipelines(pipelineIds); }
+        if (config.bloomEnabled && bloomBlurPass->isUsingShaders(shaderNames, reloadedShaders)) { bloomBlurPass->reloadPipelines(); }
+        for (const auto& postProcessingPass : postProcessingPasses) {
+            if (postProcessingPass->isUsingShaders(shaderNames, reloadedShaders)) { postProcessingPass->reloadPipelines(); }
+        }
+        if (smaaPass && smaaPass->isUsingShaders(shaderNames, reloadedShaders)) { smaaPass->reloadPipelines(); }
+    }
+
     void Renderer::compute(
        vireo::CommandList& commandList,
        Scene& scene,
        const uint32 frameIndex) const {
-        auto resourcesLock = std::lock_guard{Application::getResources().getMutex()};
+        auto resourcesLock = std::shared_lock{Application::getResources().getMutex()};
+        // The depth bounds of this frame in flight have been reduced by its previous use
+        float minDepth, maxDepth;
+        const auto depthBoundsValid = depthReduction && depthReduction->getDepthBounds(frameIndex, minDepth, maxDepth);
         for (const auto& shadowMapRenderer : scene.getShadowMapRenderers()) {
-            shadowMapRenderer->update(frameIndex);
+            const auto& shadowMapPass = static_pointer_cast<ShadowMapPass>(shadowMapRenderer);
+            if (depthBoundsValid) {
+                shadowMapPass->setDepthBounds(minDepth, maxDepth);
+            } else {
+                shadowMapPass->resetDepthBounds();
+            }
+            shadowMapPass->update(frameIndex);
         }
         scene.update(commandList);
         scene.compute(commandList);
     }
 
+    void Renderer::beginShadowMaps(
+        const std::vector<std::shared_ptr<Scene>>& scenes,
+        const uint32 frameIndex) {
+        auto& frame = framesData[frameIndex];
+        auto shadowMapPasses = std::vector<std::pair<const Scene*, std::shared_ptr<ShadowMapPass>>>{};
+        for (const auto& scene : scenes) {
+            for (const auto& shadowMapRenderer : scene->getShadowMapRenderers()) {
+                shadowMapPasses.push_back({scene.get(), static_pointer_cast<ShadowMapPass>(shadowMapRenderer)});
+            }
+        }
+        frame.shadowMapsJobs.start(
+            Application::getJobSystem(),
+            std::move(shadowMapPasses),
+            static_cast<uint32>(frame.shadowMapsCommandLists.size()),
+            [&frame](const uint32 jobIndex, const auto& passes) {
+                auto resourcesLock = std::shared_lock{Application::getResources().getMutex()};
+                frame.shadowMapsCommandAllocators[jobIndex]->reset();
+                auto& commandList = *frame.shadowMapsCommandLists[jobIndex];
+                commandList.begin();
+                commandList.bindVertexBuffer(Application::getResources().getVertexPositionArray().getBuffer());
+                commandList.bindIndexBuffer(Application::getResources().getIndexArray().getBuffer());
+                for (const auto& [scene, shadowMapPass] : passes) {
+                    shadowMapPass->render(commandList, *scene);
+                }
+                commandList.end();
+            });
+    }
+
+    std::vector<std::shared_ptr<vireo::CommandList>> Renderer::endShadowMaps(const uint32 frameIndex) {
+        auto& frame = framesData[frameIndex];
+        const auto jobsCount = frame.shadowMapsJobs.finish(Application::getJobSystem());
+        return {frame.shadowMapsCommandLists.begin(), frame.shadowMapsCommandLists.begin() + jobsCount};
+    }
+
     void Renderer::preRender(
         vireo::CommandList& commandList,
         const Scene& scene,
         const uint32 frameIndex) {
-        auto resourcesLock = std::lock_guard{Application::getResources().getMutex()};
-        commandList.bindVertexBuffer(Application::getResources().getVertexArray().getBuffer());
+        auto resourcesLock = std::shared_lock{Application::getResources().getMutex()};
+        // The depth pre-pass only reads the positions-only vertex stream
+        commandList.bindVertexBuffer(Application::getResources().getVertexPositionArray().getBuffer());
         commandList.bindIndexBuffer(Application::getResources().getIndexArray().getBuffer());
-        for (const auto& shadowMapRenderer : scene.getShadowMapRenderers()) {
-            static_pointer_cast<ShadowMapPass>(shadowMapRenderer)->render(commandList, scene);
-        }
         scene.setInitialState(commandList);
         depthPrePass.render(commandList, scene, framesData[frameIndex].depthAttachment);
+        if (depthReduction) {
+            depthReduction->dispatch(commandList, framesData[frameIndex].depthAttachment, frameIndex);
+        }
     }
 
     void Renderer::render(
@@ -124,7 +192,7 @@ namespace lysa {
         const Scene& scene,
         const bool clearAttachment,
         const uint32 frameIndex) {
-        auto resourcesLock = std::lock_guard{Application::getResources().getMutex()};
+        auto resourcesLock = std::shared_lock{Application::getResources().getMutex()};
         const auto& frame = framesData[frameIndex];
         commandList.bindVertexBuffer(Application::getResources().getVertexArray().getBuffer());
         commandList.bindIndexBuffer(Application::getResources().getIndexArray().getBuffer());
@@ -160,16 +228,22 @@ namespace lysa {
         }
         auto colorAttachment = frame.colorAttachment;
         if (!postProcessingPasses.empty()) {
-            const auto depthStage =
-               config.depthStencilFormat == vireo::ImageFormat::D32_SFLOAT_S8_UINT ||
-               config.depthStencilFormat == vireo::ImageFormat::D24_UNORM_S8_UINT   ?
-               vireo::ResourceState::RENDER_TARGET_DEPTH_STENCIL :
-               vireo::ResourceState::RENDER_TARGET_DEPTH;
-            commandList.barrier(
-               frame.depthAttachment,
-               depthStage,
-               vireo::ResourceState::SHADER_READ);
-            std::ranges::for_each(postProcessingPasses, [&](const auto& postProcessingPass) {
+            // The barriers of the chain are computed by the post-processing graph
+            const auto getAttachment = [&](const FrameGraph::ResourceId resource) {
+                if (resource == postProcessingColorResource) { return frame.colorAttachment; }
+                if (resource == postProcessingDepthResource) { return frame.depthAttachment; }
+                if (resource == postProcessingBloomResource) { return bloomColorAttachment; }
+                return frame.postProcessingAttachments[postProcessingGraph.getPhysicalResource(resource)];
+            };
+            const auto recordBarriers = [&](const std::vector<FrameGraph::Barrier>& barriers) {
+                for (const auto& barrier : barriers) {
+                    commandList.barrier(getAttachment(barrier.resource), barrier.before, barrier.after);
+                }
+            };
+            for (auto passIndex = 0; passIndex < postProcessingPasses.size(); passIndex++) {
+                if (postProcessingGraph.isCulled(passIndex)) { continue; }
+                recordBarriers(postProcessingGraph.getBarriers(passIndex));
+                const auto& postProcessingPass = postProcessingPasses[passIndex];
                 postProcessingPass->render(
                     frameIndex,
                     viewport,
@@ -179,17 +253,8 @@ namespace lysa {
                     bloomColorAttachment,
                     commandList);
                 colorAttachment = postProcessingPass->getColorAttachment(frameIndex);
-            });
-            commandList.barrier(
-               frame.depthAttachment,
-               vireo::ResourceState::SHADER_READ,
-               depthStage);
-            std::ranges::for_each(postProcessingPasses, [&](const auto& postProcessingPass) {
-                commandList.barrier(
-                    postProcessingPass->getColorAttachment(frameIndex),
-                    vireo::ResourceState::SHADER_READ,
-                    vireo::ResourceState::UNDEFINED);
-            });
+            }
+            recordBarriers(postProcessingGraph.getFinalBarriers());
         }
         if (smaaPass) {
             smaaPass->render(
@@ -238,7 +303,7 @@ namespace lysa {
                 config.depthStencilFormat,
                 extent.width, extent.height,
                 vireo::RenderTargetType::DEPTH,
-                { .depthStencil = { .depth = 1.0f, .stencil = 0 } },
+                { .depthStencil = { .depth = DEPTH_CLEAR_VALUE, .stencil = 0 } },
                 1,
                 config.msaa,
                 name + " DepthStencil");
@@ -260,6 +325,7 @@ namespace lysa {
         if (smaaPass) {
             smaaPass->resize(extent, commandList);
         }
+        createPostProcessingAttachments();
         for (const auto& postProcessingPass : postProcessingPasses) {
             postProcessingPass->resize(extent, commandList);
         }
@@ -298,14 +364,82 @@ namespace lysa {
             data,
             dataSize,
             fragShaderName);
-        postProcessingPass->resize(currentExtent, nullptr);
         postProcessingPasses.push_back(postProcessingPass);
+        updatePostProcessingGraph();
+        postProcessingPass->resize(currentExtent, nullptr);
     }
 
     void Renderer::removePostprocessing(const std::string& fragShaderName) {
         std::erase_if(postProcessingPasses, [&fragShaderName](const std::shared_ptr<PostProcessing>& item) {
             return item->getFragShaderName() == fragShaderName;
         });
+        updatePostProcessingGraph();
+    }
+
+    void Renderer::updatePostProcessingGraph() {
+        // Each pass reads the output of the previous one (or the color attachment),
+        // the depth & bloom buffers, and writes its own transient color attachment
+        const auto depthStage =
+           config.depthStencilFormat == vireo::ImageFormat::D32_SFLOAT_S8_UINT ||
+           config.depthStencilFormat == vireo::ImageFormat::D24_UNORM_S8_UINT   ?
+           vireo::ResourceState::RENDER_TARGET_DEPTH_STENCIL :
+           vireo::ResourceState::RENDER_TARGET_DEPTH;
+        postProcessingGraph.clear();
+        postProcessingColorResource = postProcessingGraph.importResource(
+            "Color",
+            vireo::ResourceState::SHADER_READ,
+            vireo::ResourceState::SHADER_READ);
+        postProcessingDepthResource = postProcessingGraph.importResource(
+            "Depth",
+            depthStage,
+            depthStage);
+        postProcessingBloomResource = postProcessingGraph.importResource(
+            "Bloom",
+            vireo::ResourceState::SHADER_READ,
+            vireo::ResourceState::SHADER_READ);
+        postProcessingResources.clear();
+        auto input = postProcessingColorResource;
+        for (const auto& postProcessingPass : postProcessingPasses) {
+            const auto pass = postProcessingGraph.addPass(postProcessingPass->getFragShaderName());
+            const auto output = postProcessingGraph.createResource(
+                postProcessingPass->getFragShaderName(),
+                postProcessingPass->getOutputFormat());
+            postProcessingGraph.read(pass, input);
+            postProcessingGraph.read(pass, postProcessingDepthResource);
+            postProcessingGraph.read(pass, postProcessingBloomResource);
+            postProcessingGraph.write(pass, output);
+            postProcessingResources.push_back(output);
+            input = output;
+        }
+        // Sampled by the SMAA pass or the window
+        postProcessingGraph.setOutput(input, vireo::ResourceState::SHADER_READ);
+        postProcessingGraph.compile();
+        createPostProcessingAttachments();
+    }
+
+    void Renderer::createPostProcessingAttachments() {
+        if (currentExtent.width == 0 || currentExtent.height == 0) { return; }
+        for (auto frameIndex = 0; frameIndex < framesData.size(); frameIndex++) {
+            auto& frame = framesData[frameIndex];
+            // Transient attachments with disjoint lifetimes share the same physical attachment
+            frame.postProcessingAttachments.clear();
+            for (auto physical = 0u; physical < postProcessingGraph.getPhysicalResourcesCount(); physical++) {
+                frame.postProcessingAttachments.push_back(Application::getVireo().createRenderTarget(
+                    postProcessingGraph.getPhysicalResourceFormat(physical),
+                    currentExtent.width, currentExtent.height,
+                    vireo::RenderTargetType::COLOR,
+                    {},
+                    1,
+                    config.msaa,
+                    name + " Post-processing " + std::to_string(physical)));
+            }
+            for (auto passIndex = 0; passIndex < postProcessingPasses.size(); passIndex++) {
+                const auto physical = postProcessingGraph.getPhysicalResource(postProcessingResources[passIndex]);
+                if (physical != FrameGraph::NO_PHYSICAL_RESOURCE) {
+                    postProcessingPasses[passIndex]->setColorAttachment(frameIndex, frame.postProcessingAttachments[physical]);
+                }
+            }
+        }
     }
 
 }
\ No newline at end of file
@@ -8,11 +8,15 @@ export module lysa.renderers.renderer;
 
 import vireo;
 import lysa.configuration;
+import lysa.job_system;
 import lysa.math;
 import lysa.samplers;
 import lysa.scene;
 import lysa.types;
 import lysa.resources.material;
+import lysa.pipelines.depth_reduction;
+import lysa.renderers.frame_graph;
+import lysa.renderers.recording_jobs;
 import lysa.renderers.renderpass.post_processing;
 import lysa.renderers.renderpass.depth_prepass;
 import lysa.renderers.renderpass.shader_material_pass;
@@ -37,10 +41,20 @@ export namespace lysa {
      */
     class Renderer {
     public:
-        /** Per-frame attachments owned by the renderer. */
+        /** Depth of the background, the depth attachment is cleared with it. */
+        static constexpr float DEPTH_CLEAR_VALUE{1.0f};
+
+        /** Per-frame attachments and shadow maps recording state owned by the renderer. */
         struct FrameData {
             std::shared_ptr<vireo::RenderTarget> colorAttachment;
             std::shared_ptr<vireo::RenderTarget> depthAttachment;
+            /** Physical color attachments of the post-processing frame graph. */
+            std::vector<std::shared_ptr<vireo::RenderTarget>> postProcessingAttachments;
+            /** One allocator & command list per shadow maps recording job. */
+            std::vector<std::shared_ptr<vireo::CommandAllocator>> shadowMapsCommandAllocators;
+            std::vector<std::shared_ptr<vireo::CommandList>> shadowMapsCommandLists;
+            /** Shadow maps recording jobs started by beginShadowMaps() */
+            RecordingJobs<std::pair<const Scene*, std::shared_ptr<ShadowMapPass>>> shadowMapsJobs;
         };
 
         /**
@@ -92,6 +106,19 @@ export namespace lysa {
          */
         virtual void updatePipelines(const std::unordered_map<pipeline_id, std::vector<std::shared_ptr<Material>>>& pipelineIds);
 
+        /**
+         * Recreates the pipelines of the passes using one of the modified shaders.
+         * Must be called at a frame boundary, with the GPU idle. A pass that fails to
+         * recreate its pipelines keeps the previous ones.
+         * @param shaderNames Names of the modified shaders.
+         * @param pipelineIds Map of pipeline family id to materials, for all the scenes drawn.
+         * @param reloadedShaders Receives the names of the modified shaders used by the reloaded passes.
+         */
+        virtual void reloadShaders(
+            const std::set<std::string>& shaderNames,
+            const std::unordered_map<pipeline_id, std::vector<std::shared_ptr<Material>>>& pipelineIds,
+            std::set<std::string>& reloadedShaders);
+
         /** Performs per-frame housekeeping (e.g., pass-local data updates). */
         virtual void update(uint32 frameIndex);
 
@@ -101,7 +128,21 @@ export namespace lysa {
             Scene& scene,
             uint32 frameIndex) const;
 
-        /** Pre-render stage: uploads, layout transitions, and shadow maps. */
+        /**
+         * Starts recording the shadow maps of the scenes in background jobs, each job recording
+         * its own command list. Must be followed by endShadowMaps() for the same frame.
+         */
+        void beginShadowMaps(
+            const std::vector<std::shared_ptr<Scene>>& scenes,
+            uint32 frameIndex);
+
+        /**
+         * Waits for the shadow maps recording jobs.
+         * Returns the recorded command lists, to be submitted before the pre-render command list.
+         */
+        std::vector<std::shared_ptr<vireo::CommandList>> endShadowMaps(uint32 frameIndex);
+
+        /** Pre-render stage: uploads, layout transitions, and depth pre-pass. */
         void preRender(
             vireo::CommandList& commandList,
             const Scene& scene,
@@ -187,8 +228,23 @@ export namespace lysa {
 
         BlurData bloomBlurData;
         std::unique_ptr<SMAAPass> smaaPass;
+        /** Depth range reduction used by the sample distribution shadow maps. */
+        std::unique_ptr<DepthReduction> depthReduction;
         std::unique_ptr<PostProcessing> bloomBlurPass;
         /** List of active post-processing passes applied after color pass. */
         std::vector<std::shared_ptr<PostProcessing>> postProcessingPasses;
+        /** Post-processing chain, one graph pass per post-processing pass, in the same order. */
+        FrameGraph postProcessingGraph;
+        FrameGraph::ResourceId postProcessingColorResource{0};
+        FrameGraph::ResourceId postProcessingDepthResource{0};
+        FrameGraph::ResourceId postProcessingBloomResource{0};
+        /** Output resource of each post-processing pass. */
+        std::vector<FrameGraph::ResourceId> postProcessingResources;
+
+        /** Rebuilds and compiles the post-processing graph after a change of the chain. */
+        void updatePostProcessingGraph();
+
+        /** Creates the physical attachments of the post-processing graph and assigns them to the passes. */
+        void createPostProcessingAttachments();
     };
 }
\ No newline at end of file
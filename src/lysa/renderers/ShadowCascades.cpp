@@ -0,0 +1,142 @@
+/*
+* Copyright (c) 2025-present Henri Michelon
+*
+* This software is released under the MIT License.
+* https://opensource.org/licenses/MIT
+*/
+module lysa.renderers.shadow_cascades;
+
+import lysa.constants;
+
+namespace lysa {
+
+    void fitShadowCascades(
+        const float4x4& cameraTransform,
+        const float4x4& cameraProjection,
+        const float nearClip,
+        const float farClip,
+        const float3& lightDirection,
+        const float splitLambda,
+        const std::optional<float2>& depthBounds,
+        const std::vector<uint32>& shadowMapSizes,
+        std::vector<ShadowCascade>& cascades) {
+        const auto cascadesCount = static_cast<uint32>(shadowMapSizes.size());
+        cascades.resize(cascadesCount);
+        const auto clipRange = farClip - nearClip;
+        auto minZ = nearClip;
+        auto maxZ = nearClip + clipRange;
+        if (depthBounds) {
+            // Sample distribution : fit the cascades on the visible depth range.
+            // The bounds are quantized to avoid cascades flickering on small depth changes
+            const auto quantum = clipRange / 64.0f;
+            const auto invProjection = inverse(cameraProjection);
+            const auto toViewDistance = [&](const float depth) {
+                const auto view = mul(float4(0.0f, 0.0f, depth, 1.0f), invProjection);
+                return std::abs(view.z / view.w);
+            };
+            // The nearest depth is the max depth with a reversed depth buffer
+            const auto distance1 = toViewDistance(depthBounds->x);
+            const auto distance2 = toViewDistance(depthBounds->y);
+            minZ = std::clamp(std::floor(std::min(distance1, distance2) / quantum) * quantum, nearClip, farClip);
+            maxZ = std::clamp(std::ceil(std::max(distance1, distance2) / quantum) * quantum, nearClip, farClip);
+            if (maxZ <= minZ) {
+                maxZ = std::min(minZ + quantum, farClip);
+                minZ = maxZ - quantum;
+            }
+        }
+        const auto range = maxZ - minZ;
+        const auto ratio = maxZ / minZ;
+
+        // Camera frustum corners in world space
+        const auto invCam = inverse(mul(inverse(cameraTransform), cameraProjection));
+        float3 cameraCorners[] = {
+            float3(-1.0f, 1.0f, -1.0f),
+            float3(1.0f, 1.0f, -1.0f),
+            float3(1.0f, -1.0f, -1.0f),
+            float3(-1.0f, -1.0f, -1.0f),
+
+            float3(-1.0f, 1.0f, 1.0f),
+            float3(1.0f, 1.0f, 1.0f),
+            float3(1.0f, -1.0f, 1.0f),
+            float3(-1.0f, -1.0f, 1.0f),
+        };
+        for (auto& corner : cameraCorners) {
+            const auto invCorner = mul(float4(corner, 1.0f), invCam);
+            corner = (invCorner / invCorner.w).xyz;
+        }
+
+        auto lastSplitDist = (minZ - nearClip) / clipRange;
+        for (auto cascadeIndex = 0u; cascadeIndex < cascadesCount; cascadeIndex++) {
+            // Split depth based on view camera frustum
+            const auto p = (cascadeIndex + 1) / static_cast<float>(cascadesCount);
+            const auto log = minZ * std::pow(ratio, p);
+            const auto uniform = minZ + range * p;
+            const auto d = splitLambda * (log - uniform) + uniform;
+            const auto splitDist = (d - nearClip) / clipRange;
+
+            // Adjust the coordinates of near and far planes for this specific cascade
+            float3 frustumCorners[8];
+            for (auto j = 0; j < 4; j++) {
+                const auto dist = cameraCorners[j + 4] - cameraCorners[j];
+                frustumCorners[j + 4] = cameraCorners[j] + (dist * splitDist);
+                frustumCorners[j]     = cameraCorners[j] + (dist * lastSplitDist);
+            }
+
+            // Frustum center for this cascade split, in world space
+            auto frustumCenter = FLOAT3ZERO;
+            for (auto j = 0; j < 8; j++) {
+                frustumCenter += frustumCorners[j];
+            }
+            frustumCenter /= 8.0f;
+
+            // Radius of the cascade split
+            auto radius = 0.0f;
+            for (auto j = 0; j < 8; j++) {
+                const float distance = length(frustumCorners[j] - frustumCenter);
+                radius = std::max(radius, distance);
+            }
+            radius = std::ceil(radius * 16.0f) / 16.0f;
+
+            // Snap the frustum center to the nearest texel grid
+            const auto shadowMapResolution = static_cast<float>(shadowMapSizes[cascadeIndex]);
+            const float worldUnitsPerTexel = (2.0f * radius) / shadowMapResolution;
+            frustumCenter.x = std::floor(frustumCenter.x / worldUnitsPerTexel) * worldUnitsPerTexel;
+            frustumCenter.y = std::floor(frustumCenter.y / worldUnitsPerTexel) * worldUnitsPerTexel;
+            frustumCenter.z = std::floor(frustumCenter.z / worldUnitsPerTexel) * worldUnitsPerTexel;
+
+            // Split the bounding box
+            const auto maxExtents = float3(radius);
+            const auto minExtents = -maxExtents;
+            const float depth = maxExtents.z - minExtents.z;
+
+            // View & projection matrices
+            const auto eye = frustumCenter - lightDirection * -minExtents.z ;
+            const auto viewMatrix = lookAt(eye, frustumCenter, AXIS_UP);
+            auto lightProjection = orthographic(
+                minExtents.x, maxExtents.x,
+                maxExtents.y, minExtents.y,
+                -depth, depth);
+
+            // https://stackoverflow.com/questions/33499053/cascaded-shadow-map-shimmering
+            // Create the rounding matrix by projecting the world-space origin and determining
+            // the fractional offset in texel space
+            const auto shadowMatrix = mul(viewMatrix, lightProjection);
+            const float4 shadowOrigin =
+                mul(float4(0, 0, 0, 1), shadowMatrix) * (shadowMapResolution * 0.5f);
+            const auto roundedOrigin = round(shadowOrigin);
+            auto roundOffset = roundedOrigin - shadowOrigin;
+            roundOffset = roundOffset * 2.0f / shadowMapResolution;
+            roundOffset.z = 0.0f;
+            roundOffset.w = 0.0f;
+            lightProjection[3] += roundOffset;
+
+            cascades[cascadeIndex] = {
+                .viewMatrix = viewMatrix,
+                .projection = lightProjection,
+                .splitDepth = nearClip + splitDist * clipRange,
+            };
+            lastSplitDist = splitDist;
+        }
+    }
+
+}
@@ -0,0 +1,54 @@
+/*
+* Copyright (c) 2025-present Henri Michelon
+*
+* This software is released under the MIT License.
+* https://opensource.org/licenses/MIT
+*/
+export module lysa.renderers.shadow_cascades;
+
+import std;
+import lysa.math;
+import lysa.types;
+
+export namespace lysa {
+
+    /** Light space matrices of one cascade of a directional light shadow map */
+    struct ShadowCascade {
+        //! Light view matrix
+        float4x4 viewMatrix;
+        //! Orthographic projection, rounded to the shadow map texels
+        float4x4 projection;
+        //! View distance of the far plane of the cascade
+        float    splitDepth;
+    };
+
+    /**
+     * Fits the cascades of a directional light on the camera frustum.<br>
+     * Based on the method presented in https://developer.nvidia.com/gpugems/GPUGems3/gpugems3_ch10.html
+     * The cascades are quantized to avoid shimmering and flickering when the camera moves :
+     *  - the visible depth range reduced on the GPU is rounded to 1/64 of the camera clip range,
+     *  - the radius of each cascade is rounded up to 1/16 of a world unit,
+     *  - the center of each cascade and its projection are snapped to the shadow map texels.
+     *
+     * @param cameraTransform   Global transform of the camera
+     * @param cameraProjection  Projection of the camera
+     * @param nearClip          Near distance of the camera
+     * @param farClip           Far distance of the camera
+     * @param lightDirection    Front vector of the light
+     * @param splitLambda       Blend between the uniform (0.0) and logarithmic (1.0) splits
+     * @param depthBounds       Non-linear depth range of the visible pixels, the whole clip range when empty
+     * @param shadowMapSizes    Width & height in texels of the shadow map of each cascade
+     * @param cascades          Computed cascades, one per shadow map size
+     */
+    void fitShadowCascades(
+        const float4x4& cameraTransform,
+        const float4x4& cameraProjection,
+        float nearClip,
+        float farClip,
+        const float3& lightDirection,
+        float splitLambda,
+        const std::optional<float2>& depthBounds,
+        const std::vector<uint32>& shadowMapSizes,
+        std::vector<ShadowCascade>& cascades);
+
+}
@@ -0,0 +1,108 @@
+/*
+* Copyright (c) 2025-present Henri Michelon
+*
+* This software is released under the MIT License.
+* https://opensource.org/licenses/MIT
+*/
+module lysa.renderers.shadow_map_budget;
+
+import lysa.exception;
+
+namespace lysa {
+
+    ShadowMapBudget::ShadowMapBudget(const uint32 size, const uint32 minTileSize):
+        size{roundUpPowerOfTwo(size)},
+        minTileSize{std::min(roundUpPowerOfTwo(minTileSize), roundUpPowerOfTwo(size))} {
+        levelsCount = std::countr_zero(this->size) - std::countr_zero(this->minTileSize) + 1;
+        nodes.resize(getLevelFirstNode(levelsCount), NodeState::FREE);
+    }
+
+    ShadowMapBudget::Tile ShadowMapBudget::allocate(const uint32 size) {
+        const auto tileSize = std::clamp(roundUpPowerOfTwo(size), minTileSize, this->size);
+        const auto targetLevel = std::countr_zero(this->size) - std::countr_zero(tileSize);
+        const auto node = allocate(0, 0, targetLevel);
+        if (node == INVALID_NODE) {
+            return {};
+        }
+        usedTexels += static_cast<uint64>(tileSize) * tileSize;
+
+        // Compute the tile position by walking up to the root
+        auto tile = Tile{ .size = tileSize, .node = node };
+        auto current = node;
+        auto level = targetLevel;
+        while (current != 0) {
+            const auto slot = (current - 1) % 4;
+            const auto levelTileSize = getLevelTileSize(level);
+            tile.x += (slot & 1) * levelTileSize;
+            tile.y += (slot >> 1) * levelTileSize;
+            current = getParent(current);
+            level -= 1;
+        }
+        return tile;
+    }
+
+    uint32 ShadowMapBudget::allocate(const uint32 node, const uint32 level, const uint32 targetLevel) {
+        if (nodes[node] == NodeState::USED) {
+            return INVALID_NODE;
+        }
+        if (level == targetLevel) {
+            if (nodes[node] == NodeState::FREE) {
+                nodes[node] = NodeState::USED;
+                return node;
+            }
+            return INVALID_NODE;
+        }
+        if (nodes[node] == NodeState::FREE) {
+            // The whole subtree is free : split it down to the requested level
+            nodes[node] = NodeState::SPLIT;
+            return allocate(getFirstChild(node), level + 1, targetLevel);
+        }
+        // Fill the already split quadrants first, then split a free one
+        for (const auto state : { NodeState::SPLIT, NodeState::FREE }) {
+            for (auto child = getFirstChild(node); child < getFirstChild(node) + 4; child++) {
+                if (nodes[child] == state) {
+                    const auto result = allocate(child, level + 1, targetLevel);
+                    if (result != INVALID_NODE) {
+                        return result;
+                    }
+                }
+            }
+        }
+        return INVALID_NODE;
+    }
+
+    void ShadowMapBudget::free(const Tile& tile) {
+        if (!tile.isValid()) { return; }
+        assert([&]{ return nodes[tile.node] == NodeState::USED; }, "Shadow map budget tile already released");
+        nodes[tile.node] = NodeState::FREE;
+        usedTexels -= static_cast<uint64>(tile.size) * tile.size;
+        // Merge the free siblings back into their parent
+        auto current = tile.node;
+        while (current != 0) {
+            const auto parent = getParent(current);
+            const auto firstChild = getFirstChild(parent);
+            for (auto child = firstChild; child < firstChild + 4; child++) {
+                if (nodes[child] != NodeState::FREE) {
+                    return;
+                }
+            }
+            nodes[parent] = NodeState::FREE;
+            current = parent;
+        }
+    }
+
+    void ShadowMapBudget::clear() {
+        std::ranges::fill(nodes, NodeState::FREE);
+        usedTexels = 0;
+    }
+
+    uint32 ShadowMapBudget::roundUpPowerOfTwo(const uint32 value) {
+        return std::bit_ceil(std::max(1u, value));
+    }
+
+    uint32 ShadowMapBudget::getLevelFirstNode(const uint32 level) {
+        // (4^level - 1) / 3
+        return static_cast<uint32>(((1ull << (2 * level)) - 1) / 3);
+    }
+
+}
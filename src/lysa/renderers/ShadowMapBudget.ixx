@@ -0,0 +1,100 @@
+/*
+* Copyright (c) 2025-present Henri Michelon
+*
+* This software is released under the MIT License.
+* https://opensource.org/licenses/MIT
+*/
+export module lysa.renderers.shadow_map_budget;
+
+import std;
+import lysa.types;
+
+export namespace lysa {
+
+    /**
+     * Quad-tree allocator for the shadow maps texels budget.<br>
+     * Only the texels are accounted for : each shadow map keeps its own render target sized
+     * by the allocated tile, the tiles are not packed into a shared render target.
+     *  - The budget is a square of `size` texels, recursively split in four quadrants
+     *    down to `minTileSize`.
+     *  - Tiles are square, power-of-two sized, and allocated best-fit : already split
+     *    nodes are filled before splitting a free one, to limit fragmentation.
+     *  - Freed tiles are merged back with their siblings.
+     *
+     * Thread-safety: calls are expected from the render thread only.
+     */
+    class ShadowMapBudget {
+    public:
+        static constexpr uint32 INVALID_NODE{std::numeric_limits<uint32>::max()};
+
+        /** %A square region of the budget */
+        struct Tile {
+            //! Left texel coordinate in the budget square
+            uint32 x{0};
+            //! Top texel coordinate in the budget square
+            uint32 y{0};
+            //! Width & height in texels
+            uint32 size{0};
+            //! Quad-tree node holding this tile
+            uint32 node{INVALID_NODE};
+
+            bool isValid() const { return node != INVALID_NODE; }
+        };
+
+        /**
+         * Creates a budget allocator
+         * @param size          Budget width & height in texels, rounded up to a power of two
+         * @param minTileSize   Smallest tile size in texels, rounded up to a power of two
+         */
+        ShadowMapBudget(uint32 size, uint32 minTileSize);
+
+        /**
+         * Allocates a tile of at least `size` texels (rounded up to a power of two
+         * and clamped to [minTileSize, budget size]).
+         * Returns an invalid tile if there is no room left for this size.
+         */
+        Tile allocate(uint32 size);
+
+        /** Releases a tile previously returned by allocate() */
+        void free(const Tile& tile);
+
+        /** Releases all the tiles */
+        void clear();
+
+        /** Returns the budget width & height in texels */
+        auto getSize() const { return size; }
+
+        /** Returns the smallest tile size in texels */
+        auto getMinTileSize() const { return minTileSize; }
+
+        /** Returns the number of texels currently allocated */
+        auto getUsedTexels() const { return usedTexels; }
+
+        /** Rounds up a value to the next power of two */
+        static uint32 roundUpPowerOfTwo(uint32 value);
+
+    private:
+        enum class NodeState : uint8 {
+            FREE,
+            SPLIT,
+            USED,
+        };
+
+        const uint32 size;
+        const uint32 minTileSize;
+        uint32 levelsCount;
+        uint64 usedTexels{0};
+        std::vector<NodeState> nodes;
+
+        uint32 allocate(uint32 node, uint32 level, uint32 targetLevel);
+
+        uint32 getLevelTileSize(const uint32 level) const { return size >> level; }
+
+        static uint32 getFirstChild(const uint32 node) { return node * 4 + 1; }
+
+        static uint32 getParent(const uint32 node) { return (node - 1) / 4; }
+
+        static uint32 getLevelFirstNode(uint32 level);
+    };
+
+}
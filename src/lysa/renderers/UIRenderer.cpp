@@ -4,11 +4,10 @@
 * This software is released under the MIT License.
 * https://opensource.org/licenses/MIT
 */
-module;
-#include <hb.h>
 module lysa.renderers.ui;
 
 import lysa.constants;
+import lysa.exception;
 
 namespace lysa {
 
@@ -26,6 +25,44 @@ namespace lysa {
             false} {
     }
 
+    void UIRenderer::beginGeometry(Geometry& geometry) {
+        assert([&]{ return currentGeometry == nullptr; }, "UIRenderer::endGeometry() not called");
+        currentGeometry = &geometry;
+        geometry.linesVertices.clear();
+        geometry.triangleVertices.clear();
+        geometry.glyphVertices.clear();
+        // The renderer vertices are kept in the geometry while drawing
+        std::swap(linesVertices, geometry.linesVertices);
+        std::swap(triangleVertices, geometry.triangleVertices);
+        std::swap(glyphVertices, geometry.glyphVertices);
+    }
+
+    void UIRenderer::endGeometry() {
+        assert([&]{ return currentGeometry != nullptr; }, "UIRenderer::beginGeometry() not called");
+        std::swap(linesVertices, currentGeometry->linesVertices);
+        std::swap(triangleVertices, currentGeometry->triangleVertices);
+        std::swap(glyphVertices, currentGeometry->glyphVertices);
+        currentGeometry = nullptr;
+    }
+
+    void UIRenderer::addGeometry(const Geometry& geometry, GeometryRange& range) {
+        range.lines = ui::appendVertices(linesVertices, geometry.linesVertices);
+        range.triangles = ui::appendVertices(triangleVertices, geometry.triangleVertices);
+        range.glyphs = ui::appendVertices(glyphVertices, geometry.glyphVertices);
+        vertexBufferDirty = true;
+    }
+
+    bool UIRenderer::updateGeometry(const Geometry& geometry, const GeometryRange& range) {
+        // A partial patch is replaced when the geometries are added again
+        if (!ui::patchVertices(linesVertices, geometry.linesVertices, range.lines) ||
+            !ui::patchVertices(triangleVertices, geometry.triangleVertices, range.triangles) ||
+            !ui::patchVertices(glyphVertices, geometry.glyphVertices, range.glyphs)) {
+            return false;
+        }
+        vertexBufferDirty = true;
+        return true;
+    }
+
     void UIRenderer::drawLine(const float2& start, const float2& end) {
         const auto scaledStart = (start + translate) / VECTOR_SCREEN_SIZE;
         const auto scaledEnd = (end + translate) / VECTOR_SCREEN_SIZE;
@@ -90,25 +127,18 @@ namespace lysa {
         const float fontScale,
         const float x,
         const float y) {
-        float2 pos  = (float2{x, y} + translate) / VECTOR_SCREEN_SIZE;
+        const float2 pos  = (float2{x, y} + translate) / VECTOR_SCREEN_SIZE;
         const auto scale = fontScale * font.getFontSize() / VECTOR_SCREEN_SIZE;
         const auto textureIndex = addTexture(font.getAtlas());
         const auto fontIndex = addFont(font);
         const auto innerColor = float4{penColor.rgb, std::max(0.0f, static_cast<float>(penColor.a - transparency))};
 
-        hb_buffer_t* hb_buffer = hb_buffer_create();
-        hb_buffer_add_utf8(hb_buffer, text.c_str(), -1, 0, -1);
-        hb_buffer_guess_segment_properties(hb_buffer);
-        hb_shape(font.getHarfBuzzFont(), hb_buffer, nullptr, 0);
-        unsigned int glyph_count;
-        hb_glyph_info_t* glyph_info = hb_buffer_get_glyph_infos(hb_buffer, &glyph_count);
-        for (unsigned int i = 0; i < glyph_count; i++) {
-            auto glyphInfo = font.getGlyphInfo(glyph_info[i].codepoint);
+        for (const auto& glyph : font.shape(text)->glyphs) {
             auto plane = Font::GlyphBounds{};
-            plane.left = scale * glyphInfo.planeBounds.left ;
-            plane.right = scale * glyphInfo.planeBounds.right;
-            plane.top = scale * glyphInfo.planeBounds.top;
-            plane.bottom = scale * glyphInfo.planeBounds.bottom;
+            plane.left = scale * glyph.bounds.left ;
+            plane.right = scale * glyph.bounds.right;
+            plane.top = scale * glyph.bounds.top;
+            plane.bottom = scale * glyph.bounds.bottom;
             /*
             * v1 ---- v3
             * |  \     |
@@ -119,15 +149,13 @@ namespace lysa {
             const float3 v1 = { pos.x + plane.left,  pos.y + plane.top, 0.0f };
             const float3 v2 = { pos.x + plane.right, pos.y + plane.bottom, 0.0f };
             const float3 v3 = { pos.x + plane.right, pos.y + plane.top, 0.0f };
-            glyphVertices.push_back({v0, {glyphInfo.uv0.x, glyphInfo.uv1.y}, innerColor, textureIndex, fontIndex});
-            glyphVertices.push_back({v1, {glyphInfo.uv0.x, glyphInfo.uv0.y}, innerColor, textureIndex, fontIndex});
-            glyphVertices.push_back({v2, {glyphInfo.uv1.x, glyphInfo.uv1.y}, innerColor, textureIndex, fontIndex});
-            glyphVertices.push_back({v1, {glyphInfo.uv0.x, glyphInfo.uv0.y}, innerColor, textureIndex, fontIndex});
-            glyphVertices.push_back({v3, {glyphInfo.uv1.x, glyphInfo.uv0.y}, innerColor, textureIndex, fontIndex});
-            glyphVertices.push_back({v2, {glyphInfo.uv1.x, glyphInfo.uv1.y}, innerColor, textureIndex, fontIndex});
-            pos.x += scale * glyphInfo.advance;
+            glyphVertices.push_back({v0, {glyph.uv0.x, glyph.uv1.y}, innerColor, textureIndex, fontIndex});
+            glyphVertices.push_back({v1, {glyph.uv0.x, glyph.uv0.y}, innerColor, textureIndex, fontIndex});
+            glyphVertices.push_back({v2, {glyph.uv1.x, glyph.uv1.y}, innerColor, textureIndex, fontIndex});
+            glyphVertices.push_back({v1, {glyph.uv0.x, glyph.uv0.y}, innerColor, textureIndex, fontIndex});
+            glyphVertices.push_back({v3, {glyph.uv1.x, glyph.uv0.y}, innerColor, textureIndex, fontIndex});
+            glyphVertices.push_back({v2, {glyph.uv1.x, glyph.uv1.y}, innerColor, textureIndex, fontIndex});
         }
-        hb_buffer_destroy(hb_buffer);
         vertexBufferDirty = true;
     }
 
@@ -15,13 +15,46 @@ import lysa.renderers.vector;
 import lysa.resources.font;
 import lysa.resources.image;
 import lysa.ui.rect;
+import lysa.ui.window_geometries;
 
 export namespace lysa {
 
     class UIRenderer : public VectorRenderer {
     public:
+        /** Vertices drawn by a UI window, kept between frames */
+        struct Geometry {
+            std::vector<Vertex> linesVertices;
+            std::vector<Vertex> triangleVertices;
+            std::vector<Vertex> glyphVertices;
+        };
+
+        /** Position of a Geometry in the vertices of the renderer */
+        struct GeometryRange {
+            ui::VerticesRange lines;
+            ui::VerticesRange triangles;
+            ui::VerticesRange glyphs;
+        };
+
         UIRenderer(const RenderingConfiguration& renderingConfiguration);
 
+        /**
+         * Redirects the next drawing commands into `geometry` (cleared first) until endGeometry().
+         * The vertices of the renderer are left untouched.
+         */
+        void beginGeometry(Geometry& geometry);
+
+        /** Ends the drawing commands started with beginGeometry() */
+        void endGeometry();
+
+        /** Appends the vertices of a geometry to the renderer vertices */
+        void addGeometry(const Geometry& geometry, GeometryRange& range);
+
+        /**
+         * Replaces in place the vertices of a geometry previously added with addGeometry().
+         * Returns false if the vertices count changed : the geometries must be added again.
+         */
+        bool updateGeometry(const Geometry& geometry, const GeometryRange& range);
+
         void resize(const vireo::Extent& extent);
 
         auto getAspectRatio() const { return vectorRatio; }
@@ -74,5 +107,7 @@ export namespace lysa {
 
         // float2 vectorExtent{};
         float vectorRatio{};
+        // Geometry being drawn between beginGeometry() and endGeometry()
+        Geometry* currentGeometry{nullptr};
     };
 }
\ No newline at end of file
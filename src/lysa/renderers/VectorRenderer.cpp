@@ -4,18 +4,40 @@
 * This software is released under the MIT License.
 * https://opensource.org/licenses/MIT
 */
-module;
-#include <hb.h>
 module lysa.renderers.vector;
 
 import lysa.application;
 import lysa.constants;
 import lysa.exception;
 import lysa.log;
-import lysa.virtual_fs;
+import lysa.resources.mesh;
+import lysa.shader_modules;
 
 namespace lysa {
 
+    // Packs a color in 4 x 8 bits unsigned normalized, R in the low bits
+    static uint32 packColor(const float4& color) {
+        const auto toUnorm = [](const float value) {
+            return static_cast<uint32>(std::round(std::clamp(value, 0.0f, 1.0f) * 255.0f));
+        };
+        return toUnorm(static_cast<float>(color.r)) |
+               (toUnorm(static_cast<float>(color.g)) << 8) |
+               (toUnorm(static_cast<float>(color.b)) << 16) |
+               (toUnorm(static_cast<float>(color.a)) << 24);
+    }
+
+    VectorRenderer::Vertex::Vertex(
+        const float3& position,
+        const float2& uv,
+        const float4& color,
+        const int32 textureIndex,
+        const int32 fontIndex) :
+        position{static_cast<float>(position.x), static_cast<float>(position.y), static_cast<float>(position.z)},
+        uv{VertexData::packUV(uv)},
+        color{packColor(color)},
+        indices{(static_cast<uint32>(textureIndex) & 0xffffu) | (static_cast<uint32>(fontIndex) << 16)} {
+    }
+
     VectorRenderer::VectorRenderer(
         const bool depthTestEnable,
         const bool enableAlphaBlending,
@@ -29,7 +51,8 @@ namespace lysa {
         config{renderingConfiguration},
         useTextures{useTextures},
         useCamera{useCamera},
-        name{name} {
+        name{name},
+        vertexBuffers{renderingConfiguration.framesInFlight, sizeof(Vertex), MIN_VERTEX_CAPACITY} {
         const auto& vireo = Application::getVireo();
 
         descriptorLayout = vireo.createDescriptorLayout(name);
@@ -43,6 +66,7 @@ namespace lysa {
 
         if (useTextures) {
             textures.resize(MAX_TEXTURES);
+            textureImages.resize(MAX_TEXTURES);
             descriptorLayout->add(texturesIndex, vireo::DescriptorType::SAMPLED_IMAGE, textures.size());
             blankImage = Application::getResources().getBlankImage();
             for (int i = 0; i < textures.size(); i++) {
@@ -70,7 +94,8 @@ namespace lysa {
                 frameData.descriptorSet->update(globalUniformIndex, frameData.globalUniform);
             }
             if (useTextures) {
-                frameData.descriptorSet->update(texturesIndex, textures);
+                frameData.textures = textures;
+                frameData.descriptorSet->update(texturesIndex, frameData.textures);
             }
         }
         renderingConfig.depthTestEnable = depthTestEnable;
@@ -81,12 +106,8 @@ namespace lysa {
         pipelineConfig.depthWriteEnable = depthTestEnable;
         pipelineConfig.colorRenderFormats.push_back(renderingConfiguration.swapChainFormat);
         pipelineConfig.vertexInputLayout = vireo.createVertexLayout(sizeof(Vertex), vertexAttributes);
-        auto tempBuffer = std::vector<char>{};
-        const auto& ext = vireo.getShaderFileExtension();
-        VirtualFS::loadBinaryData("app://" + Application::getConfiguration().shaderDir + "/" + shadersName + ".vert" + ext, tempBuffer);
-        pipelineConfig.vertexShader = vireo.createShaderModule(tempBuffer);
-        VirtualFS::loadBinaryData("app://" + Application::getConfiguration().shaderDir + "/" + shadersName + ".frag" + ext, tempBuffer);
-        pipelineConfig.fragmentShader = vireo.createShaderModule(tempBuffer);
+        pipelineConfig.vertexShader = ShaderModules::get(shadersName + ".vert");
+        pipelineConfig.fragmentShader = ShaderModules::get(shadersName + ".frag");
         pipelineConfig.resources = Application::getVireo().createPipelineResources(
            {
                descriptorLayout,
@@ -104,10 +125,8 @@ namespace lysa {
         pipelineConfig.primitiveTopology = vireo::PrimitiveTopology::TRIANGLE_LIST;
         pipelineTriangles = vireo.createGraphicPipeline(pipelineConfig, name + " triangles");
 
-        VirtualFS::loadBinaryData("app://" + Application::getConfiguration().shaderDir + "/" + glyphShadersName + ".vert" + ext, tempBuffer);
-        pipelineConfig.vertexShader = vireo.createShaderModule(tempBuffer);
-        VirtualFS::loadBinaryData("app://" + Application::getConfiguration().shaderDir + "/" + glyphShadersName + ".frag" + ext, tempBuffer);
-        pipelineConfig.fragmentShader = vireo.createShaderModule(tempBuffer);
+        pipelineConfig.vertexShader = ShaderModules::get(glyphShadersName + ".vert");
+        pipelineConfig.fragmentShader = ShaderModules::get(glyphShadersName + ".frag");
         pipelineConfig.polygonMode = vireo::PolygonMode::FILL;
         pipelineConfig.colorBlendDesc = glyphPipelineConfig.colorBlendDesc;
         pipelineGlyphs = vireo.createGraphicPipeline(pipelineConfig, name + " glyphs");
@@ -136,24 +155,16 @@ namespace lysa {
         assert([&]{ return useTextures; }, "Can't draw text without textures");
         auto textureIndex = addTexture(font.getAtlas());
         auto fontIndex = addFont(font);
-        auto pos = position;
-
-        hb_buffer_t* hb_buffer = hb_buffer_create();
-        hb_buffer_add_utf8(hb_buffer, text.c_str(), -1, 0, -1);
-        hb_buffer_guess_segment_properties(hb_buffer);
-        hb_shape(font.getHarfBuzzFont(), hb_buffer, nullptr, 0);
-        unsigned int glyph_count;
-        hb_glyph_info_t* glyph_info = hb_buffer_get_glyph_infos(hb_buffer, &glyph_count);
-        //hb_glyph_position_t* glyph_pos = hb_buffer_get_glyph_positions(hb_buffer, &glyph_count);
+        const auto& pos = position;
+        const auto shapedText = font.shape(text);
         const auto rm = float4x4{rotation};
 
-        for (unsigned int i = 0; i < glyph_count; i++) {
-            auto glyphInfo = font.getGlyphInfo(glyph_info[i].codepoint);
+        for (const auto& glyph : shapedText->glyphs) {
             auto plane = Font::GlyphBounds{};
-            plane.left = fontScale * (glyphInfo.planeBounds.left);
-            plane.right = fontScale * (glyphInfo.planeBounds.right);
-            plane.top = fontScale * (glyphInfo.planeBounds.top);
-            plane.bottom = fontScale * (glyphInfo.planeBounds.bottom);
+            plane.left = fontScale * (glyph.bounds.left);
+            plane.right = fontScale * (glyph.bounds.right);
+            plane.top = fontScale * (glyph.bounds.top);
+            plane.bottom = fontScale * (glyph.bounds.bottom);
             /*
             * v1 ---- v3
             * |  \     |
@@ -164,16 +175,13 @@ namespace lysa {
             const float3 v1 = mul({ pos.x + plane.left,  pos.y + plane.top, pos.z, 1.0f }, rm).xyz;
             const float3 v2 = mul({ pos.x + plane.right, pos.y + plane.bottom, pos.z, 1.0f }, rm).xyz;
             const float3 v3 = mul({ pos.x + plane.right, pos.y + plane.top, pos.z, 1.0f }, rm).xyz;
-            glyphVertices.push_back({v0, {glyphInfo.uv0.x, glyphInfo.uv1.y}, innerColor, textureIndex, fontIndex});
-            glyphVertices.push_back({v1, {glyphInfo.uv0.x, glyphInfo.uv0.y}, innerColor, textureIndex, fontIndex});
-            glyphVertices.push_back({v2, {glyphInfo.uv1.x, glyphInfo.uv1.y}, innerColor, textureIndex, fontIndex});
-            glyphVertices.push_back({v1, {glyphInfo.uv0.x, glyphInfo.uv0.y}, innerColor, textureIndex, fontIndex});
-            glyphVertices.push_back({v3, {glyphInfo.uv1.x, glyphInfo.uv0.y}, innerColor, textureIndex, fontIndex});
-            glyphVertices.push_back({v2, {glyphInfo.uv1.x, glyphInfo.uv1.y}, innerColor, textureIndex, fontIndex});
-            pos.x += fontScale * glyphInfo.advance;
+            glyphVertices.push_back({v0, {glyph.uv0.x, glyph.uv1.y}, innerColor, textureIndex, fontIndex});
+            glyphVertices.push_back({v1, {glyph.uv0.x, glyph.uv0.y}, innerColor, textureIndex, fontIndex});
+            glyphVertices.push_back({v2, {glyph.uv1.x, glyph.uv1.y}, innerColor, textureIndex, fontIndex});
+            glyphVertices.push_back({v1, {glyph.uv0.x, glyph.uv0.y}, innerColor, textureIndex, fontIndex});
+            glyphVertices.push_back({v3, {glyph.uv1.x, glyph.uv0.y}, innerColor, textureIndex, fontIndex});
+            glyphVertices.push_back({v2, {glyph.uv1.x, glyph.uv1.y}, innerColor, textureIndex, fontIndex});
         }
-
-        hb_buffer_destroy(hb_buffer);
         vertexBufferDirty = true;
     }
 
@@ -185,47 +193,56 @@ namespace lysa {
 
     void VectorRenderer::update(
         const vireo::CommandList& commandList,
-        const uint32) {
-        // Destroy the previous buffer when we are sure they aren't used by another frame
-        oldBuffers.clear();
-        const auto& vireo = Application::getVireo();
-        if (!linesVertices.empty() || !triangleVertices.empty() || !glyphVertices.empty()) {
-            // Resize the buffers only if needed by recreating them
-            if ((vertexBuffer == nullptr) ||
-                (vertexCount != (linesVertices.size() + triangleVertices.size() + glyphVertices.size()))) {
-                // Put the current buffers in the recycle bin since they are currently used
-                // and can't be destroyed now
-                oldBuffers.push_back(stagingBuffer);
-                oldBuffers.push_back(vertexBuffer);
-                // Allocate new buffers to change size
-                vertexCount = linesVertices.size() + triangleVertices.size() + glyphVertices.size();
-                stagingBuffer = vireo.createBuffer(vireo::BufferType::BUFFER_UPLOAD, sizeof(Vertex), vertexCount, name + " vertices staging");
-                stagingBuffer->map();
-                vertexBuffer = vireo.createBuffer(vireo::BufferType::VERTEX, sizeof(Vertex), vertexCount, name + " vertices");
-                // commandList.barrier(*vertexBuffer, vireo::ResourceState::UNDEFINED, vireo::ResourceState::COPY_DST);
+        const uint32 frameIndex) {
+        if (useTextures) {
+            updateTextures();
+            if (auto& frame = framesData[frameIndex]; frame.texturesDirty) {
+                frame.textures = textures;
+                frame.descriptorSet->update(texturesIndex, frame.textures);
+                frame.texturesDirty = false;
             }
-            if (vertexBufferDirty) {
+        }
+        if (vertexBufferDirty) {
+            // Each frame in flight has its own buffers, updated when the frame is reused
+            vertexBuffers.invalidate();
+            vertexBufferDirty = false;
+        }
+        vertexCount = static_cast<uint32>(linesVertices.size() + triangleVertices.size() + glyphVertices.size());
+        vertexBuffers.upload(
+            frameIndex,
+            vertexCount,
+            [&](const uint32 capacity) {
+                const auto& vireo = Application::getVireo();
+                auto buffers = VertexBuffers {
+                    .stagingBuffer = vireo.createBuffer(vireo::BufferType::BUFFER_UPLOAD, sizeof(Vertex), capacity, name + " vertices staging"),
+                    .vertexBuffer = vireo.createBuffer(vireo::BufferType::VERTEX, sizeof(Vertex), capacity, name + " vertices"),
+                };
+                buffers.stagingBuffer->map();
+                return buffers;
+            },
+            [&](const VertexBuffers& buffers, const uint64 size, const bool created) {
+                if (!created) {
+                    commandList.barrier(*buffers.vertexBuffer, vireo::ResourceState::VERTEX_INPUT, vireo::ResourceState::COPY_DST);
+                }
                 // Push new vertices data to GPU memory
                 if (!linesVertices.empty()) {
-                    stagingBuffer->write(linesVertices.data(), linesVertices.size() * sizeof(Vertex));
+                    buffers.stagingBuffer->write(linesVertices.data(), linesVertices.size() * sizeof(Vertex));
                 }
                 if (!triangleVertices.empty()) {
-                    stagingBuffer->write(
+                    buffers.stagingBuffer->write(
                         triangleVertices.data(),
                         triangleVertices.size() * sizeof(Vertex),
                         linesVertices.size() * sizeof(Vertex));
                 }
                 if (!glyphVertices.empty()) {
-                    stagingBuffer->write(
+                    buffers.stagingBuffer->write(
                         glyphVertices.data(),
                         glyphVertices.size() * sizeof(Vertex),
                         (linesVertices.size() + triangleVertices.size()) * sizeof(Vertex));
                 }
-                commandList.copy(stagingBuffer, vertexBuffer);
-                commandList.barrier(*vertexBuffer, vireo::ResourceState::COPY_DST, vireo::ResourceState::VERTEX_INPUT);
-                vertexBufferDirty = false;
-            }
-        }
+                commandList.copy(buffers.stagingBuffer, buffers.vertexBuffer, size);
+                commandList.barrier(*buffers.vertexBuffer, vireo::ResourceState::COPY_DST, vireo::ResourceState::VERTEX_INPUT);
+            });
     }
 
     void VectorRenderer::render(
@@ -261,7 +278,7 @@ namespace lysa {
             colorAttachment,
             vireo::ResourceState::UNDEFINED,
             vireo::ResourceState::RENDER_TARGET_COLOR);
-        commandList.bindVertexBuffer(vertexBuffer);
+        commandList.bindVertexBuffer(vertexBuffers.get(frameIndex).vertexBuffer);
         commandList.beginRendering(renderingConfig);
         if (!triangleVertices.empty()) {
             commandList.bindPipeline(pipelineTriangles);
@@ -292,16 +309,35 @@ namespace lysa {
         for (int index = 0; index < textures.size(); index++) {
             if (textures[index] == blankImage) {
                 textures[index] = texture->getImage();
+                textureImages[index] = texture;
                 texturesIndices[texture->getId()] = index;
-                for (const auto& frameData : framesData) {
-                    frameData.descriptorSet->update(texturesIndex, textures);
-                }
+                setTexturesDirty();
                 return index;
             }
         }
         throw Exception("Maximum images count reached for the vector renderer");
     }
 
+    void VectorRenderer::updateTextures() {
+        auto updated = false;
+        for (int index = 0; index < textureImages.size(); index++) {
+            const auto texture = textureImages[index].lock();
+            if (texture && texture->getImage() != textures[index]) {
+                textures[index] = texture->getImage();
+                updated = true;
+            }
+        }
+        if (updated) {
+            setTexturesDirty();
+        }
+    }
+
+    void VectorRenderer::setTexturesDirty() {
+        for (auto& frameData : framesData) {
+            frameData.texturesDirty = true;
+        }
+    }
+
     int32 VectorRenderer::addFont(const Font &font) {
         if (fontsIndices.contains(font.getId())) {
             return fontsIndices.at(font.getId());
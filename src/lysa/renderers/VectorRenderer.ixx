@@ -11,6 +11,7 @@ export module lysa.renderers.vector;
 import vireo;
 import lysa.configuration;
 import lysa.math;
+import lysa.renderers.growable_buffers;
 import lysa.scene;
 import lysa.types;
 import lysa.resources.font;
@@ -82,7 +83,7 @@ export namespace lysa {
         void restart();
 
         /** Uploads dirty vertex buffers and prepares descriptor sets. */
-        void update(
+        virtual void update(
             const vireo::CommandList& commandList,
             uint32 frameIndex);
 
@@ -94,7 +95,7 @@ export namespace lysa {
          * @param depthAttachment Target depth surface (may be null if no depth).
          * @param frameIndex      Index of the current frame in flight.
          */
-        void render(
+        virtual void render(
             vireo::CommandList& commandList,
             const Scene& scene,
             const std::shared_ptr<vireo::RenderTarget>& colorAttachment,
@@ -111,21 +112,37 @@ export namespace lysa {
             const std::shared_ptr<vireo::RenderTarget>& depthAttachment,
             uint32 frameIndex);
 
+        /** Vertex buffers statistics, cumulated since the creation of the renderer */
+        const auto& getStatistics() const { return vertexBuffers.getStatistics(); }
+
         virtual ~VectorRenderer() = default;
         VectorRenderer(VectorRenderer&) = delete;
         VectorRenderer& operator=(VectorRenderer&) = delete;
 
     protected:
+        struct GlobalUniform {
+            float4x4 projection{1.0f};
+            float4x4 view{1.0f};
+        };
+
+        /**
+         * Packed vertex (24 bytes) :
+         *  - position as 3 floats
+         *  - UV as 2 x half floats
+         *  - color as RGBA 4 x 8 bits unsigned normalized
+         *  - texture index in the low 16 bits, font index in the high 16 bits (-1 for none)
+         */
         struct Vertex {
-            alignas(16) float3 position;
-            alignas(16) float2 uv;
-            alignas(16) float4 color;
-            alignas(16) int textureIndex{-1};
-            alignas(16) int fontIndex{-1};
+            float  position[3];
+            uint32 uv;
+            uint32 color;
+            uint32 indices;
+
+            Vertex(const float3& position, const float2& uv, const float4& color, int32 textureIndex = -1, int32 fontIndex = -1);
         };
 
         const RenderingConfiguration& config;
-        // Vertex buffer needs to be re-uploaded to GPU
+        // Vertices modified since the last update, the buffers of all the frames need to be re-uploaded to GPU
         bool vertexBufferDirty{true};
         // All the vertices for lines
         std::vector<Vertex> linesVertices;
@@ -153,22 +170,30 @@ export namespace lysa {
         vireo::DescriptorIndex globalUniformIndex;
         vireo::DescriptorIndex texturesIndex;
 
-        struct GlobalUniform {
-            float4x4 projection{1.0f};
-            float4x4 view{1.0f};
-        };
+        // Minimum number of vertices of the vertex buffers
+        static constexpr uint32 MIN_VERTEX_CAPACITY{1024};
 
         struct FrameData {
             std::shared_ptr<vireo::Buffer> globalUniform;
             std::shared_ptr<vireo::DescriptorSet> descriptorSet;
+            // Textures written in the descriptor set, kept alive while the frame is in flight
+            std::vector<std::shared_ptr<vireo::Image>> textures;
+            // The textures changed since the descriptor set was written
+            bool texturesDirty{false};
+        };
+
+        struct VertexBuffers {
+            // Staging vertex buffer used when updating GPU memory
+            std::shared_ptr<vireo::Buffer> stagingBuffer;
+            // Vertex buffer in GPU memory
+            std::shared_ptr<vireo::Buffer> vertexBuffer;
         };
 
         const std::vector<vireo::VertexAttributeDesc> vertexAttributes{
             {"POSITION", vireo::AttributeFormat::R32G32B32_FLOAT, offsetof(Vertex, position)},
-            {"TEXCOORD", vireo::AttributeFormat::R32G32_FLOAT, offsetof(Vertex, uv)},
-            {"COLOR", vireo::AttributeFormat::R32G32B32A32_FLOAT, offsetof(Vertex, color)},
-            {"TEXTURE", vireo::AttributeFormat::R32_SINT, offsetof(Vertex, textureIndex)},
-            {"FONT", vireo::AttributeFormat::R32_SINT, offsetof(Vertex, fontIndex)},
+            {"TEXCOORD", vireo::AttributeFormat::R32_SINT, offsetof(Vertex, uv)},
+            {"COLOR", vireo::AttributeFormat::R32_SINT, offsetof(Vertex, color)},
+            {"INDICES", vireo::AttributeFormat::R32_SINT, offsetof(Vertex, indices)},
         };
 
         vireo::GraphicPipelineConfiguration pipelineConfig {
@@ -197,16 +222,14 @@ export namespace lysa {
         vireo::Extent currentExtent{};
         std::vector<FrameData> framesData;
 
-        // Number of vertices for the currently allocated buffers, used to check if we need to resize the buffers
+        // Vertex buffers of each frame in flight, only recreated when they are too small
+        GrowableBuffers<VertexBuffers> vertexBuffers;
+        // Number of vertices uploaded in the vertex buffers
         uint32 vertexCount{0};
-        // Staging vertex buffer used when updating GPU memory
-        std::shared_ptr<vireo::Buffer> stagingBuffer;
-        // Vertex buffer in GPU memory
-        std::shared_ptr<vireo::Buffer> vertexBuffer;
-        // Used when we need to postpone the buffer destruction when they are in use by another frame in flight
-        std::list<std::shared_ptr<vireo::Buffer>> oldBuffers;
 
         std::vector<std::shared_ptr<vireo::Image>> textures;
+        // Images of the textures, their GPU image can be replaced (streamed mip levels, glyphs atlas)
+        std::vector<std::weak_ptr<Image>> textureImages;
         // Indices of each image in the descriptor binding
         std::map<unique_id, int32> texturesIndices{};
 
@@ -220,5 +243,12 @@ export namespace lysa {
         std::shared_ptr<vireo::GraphicPipeline>  pipelineTriangles;
         std::shared_ptr<vireo::GraphicPipeline>  pipelineGlyphs;
         std::shared_ptr<vireo::DescriptorLayout> descriptorLayout;
+
+        // Marks the descriptor sets of the textures of all the frames to be written again
+        // when each frame is updated, the descriptor sets of the frames in flight are used by the GPU
+        void setTexturesDirty();
+
+        // Gets the new GPU images of the textures replaced since they were added
+        void updateTextures();
     };
 }
\ No newline at end of file
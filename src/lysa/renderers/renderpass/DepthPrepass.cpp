@@ -38,12 +38,19 @@ namespace lysa {
                 const auto& material = materials.at(0);
                 pipelineConfig.cullMode = material->getCullMode();
                 pipelineConfig.vertexShader = loadShader(VERTEX_SHADER);
-                pipelineConfig.vertexInputLayout = vireo.createVertexLayout(sizeof(VertexData), VertexData::vertexAttributes);
+                pipelineConfig.vertexInputLayout = vireo.createVertexLayout(sizeof(VertexPositionData), VertexPositionData::vertexAttributes);
                 pipelines[pipelineId] = vireo.createGraphicPipeline(pipelineConfig, name);
             }
         }
     }
 
+    void DepthPrepass::reloadPipelines(const std::unordered_map<pipeline_id, std::vector<std::shared_ptr<Material>>>& pipelineIds) {
+        reload(pipelines, [&] {
+            pipelines.clear();
+            updatePipelines(pipelineIds);
+        });
+    }
+
     void DepthPrepass::render(
             vireo::CommandList& commandList,
             const Scene& scene,
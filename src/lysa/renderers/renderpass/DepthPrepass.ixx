@@ -25,6 +25,8 @@ export namespace lysa {
 
         void updatePipelines(const std::unordered_map<pipeline_id, std::vector<std::shared_ptr<Material>>>& pipelineIds);
 
+        void reloadPipelines(const std::unordered_map<pipeline_id, std::vector<std::shared_ptr<Material>>>& pipelineIds);
+
     private:
         const std::string VERTEX_SHADER{"depth_prepass.vert"};
 
@@ -56,6 +56,13 @@ namespace lysa {
         }
     }
 
+    void ForwardColor::reloadPipelines(const std::unordered_map<pipeline_id, std::vector<std::shared_ptr<Material>>>& pipelineIds) {
+        reload(pipelines, [&] {
+            pipelines.clear();
+            updatePipelines(pipelineIds);
+        });
+    }
+
     void ForwardColor::render(
         vireo::CommandList& commandList,
         const Scene& scene,
@@ -45,6 +45,13 @@ namespace lysa {
         }
     }
 
+    void GBufferPass::reloadPipelines(const std::unordered_map<pipeline_id, std::vector<std::shared_ptr<Material>>>& pipelineIds) {
+        reload(pipelines, [&] {
+            pipelines.clear();
+            updatePipelines(pipelineIds);
+        });
+    }
+
     void GBufferPass::render(
         vireo::CommandList& commandList,
         const Scene& scene,
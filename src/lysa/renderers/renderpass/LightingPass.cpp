@@ -61,6 +61,14 @@ namespace lysa {
             1.0f};
     }
 
+    void LightingPass::reloadPipelines() {
+        reload(pipeline, [&] {
+            pipelineConfig.vertexShader = loadShader(VERTEX_SHADER);
+            pipelineConfig.fragmentShader = loadShader(config.bloomEnabled ? FRAGMENT_SHADER_BLOOM : FRAGMENT_SHADER);
+            pipeline = Application::getVireo().createGraphicPipeline(pipelineConfig, name);
+        });
+    }
+
     void LightingPass::render(
         vireo::CommandList& commandList,
         const Scene& scene,
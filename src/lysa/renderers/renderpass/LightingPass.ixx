@@ -31,6 +31,8 @@ export namespace lysa {
 
         void resize(const vireo::Extent& extent, const std::shared_ptr<vireo::CommandList>& commandList) override;
 
+        void reloadPipelines();
+
         auto getBrightnessBuffer(const uint32 frameIndex) const {
             return framesData[frameIndex].brightnessBuffer;
         }
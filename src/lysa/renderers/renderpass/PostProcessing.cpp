@@ -69,6 +69,14 @@ namespace lysa {
         }
     }
 
+    void PostProcessing::reloadPipelines() {
+        reload(pipeline, [&] {
+            pipelineConfig.vertexShader = loadShader(VERTEX_SHADER);
+            pipelineConfig.fragmentShader = loadShader(fragShaderName + ".frag");
+            pipeline = Application::getVireo().createGraphicPipeline(pipelineConfig, name);
+        });
+    }
+
     void PostProcessing::render(
         const uint32 frameIndex,
         const vireo::Viewport& viewport,
@@ -85,10 +93,12 @@ namespace lysa {
         frame.descriptorSet->update(BINDING_TEXTURES, textures);
 
         renderingConfig.colorRenderTargets[0].renderTarget = frame.colorAttachment;
-        commandList.barrier(
-            frame.colorAttachment,
-            vireo::ResourceState::UNDEFINED,
-            vireo::ResourceState::RENDER_TARGET_COLOR);
+        if (!externalColorAttachments) {
+            commandList.barrier(
+                frame.colorAttachment,
+                vireo::ResourceState::UNDEFINED,
+                vireo::ResourceState::RENDER_TARGET_COLOR);
+        }
         commandList.beginRendering(renderingConfig);
         commandList.setViewport(viewport);
         commandList.setScissors(scissor);
@@ -98,15 +108,25 @@ namespace lysa {
             Application::getResources().getSamplers().getDescriptorSet()});
         commandList.draw(3);
         commandList.endRendering();
-        commandList.barrier(
-            frame.colorAttachment,
-            vireo::ResourceState::RENDER_TARGET_COLOR,
-            vireo::ResourceState::SHADER_READ);
+        if (!externalColorAttachments) {
+            commandList.barrier(
+                frame.colorAttachment,
+                vireo::ResourceState::RENDER_TARGET_COLOR,
+                vireo::ResourceState::SHADER_READ);
+        }
+    }
+
+    void PostProcessing::setColorAttachment(const uint32 frameIndex, const std::shared_ptr<vireo::RenderTarget>& attachment) {
+        externalColorAttachments = true;
+        framesData[frameIndex].colorAttachment = attachment;
     }
 
     void PostProcessing::resize(const vireo::Extent& extent, const std::shared_ptr<vireo::CommandList>& commandList) {
         if (extent.width == 0 || extent.height == 0) { return; }
         for (auto& frame : framesData) {
+            frame.params.imageSize.x = extent.width;
+            frame.params.imageSize.y = extent.height;
+            if (externalColorAttachments) { continue; }
             frame.colorAttachment = Application::getVireo().createRenderTarget(
                 pipelineConfig.colorRenderFormats[0],
                 extent.width, extent.height,
@@ -115,8 +135,6 @@ namespace lysa {
                 1,
                 config.msaa,
                 name);
-            frame.params.imageSize.x = extent.width;
-            frame.params.imageSize.y = extent.height;
         }
     }
 
@@ -54,12 +54,22 @@ export namespace lysa {
 
         void resize(const vireo::Extent& extent, const std::shared_ptr<vireo::CommandList>& commandList) override;
 
+        void reloadPipelines();
+
         virtual std::shared_ptr<vireo::RenderTarget> getColorAttachment(const uint32 frameIndex) {
             return framesData[frameIndex].colorAttachment;
         }
 
+        /**
+         * Renders into an attachment owned by the caller instead of creating one on resize().
+         * The caller (the renderer frame graph) is then responsible for the attachment barriers.
+         */
+        void setColorAttachment(uint32 frameIndex, const std::shared_ptr<vireo::RenderTarget>& attachment);
+
         const auto& getFragShaderName() const { return fragShaderName; }
 
+        auto getOutputFormat() const { return pipelineConfig.colorRenderFormats[0]; }
+
     protected:
         struct FrameData {
             PostProcessingParams                  params;
@@ -77,6 +87,8 @@ export namespace lysa {
         };
 
         const std::string fragShaderName;
+        //! True when the color attachments and their barriers are managed by the caller
+        bool externalColorAttachments{false};
         void* data{nullptr};
         std::shared_ptr<vireo::Buffer> dataUniform{nullptr};
         std::vector<FrameData> framesData;
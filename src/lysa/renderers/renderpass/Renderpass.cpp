@@ -6,8 +6,7 @@
 */
 module lysa.renderers.renderpass;
 
-import lysa.application;
-import lysa.virtual_fs;
+import lysa.shader_modules;
 
 namespace lysa {
 
@@ -19,10 +18,13 @@ namespace lysa {
     }
 
     std::shared_ptr<vireo::ShaderModule> Renderpass::loadShader(const std::string& shaderName) const {
-        const auto& vireo = Application::getVireo();
-        auto tempBuffer = std::vector<char>{};
-        const auto& ext = vireo.getShaderFileExtension();
-        VirtualFS::loadBinaryData("app://" + Application::getConfiguration().shaderDir + "/" + shaderName + ext, tempBuffer);
-        return vireo.createShaderModule(tempBuffer);
+        shaderDependencies.add(shaderName);
+        return ShaderModules::get(shaderName);
+    }
+
+    bool Renderpass::isUsingShaders(
+        const std::set<std::string>& shaderNames,
+        std::set<std::string>& reloadedShaders) const {
+        return shaderDependencies.isUsing(shaderNames, reloadedShaders);
     }
 }
\ No newline at end of file
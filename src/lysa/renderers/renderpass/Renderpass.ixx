@@ -10,6 +10,7 @@ import std;
 import vireo;
 import lysa.types;
 import lysa.configuration;
+import lysa.shader_module_cache;
 
 export namespace lysa {
     /**
@@ -41,6 +42,12 @@ export namespace lysa {
         /** Update any per-frame state (default: no-op). */
         virtual void update(uint32 frameIndex) { }
 
+        /**
+         * Returns true if the pass loaded one of the shaders (used by the shaders hot-reload).
+         * The shaders loaded by the pass are added to `reloadedShaders`.
+         */
+        bool isUsingShaders(const std::set<std::string>& shaderNames, std::set<std::string>& reloadedShaders) const;
+
         virtual ~Renderpass() = default;
         Renderpass(Renderpass&) = delete;
         Renderpass& operator=(Renderpass&) = delete;
@@ -53,5 +60,18 @@ export namespace lysa {
 
         /** Utility to load a shader module by name (backend-agnostic). */
         std::shared_ptr<vireo::ShaderModule> loadShader(const std::string& shaderName) const;
+
+        /**
+         * Recreates the pipelines stored in `pipelines` by calling `create`.
+         * If the creation fails (e.g. a shader being edited), the previous pipelines are restored.
+         */
+        template<typename T>
+        void reload(T& pipelines, const std::function<void()>& create) const {
+            reloadOrKeep(name, pipelines, create);
+        }
+
+    private:
+        /** Names of the shaders loaded by the pass. */
+        mutable ShaderDependencies shaderDependencies;
     };
 }
\ No newline at end of file
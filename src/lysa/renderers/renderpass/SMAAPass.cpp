@@ -40,24 +40,39 @@ namespace lysa {
             descriptorLayout,
             Application::getResources().getSamplers().getDescriptorLayout()},
         {}, name);
+        createPipelines();
+
+        framesData.resize(config.framesInFlight);
+        for (auto& frame : framesData) {
+            frame.descriptorSet = vireo.createDescriptorSet(descriptorLayout);
+            frame.descriptorSet->update(PostProcessing::BINDING_PARAMS, paramsBuffer);
+            frame.descriptorSet->update(PostProcessing::BINDING_DATA, dataBuffer);
+        }
+    }
+
+    void SMAAPass::createPipelines() {
+        const auto& vireo = Application::getVireo();
         pipelineConfig.vertexShader = loadShader(PostProcessing::VERTEX_SHADER);
 
+        // The pipelines are replaced once all are created, a failure keeps the previous ones
+        pipelineConfig.colorRenderFormats[0] = WEIGHTS_FORMAT;
         pipelineConfig.fragmentShader = loadShader(EDGE_DETECT_FRAGMENT_SHADER);
-        edgeDetectPipeline = vireo.createGraphicPipeline(pipelineConfig, name);
+        const auto edgeDetect = vireo.createGraphicPipeline(pipelineConfig, name);
 
         pipelineConfig.fragmentShader = loadShader(BLEND_WEIGHT_FRAGMENT_SHADER);
-        blendWeightPipeline = vireo.createGraphicPipeline(pipelineConfig);
+        const auto blendWeight = vireo.createGraphicPipeline(pipelineConfig);
 
         pipelineConfig.colorRenderFormats[0] = config.swapChainFormat;
         pipelineConfig.fragmentShader = loadShader(BLEND_FRAGMENT_SHADER);
-        blendPipeline = vireo.createGraphicPipeline(pipelineConfig);
+        const auto blend = vireo.createGraphicPipeline(pipelineConfig);
 
-        framesData.resize(config.framesInFlight);
-        for (auto& frame : framesData) {
-            frame.descriptorSet = vireo.createDescriptorSet(descriptorLayout);
-            frame.descriptorSet->update(PostProcessing::BINDING_PARAMS, paramsBuffer);
-            frame.descriptorSet->update(PostProcessing::BINDING_DATA, dataBuffer);
-        }
+        edgeDetectPipeline = edgeDetect;
+        blendWeightPipeline = blendWeight;
+        blendPipeline = blend;
+    }
+
+    void SMAAPass::reloadPipelines() {
+        reload(edgeDetectPipeline, [&] { createPipelines(); });
     }
 
     void SMAAPass::render(
@@ -127,7 +142,7 @@ namespace lysa {
         const auto& vireo = Application::getVireo();
         for (auto& frame : framesData) {
             frame.edgeDetectBuffer = vireo.createRenderTarget(
-                vireo::ImageFormat::R16G16_SFLOAT,
+                WEIGHTS_FORMAT,
                 extent.width,extent.height,
                 vireo::RenderTargetType::COLOR,
                 renderingConfig.colorRenderTargets[0].clearValue,
@@ -135,7 +150,7 @@ namespace lysa {
                 vireo::MSAA::NONE,
                 "SMAA Edge detect");
             frame.blendWeightBuffer = vireo.createRenderTarget(
-                vireo::ImageFormat::R16G16_SFLOAT,
+                WEIGHTS_FORMAT,
                 extent.width,extent.height,
                 vireo::RenderTargetType::COLOR,
                 renderingConfig.colorRenderTargets[0].clearValue,
@@ -26,6 +26,8 @@ export namespace lysa {
 
         void resize(const vireo::Extent& extent, const std::shared_ptr<vireo::CommandList>& commandList) override;
 
+        void reloadPipelines();
+
         virtual std::shared_ptr<vireo::RenderTarget> getColorAttachment(const uint32 frameIndex) {
             return framesData[frameIndex].colorBuffer;
         }
@@ -34,6 +36,8 @@ export namespace lysa {
         const std::string EDGE_DETECT_FRAGMENT_SHADER{"smaa_edge_detect.frag"};
         const std::string BLEND_WEIGHT_FRAGMENT_SHADER{"smaa_blend_weight.frag"};
         const std::string BLEND_FRAGMENT_SHADER{"smaa_neighborhood_blend.frag"};
+        // Format of the edges & blend weights buffers
+        static constexpr auto WEIGHTS_FORMAT{vireo::ImageFormat::R16G16_SFLOAT};
 
         struct Data {
             float edgeThreshold;
@@ -48,7 +52,7 @@ export namespace lysa {
         };
 
         vireo::GraphicPipelineConfiguration pipelineConfig {
-            .colorRenderFormats = { vireo::ImageFormat::R16G16_SFLOAT },
+            .colorRenderFormats = { WEIGHTS_FORMAT },
             .colorBlendDesc = {{}},
         };
 
@@ -66,5 +70,7 @@ export namespace lysa {
         std::shared_ptr<vireo::GraphicPipeline> blendWeightPipeline;
         std::shared_ptr<vireo::GraphicPipeline> blendPipeline;
         std::shared_ptr<vireo::DescriptorLayout> descriptorLayout;
+
+        void createPipelines();
     };
 }
\ No newline at end of file
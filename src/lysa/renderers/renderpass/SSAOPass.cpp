@@ -48,6 +48,14 @@ namespace lysa {
         }
     }
 
+    void SSAOPass::reloadPipelines() {
+        reload(pipeline, [&] {
+            pipelineConfig.vertexShader = loadShader(VERTEX_SHADER);
+            pipelineConfig.fragmentShader = loadShader(FRAGMENT_SHADER);
+            pipeline = Application::getVireo().createGraphicPipeline(pipelineConfig, name);
+        });
+    }
+
     void SSAOPass::render(
         vireo::CommandList& commandList,
         const Scene& scene,
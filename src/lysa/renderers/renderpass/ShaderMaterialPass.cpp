@@ -58,6 +58,13 @@ namespace lysa {
         }
     }
 
+    void ShaderMaterialPass::reloadPipelines(const std::unordered_map<pipeline_id, std::vector<std::shared_ptr<Material>>>& pipelineIds) {
+        reload(pipelines, [&] {
+            pipelines.clear();
+            updatePipelines(pipelineIds);
+        });
+    }
+
     void ShaderMaterialPass::render(
         vireo::CommandList& commandList,
         const Scene& scene,
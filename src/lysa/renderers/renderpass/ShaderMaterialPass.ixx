@@ -22,6 +22,9 @@ export namespace lysa {
         void updatePipelines(
             const std::unordered_map<pipeline_id, std::vector<std::shared_ptr<Material>>>& pipelineIds);
 
+        void reloadPipelines(
+            const std::unordered_map<pipeline_id, std::vector<std::shared_ptr<Material>>>& pipelineIds);
+
         void render(
             vireo::CommandList& commandList,
             const Scene& scene,
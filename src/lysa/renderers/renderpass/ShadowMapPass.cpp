@@ -44,19 +44,8 @@ namespace lysa {
             Application::getResources().getSamplers().getDescriptorLayout()},
             Scene::instanceIndexConstantDesc, name);
 
-        pipelineConfig.vertexInputLayout = Application::getVireo().createVertexLayout(sizeof(VertexData), vertexAttributes);
-        pipelineConfig.vertexShader = loadShader(VERTEX_SHADER);
-        if (isCubeMap) {
-            pipelineConfig.fragmentShader = loadShader(FRAGMENT_SHADER_CUBEMAP);
-        } else {
-            pipelineConfig.fragmentShader = loadShader(FRAGMENT_SHADER);
-        }
-        pipeline = vireo.createGraphicPipeline(pipelineConfig, name);
-
-        viewport.width = static_cast<float>(light->getShadowMapSize());
-        viewport.height = viewport.width;
-        scissors.width = light->getShadowMapSize();
-        scissors.height = scissors.width;
+        pipelineConfig.vertexInputLayout = Application::getVireo().createVertexLayout(sizeof(VertexPositionData), VertexPositionData::vertexAttributes);
+        createPipeline();
 
         if (isCascaded) {
             subpassesCount = reinterpret_pointer_cast<DirectionalLight>(light)->getShadowMapCascadesCount();
@@ -73,23 +62,129 @@ namespace lysa {
             data.globalUniformBuffer->map();
             data.descriptorSet = vireo.createDescriptorSet(descriptorLayout);
             data.descriptorSet->update(BINDING_GLOBAL, data.globalUniformBuffer);
-            int size = light->getShadowMapSize();
-            if (isCascaded) {
-                size = std::max(512, size >> i);
+        }
+        setShadowMapSize(light->getShadowMapSize());
+    }
+
+    void ShadowMapPass::createPipeline() {
+        pipelineConfig.vertexShader = loadShader(VERTEX_SHADER);
+        if (isCubeMap) {
+            pipelineConfig.fragmentShader = loadShader(FRAGMENT_SHADER_CUBEMAP);
+        } else {
+            pipelineConfig.fragmentShader = loadShader(FRAGMENT_SHADER);
+        }
+        pipeline = Application::getVireo().createGraphicPipeline(pipelineConfig, name);
+    }
+
+    void ShadowMapPass::reloadPipelines() {
+        reload(pipeline, [&] { createPipeline(); });
+    }
+
+    uint32 ShadowMapPass::getSubpassShadowMapSize(const uint32 size, const uint32 index) const {
+        if (isCascaded) {
+            return std::min(size, std::max(512u, size >> index));
+        }
+        return size;
+    }
+
+    void ShadowMapPass::setShadowMapSize(const uint32 size) {
+        if (size == shadowMapSize) { return; }
+        const auto& vireo = Application::getVireo();
+        shadowMapSize = size;
+        for (int i = 0; i < subpassesCount; i++) {
+            auto& data = subpassData[i];
+            if (data.shadowMap) {
+                renderTargetsRecycleBin.push_back(data.shadowMap);
+                renderTargetsRecycleBin.push_back(data.transparencyColorMap);
             }
+            const auto mapSize = getSubpassShadowMapSize(size, i);
+            data.viewport.width = static_cast<float>(mapSize);
+            data.viewport.height = data.viewport.width;
+            data.scissors.width = mapSize;
+            data.scissors.height = data.scissors.width;
             data.shadowMap = vireo.createRenderTarget(
                 pipelineConfig.depthStencilImageFormat,
-                size, size,
+                mapSize, mapSize,
                 vireo::RenderTargetType::DEPTH,
                 renderingConfig.depthStencilClearValue);
             data.transparencyColorMap = vireo.createRenderTarget(
                 pipelineConfig.colorRenderFormats[0],
-                size, size,
+                mapSize, mapSize,
                 vireo::RenderTargetType::COLOR,
                 renderingConfig.colorRenderTargets[0].clearValue);
+            data.firstPass = true;
+            if (staticCacheEnabled) {
+                createStaticLayer(data, mapSize);
+            }
         }
     }
 
+    void ShadowMapPass::createStaticLayer(SubpassData& data, const uint32 mapSize) {
+        const auto& vireo = Application::getVireo();
+        if (data.staticShadowMap) {
+            renderTargetsRecycleBin.push_back(data.staticShadowMap);
+            renderTargetsRecycleBin.push_back(data.staticTransparencyColorMap);
+        }
+        data.staticShadowMap = vireo.createRenderTarget(
+            pipelineConfig.depthStencilImageFormat,
+            mapSize, mapSize,
+            vireo::RenderTargetType::DEPTH,
+            renderingConfig.depthStencilClearValue);
+        data.staticTransparencyColorMap = vireo.createRenderTarget(
+            pipelineConfig.colorRenderFormats[0],
+            mapSize, mapSize,
+            vireo::RenderTargetType::COLOR,
+            renderingConfig.colorRenderTargets[0].clearValue);
+        data.staticFirstPass = true;
+        invalidateStaticCache(data);
+    }
+
+    void ShadowMapPass::createStaticCulling(SubpassData& data, const pipeline_id pipelineId) const {
+        const auto& vireo = Application::getVireo();
+        data.staticFrustumCullingPipelines[pipelineId] = std::make_shared<FrustumCulling>(false, meshInstancesDataArray);
+        data.staticCulledDrawCommandsCountBuffers[pipelineId] = vireo.createBuffer(
+          vireo::BufferType::READWRITE_STORAGE,
+          sizeof(uint32));
+        data.staticCulledDrawCommandsBuffers[pipelineId] = vireo.createBuffer(
+          vireo::BufferType::READWRITE_STORAGE,
+          sizeof(DrawCommand) * sceneConfig.maxMeshSurfacePerPipeline);
+        invalidateStaticCache(data);
+    }
+
+    void ShadowMapPass::setStaticCastersEnabled(const bool enabled) {
+        if (isCascaded || enabled == staticCacheEnabled) { return; }
+        staticCacheEnabled = enabled;
+        for (int i = 0; i < subpassesCount; i++) {
+            auto& data = subpassData[i];
+            if (enabled) {
+                createStaticLayer(data, getSubpassShadowMapSize(shadowMapSize, i));
+                for (const auto& pipelineId : std::views::keys(data.frustumCullingPipelines)) {
+                    createStaticCulling(data, pipelineId);
+                }
+            } else {
+                renderTargetsRecycleBin.push_back(data.staticShadowMap);
+                renderTargetsRecycleBin.push_back(data.staticTransparencyColorMap);
+                data.staticShadowMap.reset();
+                data.staticTransparencyColorMap.reset();
+                data.staticFrustumCullingPipelines.clear();
+                data.staticCulledDrawCommandsBuffers.clear();
+                data.staticCulledDrawCommandsCountBuffers.clear();
+                data.shadowMapIsStaticCache = false;
+            }
+        }
+    }
+
+    void ShadowMapPass::invalidateStaticCache() {
+        for (auto& data : subpassData) {
+            invalidateStaticCache(data);
+        }
+    }
+
+    void ShadowMapPass::invalidateStaticCache(SubpassData& data) const {
+        data.staticCacheInvalidFrames = config.framesInFlight + 1;
+        data.shadowMapIsStaticCache = false;
+    }
+
     void ShadowMapPass::updatePipelines(const std::unordered_map<pipeline_id, std::vector<std::shared_ptr<Material>>>& pipelineIds) {
         const auto& vireo = Application::getVireo();
         for (const auto& pipelineId: std::views::keys(pipelineIds)) {
@@ -103,6 +198,9 @@ namespace lysa {
                     data.culledDrawCommandsBuffers[pipelineId] = vireo.createBuffer(
                       vireo::BufferType::READWRITE_STORAGE,
                       sizeof(DrawCommand) * sceneConfig.maxMeshSurfacePerPipeline);
+                    if (staticCacheEnabled) {
+                        createStaticCulling(data, pipelineId);
+                    }
                 }
             }
         }
@@ -122,125 +220,70 @@ namespace lysa {
                     *pipelineData->instancesArray.getBuffer(),
                     *pipelineData->drawCommandsBuffer,
                     *data.culledDrawCommandsBuffers.at(pipelineId),
-                    *data.culledDrawCommandsCountBuffers.at(pipelineId));
+                    *data.culledDrawCommandsCountBuffers.at(pipelineId),
+                    staticCacheEnabled ?
+                        FrustumCulling::ShadowCasters::DYNAMIC :
+                        FrustumCulling::ShadowCasters::ALL);
+                if (!staticCacheEnabled) { continue; }
+                if (data.staticCacheInvalidFrames == 0) {
+                    // Consumes the results of the last dispatch of the cached layer
+                    data.staticFrustumCullingPipelines.at(pipelineId)->readStatistics();
+                } else {
+                    data.staticFrustumCullingPipelines.at(pipelineId)->dispatch(
+                        commandList,
+                        pipelineData->drawCommandsCount,
+                        data.inverseViewMatrix,
+                        data.projection,
+                        *pipelineData->instancesArray.getBuffer(),
+                        *pipelineData->drawCommandsBuffer,
+                        *data.staticCulledDrawCommandsBuffers.at(pipelineId),
+                        *data.staticCulledDrawCommandsCountBuffers.at(pipelineId),
+                        FrustumCulling::ShadowCasters::STATIC);
+                }
             }
         }
     }
 
+    void ShadowMapPass::setDepthBounds(const float minDepth, const float maxDepth) {
+        depthBoundsValid = true;
+        minDepthBound = minDepth;
+        maxDepthBound = maxDepth;
+    }
+
     void ShadowMapPass::update(const uint32) {
+        renderTargetsRecycleBin.clear();
         if (!light->isVisible() || !light->getCastShadows()) { return; }
         static constexpr auto aspectRatio{1};
+        auto previousGlobalUniforms = std::vector<GlobalUniform>(subpassesCount);
+        for (int i = 0; i < subpassesCount; i++) {
+            previousGlobalUniforms[i] = subpassData[i].globalUniform;
+        }
         switch (light->getLightType()) {
             case Light::LIGHT_DIRECTIONAL: {
-                auto cascadeSplits = std::vector<float>(subpassesCount);
                 const auto& directionalLight = reinterpret_pointer_cast<DirectionalLight>(light);
-                const auto& lightDirection = directionalLight->getFrontVector();
-                const auto nearClip  = currentCamera->getNearDistance();
-                const auto farClip   = currentCamera->getFarDistance();
-                const auto clipRange = farClip - nearClip;
-                const auto minZ = nearClip;
-                const auto maxZ = nearClip + clipRange;
-                const auto range = maxZ - minZ;
-                const auto ratio = maxZ / minZ;
-
-                // Calculate split depths based on view camera frustum
-                // Based on the method presented in https://developer.nvidia.com/gpugems/GPUGems3/gpugems3_ch10.html
+                cascadesSizes.resize(subpassesCount);
                 for (auto i = 0; i < subpassesCount; i++) {
-                    float p          = (i + 1) / static_cast<float>(subpassesCount);
-                    float log        = minZ * std::pow(ratio, p);
-                    float uniform    = minZ + range * p;
-                    float d          = directionalLight->getCascadeSplitLambda() * (log - uniform) + uniform;
-                    cascadeSplits[i] = (d - nearClip) / clipRange;
+                    cascadesSizes[i] = subpassData[i].shadowMap->getImage()->getWidth();
                 }
-
-                // Calculate orthographic projection matrix for each cascade
-                float lastSplitDist = 0.0;
-                const auto invCam = inverse(mul(inverse(currentCamera->getTransformGlobal()), currentCamera->getProjection()));
+                fitShadowCascades(
+                    currentCamera->getTransformGlobal(),
+                    currentCamera->getProjection(),
+                    currentCamera->getNearDistance(),
+                    currentCamera->getFarDistance(),
+                    directionalLight->getFrontVector(),
+                    directionalLight->getCascadeSplitLambda(),
+                    depthBoundsValid ? std::optional{float2{minDepthBound, maxDepthBound}} : std::nullopt,
+                    cascadesSizes,
+                    cascades);
                 for (auto cascadeIndex = 0; cascadeIndex < subpassesCount; cascadeIndex++) {
-                    const auto splitDist = cascadeSplits[cascadeIndex];
-
-                    // Camera frustum corners in NDC space
-                    float3 frustumCorners[] = {
-                        float3(-1.0f, 1.0f, -1.0f),
-                        float3(1.0f, 1.0f, -1.0f),
-                        float3(1.0f, -1.0f, -1.0f),
-                        float3(-1.0f, -1.0f, -1.0f),
-
-                        float3(-1.0f, 1.0f, 1.0f),
-                        float3(1.0f, 1.0f, 1.0f),
-                        float3(1.0f, -1.0f, 1.0f),
-                        float3(-1.0f, -1.0f, 1.0f),
-                    };
-
-                    // Camera frustum corners into world space
-                    for (auto j = 0; j < 8; j++) {
-                        const auto invCorner = mul(float4(frustumCorners[j], 1.0f), invCam);
-                        frustumCorners[j]= (invCorner / invCorner.w).xyz;
-                    }
-
-                    // Adjust the coordinates of near and far planes for this specific cascade
-                    for (auto j = 0; j < 4; j++) {
-                        const auto dist = frustumCorners[j + 4] - frustumCorners[j];
-                        frustumCorners[j + 4] = frustumCorners[j] + (dist * splitDist);
-                        frustumCorners[j]     = frustumCorners[j] + (dist * lastSplitDist);
-                    }
-
-                    // Frustum center for this cascade split, in world space
-                    auto frustumCenter = FLOAT3ZERO;
-                    for (auto j = 0; j < 8; j++) {
-                        frustumCenter += frustumCorners[j];
-                    }
-                    frustumCenter /= 8.0f;
-
-                    // Radius of the cascade split
-                    auto radius = 0.0f;
-                    for (auto j = 0; j < 8; j++) {
-                        const float distance = length(frustumCorners[j] - frustumCenter);
-                        radius = std::max(radius, distance);
-                    }
-                    radius = std::ceil(radius * 16.0f) / 16.0f;
-
-                    // Snap the frustum center to the nearest texel grid
-                    const auto shadowMapResolution = static_cast<float>(subpassData[cascadeIndex].shadowMap->getImage()->getWidth());
-                    const float worldUnitsPerTexel = (2.0f * radius) / shadowMapResolution;
-                    frustumCenter.x = std::floor(frustumCenter.x / worldUnitsPerTexel) * worldUnitsPerTexel;
-                    frustumCenter.y = std::floor(frustumCenter.y / worldUnitsPerTexel) * worldUnitsPerTexel;
-                    frustumCenter.z = std::floor(frustumCenter.z / worldUnitsPerTexel) * worldUnitsPerTexel;
-
-                    // Split the bounding box
-                    const auto maxExtents = float3(radius);
-                    const auto minExtents = -maxExtents;
-                    const float depth = maxExtents.z - minExtents.z;
-
-                    // View & projection matrices
-                    const auto eye = frustumCenter - lightDirection * -minExtents.z ;
-                    const auto viewMatrix = lookAt(eye, frustumCenter, AXIS_UP);
-                    auto lightProjection = orthographic(
-                        minExtents.x, maxExtents.x,
-                        maxExtents.y, minExtents.y,
-                        -depth, depth);
-
-                    // https://stackoverflow.com/questions/33499053/cascaded-shadow-map-shimmering
-                    // Create the rounding matrix by projecting the world-space origin and determining
-                    // the fractional offset in texel space
-                    const auto shadowMatrix = mul(viewMatrix, lightProjection);
-                    const float4 shadowOrigin =
-                        mul(float4(0, 0, 0, 1), shadowMatrix) * (shadowMapResolution * 0.5f);
-                    const auto roundedOrigin = round(shadowOrigin);
-                    auto roundOffset = roundedOrigin - shadowOrigin;
-                    roundOffset = roundOffset * 2.0f / shadowMapResolution;
-                    roundOffset.z = 0.0f;
-                    roundOffset.w = 0.0f;
-                    lightProjection[3] += roundOffset;
-
-                    subpassData[cascadeIndex].inverseViewMatrix = inverse(viewMatrix);
-                    subpassData[cascadeIndex].projection = lightProjection;
-                    subpassData[cascadeIndex].globalUniform.lightSpace = mul(viewMatrix, lightProjection);
-                    subpassData[cascadeIndex].globalUniform.splitDepth = (nearClip + splitDist * clipRange);
+                    const auto& cascade = cascades[cascadeIndex];
+                    subpassData[cascadeIndex].inverseViewMatrix = inverse(cascade.viewMatrix);
+                    subpassData[cascadeIndex].projection = cascade.projection;
+                    subpassData[cascadeIndex].globalUniform.lightSpace = mul(cascade.viewMatrix, cascade.projection);
+                    subpassData[cascadeIndex].globalUniform.splitDepth = cascade.splitDepth;
                     subpassData[cascadeIndex].globalUniform.transparencyScissor = light->getShadowTransparencyScissors();
                     subpassData[cascadeIndex].globalUniform.transparencyColorScissor = light->getShadowTransparencyColorScissors();
                     subpassData[cascadeIndex].globalUniformBuffer->write(&subpassData[cascadeIndex].globalUniform);
-                    lastSplitDist = cascadeSplits[cascadeIndex];
                 }
                 break;
             }
@@ -307,17 +350,34 @@ namespace lysa {
             }
             default:;
         }
+        // The static layer is only valid for the light space it was rendered with
+        if (staticCacheEnabled) {
+            for (int i = 0; i < subpassesCount; i++) {
+                if (!isSameLightSpace(previousGlobalUniforms[i], subpassData[i].globalUniform)) {
+                    invalidateStaticCache(subpassData[i]);
+                }
+            }
+        }
+    }
+
+    bool ShadowMapPass::isSameLightSpace(const GlobalUniform& previous, const GlobalUniform& current) {
+        for (auto row = 0; row < 4; row++) {
+            if (any(previous.lightSpace[row] != current.lightSpace[row])) {
+                return false;
+            }
+        }
+        return all(previous.lightPosition == current.lightPosition) &&
+               previous.transparencyScissor == current.transparencyScissor &&
+               previous.transparencyColorScissor == current.transparencyColorScissor &&
+               previous.splitDepth == current.splitDepth;
     }
 
     void ShadowMapPass::render(
         vireo::CommandList& commandList,
         const Scene& scene) {
         if (!light->isVisible() || !light->getCastShadows()) { return; }
-        commandList.setViewport(viewport);
-        commandList.setScissors(scissors);
-
-        for (const auto& data : subpassData) {
-            if (firstPass) {
+        for (auto& data : subpassData) {
+            if (data.firstPass) {
                 commandList.barrier(
                   data.shadowMap,
                   vireo::ResourceState::UNDEFINED,
@@ -326,39 +386,108 @@ namespace lysa {
                   data.transparencyColorMap,
                   vireo::ResourceState::UNDEFINED,
                   vireo::ResourceState::SHADER_READ);
+                data.firstPass = false;
+            }
+            commandList.setViewport(data.viewport);
+            commandList.setScissors(data.scissors);
+
+            if (!staticCacheEnabled) {
+                // All the casters are drawn every frame
+                commandList.barrier(
+                    data.shadowMap,
+                    vireo::ResourceState::SHADER_READ,
+                    vireo::ResourceState::RENDER_TARGET_DEPTH);
+                commandList.barrier(
+                    data.transparencyColorMap,
+                    vireo::ResourceState::SHADER_READ,
+                    vireo::ResourceState::RENDER_TARGET_COLOR);
+                drawCasters(commandList, scene, data, false);
+                commandList.barrier(
+                    data.shadowMap,
+                    vireo::ResourceState::RENDER_TARGET_DEPTH,
+                    vireo::ResourceState::SHADER_READ);
+                commandList.barrier(
+                    data.transparencyColorMap,
+                    vireo::ResourceState::RENDER_TARGET_COLOR,
+                    vireo::ResourceState::SHADER_READ);
+                continue;
+            }
+
+            if (data.staticFirstPass) {
+                commandList.barrier(
+                  data.staticShadowMap,
+                  vireo::ResourceState::UNDEFINED,
+                  vireo::ResourceState::COPY_SRC);
+                commandList.barrier(
+                  data.staticTransparencyColorMap,
+                  vireo::ResourceState::UNDEFINED,
+                  vireo::ResourceState::COPY_SRC);
+                data.staticFirstPass = false;
+            }
+
+            // Redraw the static casters in the cached layer only when the light or the static casters changed
+            if (data.staticCacheInvalidFrames > 0) {
+                commandList.barrier(
+                    data.staticShadowMap,
+                    vireo::ResourceState::COPY_SRC,
+                    vireo::ResourceState::RENDER_TARGET_DEPTH);
+                commandList.barrier(
+                    data.staticTransparencyColorMap,
+                    vireo::ResourceState::COPY_SRC,
+                    vireo::ResourceState::RENDER_TARGET_COLOR);
+                drawCasters(commandList, scene, data, true);
+                commandList.barrier(
+                    data.staticShadowMap,
+                    vireo::ResourceState::RENDER_TARGET_DEPTH,
+                    vireo::ResourceState::COPY_SRC);
+                commandList.barrier(
+                    data.staticTransparencyColorMap,
+                    vireo::ResourceState::RENDER_TARGET_COLOR,
+                    vireo::ResourceState::COPY_SRC);
+                data.staticCacheInvalidFrames -= 1;
+                data.shadowMapIsStaticCache = false;
             }
 
             auto count{0};
             for (const auto& frustumCulling : std::views::values(data.frustumCullingPipelines)) {
                 count += frustumCulling->getDrawCommandsCount();
             }
-            if (count == 0) {
+            if (count == 0 && data.shadowMapIsStaticCache) {
                 continue;
             }
 
+            // Restore the static layer, then draw the dynamic casters over it
             commandList.barrier(
                 data.shadowMap,
                 vireo::ResourceState::SHADER_READ,
-                vireo::ResourceState::RENDER_TARGET_DEPTH);
+                vireo::ResourceState::COPY_DST);
             commandList.barrier(
                 data.transparencyColorMap,
                 vireo::ResourceState::SHADER_READ,
+                vireo::ResourceState::COPY_DST);
+            commandList.copy(data.staticShadowMap->getImage(), data.shadowMap->getImage());
+            commandList.copy(data.staticTransparencyColorMap->getImage(), data.transparencyColorMap->getImage());
+            if (count == 0) {
+                commandList.barrier(
+                    data.shadowMap,
+                    vireo::ResourceState::COPY_DST,
+                    vireo::ResourceState::SHADER_READ);
+                commandList.barrier(
+                    data.transparencyColorMap,
+                    vireo::ResourceState::COPY_DST,
+                    vireo::ResourceState::SHADER_READ);
+                data.shadowMapIsStaticCache = true;
+                continue;
+            }
+            commandList.barrier(
+                data.shadowMap,
+                vireo::ResourceState::COPY_DST,
+                vireo::ResourceState::RENDER_TARGET_DEPTH);
+            commandList.barrier(
+                data.transparencyColorMap,
+                vireo::ResourceState::COPY_DST,
                 vireo::ResourceState::RENDER_TARGET_COLOR);
-            renderingConfig.depthStencilRenderTarget = data.shadowMap;
-            renderingConfig.colorRenderTargets[0].renderTarget = data.transparencyColorMap;
-            commandList.beginRendering(renderingConfig);
-            commandList.bindPipeline(pipeline);
-            commandList.bindDescriptor(Application::getResources().getDescriptorSet(), SET_RESOURCES);
-            commandList.bindDescriptor(scene.getDescriptorSet(), SET_SCENE);
-            commandList.bindDescriptor(data.descriptorSet, SET_PASS);
-            commandList.bindDescriptor(Application::getResources().getSamplers().getDescriptorSet(), SET_SAMPLERS);
-            scene.drawModels(
-                commandList,
-                SET_PIPELINE,
-                data.culledDrawCommandsBuffers,
-                data.culledDrawCommandsCountBuffers,
-                data.frustumCullingPipelines);
-            commandList.endRendering();
+            drawCasters(commandList, scene, data, false);
             commandList.barrier(
                 data.shadowMap,
                 vireo::ResourceState::RENDER_TARGET_DEPTH,
@@ -367,8 +496,32 @@ namespace lysa {
                 data.transparencyColorMap,
                 vireo::ResourceState::RENDER_TARGET_COLOR,
                 vireo::ResourceState::SHADER_READ);
+            data.shadowMapIsStaticCache = false;
         }
-        firstPass = false;
     }
 
-}
\ No newline at end of file
+    void ShadowMapPass::drawCasters(
+        vireo::CommandList& commandList,
+        const Scene& scene,
+        const SubpassData& data,
+        const bool staticCasters) {
+        // Without the static layer the shadow map is cleared and all the casters are drawn
+        auto& rendering = staticCasters || !staticCacheEnabled ? renderingConfig : dynamicRenderingConfig;
+        rendering.depthStencilRenderTarget = staticCasters ? data.staticShadowMap : data.shadowMap;
+        rendering.colorRenderTargets[0].renderTarget = staticCasters ? data.staticTransparencyColorMap : data.transparencyColorMap;
+        commandList.beginRendering(rendering);
+        commandList.bindPipeline(pipeline);
+        commandList.bindDescriptor(Application::getResources().getDescriptorSet(), SET_RESOURCES);
+        commandList.bindDescriptor(scene.getDescriptorSet(), SET_SCENE);
+        commandList.bindDescriptor(data.descriptorSet, SET_PASS);
+        commandList.bindDescriptor(Application::getResources().getSamplers().getDescriptorSet(), SET_SAMPLERS);
+        scene.drawModels(
+            commandList,
+            SET_PIPELINE,
+            staticCasters ? data.staticCulledDrawCommandsBuffers : data.culledDrawCommandsBuffers,
+            staticCasters ? data.staticCulledDrawCommandsCountBuffers : data.culledDrawCommandsCountBuffers,
+            staticCasters ? data.staticFrustumCullingPipelines : data.frustumCullingPipelines);
+        commandList.endRendering();
+    }
+
+}
@@ -19,6 +19,7 @@ import lysa.nodes.light;
 import lysa.resources.material;
 import lysa.resources.mesh;
 import lysa.renderers.renderpass;
+import lysa.renderers.shadow_cascades;
 import lysa.pipelines.frustum_culling;
 
 export namespace lysa {
@@ -37,10 +38,22 @@ export namespace lysa {
 
         void updatePipelines(const std::unordered_map<pipeline_id, std::vector<std::shared_ptr<Material>>>& pipelineIds);
 
+        void reloadPipelines();
+
         void setCurrentCamera(const std::shared_ptr<Camera>& camera) {
             currentCamera = camera;
         }
 
+        /**
+         * Sets the non-linear depth range of the visible pixels, reduced on the GPU.
+         * Used to fit the cascades of directional lights on the visible part of the camera frustum.
+         * When not set, the cascades are split on the whole camera near/far range.
+         */
+        void setDepthBounds(float minDepth, float maxDepth);
+
+        /** Falls back to the camera near/far range for the cascades splits */
+        void resetDepthBounds() { depthBoundsValid = false; }
+
         void update(uint32 frameIndex) override;
 
         void render(
@@ -49,6 +62,28 @@ export namespace lysa {
 
         auto getShadowMapCount() const { return subpassesCount; }
 
+        /** Returns the current resolution of the light, cascades use lower resolutions */
+        auto getShadowMapSize() const { return shadowMapSize; }
+
+        /** Returns the resolution of one shadow map for a given light resolution */
+        uint32 getSubpassShadowMapSize(uint32 size, uint32 index) const;
+
+        /**
+         * Changes the resolution of the light.
+         * The shadow maps are re-created and the previous ones are destroyed on the next update.
+         */
+        void setShadowMapSize(uint32 size);
+
+        /** Forces the static shadow casters to be redrawn in the cached layer */
+        void invalidateStaticCache();
+
+        /**
+         * Enables the cached layer of the static shadow casters when the scene has some.
+         * The cached layer is only allocated while enabled. Directional lights never use it :
+         * their cascades follow the camera and would redraw it every frame.
+         */
+        void setStaticCastersEnabled(bool enabled);
+
         auto getShadowMap(const uint32 index) const {
             return subpassData[index].shadowMap;
         }
@@ -89,27 +124,47 @@ export namespace lysa {
             float4x4 inverseViewMatrix;
             float4x4 projection;
             GlobalUniform globalUniform;
+            vireo::Rect scissors;
+            vireo::Viewport viewport;
+            // Shadow map sampled by the lighting passes : static layer + dynamic casters
             std::shared_ptr<vireo::RenderTarget> shadowMap;
             std::shared_ptr<vireo::RenderTarget> transparencyColorMap;
+            // Cached layer with only the static casters
+            std::shared_ptr<vireo::RenderTarget> staticShadowMap;
+            std::shared_ptr<vireo::RenderTarget> staticTransparencyColorMap;
             std::shared_ptr<vireo::Buffer> globalUniformBuffer;
             std::shared_ptr<vireo::DescriptorSet> descriptorSet;
             std::map<pipeline_id, std::shared_ptr<FrustumCulling>> frustumCullingPipelines;
             std::map<pipeline_id, std::shared_ptr<vireo::Buffer>> culledDrawCommandsBuffers;
             std::map<pipeline_id, std::shared_ptr<vireo::Buffer>> culledDrawCommandsCountBuffers;
+            std::map<pipeline_id, std::shared_ptr<FrustumCulling>> staticFrustumCullingPipelines;
+            std::map<pipeline_id, std::shared_ptr<vireo::Buffer>> staticCulledDrawCommandsBuffers;
+            std::map<pipeline_id, std::shared_ptr<vireo::Buffer>> staticCulledDrawCommandsCountBuffers;
+            // Number of frames during which the static layer still have to be redrawn,
+            // the culling results are read back by the CPU with a delay of the frames in flight
+            uint32 staticCacheInvalidFrames{0};
+            // True when the shadow map only contains the static layer
+            bool shadowMapIsStaticCache{false};
+            bool firstPass{true};
+            bool staticFirstPass{true};
         };
 
         const bool isCubeMap;
         const bool isCascaded;
+        // Cached static layer used, only when the scene has static casters and the light is not cascaded
+        bool staticCacheEnabled{false};
         uint32 subpassesCount;
+        uint32 shadowMapSize{0};
         std::shared_ptr<Camera> currentCamera;
+        bool depthBoundsValid{false};
+        float minDepthBound{0.0f};
+        float maxDepthBound{1.0f};
+        // Cascades of a directional light, reused each frame
+        std::vector<ShadowCascade> cascades;
+        std::vector<uint32> cascadesSizes;
         float3 lastLightPosition{-10000.0f};
         std::vector<SubpassData> subpassData;
 
-        const std::vector<vireo::VertexAttributeDesc> vertexAttributes {
-            {"POSITION", vireo::AttributeFormat::R32G32B32A32_FLOAT, offsetof(VertexData, position)},
-            {"NORMAL", vireo::AttributeFormat::R32G32B32A32_FLOAT, offsetof(VertexData, normal)},
-        };
-
         vireo::GraphicPipelineConfiguration pipelineConfig {
             .colorRenderFormats = { vireo::ImageFormat::R8G8B8A8_SNORM }, // Packed RGB + alpha
             .colorBlendDesc = {{}},
@@ -132,15 +187,38 @@ export namespace lysa {
             .discardDepthStencilAfterRender = false,
         };
 
-        bool firstPass{true};
+        // Draw the dynamic casters over the static layer
+        vireo::RenderingConfiguration dynamicRenderingConfig {
+            .colorRenderTargets = {{ .clear = false }},
+            .depthTestEnable = pipelineConfig.depthTestEnable,
+            .clearDepthStencil = false,
+            .discardDepthStencilAfterRender = false,
+        };
 
         const SceneConfiguration& sceneConfig;
         const DeviceMemoryArray& meshInstancesDataArray;
 
-        vireo::Rect scissors;
-        vireo::Viewport viewport;
+        // Previous shadow maps, destroyed on the next update when no longer in use
+        std::list<std::shared_ptr<vireo::RenderTarget>> renderTargetsRecycleBin;
         std::shared_ptr<Light> light;
         std::shared_ptr<vireo::GraphicPipeline> pipeline;
         std::shared_ptr<vireo::DescriptorLayout> descriptorLayout;
+
+        void invalidateStaticCache(SubpassData& data) const;
+
+        void createStaticLayer(SubpassData& data, uint32 mapSize);
+
+        void createStaticCulling(SubpassData& data, pipeline_id pipelineId) const;
+
+        void createPipeline();
+
+        // Compares the fields used to render the shadow map, GlobalUniform has padding bytes
+        static bool isSameLightSpace(const GlobalUniform& previous, const GlobalUniform& current);
+
+        void drawCasters(
+            vireo::CommandList& commandList,
+            const Scene& scene,
+            const SubpassData& data,
+            bool staticCasters);
     };
 }
\ No newline at end of file
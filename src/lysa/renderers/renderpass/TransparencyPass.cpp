@@ -67,6 +67,13 @@ namespace lysa {
         }
     }
 
+    void TransparencyPass::reloadPipelines(const std::unordered_map<pipeline_id, std::vector<std::shared_ptr<Material>>>& pipelineIds) {
+        reload(oitPipelines, [&] {
+            oitPipelines.clear();
+            updatePipelines(pipelineIds);
+        });
+    }
+
     void TransparencyPass::render(
         vireo::CommandList& commandList,
         const Scene& scene,
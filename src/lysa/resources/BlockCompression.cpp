@@ -0,0 +1,517 @@
+/*
+ * Copyright (c) 2025-present Henri Michelon
+ *
+ * This software is released under the MIT License.
+ * https://opensource.org/licenses/MIT
+*/
+module lysa.resources.block_compression;
+
+namespace lysa {
+
+    namespace {
+
+        using Texel = std::array<float, 4>;
+        using Block = std::array<Texel, 16>;
+
+        // BC7 interpolation weights of the 4 bits indices, in 1/64
+        constexpr auto BC7_WEIGHTS = std::array<uint32, 16>{ 0, 4, 9, 13, 17, 21, 26, 30, 34, 38, 43, 47, 51, 55, 60, 64 };
+        // First byte of a BC7 mode 6 block : the mode is the position of the first set bit
+        constexpr uint8 BC7_MODE6{1 << 6};
+
+        // Texels of a block, the texels outside the image are clamped to its edges
+        Block loadBlock(const uint8* rgba, const uint32 width, const uint32 height, const uint32 blockX, const uint32 blockY) {
+            auto block = Block{};
+            for (auto y = 0u; y < 4; y++) {
+                for (auto x = 0u; x < 4; x++) {
+                    const auto sourceX = std::min(blockX * 4 + x, width - 1);
+                    const auto sourceY = std::min(blockY * 4 + y, height - 1);
+                    const auto* texel = rgba + (static_cast<size_t>(sourceY) * width + sourceX) * 4;
+                    for (auto channel = 0; channel < 4; channel++) {
+                        block[y * 4 + x][channel] = texel[channel];
+                    }
+                }
+            }
+            return block;
+        }
+
+        void storeBlock(const Block& block, uint8* rgba, const uint32 width, const uint32 height, const uint32 blockX, const uint32 blockY) {
+            for (auto y = 0u; y < 4 && blockY * 4 + y < height; y++) {
+                for (auto x = 0u; x < 4 && blockX * 4 + x < width; x++) {
+                    auto* texel = rgba + (static_cast<size_t>(blockY * 4 + y) * width + blockX * 4 + x) * 4;
+                    for (auto channel = 0; channel < 4; channel++) {
+                        texel[channel] = static_cast<uint8>(block[y * 4 + x][channel]);
+                    }
+                }
+            }
+        }
+
+        template<uint32 CHANNELS>
+        float distance(const Texel& a, const Texel& b) {
+            auto result = 0.0f;
+            for (auto channel = 0u; channel < CHANNELS; channel++) {
+                const auto delta = a[channel] - b[channel];
+                result += delta * delta;
+            }
+            return result;
+        }
+
+        // Extremes of the projection of the texels on their principal axis
+        template<uint32 CHANNELS>
+        std::pair<Texel, Texel> principalEndpoints(const Block& block) {
+            auto mean = Texel{};
+            auto minimum = block[0];
+            auto maximum = block[0];
+            for (const auto& texel : block) {
+                for (auto channel = 0u; channel < CHANNELS; channel++) {
+                    mean[channel] += texel[channel] / 16.0f;
+                    minimum[channel] = std::min(minimum[channel], texel[channel]);
+                    maximum[channel] = std::max(maximum[channel], texel[channel]);
+                }
+            }
+            auto covariance = std::array<Texel, 4>{};
+            for (const auto& texel : block) {
+                for (auto i = 0u; i < CHANNELS; i++) {
+                    for (auto j = 0u; j < CHANNELS; j++) {
+                        covariance[i][j] += (texel[i] - mean[i]) * (texel[j] - mean[j]);
+                    }
+                }
+            }
+            // Power iterations, starting from the bounding box diagonal
+            auto axis = Texel{};
+            for (auto channel = 0u; channel < CHANNELS; channel++) {
+                axis[channel] = maximum[channel] - minimum[channel];
+            }
+            for (auto iteration = 0; iteration < 8; iteration++) {
+                auto next = Texel{};
+                auto norm = 0.0f;
+                for (auto i = 0u; i < CHANNELS; i++) {
+                    for (auto j = 0u; j < CHANNELS; j++) {
+                        next[i] += covariance[i][j] * axis[j];
+                    }
+                    norm = std::max(norm, std::abs(next[i]));
+                }
+                if (norm == 0.0f) { break; }
+                for (auto channel = 0u; channel < CHANNELS; channel++) {
+                    axis[channel] = next[channel] / norm;
+                }
+            }
+            const auto length = distance<CHANNELS>(axis, Texel{});
+            if (length == 0.0f) { return { mean, mean }; }
+            auto low = std::numeric_limits<float>::max();
+            auto high = std::numeric_limits<float>::lowest();
+            for (const auto& texel : block) {
+                auto projection = 0.0f;
+                for (auto channel = 0u; channel < CHANNELS; channel++) {
+                    projection += (texel[channel] - mean[channel]) * axis[channel];
+                }
+                low = std::min(low, projection / length);
+                high = std::max(high, projection / length);
+            }
+            auto start = mean;
+            auto end = mean;
+            for (auto channel = 0u; channel < CHANNELS; channel++) {
+                start[channel] = std::clamp(mean[channel] + axis[channel] * low, 0.0f, 255.0f);
+                end[channel] = std::clamp(mean[channel] + axis[channel] * high, 0.0f, 255.0f);
+            }
+            return { start, end };
+        }
+
+        template<uint32 CHANNELS, std::size_t N>
+        uint32 nearest(const Texel& texel, const std::array<Texel, N>& palette, float& error) {
+            auto index = 0u;
+            error = distance<CHANNELS>(texel, palette[0]);
+            for (auto i = 1u; i < N; i++) {
+                const auto d = distance<CHANNELS>(texel, palette[i]);
+                if (d < error) {
+                    error = d;
+                    index = i;
+                }
+            }
+            return index;
+        }
+
+        uint16 to565(const Texel& color) {
+            const auto r = static_cast<uint16>(std::lround(color[0] * 31.0f / 255.0f));
+            const auto g = static_cast<uint16>(std::lround(color[1] * 63.0f / 255.0f));
+            const auto b = static_cast<uint16>(std::lround(color[2] * 31.0f / 255.0f));
+            return static_cast<uint16>(r << 11 | g << 5 | b);
+        }
+
+        Texel from565(const uint16 color) {
+            const auto r = (color >> 11) & 31;
+            const auto g = (color >> 5) & 63;
+            const auto b = color & 31;
+            return {
+                static_cast<float>(r << 3 | r >> 2),
+                static_cast<float>(g << 2 | g >> 4),
+                static_cast<float>(b << 3 | b >> 2),
+                255.0f };
+        }
+
+        // The 3 colors mode, with a transparent black, is only used by BC1 when color0 <= color1
+        std::array<Texel, 4> bc1Palette(const uint16 color0, const uint16 color1, const bool fourColors) {
+            auto palette = std::array<Texel, 4>{ from565(color0), from565(color1) };
+            for (auto channel = 0; channel < 3; channel++) {
+                const auto c0 = static_cast<uint32>(palette[0][channel]);
+                const auto c1 = static_cast<uint32>(palette[1][channel]);
+                if (fourColors) {
+                    palette[2][channel] = static_cast<float>((2 * c0 + c1) / 3);
+                    palette[3][channel] = static_cast<float>((c0 + 2 * c1) / 3);
+                } else {
+                    palette[2][channel] = static_cast<float>((c0 + c1) / 2);
+                    palette[3][channel] = 0.0f;
+                }
+            }
+            palette[2][3] = 255.0f;
+            palette[3][3] = fourColors ? 255.0f : 0.0f;
+            return palette;
+        }
+
+        struct ColorBlock {
+            uint16 color0;
+            uint16 color1;
+            uint32 indices{0};
+            float error{0.0f};
+        };
+
+        // Always in the 4 colors mode, as required by BC3
+        ColorBlock encodeColors(const Block& block, const Texel& endpoint0, const Texel& endpoint1) {
+            auto result = ColorBlock{ to565(endpoint0), to565(endpoint1) };
+            if (result.color0 < result.color1) {
+                std::swap(result.color0, result.color1);
+            }
+            const auto palette = bc1Palette(result.color0, result.color1, true);
+            for (auto i = 0; i < 16; i++) {
+                auto error = 0.0f;
+                result.indices |= nearest<3>(block[i], palette, error) << (i * 2);
+                result.error += error;
+            }
+            return result;
+        }
+
+        // Least squares endpoints for the indices of a color block
+        std::optional<std::pair<Texel, Texel>> refineEndpoints(const Block& block, const uint32 indices) {
+            static constexpr auto WEIGHTS = std::array{ 1.0f, 0.0f, 2.0f / 3.0f, 1.0f / 3.0f };
+            auto aa = 0.0f, bb = 0.0f, ab = 0.0f;
+            auto ax = Texel{};
+            auto bx = Texel{};
+            for (auto i = 0; i < 16; i++) {
+                const auto a = WEIGHTS[(indices >> (i * 2)) & 3];
+                const auto b = 1.0f - a;
+                aa += a * a;
+                bb += b * b;
+                ab += a * b;
+                for (auto channel = 0; channel < 3; channel++) {
+                    ax[channel] += a * block[i][channel];
+                    bx[channel] += b * block[i][channel];
+                }
+            }
+            const auto determinant = aa * bb - ab * ab;
+            if (std::abs(determinant) < 1e-6f) { return std::nullopt; }
+            auto endpoint0 = Texel{};
+            auto endpoint1 = Texel{};
+            for (auto channel = 0; channel < 3; channel++) {
+                endpoint0[channel] = std::clamp((ax[channel] * bb - bx[channel] * ab) / determinant, 0.0f, 255.0f);
+                endpoint1[channel] = std::clamp((bx[channel] * aa - ax[channel] * ab) / determinant, 0.0f, 255.0f);
+            }
+            return std::pair{ endpoint0, endpoint1 };
+        }
+
+        void encodeBC1(const Block& block, uint8* output) {
+            const auto [start, end] = principalEndpoints<3>(block);
+            auto result = encodeColors(block, end, start);
+            if (const auto refined = refineEndpoints(block, result.indices)) {
+                const auto candidate = encodeColors(block, refined->first, refined->second);
+                if (candidate.error < result.error) { result = candidate; }
+            }
+            output[0] = static_cast<uint8>(result.color0);
+            output[1] = static_cast<uint8>(result.color0 >> 8);
+            output[2] = static_cast<uint8>(result.color1);
+            output[3] = static_cast<uint8>(result.color1 >> 8);
+            for (auto i = 0; i < 4; i++) {
+                output[4 + i] = static_cast<uint8>(result.indices >> (i * 8));
+            }
+        }
+
+        void decodeBC1(const uint8* input, Block& block, const bool forceFourColors) {
+            const auto color0 = static_cast<uint16>(input[0] | input[1] << 8);
+            const auto color1 = static_cast<uint16>(input[2] | input[3] << 8);
+            const auto palette = bc1Palette(color0, color1, forceFourColors || color0 > color1);
+            const auto indices = static_cast<uint32>(input[4] | input[5] << 8 | input[6] << 16 | input[7] << 24);
+            for (auto i = 0; i < 16; i++) {
+                const auto& color = palette[(indices >> (i * 2)) & 3];
+                for (auto channel = 0; channel < (forceFourColors ? 3 : 4); channel++) {
+                    block[i][channel] = color[channel];
+                }
+            }
+        }
+
+        std::array<Texel, 8> bc4Palette(const uint32 value0, const uint32 value1) {
+            auto palette = std::array<uint32, 8>{ value0, value1 };
+            if (value0 > value1) {
+                for (auto i = 2u; i < 8; i++) {
+                    palette[i] = ((8 - i) * value0 + (i - 1) * value1 + 3) / 7;
+                }
+            } else {
+                for (auto i = 2u; i < 6; i++) {
+                    palette[i] = ((6 - i) * value0 + (i - 1) * value1 + 2) / 5;
+                }
+                palette[6] = 0;
+                palette[7] = 255;
+            }
+            auto result = std::array<Texel, 8>{};
+            for (auto i = 0; i < 8; i++) {
+                result[i][0] = static_cast<float>(palette[i]);
+            }
+            return result;
+        }
+
+        void encodeBC4(const Block& block, const uint32 channel, uint8* output) {
+            auto minimum = 255u;
+            auto maximum = 0u;
+            for (const auto& texel : block) {
+                minimum = std::min(minimum, static_cast<uint32>(texel[channel]));
+                maximum = std::max(maximum, static_cast<uint32>(texel[channel]));
+            }
+            const auto palette = bc4Palette(maximum, minimum);
+            auto indices = uint64{0};
+            for (auto i = 0; i < 16; i++) {
+                auto error = 0.0f;
+                indices |= static_cast<uint64>(nearest<1>(Texel{ block[i][channel] }, palette, error)) << (i * 3);
+            }
+            output[0] = static_cast<uint8>(maximum);
+            output[1] = static_cast<uint8>(minimum);
+            for (auto i = 0; i < 6; i++) {
+                output[2 + i] = static_cast<uint8>(indices >> (i * 8));
+            }
+        }
+
+        void decodeBC4(const uint8* input, const uint32 channel, Block& block) {
+            const auto palette = bc4Palette(input[0], input[1]);
+            auto indices = uint64{0};
+            for (auto i = 0; i < 6; i++) {
+                indices |= static_cast<uint64>(input[2 + i]) << (i * 8);
+            }
+            for (auto i = 0; i < 16; i++) {
+                block[i][channel] = palette[(indices >> (i * 3)) & 7][0];
+            }
+        }
+
+        // 128 bits of a BC7 block, least significant bit first
+        class BitStream {
+        public:
+            explicit BitStream(uint8* bytes) : bytes{bytes} {}
+
+            void write(const uint32 value, const uint32 count) {
+                for (auto bit = 0u; bit < count; bit++, position++) {
+                    if ((value >> bit) & 1) { bytes[position / 8] |= static_cast<uint8>(1 << (position % 8)); }
+                }
+            }
+
+            uint32 read(const uint32 count) {
+                auto value = 0u;
+                for (auto bit = 0u; bit < count; bit++, position++) {
+                    value |= static_cast<uint32>((bytes[position / 8] >> (position % 8)) & 1) << bit;
+                }
+                return value;
+            }
+
+        private:
+            uint8* bytes;
+            uint32 position{0};
+        };
+
+        struct BC7Endpoint {
+            std::array<uint32, 4> color;
+            uint32 pBit;
+        };
+
+        // 7 bits per channel and a shared least significant bit
+        BC7Endpoint quantizeBC7(const Texel& color) {
+            auto result = BC7Endpoint{};
+            auto bestError = std::numeric_limits<float>::max();
+            for (auto pBit = 0u; pBit < 2; pBit++) {
+                auto endpoint = BC7Endpoint{ {}, pBit };
+                auto error = 0.0f;
+                for (auto channel = 0; channel < 4; channel++) {
+                    endpoint.color[channel] = static_cast<uint32>(std::clamp(
+                        std::lround((color[channel] - static_cast<float>(pBit)) / 2.0f), 0l, 127l));
+                    const auto delta = static_cast<float>(endpoint.color[channel] << 1 | pBit) - color[channel];
+                    error += delta * delta;
+                }
+                if (error < bestError) {
+                    bestError = error;
+                    result = endpoint;
+                }
+            }
+            return result;
+        }
+
+        std::array<Texel, 16> bc7Palette(const BC7Endpoint& endpoint0, const BC7Endpoint& endpoint1) {
+            auto palette = std::array<Texel, 16>{};
+            for (auto i = 0; i < 16; i++) {
+                for (auto channel = 0; channel < 4; channel++) {
+                    const auto e0 = endpoint0.color[channel] << 1 | endpoint0.pBit;
+                    const auto e1 = endpoint1.color[channel] << 1 | endpoint1.pBit;
+                    palette[i][channel] = static_cast<float>(((64 - BC7_WEIGHTS[i]) * e0 + BC7_WEIGHTS[i] * e1 + 32) >> 6);
+                }
+            }
+            return palette;
+        }
+
+        void encodeBC7(const Block& block, uint8* output) {
+            const auto [start, end] = principalEndpoints<4>(block);
+            auto endpoint0 = quantizeBC7(start);
+            auto endpoint1 = quantizeBC7(end);
+            const auto palette = bc7Palette(endpoint0, endpoint1);
+            auto indices = std::array<uint32, 16>{};
+            for (auto i = 0; i < 16; i++) {
+                auto error = 0.0f;
+                indices[i] = nearest<4>(block[i], palette, error);
+            }
+            // The most significant bit of the first index is implicitly 0
+            if (indices[0] >= 8) {
+                std::swap(endpoint0, endpoint1);
+                for (auto& index : indices) { index = 15 - index; }
+            }
+            std::fill_n(output, 16, uint8{0});
+            auto stream = BitStream{output};
+            stream.write(BC7_MODE6, 7);
+            for (auto channel = 0; channel < 4; channel++) {
+                stream.write(endpoint0.color[channel], 7);
+                stream.write(endpoint1.color[channel], 7);
+            }
+            stream.write(endpoint0.pBit, 1);
+            stream.write(endpoint1.pBit, 1);
+            stream.write(indices[0], 3);
+            for (auto i = 1; i < 16; i++) {
+                stream.write(indices[i], 4);
+            }
+        }
+
+        void decodeBC7(const uint8* input, Block& block) {
+            if ((input[0] & 0x7f) != BC7_MODE6) {
+                block = {};
+                return;
+            }
+            auto bytes = std::array<uint8, 16>{};
+            std::copy_n(input, 16, bytes.begin());
+            auto stream = BitStream{bytes.data()};
+            stream.read(7);
+            auto endpoint0 = BC7Endpoint{};
+            auto endpoint1 = BC7Endpoint{};
+            for (auto channel = 0; channel < 4; channel++) {
+                endpoint0.color[channel] = stream.read(7);
+                endpoint1.color[channel] = stream.read(7);
+            }
+            endpoint0.pBit = stream.read(1);
+            endpoint1.pBit = stream.read(1);
+            const auto palette = bc7Palette(endpoint0, endpoint1);
+            block[0] = palette[stream.read(3)];
+            for (auto i = 1; i < 16; i++) {
+                block[i] = palette[stream.read(4)];
+            }
+        }
+
+    }
+
+    uint32 BlockCompression::getBlockBytes(const BlockFormat format) {
+        return format == BlockFormat::BC1 || format == BlockFormat::BC4 ? 8 : 16;
+    }
+
+    size_t BlockCompression::getImageSize(const BlockFormat format, const uint32 width, const uint32 height) {
+        const auto blocksX = (width + BLOCK_SIZE - 1) / BLOCK_SIZE;
+        const auto blocksY = (height + BLOCK_SIZE - 1) / BLOCK_SIZE;
+        return static_cast<size_t>(blocksX) * blocksY * getBlockBytes(format);
+    }
+
+    void BlockCompression::compress(
+        const BlockFormat format,
+        const uint8* rgba,
+        const uint32 width, const uint32 height,
+        uint8* blocks) {
+        const auto blocksX = (width + BLOCK_SIZE - 1) / BLOCK_SIZE;
+        const auto blocksY = (height + BLOCK_SIZE - 1) / BLOCK_SIZE;
+        const auto blockBytes = getBlockBytes(format);
+        for (auto blockY = 0u; blockY < blocksY; blockY++) {
+            for (auto blockX = 0u; blockX < blocksX; blockX++) {
+                const auto block = loadBlock(rgba, width, height, blockX, blockY);
+                auto* output = blocks + (static_cast<size_t>(blockY) * blocksX + blockX) * blockBytes;
+                switch (format) {
+                case BlockFormat::BC1:
+                    encodeBC1(block, output);
+                    break;
+                case BlockFormat::BC3:
+                    encodeBC4(block, 3, output);
+                    encodeBC1(block, output + 8);
+                    break;
+                case BlockFormat::BC4:
+                    encodeBC4(block, 0, output);
+                    break;
+                case BlockFormat::BC5:
+                    encodeBC4(block, 0, output);
+                    encodeBC4(block, 1, output + 8);
+                    break;
+                case BlockFormat::BC7:
+                    encodeBC7(block, output);
+                    break;
+                }
+            }
+        }
+    }
+
+    void BlockCompression::decompress(
+        const BlockFormat format,
+        const uint8* blocks,
+        const uint32 width, const uint32 height,
+        uint8* rgba) {
+        const auto blocksX = (width + BLOCK_SIZE - 1) / BLOCK_SIZE;
+        const auto blocksY = (height + BLOCK_SIZE - 1) / BLOCK_SIZE;
+        const auto blockBytes = getBlockBytes(format);
+        for (auto blockY = 0u; blockY < blocksY; blockY++) {
+            for (auto blockX = 0u; blockX < blocksX; blockX++) {
+                const auto* input = blocks + (static_cast<size_t>(blockY) * blocksX + blockX) * blockBytes;
+                auto block = Block{};
+                block.fill(Texel{ 0.0f, 0.0f, 0.0f, 255.0f });
+                switch (format) {
+                case BlockFormat::BC1:
+                    decodeBC1(input, block, false);
+                    break;
+                case BlockFormat::BC3:
+                    decodeBC4(input, 3, block);
+                    decodeBC1(input + 8, block, true);
+                    break;
+                case BlockFormat::BC4:
+                    decodeBC4(input, 0, block);
+                    break;
+                case BlockFormat::BC5:
+                    decodeBC4(input, 0, block);
+                    decodeBC4(input + 8, 1, block);
+                    break;
+                case BlockFormat::BC7:
+                    decodeBC7(input, block);
+                    break;
+                }
+                storeBlock(block, rgba, width, height, blockX, blockY);
+            }
+        }
+    }
+
+    std::vector<size_t> BlockCompression::compressLevels(
+        const BlockFormat format,
+        const std::vector<uint8>& levels,
+        const std::vector<size_t>& offsets,
+        const uint32 width, const uint32 height,
+        std::vector<uint8>& blocks) {
+        auto blocksOffsets = std::vector<size_t>(offsets.size());
+        for (auto level = 0u; level < offsets.size(); level++) {
+            const auto levelWidth = std::max(1u, width >> level);
+            const auto levelHeight = std::max(1u, height >> level);
+            blocksOffsets[level] = blocks.size();
+            blocks.resize(blocks.size() + getImageSize(format, levelWidth, levelHeight));
+            compress(format, levels.data() + offsets[level], levelWidth, levelHeight, blocks.data() + blocksOffsets[level]);
+        }
+        return blocksOffsets;
+    }
+
+}
@@ -0,0 +1,77 @@
+/*
+ * Copyright (c) 2025-present Henri Michelon
+ *
+ * This software is released under the MIT License.
+ * https://opensource.org/licenses/MIT
+*/
+export module lysa.resources.block_compression;
+
+import std;
+import lysa.types;
+
+export namespace lysa {
+
+    /**
+     * GPU block compressed formats produced by the textures cook step.<br>
+     * All the formats compress blocks of 4x4 texels.
+     */
+    enum class BlockFormat : uint8 {
+        //! RGB, 8 bytes per block, for the opaque color textures
+        BC1,
+        //! RGBA, a BC4 alpha block followed by a BC1 color block, 16 bytes per block
+        BC3,
+        //! One channel, 8 bytes per block
+        BC4,
+        //! Two channels, one BC4 block per channel, 16 bytes per block, for the normal maps
+        BC5,
+        //! RGBA, 16 bytes per block. Only the mode 6 (one subset, 7 bits endpoints, 4 bits indices) is encoded :
+        //! the blocks with an alpha not correlated with the color lose more than with the modes 4 & 5.
+        BC7,
+    };
+
+    /**
+     * CPU encoder & decoder of the BCn formats, used to cook the textures of the assets packs.<br>
+     * The endpoints of each block are the extremes of the principal axis of its texels,
+     * refined once by least squares for BC1. The decoder is used to measure the
+     * compression error, it only decodes the BC7 blocks encoded in mode 6.
+     */
+    class BlockCompression {
+    public:
+        //! Width & height of a block in texels
+        static constexpr uint32 BLOCK_SIZE{4};
+
+        /**
+         * Returns the size in bytes of one 4x4 block
+         */
+        static uint32 getBlockBytes(BlockFormat format);
+
+        /**
+         * Returns the size in bytes of a compressed image, the partial blocks are padded
+         */
+        static size_t getImageSize(BlockFormat format, uint32 width, uint32 height);
+
+        /**
+         * Compresses a RGBA8 image into `blocks`, getImageSize() bytes.<br>
+         * BC4 compresses the red channel, BC5 the red & green channels.
+         */
+        static void compress(BlockFormat format, const uint8* rgba, uint32 width, uint32 height, uint8* blocks);
+
+        /**
+         * Decompresses `blocks` into a RGBA8 image.<br>
+         * The missing channels are 0, and the alpha is 255, for BC1, BC4 & BC5.
+         */
+        static void decompress(BlockFormat format, const uint8* blocks, uint32 width, uint32 height, uint8* rgba);
+
+        /**
+         * Compresses all the levels of a RGBA8 mip chain, see Image::generateMips(), and
+         * returns the start of each compressed level in `blocks`
+         */
+        static std::vector<size_t> compressLevels(
+            BlockFormat format,
+            const std::vector<uint8>& levels,
+            const std::vector<size_t>& offsets,
+            uint32 width, uint32 height,
+            std::vector<uint8>& blocks);
+    };
+
+}
@@ -0,0 +1,64 @@
+/*
+* Copyright (c) 2025-present Henri Michelon
+*
+* This software is released under the MIT License.
+* https://opensource.org/licenses/MIT
+*/
+export module lysa.resources.face_cache;
+
+import std;
+import lysa.types;
+
+export namespace lysa {
+
+    /**
+     * Parsed font files shared by all the fonts using the same file, whatever their size.
+     * A face is loaded by the first font using it and released with the last one.
+     *
+     * The loading is done by the caller, Font uses HarfBuzz. `Face` is the parsed file type.
+     *
+     * Thread-safety: all methods can be called from any thread.
+     */
+    template<typename Face>
+    class FaceCache {
+    public:
+        /**
+         * Returns the face of a font file, calling `load()` to get a new face
+         * if the file is not loaded or was released.
+         */
+        template<typename Load>
+        std::shared_ptr<Face> get(const std::string& path, const Load& load) {
+            auto lock = std::lock_guard{mutex};
+            if (const auto it = faces.find(path); it != faces.end()) {
+                if (auto face = it->second.lock()) {
+                    return face;
+                }
+            }
+            auto face = std::shared_ptr<Face>{load()};
+            faces[path] = face;
+            loadsCount++;
+            return face;
+        }
+
+        /** Returns the number of loaded faces, used by at least one font */
+        uint32 getCount() {
+            auto lock = std::lock_guard{mutex};
+            return static_cast<uint32>(std::ranges::count_if(faces, [](const auto& face) {
+                return !face.second.expired();
+            }));
+        }
+
+        /** Returns the number of font files loaded since the creation of the cache */
+        uint32 getLoadsCount() {
+            auto lock = std::lock_guard{mutex};
+            return loadsCount;
+        }
+
+    private:
+        //! Loaded faces by font path
+        std::unordered_map<std::string, std::weak_ptr<Face>> faces;
+        uint32 loadsCount{0};
+        std::mutex mutex;
+    };
+
+}
@@ -7,9 +7,6 @@
 module;
 #include <json.hpp>
 #include <hb.h>
-#include <hb-ft.h>
-#include <ft2build.h>
-#include FT_FREETYPE_H
 module lysa.resources.font;
 
 import vireo;
@@ -23,22 +20,50 @@ import lysa.window;
 
 namespace lysa {
 
-    FT_Library Font::ftLibrary{nullptr};
+    FaceCache<Font::Face> Font::faces;
 
     void Font::getSize(const std::string &text, const float fontScale, float &width, float &height) {
-        const auto scale = fontScale * size;
         height = fontScale * lineHeight;
-        width = 0;
+        width = shape(text)->width * fontScale * size;
+    }
+
+    std::shared_ptr<const Font::ShapedText> Font::shape(const std::string& text) {
+        const auto atlasGeneration = dynamic ? Application::getResources().getGlyphAtlas().getGeneration() : 0;
+        if (const auto cached = shapedTexts->get(text, atlasGeneration)) {
+            return cached;
+        }
+
+        const auto shapedText = std::make_shared<ShapedText>();
         hb_buffer_t* hb_buffer = hb_buffer_create();
         hb_buffer_add_utf8(hb_buffer, text.c_str(), -1, 0, -1);
         hb_buffer_guess_segment_properties(hb_buffer);
         hb_shape(hbFont, hb_buffer, nullptr, 0);
         unsigned int glyph_count;
         hb_glyph_info_t* glyph_info = hb_buffer_get_glyph_infos(hb_buffer, &glyph_count);
+        shapedText->glyphs.reserve(glyph_count);
         for (unsigned int i = 0; i < glyph_count; i++) {
-            width += glyphs[glyph_info[i].codepoint].advance * scale;
+            const auto glyphInfo = getGlyphInfo(glyph_info[i].codepoint);
+            shapedText->glyphs.push_back({
+                .index = glyphInfo.index,
+                .bounds = {
+                    .left = shapedText->width + glyphInfo.planeBounds.left,
+                    .bottom = glyphInfo.planeBounds.bottom,
+                    .right = shapedText->width + glyphInfo.planeBounds.right,
+                    .top = glyphInfo.planeBounds.top,
+                },
+                .uv0 = glyphInfo.uv0,
+                .uv1 = glyphInfo.uv1,
+            });
+            shapedText->width += glyphInfo.advance;
         }
         hb_buffer_destroy(hb_buffer);
+
+        return shapedTexts->add(
+            text,
+            shapedText,
+            sizeof(ShapedText) + shapedText->glyphs.capacity() * sizeof(ShapedGlyph),
+            atlasGeneration,
+            Application::getConfiguration().resourcesConfig.shapedTextCacheBudget);
     }
 
     Font::Font(const Font &font):
@@ -50,23 +75,54 @@ namespace lysa {
         lineHeight{font.lineHeight},
         params{font.params},
         atlas{font.atlas},
-        glyphs{font.glyphs}  {
-        if (FT_New_Face(ftLibrary, VirtualFS::getPath(path + ".ttf").c_str(), 0, &ftFace)) {
-            if (FT_New_Face(ftLibrary, VirtualFS::getPath(path + ".otf").c_str(), 0, &ftFace)) {
-                throw Exception("Error loading font ", path);
-            }
+        glyphs{font.glyphs},
+        dynamic{font.dynamic},
+        atlasFont{font.atlasFont},
+        glyphsGeneration{font.glyphsGeneration} {
+        openFace();
+        if (dynamic) {
+            addShapedTexts();
         }
-        FT_Set_Char_Size(ftFace, 0, size * 64, 0, 0);
-        hbFont = hb_ft_font_create(ftFace, nullptr);
+    }
+
+    void Font::addShapedTexts() const {
+        Application::getResources().getGlyphAtlas().addShapedTexts(
+            atlasFont,
+            [shapedTexts = std::weak_ptr{shapedTexts}](std::vector<uint32>& glyphIndices) {
+                const auto texts = shapedTexts.lock();
+                if (!texts) {
+                    return false;
+                }
+                texts->forEach([&](const ShapedText& shapedText) {
+                    for (const auto& glyph : shapedText.glyphs) {
+                        glyphIndices.push_back(glyph.index);
+                    }
+                });
+                return true;
+            });
     }
 
     Font::Font(const std::string &path):
         Resource{path},
         path{path} {
-        if (!ftLibrary) {
-            if (FT_Init_FreeType(&ftLibrary)) {
-                throw Exception("Error initializing FreeType");
-            }
+        if (!VirtualFS::fileExists(path + ".json")) {
+            // No precomputed atlas, the glyphs are generated on demand in the shared atlas
+            auto& glyphAtlas = Application::getResources().getGlyphAtlas();
+            dynamic = true;
+            size = static_cast<uint32>(glyphAtlas.getGlyphSize());
+            openFace();
+            const auto atlasSize = static_cast<float>(Application::getConfiguration().resourcesConfig.glyphAtlasSize);
+            params.pxRange = { glyphAtlas.getPixelRange() / atlasSize, glyphAtlas.getPixelRange() / atlasSize };
+            auto extents = hb_font_extents_t{};
+            hb_font_get_h_extents(hbFont, &extents);
+            ascender = static_cast<float>(extents.ascender) / 64.0f;
+            descender = static_cast<float>(extents.descender) / 64.0f;
+            lineHeight = ascender - descender + static_cast<float>(extents.line_gap) / 64.0f;
+            atlasFont = glyphAtlas.addFont(face->filename);
+            this->atlas = glyphAtlas.getImage();
+            glyphsGeneration = glyphAtlas.getGeneration();
+            addShapedTexts();
+            return;
         }
 
         auto json = nlohmann::ordered_json::parse(VirtualFS::openReadStream(path + ".json"));
@@ -79,13 +135,7 @@ namespace lysa {
         const auto pixelRange = atlas["distanceRange"].get<float>();
         params.pxRange = { pixelRange / atlasWidth, pixelRange / atlasHeight };
 
-        if (FT_New_Face(ftLibrary, VirtualFS::getPath(path + ".ttf").c_str(), 0, &ftFace)) {
-            if (FT_New_Face(ftLibrary, VirtualFS::getPath(path + ".otf").c_str(), 0, &ftFace)) {
-                throw Exception("Error loading font ", path);
-            }
-        }
-        FT_Set_Char_Size(ftFace, 0, size * 64, 0, 0);
-        hbFont = hb_ft_font_create(ftFace, nullptr);
+        openFace();
 
         const auto& metrics = json["metrics"];
         lineHeight = metrics["lineHeight"].get<float>() * size;
@@ -112,19 +162,73 @@ namespace lysa {
             }
             glyphs[glyphInfo.index] = glyphInfo;
         }
-        this->atlas = Image::load(path + ".png", vireo::ImageFormat::R8G8B8A8_SRGB);
+        this->atlas = Image::load(path + ".png", vireo::ImageFormat::R8G8B8A8_SRGB, false);
         // INFO("Loaded ", glyphs.size(), " glyphs from ", path);
     }
 
-    const Font::GlyphInfo& Font::getGlyphInfo(const uint32 index) const {
-        if (!glyphs.contains(index)) {
-            return glyphs.at(0);
+    void Font::openFace() {
+        face = faces.get(path, [&] {
+            auto face = std::make_shared<Face>();
+            face->filename = VirtualFS::getPath(path + ".ttf");
+            face->blob = hb_blob_create_from_file_or_fail(face->filename.c_str());
+            if (!face->blob) {
+                face->filename = VirtualFS::getPath(path + ".otf");
+                face->blob = hb_blob_create_from_file_or_fail(face->filename.c_str());
+                if (!face->blob) {
+                    throw Exception("Error loading font ", path);
+                }
+            }
+            face->face = hb_face_create(face->blob, 0);
+            return face;
+        });
+        // Only the scale depends on the font size, in 26.6 fixed point pixels
+        hbFont = hb_font_create(face->face);
+        hb_font_set_scale(hbFont, static_cast<int>(size * 64), static_cast<int>(size * 64));
+    }
+
+    uint32 Font::getFacesCount() {
+        return faces.getCount();
+    }
+
+    Font::Face::~Face() {
+        hb_face_destroy(face);
+        hb_blob_destroy(blob);
+    }
+
+    Font::GlyphInfo Font::getGlyphInfo(const uint32 index) {
+        if (!dynamic) {
+            if (!glyphs.contains(index)) {
+                return glyphs.at(0);
+            }
+            return glyphs.at(index);
+        }
+
+        auto& glyphAtlas = Application::getResources().getGlyphAtlas();
+        auto lock = std::lock_guard{glyphsMutex};
+        if (const auto generation = glyphAtlas.getGeneration(); generation != glyphsGeneration) {
+            // The UV coordinates change when the atlas evicts glyphs
+            glyphs.clear();
+            glyphsGeneration = generation;
+        }
+        if (const auto it = glyphs.find(index); it != glyphs.end()) {
+            return it->second;
+        }
+        auto glyphInfo = GlyphInfo {
+            .index = index,
+            .advance = static_cast<float>(hb_font_get_glyph_h_advance(hbFont, index)) / (64.0f * size),
+        };
+        auto glyph = GlyphAtlas::Glyph{};
+        if (glyphAtlas.getGlyph(atlasFont, index, glyph)) {
+            glyphInfo.planeBounds = { glyph.left, glyph.bottom, glyph.right, glyph.top };
+            glyphInfo.uv0 = glyph.uv0;
+            glyphInfo.uv1 = glyph.uv1;
+            // Glyphs not yet generated are drawn empty and are not cached
+            glyphs[index] = glyphInfo;
         }
-        return glyphs.at(index);
+        return glyphInfo;
     }
 
     Font::~Font() {
         hb_font_destroy(hbFont);
-        FT_Done_Face(ftFace);
     }
 }
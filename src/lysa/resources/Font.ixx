@@ -6,13 +6,14 @@
 */
 module;
 #include <hb.h>
-#include <hb-ft.h>
-#include FT_FREETYPE_H
 export module lysa.resources.font;
 
 import std;
+import lysa.resources.face_cache;
+import lysa.resources.glyph_atlas;
 import lysa.resources.image;
 import lysa.resources.resource;
+import lysa.resources.shaped_text_cache;
 import lysa.constants;
 import lysa.math;
 import lysa.types;
@@ -33,6 +34,9 @@ export namespace lysa {
     /**
      * %A font resource to render text
      * %A font is a combination of a font file name and a size.
+     *
+     * Fonts with a precomputed MTSDF atlas (`.json` and `.png` files next to the font file)
+     * use it, the other fonts use the glyphs generated on demand in the shared GlyphAtlas.
      */
     class Font : public Resource {
     public:
@@ -53,6 +57,24 @@ export namespace lysa {
             float2 uv1{0.0f};
         };
 
+        /** %A glyph of a shaped text */
+        struct ShapedGlyph {
+            uint32 index{0};
+            //! Quad of the glyph relative to the text origin, in em units
+            GlyphBounds bounds{};
+            float2 uv0{0.0f};
+            float2 uv1{0.0f};
+        };
+
+        /** Result of the shaping of a string, ready to be scaled & positioned */
+        struct ShapedText {
+            std::vector<ShapedGlyph> glyphs;
+            //! Sum of the glyphs advances, in em units
+            float width{0.0f};
+        };
+
+        using ShapedTextCacheStatistics = ShapedTextCache<ShapedText>::Statistics;
+
         /**
          * Creates a font resource
          * @param path : font file path, relative to the application working directory
@@ -80,7 +102,24 @@ export namespace lysa {
 
         auto getDescender() const { return descender; }
 
-        const GlyphInfo& getGlyphInfo(uint32 index) const;
+        /**
+         * Returns the metrics and the atlas position of a glyph.
+         * For fonts using the shared glyph atlas, the bounds are empty until the glyph is generated.
+         */
+        GlyphInfo getGlyphInfo(uint32 index);
+
+        /** Returns true if the glyphs are generated on demand in the shared glyph atlas */
+        auto isDynamic() const { return dynamic; }
+
+        /**
+         * Shapes a string with HarfBuzz. The results are kept in a LRU cache with a memory
+         * budget (see ResourcesConfiguration::shapedTextCacheBudget) since the same labels are
+         * usually drawn every frame.
+         */
+        std::shared_ptr<const ShapedText> shape(const std::string& text);
+
+        /** Returns the shaped texts cache statistics */
+        ShapedTextCacheStatistics getShapedTextCacheStatistics() { return shapedTexts->getStatistics(); }
 
         auto getAtlas() const { return atlas; }
 
@@ -112,6 +151,9 @@ export namespace lysa {
 
         auto getHarfBuzzFont() const { return hbFont; }
 
+        /** Returns the number of font files loaded and shared by the fonts */
+        static uint32 getFacesCount();
+
     private:
         const std::string path;
         uint32 size;
@@ -121,10 +163,39 @@ export namespace lysa {
         FontParams params;
         std::shared_ptr<Image> atlas;
         std::unordered_map<uint32, GlyphInfo> glyphs;
+        //! Glyphs generated on demand in the shared glyph atlas
+        bool dynamic{false};
+        GlyphAtlas::FontId atlasFont{0};
+        //! Glyph atlas generation of the cached glyphs, for the dynamic fonts
+        uint32 glyphsGeneration{0};
+        std::mutex glyphsMutex;
+
+        /**
+         * Parsed font file shared by all the fonts using the same file, whatever their size.
+         * Each font only has its own scaled HarfBuzz font.
+         */
+        struct Face {
+            std::string filename;
+            hb_blob_t* blob{nullptr};
+            hb_face_t* face{nullptr};
+            ~Face();
+        };
+
+        //! Loaded faces by font path, released with the last font using them
+        static FaceCache<Face> faces;
 
-        static FT_Library ftLibrary;
-        FT_Face ftFace{nullptr};
+        std::shared_ptr<Face> face;
         hb_font_t* hbFont{nullptr};
+
+        //! Shaped texts, with the glyph atlas generation used to shape them for the dynamic fonts.
+        //! Shared with the glyph atlas eviction, which keeps the glyphs of the cached texts
+        std::shared_ptr<ShapedTextCache<ShapedText>> shapedTexts{std::make_shared<ShapedTextCache<ShapedText>>()};
+
+        // Gets the shared face of the font file, loading it if needed, and creates the scaled HarfBuzz font
+        void openFace();
+
+        // Registers the glyphs of the cached texts in the shared glyph atlas, for the dynamic fonts
+        void addShapedTexts() const;
     };
 
 }
@@ -0,0 +1,481 @@
+/*
+* Copyright (c) 2025-present Henri Michelon
+*
+* This software is released under the MIT License.
+* https://opensource.org/licenses/MIT
+*/
+module;
+#include <ft2build.h>
+#include FT_FREETYPE_H
+#include <msdfgen.h>
+#include <msdfgen-ext.h>
+module lysa.resources.glyph_atlas;
+
+import lysa.application;
+import lysa.exception;
+import lysa.log;
+
+namespace lysa {
+
+    SkylinePacker::SkylinePacker(const uint32 width, const uint32 height):
+        width{width},
+        height{height} {
+        clear();
+    }
+
+    void SkylinePacker::clear() {
+        skyline.clear();
+        skyline.push_back({0, 0, width});
+        usedArea = 0;
+    }
+
+    bool SkylinePacker::fit(const std::size_t index, const uint32 width, const uint32 height, uint32& y) const {
+        if (skyline[index].x + width > this->width) {
+            return false;
+        }
+        // The rectangle lies on the highest segment it covers
+        y = 0;
+        auto covered = 0u;
+        for (auto i = index; covered < width; i++) {
+            y = std::max(y, skyline[i].y);
+            if (y + height > this->height) {
+                return false;
+            }
+            covered += skyline[i].width;
+        }
+        return true;
+    }
+
+    bool SkylinePacker::pack(const uint32 width, const uint32 height, uint32& x, uint32& y) {
+        if (width == 0 || height == 0 || width > this->width || height > this->height) {
+            return false;
+        }
+        constexpr auto NOT_FOUND = std::numeric_limits<std::size_t>::max();
+        auto bestIndex = NOT_FOUND;
+        auto bestBottom = std::numeric_limits<uint32>::max();
+        auto bestWidth = std::numeric_limits<uint32>::max();
+        for (auto i = 0; i < skyline.size(); i++) {
+            uint32 top;
+            if (fit(i, width, height, top)) {
+                const auto bottom = top + height;
+                if (bottom < bestBottom || (bottom == bestBottom && skyline[i].width < bestWidth)) {
+                    bestIndex = i;
+                    bestBottom = bottom;
+                    bestWidth = skyline[i].width;
+                    x = skyline[i].x;
+                    y = top;
+                }
+            }
+        }
+        if (bestIndex == NOT_FOUND) {
+            return false;
+        }
+
+        // New segment on top of the rectangle
+        skyline.insert(skyline.begin() + bestIndex, Segment{x, y + height, width});
+        // Shrinks or removes the segments under the rectangle
+        const auto right = x + width;
+        for (auto i = bestIndex + 1; i < skyline.size();) {
+            auto& segment = skyline[i];
+            if (segment.x >= right) {
+                break;
+            }
+            const auto shrink = right - segment.x;
+            if (segment.width <= shrink) {
+                skyline.erase(skyline.begin() + i);
+                continue;
+            }
+            segment.x += shrink;
+            segment.width -= shrink;
+            break;
+        }
+        // Merges the neighbor segments at the same height
+        for (auto i = 0; i + 1 < skyline.size();) {
+            if (skyline[i].y == skyline[i + 1].y) {
+                skyline[i].width += skyline[i + 1].width;
+                skyline.erase(skyline.begin() + i + 1);
+            } else {
+                i++;
+            }
+        }
+        usedArea += static_cast<uint64>(width) * height;
+        return true;
+    }
+
+    GlyphAtlas::GlyphAtlas(const ResourcesConfiguration& config):
+        config{config},
+        packer{config.glyphAtlasSize, config.glyphAtlasSize},
+        pixels(static_cast<std::size_t>(config.glyphAtlasSize) * config.glyphAtlasSize * 4, 0) {
+    }
+
+    GlyphAtlas::~GlyphAtlas() {
+        cleanup();
+    }
+
+    GlyphAtlas::FontId GlyphAtlas::addFont(const std::string& filename) {
+        auto fontId = FontId{0};
+        {
+            auto lock = std::lock_guard{mutex};
+            const auto it = std::ranges::find(fonts, filename, &FontSource::filename);
+            if (it != fonts.end()) {
+                return static_cast<FontId>(std::distance(fonts.begin(), it));
+            }
+            // The atlas has its own FreeType faces, used by the generation threads
+            if (!ftLibrary && FT_Init_FreeType(&ftLibrary)) {
+                throw Exception("Error initializing FreeType");
+            }
+            FT_Face face;
+            if (FT_New_Face(ftLibrary, filename.c_str(), 0, &face)) {
+                throw Exception("Error loading font ", filename);
+            }
+            fontId = static_cast<FontId>(fonts.size());
+            fonts.push_back({ filename, face, std::make_unique<std::mutex>() });
+        }
+        // Created outside the lock : the creation locks the textures table, which is locked
+        // before the atlas in update()
+        std::call_once(imageCreated, [&] {
+            const auto newImage = Image::create(
+                pixels.data(),
+                config.glyphAtlasSize,
+                config.glyphAtlasSize,
+                vireo::ImageFormat::R8G8B8A8_SRGB,
+                "Glyph atlas");
+            auto lock = std::lock_guard{mutex};
+            image = newImage;
+        });
+        return fontId;
+    }
+
+    bool GlyphAtlas::getGlyph(const FontId font, const uint32 glyphIndex, Glyph& glyph) {
+        auto lock = std::lock_guard{mutex};
+        const auto [it, inserted] = entries.try_emplace(getKey(font, glyphIndex));
+        it->second.lastUsedFrame = frame;
+        if (inserted) {
+            requests[font].push_back(glyphIndex);
+        }
+        if (!it->second.ready) {
+            return false;
+        }
+        glyph = it->second.glyph;
+        return true;
+    }
+
+    void GlyphAtlas::addShapedTexts(const FontId font, std::function<bool(std::vector<uint32>&)> getGlyphs) {
+        auto lock = std::lock_guard{mutex};
+        shapedTexts.push_back({ font, std::move(getGlyphs) });
+    }
+
+    bool GlyphAtlas::update(TextureSlots<std::shared_ptr<vireo::Image>>& textures) {
+        auto lock = std::lock_guard{mutex};
+        auto moved = false;
+        frame += 1;
+
+        // Packs the generated glyphs
+        for (auto it = jobs.begin(); it != jobs.end();) {
+            if (!it->job->isFinished()) {
+                ++it;
+                continue;
+            }
+            auto& bitmaps = it->result->bitmaps;
+            if (it->result->error) {
+                try {
+                    std::rethrow_exception(it->result->error);
+                } catch (const std::exception& e) {
+                    ERROR("Glyphs generation failed for ", fonts[it->font].filename, " : ", e.what());
+                }
+                // Failed glyphs stay empty
+                bitmaps.clear();
+                bitmaps.resize(it->glyphIndices.size());
+            }
+            for (auto i = 0; i < it->glyphIndices.size(); i++) {
+                const auto entry = entries.find(getKey(it->font, it->glyphIndices[i]));
+                if (entry == entries.end()) { continue; }
+                entry->second.bitmap = std::move(bitmaps[i]);
+                moved |= insert(entry->second);
+            }
+            it = jobs.erase(it);
+        }
+
+        // Starts the generation of the requested glyphs
+        for (auto request = requests.begin(); request != requests.end() && jobs.size() < config.glyphAtlasMaxJobs;) {
+            // One job per font : the jobs of the same font would wait for each other on the face mutex
+            if (std::ranges::find(jobs, request->first, &Job::font) != jobs.end()) {
+                ++request;
+                continue;
+            }
+            auto& glyphIndices = request->second;
+            const auto count = std::min(static_cast<std::size_t>(GLYPHS_PER_JOB), glyphIndices.size());
+            auto jobGlyphIndices = std::vector<uint32>(glyphIndices.end() - count, glyphIndices.end());
+            glyphIndices.resize(glyphIndices.size() - count);
+            const auto& source = fonts[request->first];
+            auto result = std::make_shared<JobResult>();
+            // Jobs must not throw, the error is reported by update()
+            auto job = Application::getJobSystem().schedule(
+                [
+                    result,
+                    face = source.face,
+                    faceMutex = source.mutex.get(),
+                    glyphIndices = jobGlyphIndices,
+                    glyphSize = config.glyphAtlasGlyphSize,
+                    pixelRange = config.glyphAtlasPixelRange] {
+                    try {
+                        auto faceLock = std::lock_guard{*faceMutex};
+                        result->bitmaps.reserve(glyphIndices.size());
+                        for (const auto glyphIndex : glyphIndices) {
+                            result->bitmaps.push_back(generate(face, glyphIndex, glyphSize, pixelRange));
+                        }
+                    } catch (...) {
+                        result->error = std::current_exception();
+                    }
+                },
+                JobPriority::LOW);
+            jobs.push_back({
+                .font = request->first,
+                .glyphIndices = std::move(jobGlyphIndices),
+                .job = std::move(job),
+                .result = std::move(result),
+            });
+            if (glyphIndices.empty()) {
+                request = requests.erase(request);
+            } else {
+                ++request;
+            }
+        }
+
+        if (!uploadPending || !image) {
+            return false;
+        }
+        // The glyphs generated during the next frames are uploaded with these ones, unless the
+        // packed glyphs have been moved : their new UV coordinates are already visible
+        const auto generating = !jobs.empty() || !requests.empty();
+        if (!moved && generating && frame < firstPendingFrame + config.glyphAtlasUploadDelay) {
+            return false;
+        }
+        const auto newImage = upload();
+        image->setImage(newImage);
+        textures.set(image->getIndex(), newImage);
+        for (auto& entry : entries | std::views::values) {
+            if (entry.packed) {
+                entry.ready = true;
+            }
+        }
+        uploadPending = false;
+        generation += 1;
+        return true;
+    }
+
+    bool GlyphAtlas::insert(Entry& entry) {
+        entry.glyph = {};
+        if (entry.bitmap.width == 0 || entry.bitmap.height == 0) {
+            // Nothing to draw, nothing to upload
+            entry.ready = true;
+            return false;
+        }
+        const auto width = entry.bitmap.width + GLYPH_PADDING;
+        const auto height = entry.bitmap.height + GLYPH_PADDING;
+        auto evicted = false;
+        if (!packer.pack(width, height, entry.x, entry.y)) {
+            // The glyph is not packed yet : it is neither moved nor erased by the eviction
+            evict();
+            evicted = true;
+            if (!packer.pack(width, height, entry.x, entry.y)) {
+                ERROR("Glyph of ", entry.bitmap.width, "x", entry.bitmap.height, " pixels too large for the glyph atlas");
+                entry.bitmap = {};
+                entry.ready = true;
+                return evicted;
+            }
+        }
+        blit(entry);
+        entry.packed = true;
+        if (!uploadPending) {
+            uploadPending = true;
+            firstPendingFrame = frame;
+        }
+        return evicted;
+    }
+
+    void GlyphAtlas::blit(Entry& entry) {
+        const auto& bitmap = entry.bitmap;
+        const auto rowSize = static_cast<std::size_t>(bitmap.width) * 4;
+        for (auto row = 0; row < bitmap.height; row++) {
+            std::memcpy(
+                &pixels[(static_cast<std::size_t>(entry.y + row) * config.glyphAtlasSize + entry.x) * 4],
+                &bitmap.pixels[row * rowSize],
+                rowSize);
+        }
+        const auto size = static_cast<float>(config.glyphAtlasSize);
+        entry.glyph = {
+            .left = bitmap.left,
+            .bottom = bitmap.bottom,
+            .right = bitmap.right,
+            .top = bitmap.top,
+            // Same convention as the precomputed atlases : bottom-left origin
+            .uv0 = { entry.x / size, (size - entry.y) / size },
+            .uv1 = { (entry.x + bitmap.width) / size, (size - entry.y - bitmap.height) / size },
+        };
+    }
+
+    void GlyphAtlas::evict() {
+        // The glyphs of the texts in the fonts caches are not asked again while these texts are
+        // drawn (cache hits, UI windows geometries) : they are considered used by this frame
+        auto glyphIndices = std::vector<uint32>{};
+        std::erase_if(shapedTexts, [&](const auto& fontTexts) {
+            glyphIndices.clear();
+            if (!fontTexts.second(glyphIndices)) {
+                return true;
+            }
+            for (const auto glyphIndex : glyphIndices) {
+                if (const auto it = entries.find(getKey(fontTexts.first, glyphIndex)); it != entries.end()) {
+                    it->second.lastUsedFrame = frame;
+                }
+            }
+            return false;
+        });
+        auto packedEntries = std::vector<std::pair<uint64, Entry*>>{};
+        for (auto& [key, entry] : entries) {
+            if (entry.packed) {
+                packedEntries.push_back({ key, &entry });
+            }
+        }
+        std::ranges::sort(packedEntries, std::ranges::greater{}, [](const auto& packedEntry) {
+            return packedEntry.second->lastUsedFrame;
+        });
+        // The most recently used glyphs are packed again in the first half of the atlas,
+        // leaving room for the next glyphs
+        packer.clear();
+        std::ranges::fill(pixels, 0);
+        const auto maxArea = static_cast<uint64>(config.glyphAtlasSize) * config.glyphAtlasSize / 2;
+        auto evicted = 0;
+        for (const auto& [key, entry] : packedEntries) {
+            if (packer.getUsedArea() < maxArea &&
+                packer.pack(entry->bitmap.width + GLYPH_PADDING, entry->bitmap.height + GLYPH_PADDING, entry->x, entry->y)) {
+                blit(*entry);
+            } else {
+                // Generated again on the next use
+                entries.erase(key);
+                evicted++;
+            }
+        }
+        // The moved glyphs are uploaded with the next update
+        uploadPending = true;
+        firstPendingFrame = frame;
+        INFO("Glyph atlas full, ", evicted, " glyphs evicted");
+    }
+
+    std::shared_ptr<vireo::Image> GlyphAtlas::upload() const {
+        const auto& vireo = Application::getVireo();
+        auto& asyncQueue = Application::getAsyncQueue();
+        // Same format as the precomputed atlases loaded by Font, the glyphs shader parameters are tuned for it
+        const auto newImage = vireo.createImage(
+            vireo::ImageFormat::R8G8B8A8_SRGB,
+            config.glyphAtlasSize,
+            config.glyphAtlasSize,
+            1,
+            1,
+            "Glyph atlas");
+
+        const auto command = asyncQueue.beginCommand(vireo::CommandType::GRAPHIC);
+        const auto stagingBuffer = asyncQueue.createBuffer(
+            command,
+            vireo::BufferType::IMAGE_UPLOAD,
+            pixels.size(),
+            1);
+        stagingBuffer->map();
+        stagingBuffer->write(pixels.data(), pixels.size(), 0);
+        command.commandList->barrier(newImage, vireo::ResourceState::UNDEFINED, vireo::ResourceState::COPY_DST);
+        command.commandList->copy(*stagingBuffer, *newImage, std::vector<size_t>{0});
+        command.commandList->barrier(newImage, vireo::ResourceState::COPY_DST, vireo::ResourceState::SHADER_READ);
+        asyncQueue.endCommand(command);
+        return newImage;
+    }
+
+    GlyphAtlas::Bitmap GlyphAtlas::generate(
+        const FT_Face face,
+        const uint32 glyphIndex,
+        const float glyphSize,
+        const float pixelRange) {
+        auto* fontHandle = msdfgen::adoptFreetypeFont(face);
+        if (!fontHandle) {
+            throw Exception("Error reading the font outlines");
+        }
+        auto shape = msdfgen::Shape{};
+        const auto loaded = msdfgen::loadGlyph(
+            shape,
+            fontHandle,
+            msdfgen::GlyphIndex(glyphIndex),
+            msdfgen::FONT_SCALING_EM_NORMALIZED);
+        msdfgen::destroyFont(fontHandle);
+        if (!loaded) {
+            return {};
+        }
+        return generate(std::move(shape), glyphSize, pixelRange);
+    }
+
+    GlyphAtlas::Bitmap GlyphAtlas::generate(msdfgen::Shape shape, const float glyphSize, const float pixelRange) {
+        auto bitmap = Bitmap{};
+        if (shape.contours.empty()) {
+            return bitmap;
+        }
+        shape.normalize();
+        msdfgen::edgeColoringSimple(shape, 3.0);
+
+        // Half of the range around the outline, in em units
+        const auto bounds = shape.getBounds();
+        const auto margin = 0.5 * pixelRange / glyphSize;
+        bitmap.width = static_cast<uint32>(std::ceil((bounds.r - bounds.l + 2.0 * margin) * glyphSize));
+        bitmap.height = static_cast<uint32>(std::ceil((bounds.t - bounds.b + 2.0 * margin) * glyphSize));
+        bitmap.left = static_cast<float>(bounds.l - margin);
+        bitmap.bottom = static_cast<float>(bounds.b - margin);
+        bitmap.right = bitmap.left + bitmap.width / glyphSize;
+        bitmap.top = bitmap.bottom + bitmap.height / glyphSize;
+
+        auto mtsdf = msdfgen::Bitmap<float, 4>(bitmap.width, bitmap.height);
+        msdfgen::generateMTSDF(
+            mtsdf,
+            shape,
+            msdfgen::Projection(glyphSize, msdfgen::Vector2(-bitmap.left, -bitmap.bottom)),
+            pixelRange / glyphSize);
+
+        // msdfgen bitmaps rows are from bottom to top
+        bitmap.pixels.resize(static_cast<std::size_t>(bitmap.width) * bitmap.height * 4);
+        for (auto y = 0; y < bitmap.height; y++) {
+            for (auto x = 0; x < bitmap.width; x++) {
+                const auto* pixel = mtsdf(x, bitmap.height - 1 - y);
+                for (auto channel = 0; channel < 4; channel++) {
+                    bitmap.pixels[(static_cast<std::size_t>(y) * bitmap.width + x) * 4 + channel] =
+                        msdfgen::pixelFloatToByte(pixel[channel]);
+                }
+            }
+        }
+        return bitmap;
+    }
+
+    void GlyphAtlas::cleanup() {
+        // Released outside the lock, like in addFont() : the release locks the textures table
+        auto oldImage = std::shared_ptr<Image>{};
+        auto lock = std::unique_lock{mutex};
+        // The jobs use the faces. Waited outside the lock : the waiting thread executes other
+        // jobs, which can use the atlas
+        const auto runningJobs = std::move(jobs);
+        jobs.clear();
+        lock.unlock();
+        for (const auto& job : runningJobs) {
+            Application::getJobSystem().wait(job.job);
+        }
+        lock.lock();
+        requests.clear();
+        entries.clear();
+        oldImage = std::move(image);
+        for (const auto& font : fonts) {
+            FT_Done_Face(font.face);
+        }
+        fonts.clear();
+        if (ftLibrary) {
+            FT_Done_FreeType(ftLibrary);
+            ftLibrary = nullptr;
+        }
+        lock.unlock();
+        oldImage.reset();
+    }
+
+}
@@ -0,0 +1,257 @@
+/*
+* Copyright (c) 2025-present Henri Michelon
+*
+* This software is released under the MIT License.
+* https://opensource.org/licenses/MIT
+*/
+module;
+#include <ft2build.h>
+#include FT_FREETYPE_H
+#include <msdfgen.h>
+export module lysa.resources.glyph_atlas;
+
+import std;
+import vireo;
+import lysa.configuration;
+import lysa.job_system;
+import lysa.math;
+import lysa.texture_slots;
+import lysa.types;
+import lysa.resources.image;
+
+export namespace lysa {
+
+    /**
+     * Rectangles packer using the skyline bottom-left heuristic, without any GPU dependency.
+     * The skyline is the list of the highest occupied rows for each range of columns, new
+     * rectangles are placed on top of the skyline where they end the lowest.
+     * Rectangles can't be removed individually : clear() the packer and pack them again.
+     *
+     * Coordinates are in pixels, with the origin at the top-left corner.
+     */
+    class SkylinePacker {
+    public:
+        SkylinePacker(uint32 width, uint32 height);
+
+        /**
+         * Finds a place for a rectangle.
+         * Returns false if the rectangle does not fit.
+         */
+        bool pack(uint32 width, uint32 height, uint32& x, uint32& y);
+
+        /** Removes all the rectangles */
+        void clear();
+
+        /** Returns the area covered by the packed rectangles, in pixels */
+        auto getUsedArea() const { return usedArea; }
+
+        auto getWidth() const { return width; }
+
+        auto getHeight() const { return height; }
+
+    private:
+        struct Segment {
+            uint32 x;
+            // Lowest free row of the segment
+            uint32 y;
+            uint32 width;
+        };
+
+        const uint32 width;
+        const uint32 height;
+        uint64 usedArea{0};
+        std::vector<Segment> skyline;
+
+        // Returns the row where a rectangle starting at the segment `index` can be placed,
+        // or false if it does not fit
+        bool fit(std::size_t index, uint32 width, uint32 height, uint32& y) const;
+    };
+
+    /**
+     * Multi-channel signed distance field glyphs atlas shared by the fonts without a
+     * precomputed atlas (see Font).
+     *  - Glyphs are generated on demand from the font files with msdfgen, in low priority
+     *    jobs of the JobSystem. A glyph is drawn empty until it has been uploaded.
+     *  - Generated glyphs are packed with a SkylinePacker in a CPU copy of one RGBA image
+     *    shared by all the fonts. The glyphs generated during the same frames are uploaded
+     *    together in a new GPU image, see ResourcesConfiguration::glyphAtlasUploadDelay.
+     *  - When the atlas is full, the least recently used glyphs are evicted and the other
+     *    glyphs are packed again, changing their UV coordinates. The glyphs of the texts kept
+     *    by the fonts (see addShapedTexts()) are used, even if their text is not shaped again.
+     *  - Each change of the GPU image increments the atlas generation : the users of the
+     *    glyphs UV coordinates must query them again.
+     *
+     * Thread-safety: addFont() and getGlyph() can be called from any thread, update() is
+     * called by Resources::update() from the main thread.
+     */
+    class GlyphAtlas {
+    public:
+        using FontId = uint32;
+
+        /** Position of a generated glyph */
+        struct Glyph {
+            //! Quad of the glyph relative to the pen position, in em units
+            float left{0.0f};
+            float bottom{0.0f};
+            float right{0.0f};
+            float top{0.0f};
+            //! UV coordinates in the atlas image, bottom-left origin
+            float2 uv0{0.0f};
+            float2 uv1{0.0f};
+        };
+
+        /** MTSDF bitmap of a glyph, 4 x 8 bits per pixel */
+        struct Bitmap {
+            uint32 width{0};
+            uint32 height{0};
+            //! Rows from top to bottom
+            std::vector<uint8> pixels;
+            //! Quad of the bitmap relative to the pen position, in em units
+            float left{0.0f};
+            float bottom{0.0f};
+            float right{0.0f};
+            float top{0.0f};
+        };
+
+        GlyphAtlas(const ResourcesConfiguration& config);
+
+        /**
+         * Registers a font file, returns the same id for the same file.
+         * The atlas image is created with the first font.
+         */
+        FontId addFont(const std::string& filename);
+
+        /**
+         * Returns the position of a glyph in the atlas.
+         * Returns false and requests the glyph generation if the glyph is not yet generated.
+         */
+        bool getGlyph(FontId font, uint32 glyphIndex, Glyph& glyph);
+
+        /**
+         * Adds the glyphs used by the texts shaped with a font, and drawn without asking
+         * the atlas again, to the glyphs used by the frame when the atlas is full.
+         * `getGlyphs(glyphIndices)` appends the indices of the glyphs and returns false once the
+         * texts are released : it is then removed.
+         */
+        void addShapedTexts(FontId font, std::function<bool(std::vector<uint32>&)> getGlyphs);
+
+        /** Returns the atlas image shared by the fonts */
+        auto getImage() const { return image; }
+
+        /** Size of one em in the atlas, in pixels */
+        auto getGlyphSize() const { return config.glyphAtlasGlyphSize; }
+
+        /** Distance field range in pixels */
+        auto getPixelRange() const { return config.glyphAtlasPixelRange; }
+
+        /** Returns the number of GPU image changes since the creation of the atlas */
+        uint32 getGeneration() const { return generation.load(); }
+
+        /**
+         * Starts the requested glyphs generations, packs the generated glyphs and replaces
+         * the GPU image in the textures table if needed.
+         * Returns true if the textures table has been modified.
+         */
+        bool update(TextureSlots<std::shared_ptr<vireo::Image>>& textures);
+
+        /** Waits for the generations in progress and releases the fonts and the image */
+        void cleanup();
+
+        /**
+         * Generates the MTSDF bitmap of a glyph. The result only depends on the font file
+         * and the parameters. Returns an empty bitmap for glyphs without outline (spaces).
+         * @param glyphSize     Size of one em in pixels
+         * @param pixelRange    Distance field range in pixels
+         */
+        static Bitmap generate(FT_Face face, uint32 glyphIndex, float glyphSize, float pixelRange);
+
+        /**
+         * Generates the MTSDF bitmap of a glyph outline in em units. The result only depends
+         * on the outline and the parameters. Returns an empty bitmap for an empty outline.
+         */
+        static Bitmap generate(msdfgen::Shape shape, float glyphSize, float pixelRange);
+
+        ~GlyphAtlas();
+        GlyphAtlas(GlyphAtlas&) = delete;
+        GlyphAtlas& operator=(GlyphAtlas&) = delete;
+
+    private:
+        // Pixels between the glyphs, avoids bleeding with the linear filtering
+        static constexpr uint32 GLYPH_PADDING{1};
+        // Number of glyphs generated by one background job
+        static constexpr uint32 GLYPHS_PER_JOB{16};
+
+        struct FontSource {
+            std::string filename;
+            FT_Face face{nullptr};
+            // Faces can't be used by multiple threads at the same time
+            std::unique_ptr<std::mutex> mutex;
+        };
+
+        struct Entry {
+            // Returned by getGlyph() : the glyph is in the GPU image or has nothing to draw
+            bool   ready{false};
+            // Copied in the CPU atlas, ready with the next upload
+            bool   packed{false};
+            Glyph  glyph;
+            Bitmap bitmap;
+            // Position of the bitmap in the atlas, top-left origin
+            uint32 x{0};
+            uint32 y{0};
+            uint64 lastUsedFrame{0};
+        };
+
+        // Written by the generation job, read once the job is finished
+        struct JobResult {
+            std::vector<Bitmap> bitmaps;
+            std::exception_ptr error;
+        };
+
+        struct Job {
+            FontId font;
+            std::vector<uint32> glyphIndices;
+            JobHandle job;
+            std::shared_ptr<JobResult> result;
+        };
+
+        const ResourcesConfiguration& config;
+        FT_Library ftLibrary{nullptr};
+        std::vector<FontSource> fonts;
+        // Glyphs by font id (high 32 bits) and glyph index (low 32 bits)
+        std::unordered_map<uint64, Entry> entries;
+        // Glyphs waiting for a generation job, by font
+        std::map<FontId, std::vector<uint32>> requests;
+        std::list<Job> jobs;
+        // Functions returning the glyphs of the texts kept by the fonts, by font
+        std::vector<std::pair<FontId, std::function<bool(std::vector<uint32>&)>>> shapedTexts;
+        SkylinePacker packer;
+        // CPU copy of the atlas, rows from top to bottom
+        std::vector<uint8> pixels;
+        std::shared_ptr<Image> image;
+        std::once_flag imageCreated;
+        std::atomic<uint32> generation{0};
+        uint64 frame{0};
+        // Glyphs packed since the last upload
+        bool uploadPending{false};
+        uint64 firstPendingFrame{0};
+        std::mutex mutex;
+
+        static uint64 getKey(const FontId font, const uint32 glyphIndex) {
+            return (static_cast<uint64>(font) << 32) | glyphIndex;
+        }
+
+        // Places a generated glyph in the CPU atlas, evicting the least recently used glyphs if needed.
+        // Returns true if the packed glyphs have been moved or evicted.
+        bool insert(Entry& entry);
+
+        // Copies the bitmap of a glyph in the CPU atlas and computes the UV coordinates
+        void blit(Entry& entry);
+
+        // Removes the least recently used glyphs and packs the others again
+        void evict();
+
+        // Creates the new GPU image and records the upload of the atlas
+        std::shared_ptr<vireo::Image> upload() const;
+    };
+
+}
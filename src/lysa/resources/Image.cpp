@@ -22,20 +22,44 @@ namespace lysa {
         index{Application::getResources().addTexture(*this)} {
     }
 
+    Image::~Image() {
+        Application::getResources().removeTexture(index);
+    }
+
     std::shared_ptr<Image> Image::create(
         const void* data,
         const uint32 width, const uint32 height,
         const vireo::ImageFormat imageFormat,
-        const std::string& name) {
+        const std::string& name,
+        const bool generateMips) {
         const auto& vireo = Application::getVireo();
-        const auto image = vireo.createImage(imageFormat, width, height, 1, 1, name);
+        const auto mipsSupported =
+            imageFormat == vireo::ImageFormat::R8G8B8A8_SRGB ||
+            imageFormat == vireo::ImageFormat::R8G8B8A8_UNORM;
+        const auto mipLevels = generateMips && mipsSupported ? getMipLevelsCount(width, height) : 1;
+        const auto image = vireo.createImage(imageFormat, width, height, mipLevels, 1, name);
 
         const auto commandAllocator = vireo.createCommandAllocator(vireo::CommandType::GRAPHIC);
         const auto commandList = commandAllocator->createCommandList();
         commandList->begin();
-        commandList->barrier(image, vireo::ResourceState::UNDEFINED, vireo::ResourceState::COPY_DST);
-        commandList->upload(image, data);
-        commandList->barrier(image, vireo::ResourceState::COPY_DST, vireo::ResourceState::SHADER_READ);
+        commandList->barrier(image, vireo::ResourceState::UNDEFINED, vireo::ResourceState::COPY_DST, 0, mipLevels);
+        auto stagingBuffer = std::shared_ptr<vireo::Buffer>{};
+        if (mipLevels > 1) {
+            // Upload all the levels at once from one staging buffer
+            const auto* pixels = static_cast<const uint8*>(data);
+            auto levels = std::vector<uint8>(pixels, pixels + static_cast<size_t>(width) * height * 4);
+            const auto offsets = Image::generateMips(
+                levels, width, height, mipLevels,
+                imageFormat == vireo::ImageFormat::R8G8B8A8_SRGB);
+            stagingBuffer = vireo.createBuffer(vireo::BufferType::IMAGE_UPLOAD, levels.size());
+            stagingBuffer->map();
+            stagingBuffer->write(levels.data(), levels.size(), 0);
+            stagingBuffer->unmap();
+            commandList->copy(*stagingBuffer, *image, offsets);
+        } else {
+            commandList->upload(image, data);
+        }
+        commandList->barrier(image, vireo::ResourceState::COPY_DST, vireo::ResourceState::SHADER_READ, 0, mipLevels);
         commandList->end();
 
         const auto& graphicQueue = Application::getGraphicQueue();
@@ -47,16 +71,88 @@ namespace lysa {
 
     std::shared_ptr<Image> Image::load(
         const std::string &filepath,
-        const vireo::ImageFormat imageFormat) {
+        const vireo::ImageFormat imageFormat,
+        const bool generateMips) {
         uint32 texWidth, texHeight;
         uint64 imageSize;
         auto *pixels = VirtualFS::loadRGBAImage(filepath, texWidth, texHeight, imageSize);
         if (!pixels) { throw Exception("failed to load texture image ", filepath); }
-        auto image = create(pixels, texWidth, texHeight, imageFormat, filepath);
+        auto image = create(pixels, texWidth, texHeight, imageFormat, filepath, generateMips);
         VirtualFS::destroyImage(pixels);
         return image;
     }
 
+    uint32 Image::getMipLevelsCount(const uint32 width, const uint32 height) {
+        return static_cast<uint32>(std::floor(std::log2(std::max(width, height)))) + 1;
+    }
+
+    std::vector<size_t> Image::generateMips(
+        std::vector<uint8>& data,
+        const uint32 width, const uint32 height,
+        const uint32 mipLevels,
+        const bool sRGB) {
+        // sRGB to linear conversion table, the levels are averaged in linear space
+        static const auto toLinear = [] {
+            auto table = std::array<float, 256>{};
+            for (auto i = 0; i < 256; i++) {
+                const auto c = static_cast<float>(i) / 255.0f;
+                table[i] = c <= 0.04045f ? c / 12.92f : std::pow((c + 0.055f) / 1.055f, 2.4f);
+            }
+            return table;
+        }();
+        // Linear to sRGB conversion table, 4096 entries are enough to convert back
+        // each of the 256 sRGB values exactly, and are at most one step off otherwise
+        static constexpr auto LINEAR_STEPS = 4096;
+        static const auto linearToSRGB = [] {
+            auto table = std::array<uint8, LINEAR_STEPS>{};
+            for (auto i = 0; i < LINEAR_STEPS; i++) {
+                const auto c = static_cast<float>(i) / (LINEAR_STEPS - 1);
+                const auto v = c <= 0.0031308f ? c * 12.92f : 1.055f * std::pow(c, 1.0f / 2.4f) - 0.055f;
+                table[i] = static_cast<uint8>(std::clamp(v * 255.0f + 0.5f, 0.0f, 255.0f));
+            }
+            return table;
+        }();
+        const auto toSRGB = [](const float c) {
+            return linearToSRGB[static_cast<uint32>(std::clamp(c, 0.0f, 1.0f) * (LINEAR_STEPS - 1) + 0.5f)];
+        };
+
+        auto offsets = std::vector<size_t>(mipLevels);
+        auto sourceWidth = width;
+        auto sourceHeight = height;
+        for (auto level = 1; level < mipLevels; level++) {
+            const auto levelWidth = std::max(1u, sourceWidth / 2);
+            const auto levelHeight = std::max(1u, sourceHeight / 2);
+            const auto sourceOffset = offsets[level - 1];
+            offsets[level] = data.size();
+            data.resize(data.size() + static_cast<size_t>(levelWidth) * levelHeight * 4);
+            for (auto y = 0u; y < levelHeight; y++) {
+                for (auto x = 0u; x < levelWidth; x++) {
+                    // 2x2 box filter, clamped to the edges of the odd sized levels
+                    const uint32 sourceX[2] = { std::min(x * 2, sourceWidth - 1), std::min(x * 2 + 1, sourceWidth - 1) };
+                    const uint32 sourceY[2] = { std::min(y * 2, sourceHeight - 1), std::min(y * 2 + 1, sourceHeight - 1) };
+                    auto* destination = &data[offsets[level] + (static_cast<size_t>(y) * levelWidth + x) * 4];
+                    for (auto channel = 0; channel < 4; channel++) {
+                        auto sum = 0.0f;
+                        for (const auto sy : sourceY) {
+                            for (const auto sx : sourceX) {
+                                const auto value = data[sourceOffset + (static_cast<size_t>(sy) * sourceWidth + sx) * 4 + channel];
+                                // Alpha is always linear
+                                sum += sRGB && channel < 3 ? toLinear[value] : static_cast<float>(value) / 255.0f;
+                            }
+                        }
+                        const auto average = sum * 0.25f;
+                        destination[channel] = sRGB && channel < 3 ?
+                            toSRGB(average) :
+                            static_cast<uint8>(std::clamp(average * 255.0f + 0.5f, 0.0f, 255.0f));
+                    }
+                }
+            }
+            sourceWidth = levelWidth;
+            sourceHeight = levelHeight;
+        }
+        return offsets;
+    }
+
     void Image::save(const std::string& filepath) const {
         save(filepath, image);
     }
@@ -38,6 +38,11 @@ export namespace lysa {
 
         auto getImage() const { return image; }
 
+        /**
+         * Replaces the GPU image, used by the texture streaming when the resident mip levels change
+         */
+        void setImage(const std::shared_ptr<vireo::Image>& image) { this->image = image; }
+
         auto getIndex() const { return index; }
 
         void save(const std::string& filepath) const;
@@ -46,23 +51,51 @@ export namespace lysa {
 
         /**
         * Load a bitmap from a file.<br>
-        * Supports JPEG and PNG formats
+        * Supports JPEG and PNG formats.<br>
+        * The full mip chain is generated unless `generateMips` is false, see create()
         */
         static std::shared_ptr<Image> load(
             const std::string &filepath,
-            vireo::ImageFormat imageFormat = vireo::ImageFormat::R8G8B8A8_SRGB);
+            vireo::ImageFormat imageFormat = vireo::ImageFormat::R8G8B8A8_SRGB,
+            bool generateMips = true);
 
         /**
          * Load a bitmap from memory.<br>
-         * Supports JPEG & PNG formats.
+         * Supports JPEG & PNG formats.<br>
+         * If `generateMips` is true the full mip chain is generated on the CPU with a box filter,
+         * for the R8G8B8A8 formats only (filtered in linear space for the sRGB format).
          */
         static std::shared_ptr<Image> create(
             const void* data,
             uint32 width, uint32 height,
             vireo::ImageFormat imageFormat = vireo::ImageFormat::R8G8B8A8_SRGB,
-            const std::string& name = "Image");
+            const std::string& name = "Image",
+            bool generateMips = false);
+
+        /**
+         * Returns the number of mip levels of a full mip chain, down to 1x1
+         */
+        static uint32 getMipLevelsCount(uint32 width, uint32 height);
+
+        /**
+         * Appends the mip levels 1 to `mipLevels`-1 of a RGBA8 image after the level 0 in `data`,
+         * and returns the start of each level.<br>
+         * Each level is a 2x2 box filter of the previous one, averaged in linear space if `sRGB` is true.
+         */
+        static std::vector<size_t> generateMips(
+            std::vector<uint8>& data,
+            uint32 width, uint32 height,
+            uint32 mipLevels,
+            bool sRGB);
+
+        /**
+         * Releases the texture slot of the image
+         */
+        ~Image() override;
 
-        ~Image() override = default;
+        // A copy would free the texture slot twice
+        Image(const Image&) = delete;
+        Image& operator=(const Image&) = delete;
 
     protected:
         std::shared_ptr<vireo::Image> image;
@@ -8,22 +8,70 @@ module lysa.resources.material;
 #include <xxhash.h>
 
 import lysa.application;
+import lysa.exception;
 
 namespace lysa {
 
+    pipeline_id PipelineKeyRegistry::getPipelineId(const std::string& key) {
+        const auto id = XXH32(key.data(), key.size(), 0);
+        auto lock = std::lock_guard{mutex};
+        if (const auto it = keys.find(id); it != keys.end()) {
+            if (it->second != key) {
+                throw Exception("Pipeline id collision for id ", std::to_string(id));
+            }
+        } else {
+            keys[id] = key;
+        }
+        return id;
+    }
+
     Material::Material(const Type type, const std::string &name):
         Resource{name}, type{type} {
     }
 
+    void Material::updatePipelineId() {
+        pipelineId = PipelineKeyRegistry::getPipelineId(getPipelineKey());
+    }
+
+    Material::~Material() {
+        Application::getResources().removeUpdatedMaterial(*this);
+    }
+
     void Material::upload() {
         if (bypassUpload) { return; }
         auto& resources = Application::getResources();
         if (!isUploaded()) {
             memoryBloc = resources.getMaterialArray().alloc(1);
         }
-        const auto materialData = getMaterialData();
-        resources.getMaterialArray().write(memoryBloc, &materialData);
-        resources.setUpdated();
+        resources.addUpdatedMaterial(*this, getMaterialData());
+    }
+
+    void Material::writeData(DeviceMemoryArray& materialArray) {
+        const auto& data = pendingData;
+        if (!dataUploaded) {
+            materialArray.write(memoryBloc, &data);
+        } else {
+            // Write the modified 16 bytes chunks, merged in contiguous ranges
+            forEachModifiedRange(&data, &uploadedData, sizeof(MaterialData), MATERIAL_DATA_CHUNK_SIZE,
+                [&](const size_t offset, const size_t size) {
+                    materialArray.write(memoryBloc, reinterpret_cast<const std::byte*>(&data) + offset, offset, size);
+                });
+        }
+        uploadedData = data;
+        dataUploaded = true;
+    }
+
+    TextureInfoData StandardMaterial::getTextureInfoData(const TextureInfo& textureInfo) {
+        // The shaders use column vectors : the UV are transformed by the first two columns
+        const auto& transform = textureInfo.transform;
+        return {
+            .index = static_cast<int32>(textureInfo.texture->getImage()->getIndex()),
+            .samplerIndex = textureInfo.texture->getSamplerIndex(),
+            .transform = {
+                float4{transform[0][0], transform[1][0], transform[2][0], 0.0f},
+                float4{transform[0][1], transform[1][1], transform[2][1], 0.0f},
+            },
+        };
     }
 
     MaterialData StandardMaterial::getMaterialData() const {
@@ -38,45 +86,26 @@ namespace lysa {
             .emissiveFactor = float4{emissiveFactor, emissiveStrength}
         };
         if (diffuseTexture.texture) {
-            data.diffuseTexture = {
-                .index = static_cast<int32>(diffuseTexture.texture->getImage()->getIndex()),
-                .samplerIndex = diffuseTexture.texture->getSamplerIndex(),
-                .transform = float4x4{diffuseTexture.transform},
-            };
+            data.diffuseTexture = getTextureInfoData(diffuseTexture);
         }
         if (normalTexture.texture) {
-            data.normalTexture = {
-                .index = static_cast<int32>(normalTexture.texture->getImage()->getIndex()),
-                .samplerIndex = normalTexture.texture->getSamplerIndex(),
-                .transform = float4x4{normalTexture.transform},
-            };
+            data.normalTexture = getTextureInfoData(normalTexture);
         }
         if (metallicTexture.texture) {
-            data.metallicTexture = {
-                .index = static_cast<int32>(metallicTexture.texture->getImage()->getIndex()),
-                .samplerIndex = metallicTexture.texture->getSamplerIndex(),
-                .transform = float4x4{metallicTexture.transform},
-            };
+            data.metallicTexture = getTextureInfoData(metallicTexture);
         }
         if (roughnessTexture.texture) {
-            data.roughnessTexture = {
-                .index = static_cast<int32>(roughnessTexture.texture->getImage()->getIndex()),
-                .samplerIndex = roughnessTexture.texture->getSamplerIndex(),
-                .transform = float4x4{roughnessTexture.transform},
-            };
+            data.roughnessTexture = getTextureInfoData(roughnessTexture);
         }
         if (emissiveTexture.texture) {
-            data.emissiveTexture = {
-                .index = static_cast<int32>(emissiveTexture.texture->getImage()->getIndex()),
-                .samplerIndex = emissiveTexture.texture->getSamplerIndex(),
-                .transform = float4x4{emissiveTexture.transform},
-            };
+            data.emissiveTexture = getTextureInfoData(emissiveTexture);
         }
         return data;
     }
 
     StandardMaterial::StandardMaterial(const std::string &name):
         Material(STANDARD, name) {
+        updatePipelineId();
     }
 
     void StandardMaterial::setAlbedoColor(const float4 &color) {
@@ -136,12 +165,17 @@ namespace lysa {
         upload();
     }
 
-    pipeline_id StandardMaterial::getPipelineId() const {
-        const auto name = std::format("{0}{1}{2}",
-            DEFAULT_PIPELINE_ID,
-            static_cast<uint32>(getTransparency()),
-            static_cast<uint32>(getCullMode()));
-        return XXH32(name.c_str(), name.size(), 0);
+    std::string StandardMaterial::getPipelineKey() const {
+        return createPipelineKey(getTransparency(), getCullMode());
+    }
+
+    std::string StandardMaterial::createPipelineKey(const Transparency transparency, const vireo::CullMode cullMode) {
+        const uint32 key[] = {
+            static_cast<uint32>(STANDARD),
+            static_cast<uint32>(transparency),
+            static_cast<uint32>(cullMode),
+        };
+        return std::string{reinterpret_cast<const char*>(key), sizeof(key)};
     }
 
     ShaderMaterial::ShaderMaterial(const std::shared_ptr<ShaderMaterial> &orig):
@@ -151,6 +185,7 @@ namespace lysa {
         for (int i = 0; i < SHADER_MATERIAL_MAX_PARAMETERS; i++) {
             parameters[i] = orig->parameters[i];
         }
+        updatePipelineId();
         upload();
     }
 
@@ -160,6 +195,7 @@ namespace lysa {
         Material{SHADER, name},
         fragFileName{fragShaderFileName},
         vertFileName{vertShaderFileName} {
+        updatePipelineId();
         upload();
     }
 
@@ -168,9 +204,19 @@ namespace lysa {
         upload();
     }
 
-    uint32 ShaderMaterial::getPipelineId() const {
-        const auto name = vertFileName + fragFileName;
-        return XXH32(name.c_str(), name.size(), 0);
+    std::string ShaderMaterial::getPipelineKey() const {
+        return createPipelineKey(vertFileName, fragFileName);
+    }
+
+    std::string ShaderMaterial::createPipelineKey(const std::string& vertFileName, const std::string& fragFileName) {
+        // The file names are separated by a null character, which is not valid in a path
+        auto key = std::string{};
+        const auto type = static_cast<uint32>(SHADER);
+        key.append(reinterpret_cast<const char*>(&type), sizeof(type));
+        key.append(vertFileName);
+        key.push_back('\0');
+        key.append(fragFileName);
+        return key;
     }
 
     MaterialData ShaderMaterial::getMaterialData() const {
@@ -20,7 +20,8 @@ export namespace lysa {
     struct TextureInfoData {
         int32    index{-1};
         uint32   samplerIndex{0};
-        float4x4 transform{1.0f};
+        //! UV transform as a 2x3 matrix : the first two columns of the 3x3 transform
+        float4   transform[2]{float4{1.0f, 0.0f, 0.0f, 0.0f}, float4{0.0f, 1.0f, 0.0f, 0.0f}};
     };
 
     struct MaterialData {
@@ -43,6 +44,31 @@ export namespace lysa {
         float4 parameters[SHADER_MATERIAL_MAX_PARAMETERS]{};
     };
 
+    //! The modified parts of the material data are compared and uploaded by chunks of 16 bytes
+    constexpr size_t MATERIAL_DATA_CHUNK_SIZE{16};
+    static_assert(sizeof(MaterialData) % MATERIAL_DATA_CHUNK_SIZE == 0, "MaterialData size must be a multiple of 16 bytes");
+
+    /**
+     * Global registry of the pipelines keys.
+     *  - A pipeline key is a canonical binary description of the pipeline-affecting properties
+     *    of a material, the pipeline id is the hash of the key.
+     *  - Detects the hash collisions between different keys.
+     *
+     * Thread-safety: all methods can be called from any thread.
+     */
+    class PipelineKeyRegistry {
+    public:
+        /**
+         * Returns the pipeline id of a key, registering it if needed.
+         * Throws an Exception if another key has the same id.
+         */
+        static pipeline_id getPipelineId(const std::string& key);
+
+    private:
+        inline static std::unordered_map<pipeline_id, std::string> keys;
+        inline static std::mutex mutex;
+    };
+
     /**
      * Base class for all materials of models surfaces
      */
@@ -61,7 +87,10 @@ export namespace lysa {
          * Sets the CullMode.
          * Determines which side of the triangle to cull depending on whether the triangle faces towards or away from the camera.
          */
-        void setCullMode(const vireo::CullMode mode) { cullMode = mode; }
+        void setCullMode(const vireo::CullMode mode) {
+            cullMode = mode;
+            updatePipelineId();
+        }
 
         /**
          * Returns the transparency mode
@@ -71,7 +100,10 @@ export namespace lysa {
         /**
          * Sets the transparency mode
          */
-        void setTransparency(const Transparency transparencyMode) { transparency = transparencyMode; }
+        void setTransparency(const Transparency transparencyMode) {
+            transparency = transparencyMode;
+            updatePipelineId();
+        }
 
         /**
          * Returns the alpha scissor threshold value
@@ -89,11 +121,19 @@ export namespace lysa {
 
         auto isUploaded() const { return memoryBloc.size > 0; }
 
+        /**
+         * Allocates the material in the materials array if needed and schedules the upload of its data.
+         * The data is read now by the calling thread, then written once per frame by Resources::update(),
+         * only the modified parts are uploaded.
+         */
         void upload();
 
         virtual MaterialData getMaterialData() const = 0;
 
-        virtual pipeline_id getPipelineId() const = 0;
+        /**
+         * Returns the id of the pipeline used to render the material, updated when a pipeline-affecting property changes
+         */
+        auto getPipelineId() const { return pipelineId; }
 
         const auto& getMaterialIndex() const { return memoryBloc.instanceIndex; }
 
@@ -101,16 +141,39 @@ export namespace lysa {
 
         void setBypassUpload(const bool bypass) { bypassUpload = bypass; }
 
+        ~Material() override;
+
     protected:
         Material(Type type, const std::string &name);
 
+        /**
+         * Returns the canonical binary description of the pipeline-affecting properties
+         */
+        virtual std::string getPipelineKey() const = 0;
+
+        /**
+         * Updates the pipeline id from the pipeline key, must be called by the constructors
+         * of the derived classes and when a pipeline-affecting property changes
+         */
+        void updatePipelineId();
+
     private:
         const Type      type;
         vireo::CullMode cullMode{vireo::CullMode::NONE};
         Transparency    transparency{Transparency::DISABLED};
         float           alphaScissor{0.1f};
         MemoryBlock     memoryBloc;
+        pipeline_id     pipelineId{DEFAULT_PIPELINE_ID};
+        //! Snapshot taken by upload(), guarded by the materials lock of Resources
+        MaterialData    pendingData{};
+        //! Data written by the last writeData()
+        MaterialData    uploadedData{};
+        bool            dataUploaded{false};
         bool            bypassUpload{false};
+
+        friend class Resources;
+        // Writes the parts of the pending data modified since the last call
+        void writeData(DeviceMemoryArray& materialArray);
     };
 
     /**
@@ -245,7 +308,13 @@ export namespace lysa {
 
         MaterialData getMaterialData() const override;
 
-        pipeline_id getPipelineId() const override;
+        /**
+         * Returns the pipeline key of the standard materials with these properties
+         */
+        static std::string createPipelineKey(Transparency transparency, vireo::CullMode cullMode);
+
+    protected:
+        std::string getPipelineKey() const override;
 
     private:
         float4       albedoColor{1.0f, 0.0f, 0.5f, 1.0f};
@@ -259,6 +328,8 @@ export namespace lysa {
         TextureInfo  emissiveTexture;
         TextureInfo  normalTexture{};
         float        normalScale{1.0f};
+
+        static TextureInfoData getTextureInfoData(const TextureInfo& textureInfo);
     };
 
     /**
@@ -281,8 +352,6 @@ export namespace lysa {
                        const std::string &vertShaderFileName = "",
                        const std::string &name               = "ShaderMaterial");
 
-        pipeline_id getPipelineId() const override;
-
         /**
          * Returns the fragment shader file path, relative to the application directory
          */
@@ -305,6 +374,14 @@ export namespace lysa {
 
         MaterialData getMaterialData() const override;
 
+        /**
+         * Returns the pipeline key of the shader materials using these shaders
+         */
+        static std::string createPipelineKey(const std::string& vertFileName, const std::string& fragFileName);
+
+    protected:
+        std::string getPipelineKey() const override;
+
     private:
         const std::string fragFileName;
         const std::string vertFileName;
@@ -16,11 +16,131 @@ import lysa.window;
 namespace lysa {
 
     const std::vector<vireo::VertexAttributeDesc> VertexData::vertexAttributes {
-        {"POSITION", vireo::AttributeFormat::R32G32B32A32_FLOAT, offsetof(VertexData, position)},
-        {"NORMAL", vireo::AttributeFormat::R32G32B32A32_FLOAT, offsetof(VertexData, normal)},
-        {"TANGENT", vireo::AttributeFormat::R32G32B32A32_FLOAT, offsetof(VertexData, tangent)},
+        {"POSITION", vireo::AttributeFormat::R32G32B32_FLOAT, offsetof(VertexData, position)},
+        {"NORMAL", vireo::AttributeFormat::R32_SINT, offsetof(VertexData, normal)},
+        {"TANGENT", vireo::AttributeFormat::R32_SINT, offsetof(VertexData, tangent)},
+        {"TEXCOORD", vireo::AttributeFormat::R32_SINT, offsetof(VertexData, uv)},
     };
 
+    const std::vector<vireo::VertexAttributeDesc> VertexPositionData::vertexAttributes {
+        {"POSITION", vireo::AttributeFormat::R32G32B32_FLOAT, offsetof(VertexPositionData, position)},
+        {"TEXCOORD", vireo::AttributeFormat::R32_SINT, offsetof(VertexPositionData, uv)},
+    };
+
+    // Octahedral projection of a unit vector on the [-1, 1] square
+    static float2 octahedralEncode(const float3& v) {
+        const auto x = static_cast<float>(v.x);
+        const auto y = static_cast<float>(v.y);
+        const auto z = static_cast<float>(v.z);
+        const auto l1norm = std::abs(x) + std::abs(y) + std::abs(z);
+        auto ex = x / l1norm;
+        auto ey = y / l1norm;
+        if (z < 0.0f) {
+            const auto fx = (1.0f - std::abs(ey)) * (ex >= 0.0f ? 1.0f : -1.0f);
+            const auto fy = (1.0f - std::abs(ex)) * (ey >= 0.0f ? 1.0f : -1.0f);
+            ex = fx;
+            ey = fy;
+        }
+        return float2{ex, ey};
+    }
+
+    static float3 octahedralDecode(const float ex, const float ey) {
+        auto x = ex;
+        auto y = ey;
+        const auto z = 1.0f - std::abs(x) - std::abs(y);
+        const auto t = std::max(-z, 0.0f);
+        x += x >= 0.0f ? -t : t;
+        y += y >= 0.0f ? -t : t;
+        return normalize(float3{x, y, z});
+    }
+
+    // Encodes a value in [-1, 1] as a signed normalized integer of `bits` bits
+    static uint32 toSnorm(const float value, const uint32 bits) {
+        const auto scale = static_cast<float>((1u << (bits - 1)) - 1);
+        const auto snorm = static_cast<int32>(std::round(std::clamp(value, -1.0f, 1.0f) * scale));
+        return static_cast<uint32>(snorm) & ((1u << bits) - 1);
+    }
+
+    static float fromSnorm(const uint32 value, const uint32 bits) {
+        const auto scale = static_cast<float>((1u << (bits - 1)) - 1);
+        // Sign extension of the `bits` bits value
+        const auto snorm = static_cast<int32>(value << (32 - bits)) >> (32 - bits);
+        return std::max(static_cast<float>(snorm) / scale, -1.0f);
+    }
+
+    // IEEE 754 single to half precision, rounded to nearest even
+    static uint32 toHalf(const float value) {
+        const auto bits = std::bit_cast<uint32>(value);
+        const auto sign = (bits >> 16) & 0x8000u;
+        const auto exponent = static_cast<int32>((bits >> 23) & 0xffu) - 127 + 15;
+        auto mantissa = bits & 0x7fffffu;
+        if (exponent >= 31) {
+            // Overflow to infinity, or NaN
+            return sign | 0x7c00u | (((bits & 0x7fffffffu) > 0x7f800000u) ? 0x200u : 0u);
+        }
+        if (exponent <= 0) {
+            // Subnormal half or zero
+            if (exponent < -10) { return sign; }
+            mantissa |= 0x800000u;
+            const auto shift = static_cast<uint32>(14 - exponent);
+            auto half = mantissa >> shift;
+            const auto remainder = mantissa & ((1u << shift) - 1);
+            const auto halfway = 1u << (shift - 1);
+            if (remainder > halfway || (remainder == halfway && (half & 1u))) { half++; }
+            return sign | half;
+        }
+        auto half = (static_cast<uint32>(exponent) << 10) | (mantissa >> 13);
+        const auto remainder = mantissa & 0x1fffu;
+        if (remainder > 0x1000u || (remainder == 0x1000u && (half & 1u))) {
+            // May carry into the exponent, up to infinity
+            half++;
+        }
+        return sign | half;
+    }
+
+    static float fromHalf(const uint32 half) {
+        const auto sign = (half & 0x8000u) << 16;
+        const auto exponent = (half >> 10) & 0x1fu;
+        const auto mantissa = half & 0x3ffu;
+        if (exponent == 0) {
+            // Zero or subnormal
+            const auto value = std::ldexp(static_cast<float>(mantissa), -24);
+            return sign ? -value : value;
+        }
+        if (exponent == 31) {
+            return std::bit_cast<float>(sign | 0x7f800000u | (mantissa << 13));
+        }
+        return std::bit_cast<float>(sign | ((exponent - 15 + 127) << 23) | (mantissa << 13));
+    }
+
+    uint32 VertexData::packNormal(const float3& normal) {
+        const auto e = octahedralEncode(normal);
+        return toSnorm(static_cast<float>(e.x), 16) | (toSnorm(static_cast<float>(e.y), 16) << 16);
+    }
+
+    float3 VertexData::unpackNormal(const uint32 packed) {
+        return octahedralDecode(fromSnorm(packed & 0xffffu, 16), fromSnorm(packed >> 16, 16));
+    }
+
+    uint32 VertexData::packTangent(const float4& tangent) {
+        const auto e = octahedralEncode(float3{tangent.xyz});
+        const auto sign = static_cast<float>(tangent.w) < 0.0f ? 0x80000000u : 0u;
+        return toSnorm(static_cast<float>(e.x), 15) | (toSnorm(static_cast<float>(e.y), 15) << 15) | sign;
+    }
+
+    float4 VertexData::unpackTangent(const uint32 packed) {
+        const auto tangent = octahedralDecode(fromSnorm(packed & 0x7fffu, 15), fromSnorm((packed >> 15) & 0x7fffu, 15));
+        return float4{tangent, (packed & 0x80000000u) ? -1.0f : 1.0f};
+    }
+
+    uint32 VertexData::packUV(const float2& uv) {
+        return toHalf(static_cast<float>(uv.x)) | (toHalf(static_cast<float>(uv.y)) << 16);
+    }
+
+    float2 VertexData::unpackUV(const uint32 packed) {
+        return float2{fromHalf(packed & 0xffffu), fromHalf(packed >> 16)};
+    }
+
     MeshSurface::MeshSurface(const uint32 firstIndex, const uint32 count):
         firstIndex{firstIndex},
         indexCount{count},
@@ -52,20 +172,32 @@ namespace lysa {
     void Mesh::upload() {
         auto& resources = Application::getResources();
         if (!isUploaded()) {
-            verticesMemoryBlock = resources.getVertexArray().alloc(vertices.size());
+            verticesMemoryBlock = resources.allocVertices(vertices.size());
             indicesMemoryBlock = resources.getIndexArray().alloc(indices.size());
             surfacesMemoryBlock = resources.getMeshSurfaceArray().alloc(surfaces.size());
         }
 
-        // Uploading all vertices
+        // Uploading all vertices, in the compact and the positions-only streams
         auto vertexData = std::vector<VertexData>(vertices.size());
+        auto vertexPositionData = std::vector<VertexPositionData>(vertices.size());
         for (int i = 0; i < vertices.size(); i++) {
             const auto& v = vertices[i];
-            vertexData[i].position = float4(v.position.x, v.position.y, v.position.z, v.uv.x);
-            vertexData[i].normal = float4(v.normal.x, v.normal.y, v.normal.z, v.uv.y);
-            vertexData[i].tangent = v.tangent;
+            const auto x = static_cast<float>(v.position.x);
+            const auto y = static_cast<float>(v.position.y);
+            const auto z = static_cast<float>(v.position.z);
+            const auto uv = VertexData::packUV(v.uv);
+            vertexData[i] = {
+                .position = { x, y, z },
+                .normal = VertexData::packNormal(v.normal),
+                .tangent = VertexData::packTangent(v.tangent),
+                .uv = uv,
+            };
+            vertexPositionData[i] = {
+                .position = { x, y, z },
+                .uv = uv,
+            };
         }
-        resources.getVertexArray().write(verticesMemoryBlock, vertexData.data());
+        resources.writeVertices(verticesMemoryBlock, vertexData.data(), vertexPositionData.data());
 
         // Uploading all indices
         resources.getIndexArray().write(indicesMemoryBlock, indices.data());
@@ -17,10 +17,48 @@ import lysa.resources.resource;
 
 export namespace lysa {
 
+    /**
+     * Compact GPU vertex used by the color passes (24 bytes) :
+     *  - position as 3 floats
+     *  - normal in octahedral encoding, 2 x 16 bits signed normalized
+     *  - tangent in octahedral encoding, 2 x 15 bits signed normalized + bitangent sign in the high bit
+     *  - UV as 2 x half floats
+     */
     struct VertexData {
-        float4 position; // position + uv.x
-        float4 normal;   // normal + uv.y
-        float4 tangent;  // tangent + sign
+        float  position[3];
+        uint32 normal;
+        uint32 tangent;
+        uint32 uv;
+
+        static const std::vector<vireo::VertexAttributeDesc> vertexAttributes;
+
+        /** Encodes a unit vector in octahedral encoding, 2 x 16 bits */
+        static uint32 packNormal(const float3& normal);
+
+        /** Decodes a unit vector encoded with packNormal() */
+        static float3 unpackNormal(uint32 packed);
+
+        /** Encodes a unit vector and a sign (w) in octahedral encoding, 2 x 15 bits + 1 sign bit */
+        static uint32 packTangent(const float4& tangent);
+
+        /** Decodes a tangent encoded with packTangent(), w is the sign (-1.0 or 1.0) */
+        static float4 unpackTangent(uint32 packed);
+
+        /** Encodes UV coordinates as 2 x half floats */
+        static uint32 packUV(const float2& uv);
+
+        /** Decodes UV coordinates encoded with packUV() */
+        static float2 unpackUV(uint32 packed);
+    };
+
+    /**
+     * GPU vertex of the positions-only stream (16 bytes) used by the depth pre-pass and
+     * the shadow maps passes. The UV are needed by the shadow maps for the transparency.
+     * Uses the same vertex indices than VertexData.
+     */
+    struct VertexPositionData {
+        float  position[3];
+        uint32 uv;
 
         static const std::vector<vireo::VertexAttributeDesc> vertexAttributes;
     };
@@ -0,0 +1,125 @@
+/*
+* Copyright (c) 2025-present Henri Michelon
+*
+* This software is released under the MIT License.
+* https://opensource.org/licenses/MIT
+*/
+export module lysa.resources.shaped_text_cache;
+
+import std;
+import lysa.types;
+
+export namespace lysa {
+
+    /**
+     * LRU cache of shaped texts, keyed by text, bounded by a memory budget.
+     *  - Entries are stored with the generation of the glyphs used to shape them (the glyph atlas
+     *    generation for the dynamic fonts) and are invalidated when the generation changes.
+     *  - The least recently used entries are evicted when the budget is exceeded.
+     *
+     * The shaping is done by the caller, Font uses HarfBuzz. `Value` is the shaped text type.
+     *
+     * Thread-safety: all methods can be called from any thread.
+     */
+    template<typename Value>
+    class ShapedTextCache {
+    public:
+        /** Shaped texts cache statistics */
+        struct Statistics {
+            uint64 hits{0};
+            uint64 misses{0};
+            //! Estimated memory used by the cached texts, in bytes
+            uint64 memoryUsed{0};
+            uint32 entries{0};
+        };
+
+        /**
+         * Returns the cached shaped text, or nullptr if the text is not in the cache
+         * or was shaped with another generation. Counts a hit or a miss.
+         */
+        std::shared_ptr<const Value> get(const std::string& text, const uint32 generation) {
+            auto lock = std::lock_guard{mutex};
+            if (const auto it = index.find(text); it != index.end()) {
+                if (it->second->generation == generation) {
+                    statistics.hits++;
+                    entries.splice(entries.begin(), entries, it->second);
+                    return it->second->value;
+                }
+                // Glyphs generated or moved since the shaping
+                erase(it->second);
+            }
+            statistics.misses++;
+            return nullptr;
+        }
+
+        /**
+         * Adds a shaped text, evicting the least recently used ones to stay in the budget.
+         * `valueSize` is the memory used by the shaped text. Texts larger than the budget are not cached.
+         * Returns the cached shaped text, which is the one added by another thread if any.
+         */
+        std::shared_ptr<const Value> add(
+            const std::string& text,
+            const std::shared_ptr<const Value>& value,
+            const uint64 valueSize,
+            const uint32 generation,
+            const uint64 budget) {
+            auto lock = std::lock_guard{mutex};
+            if (const auto it = index.find(text); it != index.end() && it->second->generation == generation) {
+                // Shaped in the meantime by another thread
+                return it->second->value;
+            } else if (it != index.end()) {
+                erase(it->second);
+            }
+            const auto memorySize = sizeof(Entry) + text.size() + valueSize;
+            if (memorySize > budget) {
+                // Never cached, the other entries are kept
+                return value;
+            }
+            while (!entries.empty() && statistics.memoryUsed + memorySize > budget) {
+                erase(std::prev(entries.end()));
+            }
+            entries.push_front({ text, value, memorySize, generation });
+            // The key views the text of the entry, stable while the entry is in the list
+            index[entries.front().text] = entries.begin();
+            statistics.memoryUsed += memorySize;
+            statistics.entries = static_cast<uint32>(entries.size());
+            return value;
+        }
+
+        /** Calls `function` with each cached shaped text, from the most recently used */
+        template<typename Function>
+        void forEach(const Function& function) {
+            auto lock = std::lock_guard{mutex};
+            for (const auto& entry : entries) {
+                function(*entry.value);
+            }
+        }
+
+        Statistics getStatistics() {
+            auto lock = std::lock_guard{mutex};
+            return statistics;
+        }
+
+    private:
+        struct Entry {
+            std::string text;
+            std::shared_ptr<const Value> value;
+            uint64 memorySize;
+            uint32 generation;
+        };
+
+        //! Shaped texts, most recently used first
+        std::list<Entry> entries;
+        std::unordered_map<std::string_view, typename std::list<Entry>::iterator> index;
+        Statistics statistics;
+        std::mutex mutex;
+
+        void erase(const typename std::list<Entry>::iterator entry) {
+            statistics.memoryUsed -= entry->memorySize;
+            index.erase(entry->text);
+            entries.erase(entry);
+            statistics.entries = static_cast<uint32>(entries.size());
+        }
+    };
+
+}
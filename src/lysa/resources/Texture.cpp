@@ -20,4 +20,8 @@ namespace lysa {
         samplerIndex{samplerIndex} {
     }
 
+    ImageTexture::~ImageTexture() {
+        Application::getResources().getSamplers().releaseSampler(samplerIndex);
+    }
+
 }
@@ -48,10 +48,14 @@ export namespace lysa {
     class ImageTexture : public Texture {
     public:
         /**
-         * Creates an ImageTexture from an existing Image
+         * Creates an ImageTexture from an existing Image.<br>
+         * The texture takes ownership of the sampler reference returned by Samplers::addSampler()
+         * and releases it when destroyed.
          */
         ImageTexture(const std::shared_ptr<Image> &image, uint32 samplerIndex);
 
+        ~ImageTexture() override;
+
         /**
          * Returns the attached Image
          */
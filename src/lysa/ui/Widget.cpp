@@ -71,6 +71,11 @@ namespace lysa::ui {
     }
 
     void Widget::setSize(const float width, const float height) {
+        if ((width == rect.width) && (height == rect.height) &&
+            (width == defaultRect.width) && (height == defaultRect.height) &&
+            (!layoutDirty)) {
+            return;
+        }
         if (parent) { parent->refresh(); }
         defaultRect.width  = width;
         defaultRect.height = height;
@@ -80,6 +85,10 @@ namespace lysa::ui {
     }
 
     void Widget::_setSize(const float width, const float height) {
+        if ((width == rect.width) && (height == rect.height) && (!layoutDirty)) {
+            // Same size and children already laid out : nothing to do for this branch
+            return;
+        }
         if (parent) {
             parent->refresh();
         }
@@ -279,7 +288,10 @@ namespace lysa::ui {
     }
 
     void Widget::eventResize() {
-        if (freeze) { return; }
+        if (freeze) {
+            layoutDirty = true;
+            return;
+        }
         if (parent) { parent->resizeChildren(); }
         resizeChildren();
         freeze = true;
@@ -289,6 +301,7 @@ namespace lysa::ui {
 
     void Widget::resizeChildren() {
         if (!style || freeze) {
+            layoutDirty = true;
             return;
         }
         freeze = true;
@@ -506,6 +519,8 @@ namespace lysa::ui {
             child->setRect(childRect);
             ++it;
         }
+        // Reset after the children since they can ask for the parent layout while it is frozen
+        layoutDirty = false;
         freeze = false;
     }
 
@@ -253,6 +253,10 @@ namespace lysa::ui {
         /** Changes the transparency alpha value */
         void setTransparency(float alpha);
 
+        /**
+         * Lays out the children widgets. Only the children whose size changed (or with a pending
+         * layout) lay out their own children : unchanged branches of the tree are skipped.
+         */
         void resizeChildren();
 
         void _setRedrawOnMouseEvent(const bool r) { redrawOnMouseEvent = r; }
@@ -338,6 +342,8 @@ namespace lysa::ui {
         int32 groupIndex{0};
         Rect childrenRect;
         std::shared_ptr<Font> font{nullptr};
+        // The children need to be laid out even if the size of the widget does not change
+        bool layoutDirty{true};
 
         Widget *setNextFocus();
     };
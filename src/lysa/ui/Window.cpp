@@ -35,12 +35,13 @@ namespace lysa::ui {
         windowManager = nullptr;
     }
 
-    void Window::draw() const {
-        if (!isVisible()) { return; }
+    void Window::draw() {
         UIRenderer& renderer = windowManager->getRenderer();
+        renderer.beginGeometry(geometry);
         renderer.setTranslate({rect.x, rect.y});
         renderer.setTransparency(1.0f - transparency);
         widget->_draw(renderer);
+        renderer.endGeometry();
     }
 
     void Window::unFreeze(const std::shared_ptr<Widget> &widget) {
@@ -228,7 +229,7 @@ namespace lysa::ui {
     }
 
     void Window::refresh() const {
-        if (windowManager) { windowManager->refresh(); }
+        needRedraw = true;
     }
 
     void Window::setFocusedWidget(const std::shared_ptr<Widget> &W) {
@@ -12,6 +12,7 @@ import lysa.object;
 import lysa.math;
 import lysa.types;
 import lysa.resources.font;
+import lysa.renderers.ui;
 import lysa.ui.rect;
 import lysa.ui.style;
 import lysa.ui.widget;
@@ -220,6 +221,7 @@ export namespace lysa::ui {
 
         void setTextColor(const float4& color) { textColor = color; }
 
+        /** Redraws the Window at the start of the next frame, the other windows are not redrawn */
         void refresh() const;
 
         void eventCreate();
@@ -248,7 +250,8 @@ export namespace lysa::ui {
 
         void eventLostFocus();
 
-        void draw() const;
+        /** Draws the widgets in the Window geometry */
+        void draw();
 
         friend class WindowManager;
 
@@ -276,6 +279,12 @@ export namespace lysa::ui {
         bool visibilityChange{false};
         std::shared_ptr<Font> font{nullptr};
         float fontScale{1.0f};
+        // Vertices of the widgets, kept until the next refresh()
+        UIRenderer::Geometry geometry;
+        // Position of the geometry in the UI renderer vertices
+        UIRenderer::GeometryRange geometryRange;
+        // The geometry needs to be drawn again
+        mutable bool needRedraw{true};
 
         void unFreeze(const std::shared_ptr<Widget> &);
     };
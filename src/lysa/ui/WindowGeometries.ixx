@@ -0,0 +1,88 @@
+/*
+* Copyright (c) 2025-present Henri Michelon
+*
+* This software is released under the MIT License.
+* https://opensource.org/licenses/MIT
+*/
+export module lysa.ui.window_geometries;
+
+import std;
+import lysa.types;
+
+export namespace lysa::ui {
+
+    /** Position of the vertices of a window, for one primitive type, in the vertices of the UI renderer */
+    struct VerticesRange {
+        uint32 first{0};
+        uint32 count{0};
+    };
+
+    /** Appends the vertices of a window and returns their position */
+    template<typename Vertex>
+    VerticesRange appendVertices(std::vector<Vertex>& vertices, const std::vector<Vertex>& windowVertices) {
+        const auto range = VerticesRange{
+            static_cast<uint32>(vertices.size()),
+            static_cast<uint32>(windowVertices.size()) };
+        vertices.append_range(windowVertices);
+        return range;
+    }
+
+    /**
+     * Replaces in place the vertices of a window previously appended with appendVertices().
+     * Returns false, without writing anything, if the vertices count changed.
+     */
+    template<typename Vertex>
+    bool patchVertices(std::vector<Vertex>& vertices, const std::vector<Vertex>& windowVertices, const VerticesRange& range) {
+        if (windowVertices.size() != range.count) {
+            return false;
+        }
+        std::ranges::copy(windowVertices, vertices.begin() + range.first);
+        return true;
+    }
+
+    /** Drawing state of a window, given to drawWindows() */
+    template<typename Geometry, typename GeometryRange>
+    struct WindowGeometry {
+        //! The window needs to be drawn again, reset by drawWindows()
+        bool& needRedraw;
+        bool visible;
+        //! Vertices of the widgets of the window, kept until the next redraw
+        Geometry& geometry;
+        //! Position of the geometry in the renderer vertices
+        GeometryRange& range;
+    };
+
+    /**
+     * Draws again the visible windows needing it and updates the vertices of the renderer :
+     *  - the vertices of a redrawn window are patched in place (Renderer::updateGeometry()),
+     *    the vertices of the other windows are kept.
+     *  - if the vertices count of a redrawn window changed, or if `needCompose` is true, the renderer
+     *    is restarted and the geometries of all the visible windows are added again
+     *    (Renderer::addGeometry()), without drawing the clean windows again.
+     * Hidden windows keep their `needRedraw` flag and are drawn when shown.
+     *
+     * `access(window)` returns the WindowGeometry of a window, `draw(window)` draws its widgets in its geometry.
+     * Returns true if the geometries were composed again.
+     */
+    template<typename Renderer, typename Windows, typename Access, typename Draw>
+    bool drawWindows(Renderer& renderer, const Windows& windows, bool needCompose, const Access& access, const Draw& draw) {
+        for (const auto& window : windows) {
+            auto state = access(window);
+            if (!state.needRedraw || !state.visible) { continue; }
+            state.needRedraw = false;
+            draw(window);
+            if (!needCompose && !renderer.updateGeometry(state.geometry, state.range)) {
+                needCompose = true;
+            }
+        }
+        if (!needCompose) { return false; }
+        renderer.restart();
+        for (const auto& window : windows) {
+            if (auto state = access(window); state.visible) {
+                renderer.addGeometry(state.geometry, state.range);
+            }
+        }
+        return true;
+    }
+
+}
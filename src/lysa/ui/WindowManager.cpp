@@ -10,6 +10,7 @@ module;
 #endif
 module lysa.ui.window_manager;
 
+import lysa.application;
 import lysa.enums;
 import lysa.math;
 import lysa.resources.font;
@@ -19,6 +20,7 @@ import lysa.types;
 import lysa.window;
 import lysa.ui.rect;
 import lysa.ui.window;
+import lysa.ui.window_geometries;
 import lysa.renderers.ui;
 
 namespace lysa::ui {
@@ -50,14 +52,14 @@ namespace lysa::ui {
             if (window->isVisible()) { window->eventHide(); }
             window->eventDestroy();
             windows.remove(window);
-            needRedraw = true;
+            needCompose = true;
         }
         removedWindows.clear();
         for (auto& window: windows) {
             if (window->visibilityChanged) {
                 window->visibilityChanged = false;
                 window->visible = window->visibilityChange;
-                needRedraw = true;
+                needCompose = true;
                 if (window->visible) {
                     if (focusedWindow) { focusedWindow->eventLostFocus(); }
                     focusedWindow = window;
@@ -77,12 +79,34 @@ namespace lysa::ui {
                 }
             }
         }
-        if (!needRedraw) { return; }
-        needRedraw = false;
-        uiRenderer.restart();
-        for (const auto& window: windows) {
-            window->draw();
+        // Glyphs were generated or moved in the shared atlas, the texts need to be drawn again
+        const auto atlasGeneration = Application::getResources().getGlyphAtlas().getGeneration();
+        if (atlasGeneration != glyphAtlasGeneration) {
+            glyphAtlasGeneration = atlasGeneration;
+            needRedraw = true;
+        }
+        if (needRedraw) {
+            needRedraw = false;
+            for (const auto& window: windows) {
+                window->needRedraw = true;
+            }
         }
+        // Only the modified windows are drawn again. Hidden windows are drawn when shown.
+        drawWindows(
+            uiRenderer,
+            windows,
+            needCompose,
+            [](const std::shared_ptr<Window>& window) {
+                return WindowGeometry<UIRenderer::Geometry, UIRenderer::GeometryRange> {
+                    window->needRedraw,
+                    window->isVisible(),
+                    window->geometry,
+                    window->geometryRange };
+            },
+            [](const std::shared_ptr<Window>& window) {
+                window->draw();
+            });
+        needCompose = false;
     }
 
     std::shared_ptr<Window> WindowManager::add(const std::shared_ptr<Window> &window) {
@@ -93,7 +117,7 @@ namespace lysa::ui {
         }
         window->eventCreate();
         if (window->isVisible()) { window->eventShow(); }
-        needRedraw = true;
+        needCompose = true;
         return window;
     }
 
@@ -46,7 +46,8 @@ export namespace lysa {
             auto getDefaultTextColor() const { return textColor; }
 
             /**
-             * Forces a redrawing of all the UI at the start of the next frame
+             * Forces a redrawing of all the UI windows at the start of the next frame.
+             * Use Window::refresh() to redraw only one window.
              */
             void refresh() { needRedraw = true; }
 
@@ -70,7 +71,12 @@ export namespace lysa {
             std::vector<std::shared_ptr<Window>> removedWindows{};
             std::shared_ptr<Window> focusedWindow{nullptr};
             std::shared_ptr<Window> resizedWindow{nullptr};
+            // All the windows need to be drawn again
             bool needRedraw{false};
+            // Generation of the glyphs atlas used for the last drawing, see GlyphAtlas::getGeneration()
+            uint32 glyphAtlasGeneration{0};
+            // The windows list or the windows visibility changed, the windows geometries need to be added again to the renderer
+            bool needCompose{false};
             bool enableWindowResizing{true};
             bool resizingWindow{false};
             bool resizingWindowOriginBorder{false};
@@ -0,0 +1,209 @@
+/*
+* Copyright (c) 2025-present Henri Michelon
+*
+* This software is released under the MIT License.
+* https://opensource.org/licenses/MIT
+*/
+import std;
+import lysa.tests;
+import lysa.types;
+import lysa.resources.block_compression;
+import lysa.resources.image;
+
+using namespace lysa;
+using namespace lysa::tests;
+
+namespace {
+
+    std::vector<uint8> createImage(const uint32 width, const uint32 height, const std::function<uint8(uint32, uint32, uint32)>& texel) {
+        auto data = std::vector<uint8>(static_cast<size_t>(width) * height * 4);
+        for (auto y = 0u; y < height; y++) {
+            for (auto x = 0u; x < width; x++) {
+                for (auto channel = 0u; channel < 4; channel++) {
+                    data[(static_cast<size_t>(y) * width + x) * 4 + channel] = texel(x, y, channel);
+                }
+            }
+        }
+        return data;
+    }
+
+    uint8 toByte(const double value) {
+        return static_cast<uint8>(std::clamp(std::lround(value), 0l, 255l));
+    }
+
+    // Tinted luminance with some noise, the channels of albedo textures are strongly correlated
+    std::vector<uint8> createColorImage(const uint32 width, const uint32 height) {
+        auto random = std::mt19937{7};
+        auto noise = std::uniform_real_distribution{-4.0, 4.0};
+        auto luminance = 0.0;
+        return createImage(width, height, [&](const uint32 x, const uint32 y, const uint32 channel) {
+            const auto u = static_cast<double>(x) / width;
+            const auto v = static_cast<double>(y) / height;
+            if (channel == 0) {
+                luminance = 0.5 + 0.35 * std::sin(u * 12.0) * std::cos(v * 9.0) + 0.1 * std::sin((u + v) * 40.0);
+            }
+            switch (channel) {
+            case 0: return toByte(255.0 * luminance + noise(random));
+            case 1: return toByte((200.0 - 60.0 * u) * luminance + noise(random));
+            case 2: return toByte((120.0 + 60.0 * v) * luminance + noise(random));
+            default: return toByte(255.0 * std::clamp(luminance * 1.5 - 0.25, 0.0, 1.0));
+            }
+        });
+    }
+
+    // Tangent space normals of a bumpy surface, X & Y in the red & green channels
+    std::vector<uint8> createNormalMap(const uint32 width, const uint32 height) {
+        return createImage(width, height, [](const uint32 x, const uint32 y, const uint32 channel) {
+            const auto dx = 0.6 * std::cos(x * 0.15) * std::sin(y * 0.07);
+            const auto dy = 0.6 * std::sin(x * 0.11) * std::cos(y * 0.13);
+            const auto length = std::sqrt(dx * dx + dy * dy + 1.0);
+            switch (channel) {
+            case 0: return toByte(127.5 + 127.5 * dx / length);
+            case 1: return toByte(127.5 + 127.5 * dy / length);
+            case 2: return toByte(127.5 + 127.5 / length);
+            default: return uint8{255};
+            }
+        });
+    }
+
+    double psnr(const uint8* a, const uint8* b, const size_t texelsCount, const std::vector<uint32>& channels) {
+        auto error = 0.0;
+        for (auto i = size_t{0}; i < texelsCount; i++) {
+            for (const auto channel : channels) {
+                const auto delta = static_cast<double>(a[i * 4 + channel]) - b[i * 4 + channel];
+                error += delta * delta;
+            }
+        }
+        const auto mse = error / (static_cast<double>(texelsCount) * channels.size());
+        return mse == 0.0 ? std::numeric_limits<double>::infinity() : 10.0 * std::log10(255.0 * 255.0 / mse);
+    }
+
+    std::vector<uint8> roundTrip(const BlockFormat format, const uint8* rgba, const uint32 width, const uint32 height) {
+        auto blocks = std::vector<uint8>(BlockCompression::getImageSize(format, width, height));
+        BlockCompression::compress(format, rgba, width, height, blocks.data());
+        auto result = std::vector<uint8>(static_cast<size_t>(width) * height * 4);
+        BlockCompression::decompress(format, blocks.data(), width, height, result.data());
+        return result;
+    }
+
+    void computesLevelsSizes() {
+        check(BlockCompression::getImageSize(BlockFormat::BC1, 5, 3) == 2 * 8, "partial blocks padded");
+        check(BlockCompression::getImageSize(BlockFormat::BC7, 1, 1) == 16, "one block for a 1x1 level");
+        check(BlockCompression::getImageSize(BlockFormat::BC5, 256, 256) == 256 * 256, "one byte per texel");
+        auto levels = createColorImage(5, 3);
+        const auto mipLevels = Image::getMipLevelsCount(5, 3);
+        const auto offsets = Image::generateMips(levels, 5, 3, mipLevels, true);
+        auto blocks = std::vector<uint8>{};
+        const auto blocksOffsets = BlockCompression::compressLevels(BlockFormat::BC1, levels, offsets, 5, 3, blocks);
+        check(blocksOffsets == std::vector<size_t>{ 0, 16, 24 }, "5x3, 2x1 & 1x1 levels offsets");
+        check(blocks.size() == 32, "levels appended to the blocks");
+    }
+
+    void roundTripsUniformBlocks() {
+        auto worst = std::array<int, 5>{};
+        for (auto value = 0u; value < 256; value += 3) {
+            const auto image = createImage(4, 4, [value](const uint32, const uint32, const uint32 channel) {
+                return static_cast<uint8>(channel == 3 ? 255 - value : value);
+            });
+            for (const auto format : { BlockFormat::BC1, BlockFormat::BC3, BlockFormat::BC4, BlockFormat::BC5, BlockFormat::BC7 }) {
+                const auto result = roundTrip(format, image.data(), 4, 4);
+                for (auto i = 0u; i < result.size(); i++) {
+                    const auto channel = i % 4;
+                    const auto encoded =
+                        (format == BlockFormat::BC4 && channel > 0) ||
+                        (format == BlockFormat::BC5 && channel > 1) ||
+                        (format == BlockFormat::BC1 && channel == 3);
+                    if (encoded) { continue; }
+                    auto& error = worst[static_cast<uint32>(format)];
+                    error = std::max(error, std::abs(static_cast<int>(result[i]) - image[i]));
+                }
+            }
+        }
+        // 5 and 6 bits color endpoints
+        check(worst[static_cast<uint32>(BlockFormat::BC1)] <= 5, "BC1 uniform colors within the 565 quantization");
+        check(worst[static_cast<uint32>(BlockFormat::BC3)] <= 5, "BC3 uniform colors within the 565 quantization");
+        check(worst[static_cast<uint32>(BlockFormat::BC4)] == 0, "BC4 uniform values exact");
+        check(worst[static_cast<uint32>(BlockFormat::BC5)] == 0, "BC5 uniform values exact");
+        check(worst[static_cast<uint32>(BlockFormat::BC7)] <= 1, "BC7 uniform colors within the 7 bits quantization");
+    }
+
+    void roundTripsAboveThePSNRThresholds() {
+        constexpr auto size = 256u;
+        const auto color = createColorImage(size, size);
+        const auto normals = createNormalMap(size, size);
+        const auto texels = static_cast<size_t>(size) * size;
+        const auto bc1 = psnr(color.data(), roundTrip(BlockFormat::BC1, color.data(), size, size).data(), texels, {0, 1, 2});
+        const auto bc3Color = roundTrip(BlockFormat::BC3, color.data(), size, size);
+        const auto bc3 = psnr(color.data(), bc3Color.data(), texels, {0, 1, 2});
+        const auto bc3Alpha = psnr(color.data(), bc3Color.data(), texels, {3});
+        const auto bc4 = psnr(color.data(), roundTrip(BlockFormat::BC4, color.data(), size, size).data(), texels, {0});
+        const auto bc5 = psnr(normals.data(), roundTrip(BlockFormat::BC5, normals.data(), size, size).data(), texels, {0, 1});
+        const auto bc7 = psnr(color.data(), roundTrip(BlockFormat::BC7, color.data(), size, size).data(), texels, {0, 1, 2, 3});
+        std::cout << std::fixed << std::setprecision(1)
+                  << "  PSNR BC1 " << bc1 << " dB, BC3 " << bc3 << " dB (alpha " << bc3Alpha << " dB), BC4 " << bc4
+                  << " dB, BC5 " << bc5 << " dB, BC7 " << bc7 << " dB" << std::endl;
+        check(bc1 > 34.0, "BC1 PSNR");
+        check(bc3 > 34.0 && bc3Alpha > 45.0, "BC3 PSNR");
+        check(bc4 > 40.0, "BC4 PSNR");
+        check(bc5 > 45.0, "BC5 PSNR");
+        check(bc7 > 38.0, "BC7 PSNR");
+    }
+
+    void roundTripsTheMipChain() {
+        constexpr auto size = 128u;
+        auto levels = createColorImage(size, size);
+        const auto mipLevels = Image::getMipLevelsCount(size, size);
+        const auto offsets = Image::generateMips(levels, size, size, mipLevels, true);
+        auto blocks = std::vector<uint8>{};
+        const auto blocksOffsets = BlockCompression::compressLevels(BlockFormat::BC7, levels, offsets, size, size, blocks);
+        auto psnrs = std::vector<double>{};
+        for (auto level = 0u; level < mipLevels; level++) {
+            const auto levelSize = std::max(1u, size >> level);
+            auto result = std::vector<uint8>(static_cast<size_t>(levelSize) * levelSize * 4);
+            BlockCompression::decompress(BlockFormat::BC7, blocks.data() + blocksOffsets[level], levelSize, levelSize, result.data());
+            psnrs.push_back(psnr(levels.data() + offsets[level], result.data(), static_cast<size_t>(levelSize) * levelSize, {0, 1, 2, 3}));
+        }
+        check(psnrs[0] > 40.0, "first level above the PSNR threshold");
+        // The coarse levels have more details per block
+        check(std::ranges::min(psnrs) > 30.0, "all the levels above the PSNR threshold");
+    }
+
+    void benchmarkPackSize() {
+        // One 1024x1024 color texture with its full mip chain, the pack stores and uploads the levels as they are
+        constexpr auto size = 1024u;
+        auto levels = createColorImage(size, size);
+        const auto mipLevels = Image::getMipLevelsCount(size, size);
+        const auto offsets = Image::generateMips(levels, size, size, mipLevels, true);
+        std::cout << "  RGBA8 mip chain : " << levels.size() << " bytes" << std::endl;
+        for (const auto& [format, name] : {
+            std::pair{ BlockFormat::BC1, "BC1" },
+            std::pair{ BlockFormat::BC5, "BC5" },
+            std::pair{ BlockFormat::BC7, "BC7" } }) {
+            auto blocks = std::vector<uint8>{};
+            BlockCompression::compressLevels(format, levels, offsets, size, size, blocks);
+            std::cout << "  " << name << " mip chain : " << blocks.size() << " bytes stored & uploaded ("
+                      << std::setprecision(1) << static_cast<double>(levels.size()) / blocks.size() << "x smaller)" << std::endl;
+            check(blocks.size() * (format == BlockFormat::BC1 ? 8 : 4) >= levels.size(), "compression ratio");
+        }
+        auto blocks = std::vector<uint8>{};
+        benchmark("cook a 1024x1024 mip chain to BC7", 1, [&] {
+            blocks.clear();
+            BlockCompression::compressLevels(BlockFormat::BC7, levels, offsets, size, size, blocks);
+        });
+        benchmark("cook a 1024x1024 mip chain to BC1", 1, [&] {
+            blocks.clear();
+            BlockCompression::compressLevels(BlockFormat::BC1, levels, offsets, size, size, blocks);
+        });
+    }
+
+}
+
+int main() {
+    return run({
+        { "computes levels sizes", computesLevelsSizes },
+        { "round trips uniform blocks", roundTripsUniformBlocks },
+        { "round trips above the PSNR thresholds", roundTripsAboveThePSNRThresholds },
+        { "round trips the mip chain", roundTripsTheMipChain },
+        { "benchmark pack size", benchmarkPackSize },
+    });
+}
@@ -0,0 +1,135 @@
+/*
+* Copyright (c) 2025-present Henri Michelon
+*
+* This software is released under the MIT License.
+* https://opensource.org/licenses/MIT
+*/
+import std;
+import lysa.math;
+import lysa.tests;
+import lysa.types;
+import lysa.renderers.debug_shapes;
+
+using namespace lysa;
+using namespace lysa::tests;
+
+namespace {
+
+    // The shape number is stored in the red channel to follow the instances
+    void add(DebugShapes& shapes, const uint32 number, const DebugShape shape, const DebugDrawMode mode, const float duration = 0.0f) {
+        shapes.add(shape, float4x4::identity(), float4{static_cast<float>(number), 0.0f, 0.0f, 1.0f}, duration, mode);
+    }
+
+    uint32 getNumber(const DebugShapes::Instance& instance) {
+        return static_cast<uint32>(static_cast<float>(instance.color.x));
+    }
+
+    void buildsOneBatchPerModeAndShape() {
+        auto shapes = DebugShapes{};
+        add(shapes, 0, DebugShape::SPHERE, DebugDrawMode::OVERLAY);
+        add(shapes, 1, DebugShape::BOX, DebugDrawMode::DEPTH_TESTED);
+        add(shapes, 2, DebugShape::BOX, DebugDrawMode::OVERLAY);
+        add(shapes, 3, DebugShape::BOX, DebugDrawMode::DEPTH_TESTED);
+        add(shapes, 4, DebugShape::SEGMENT, DebugDrawMode::DEPTH_TESTED);
+        add(shapes, 5, DebugShape::SPHERE, DebugDrawMode::OVERLAY);
+
+        auto instances = std::vector<DebugShapes::Instance>{};
+        auto batches = std::vector<DebugShapes::Batch>{};
+        shapes.build(instances, batches);
+        check(instances.size() == 6 && batches.size() == 4, "one batch per used mode and shape");
+        const auto expected = std::vector<DebugShapes::Batch>{
+            { DebugShape::BOX, DebugDrawMode::DEPTH_TESTED, 0, 2 },
+            { DebugShape::SEGMENT, DebugDrawMode::DEPTH_TESTED, 2, 1 },
+            { DebugShape::BOX, DebugDrawMode::OVERLAY, 3, 1 },
+            { DebugShape::SPHERE, DebugDrawMode::OVERLAY, 4, 2 },
+        };
+        check(std::ranges::equal(batches, expected, [](const auto& a, const auto& b) {
+            return a.shape == b.shape && a.mode == b.mode &&
+                   a.firstInstance == b.firstInstance && a.instanceCount == b.instanceCount;
+        }), "batches sorted by mode then by shape, depth tested first");
+        auto numbers = std::vector<uint32>{};
+        std::ranges::transform(instances, std::back_inserter(numbers), getNumber);
+        check(numbers == std::vector<uint32>{1, 3, 4, 2, 0, 5}, "instances grouped by batch, in the order of addition");
+
+        // Rebuilt in the same order, whatever the previous content of the arrays
+        auto rebuiltInstances = std::vector<DebugShapes::Instance>(10);
+        auto rebuiltBatches = std::vector<DebugShapes::Batch>(10);
+        shapes.build(rebuiltInstances, rebuiltBatches);
+        check(rebuiltBatches.size() == batches.size() &&
+              std::ranges::equal(rebuiltInstances | std::views::transform(getNumber), numbers), "stable order");
+    }
+
+    void expiresTheShapesAfterTheirDuration() {
+        auto shapes = DebugShapes{};
+        add(shapes, 0, DebugShape::BOX, DebugDrawMode::DEPTH_TESTED);
+        add(shapes, 1, DebugShape::SPHERE, DebugDrawMode::DEPTH_TESTED, 1.0f);
+        add(shapes, 2, DebugShape::CONE, DebugDrawMode::OVERLAY, 0.25f);
+        check(shapes.getCount() == 3 && shapes.getVersion() == 3, "version incremented by each addition");
+
+        shapes.expire(0.1f);
+        check(shapes.getCount() == 2 && shapes.getVersion() == 4, "zero duration shape drawn once");
+        shapes.expire(0.1f);
+        check(shapes.getCount() == 2 && shapes.getVersion() == 4, "version unchanged without expired shapes");
+        shapes.expire(0.1f);
+        check(shapes.getCount() == 1 && shapes.getVersion() == 5, "shape removed when its duration is elapsed");
+
+        auto instances = std::vector<DebugShapes::Instance>{};
+        auto batches = std::vector<DebugShapes::Batch>{};
+        shapes.build(instances, batches);
+        check(instances.size() == 1 && getNumber(instances[0]) == 1 && batches.size() == 1, "remaining shape built");
+
+        shapes.expire(1.0f);
+        check(shapes.getCount() == 0 && shapes.getVersion() == 6, "all the shapes expired");
+        shapes.clear();
+        check(shapes.getVersion() == 6, "clearing an empty list is not a change");
+        shapes.build(instances, batches);
+        check(instances.empty() && batches.empty(), "nothing to draw");
+    }
+
+    void buildsTheUnitMeshes() {
+        auto positions = std::vector<float3>{};
+        auto indices = std::vector<uint32>{};
+        auto ranges = std::array<DebugShapes::MeshRange, DebugShapes::SHAPES_COUNT>{};
+        DebugShapes::buildMeshes(positions, indices, ranges);
+        auto firstIndex = 0u;
+        for (const auto& range : ranges) {
+            check(range.firstIndex == firstIndex && range.indexCount > 0 && range.indexCount % 2 == 0,
+                  "contiguous line lists, in DebugShape order");
+            firstIndex += range.indexCount;
+        }
+        check(firstIndex == indices.size(), "all the indices used");
+        check(std::ranges::all_of(indices, [&](const uint32 index) { return index < positions.size(); }), "valid indices");
+        check(ranges[static_cast<uint32>(DebugShape::BOX)].indexCount == 24, "12 box edges");
+        check(ranges[static_cast<uint32>(DebugShape::SEGMENT)].indexCount == 2, "one segment line");
+    }
+
+    void benchmarkTenThousandShapes() {
+        auto shapes = DebugShapes{};
+        for (auto i = 0u; i < 10000; i++) {
+            add(shapes,
+                i,
+                static_cast<DebugShape>(i % DebugShapes::SHAPES_COUNT),
+                (i / DebugShapes::SHAPES_COUNT) % 3 == 0 ? DebugDrawMode::OVERLAY : DebugDrawMode::DEPTH_TESTED,
+                1.0f);
+        }
+        auto instances = std::vector<DebugShapes::Instance>{};
+        auto batches = std::vector<DebugShapes::Batch>{};
+        benchmark("build 10000 shapes", 100, [&] {
+            shapes.build(instances, batches);
+        });
+        // Before : one draw per shape. After : one indirect draw per mode, with one instanced command per batch
+        std::cout << "  " << shapes.getCount() << " shapes drawn with " << batches.size() << " instanced commands in "
+                  << DebugShapes::MODES_COUNT << " indirect draws" << std::endl;
+        check(batches.size() == DebugShapes::SHAPES_COUNT * DebugShapes::MODES_COUNT, "one draw per mode and shape");
+    }
+
+}
+
+int main() {
+    return run({
+        { "builds one batch per mode and shape", buildsOneBatchPerModeAndShape },
+        { "expires the shapes after their duration", expiresTheShapesAfterTheirDuration },
+        { "builds the unit meshes", buildsTheUnitMeshes },
+        { "benchmark ten thousand shapes", benchmarkTenThousandShapes },
+    });
+}
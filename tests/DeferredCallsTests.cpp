@@ -0,0 +1,188 @@
+/*
+* Copyright (c) 2025-present Henri Michelon
+*
+* This software is released under the MIT License.
+* https://opensource.org/licenses/MIT
+*/
+import std;
+import lysa.tests;
+import lysa.types;
+import lysa.deferred_calls;
+
+using namespace lysa;
+using namespace lysa::tests;
+
+// Counts the allocations of the whole program, to check that the queue does not allocate once warmed up
+static std::atomic<uint64> allocations{0};
+
+void* operator new(const std::size_t size) {
+    allocations.fetch_add(1, std::memory_order_relaxed);
+    if (auto* pointer = std::malloc(size == 0 ? 1 : size)) {
+        return pointer;
+    }
+    throw std::bad_alloc{};
+}
+
+void operator delete(void* pointer) noexcept {
+    std::free(pointer);
+}
+
+void operator delete(void* pointer, std::size_t) noexcept {
+    std::free(pointer);
+}
+
+namespace {
+
+    constexpr auto BLOCK_SIZE = DeferredCallQueue::BLOCK_SIZE;
+
+    void storesSmallCallsInline() {
+        auto value = 0;
+        auto small = DeferredCall{[&value] { value += 1; }};
+        check(small.isInline(), "small lambda stored inline");
+        auto large = DeferredCall{[&value, padding = std::array<uint8, DeferredCall::INLINE_SIZE>{}] {
+            value += 2 + padding[0];
+        }};
+        check(!large.isInline(), "large lambda stored on the heap");
+        auto moved = std::move(small);
+        check(!small && moved, "moved");
+        moved();
+        large();
+        check(value == 3, "both called");
+    }
+
+    void destroysCapturedObjects() {
+        auto captured = std::make_shared<int>(0);
+        {
+            auto queue = DeferredCallQueue{};
+            queue.push([captured] { *captured += 1; });
+            queue.push([captured] { *captured += 1; });
+            check(captured.use_count() == 3, "captured by the queued calls");
+            queue.process(1);
+            check(captured.use_count() == 2, "executed call destroyed");
+        }
+        check(captured.use_count() == 1 && *captured == 1, "pending call destroyed with the queue without being executed");
+    }
+
+    void keepsOrderAcrossBlocks() {
+        auto queue = DeferredCallQueue{};
+        auto executed = std::vector<uint32>{};
+        constexpr auto count = BLOCK_SIZE * 3 + 7;
+        for (auto i = 0u; i < count; i++) {
+            queue.push([&executed, i] { executed.push_back(i); });
+        }
+        check(!queue.empty(), "calls to execute");
+        check(queue.process() == count, "all executed");
+        check(queue.empty(), "empty");
+        check(executed.size() == count && std::ranges::is_sorted(executed), "executed in the push order");
+    }
+
+    void limitsCallsPerProcess() {
+        auto queue = DeferredCallQueue{};
+        auto executed = std::vector<uint32>{};
+        for (auto i = 0u; i < 10; i++) {
+            queue.push([&executed, i] { executed.push_back(i); });
+        }
+        check(queue.process(0) == 0 && executed.empty(), "nothing executed");
+        check(queue.process(3) == 3 && executed.size() == 3, "three executed");
+        check(!queue.empty(), "remaining calls kept");
+        check(queue.process() == 7, "remaining calls executed");
+        check(std::ranges::equal(executed, std::views::iota(0u, 10u)), "in order");
+        // Calls pushed by the executed calls are counted and executed after the queued ones
+        queue.push([&] {
+            executed.push_back(10);
+            queue.push([&executed] { executed.push_back(12); });
+        });
+        queue.push([&executed] { executed.push_back(11); });
+        check(queue.process(2) == 2 && executed.back() == 11, "pushed call not executed past the limit");
+        check(queue.process() == 1 && executed.back() == 12, "pushed call executed on the next process");
+    }
+
+    void recyclesBlocks() {
+        auto queue = DeferredCallQueue{};
+        auto executed = 0u;
+        const auto round = [&] {
+            for (auto i = 0u; i < BLOCK_SIZE * 4 + 100; i++) {
+                queue.push([&executed] { executed++; });
+            }
+            queue.process();
+        };
+        // Warm up : the number of blocks of a round depends on the position of its first call in a block
+        for (auto i = 0; i < 10; i++) {
+            round();
+        }
+        const auto before = allocations.load();
+        for (auto i = 0; i < 100; i++) {
+            round();
+        }
+        const auto allocated = allocations.load() - before;
+        std::cout << "  allocations in 100 rounds of " << BLOCK_SIZE * 4 + 100 << " calls: " << allocated << std::endl;
+        check(executed == (BLOCK_SIZE * 4 + 100) * 110, "all executed");
+        check(allocated == 0, "consumed blocks reused");
+    }
+
+    void keepsOrderPerProducer() {
+        constexpr auto producersCount = 8u;
+        constexpr auto callsPerProducer = 100000u;
+        auto queue = DeferredCallQueue{};
+        // Written by the consumer thread only
+        auto next = std::array<uint32, producersCount>{};
+        auto outOfOrder = 0u;
+        auto heap = 0u;
+        auto received = uint64{0};
+        auto producers = std::vector<std::jthread>{};
+        for (auto producer = 0u; producer < producersCount; producer++) {
+            producers.emplace_back([&, producer] {
+                for (auto i = 0u; i < callsPerProducer; i++) {
+                    const auto receive = [&, producer, i] {
+                        outOfOrder += next[producer] != i;
+                        next[producer] = i + 1;
+                        received++;
+                    };
+                    if (i % 64 == 0) {
+                        // Some calls too large to be stored inline
+                        queue.push([receive, &heap, padding = std::array<uint8, DeferredCall::INLINE_SIZE>{}] {
+                            receive();
+                            heap += 1 + padding[0];
+                        });
+                    } else {
+                        queue.push(receive);
+                    }
+                }
+            });
+        }
+        // Consumes with a small limit to interleave with the producers
+        while (received < producersCount * callsPerProducer) {
+            if (queue.process(1000) == 0) {
+                std::this_thread::yield();
+            }
+        }
+        producers.clear();
+        check(queue.process() == 0, "no extra call");
+        check(outOfOrder == 0, "calls of each producer in order");
+        check(heap == producersCount * ((callsPerProducer + 63) / 64), "large calls executed");
+    }
+
+    void benchmarkPushProcess() {
+        auto queue = DeferredCallQueue{};
+        auto executed = 0u;
+        benchmark("push & process 10000 calls", 100, [&] {
+            for (auto i = 0; i < 10000; i++) {
+                queue.push([&executed] { executed++; });
+            }
+            queue.process();
+        });
+    }
+
+}
+
+int main() {
+    return run({
+        { "stores small calls inline", storesSmallCallsInline },
+        { "destroys captured objects", destroysCapturedObjects },
+        { "keeps order across blocks", keepsOrderAcrossBlocks },
+        { "limits calls per process", limitsCallsPerProcess },
+        { "recycles blocks", recyclesBlocks },
+        { "keeps order per producer", keepsOrderPerProducer },
+        { "benchmark push & process", benchmarkPushProcess },
+    });
+}
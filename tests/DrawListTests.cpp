@@ -0,0 +1,185 @@
+/*
+* Copyright (c) 2025-present Henri Michelon
+*
+* This software is released under the MIT License.
+* https://opensource.org/licenses/MIT
+*/
+import std;
+import lysa.tests;
+import lysa.types;
+import lysa.renderers.draw_list;
+
+using namespace lysa;
+using namespace lysa::tests;
+
+namespace {
+
+    // Stand-ins of the device objects, identified by their value
+    using Set = std::shared_ptr<uint32>;
+    using Buffer = std::shared_ptr<uint32>;
+
+    struct Draw {
+        pipeline_id pipelineId;
+        Set descriptorSet;
+        uint32 drawCommandsCount;
+        Buffer culledDrawCommandsBuffer;
+        Buffer culledDrawCommandsCountBuffer;
+    };
+
+    // Counts the commands recorded instead of sending them to a device
+    struct CountingCommandList {
+        std::vector<pipeline_id> boundPipelines;
+        uint32 bindDescriptorsCalls{0};
+        uint32 bindDescriptorCalls{0};
+        uint32 boundSets{0};
+        std::vector<uint32> drawnCommands;
+        bool perPipelineSetBound{true};
+
+        void bindPipeline(const pipeline_id pipeline) { boundPipelines.push_back(pipeline); }
+
+        void bindDescriptors(const std::vector<Set>& sets) {
+            bindDescriptorsCalls++;
+            boundSets += static_cast<uint32>(sets.size());
+        }
+
+        void bindDescriptor(const Set& set, const uint32 index) {
+            bindDescriptorCalls++;
+            boundSets++;
+            perPipelineSetBound &= index == SET_PIPELINE && *set == boundPipelines.back();
+        }
+
+        void drawIndexedIndirectCount(
+            const Buffer&, const std::size_t,
+            const Buffer&, const std::size_t,
+            const uint32 maxDrawCount, const uint32, const uint32) {
+            drawnCommands.push_back(maxDrawCount);
+        }
+
+        static constexpr uint32 SET_PIPELINE{3};
+    };
+
+    // Pipelines of a pass, the scene keeps them in hash maps indexed by pipeline id
+    struct Pass {
+        std::unordered_map<pipeline_id, std::unique_ptr<Draw>> draws;
+        std::unordered_map<pipeline_id, pipeline_id> pipelines;
+        Set sharedSet{std::make_shared<uint32>(0)};
+
+        explicit Pass(const std::vector<pipeline_id>& pipelineIds) {
+            for (const auto id : pipelineIds) {
+                draws[id] = std::make_unique<Draw>(Draw{
+                    .pipelineId = id,
+                    .descriptorSet = std::make_shared<uint32>(id),
+                    .drawCommandsCount = id * 10,
+                    .culledDrawCommandsBuffer = std::make_shared<uint32>(id),
+                    .culledDrawCommandsCountBuffer = std::make_shared<uint32>(id),
+                });
+                pipelines[id] = id;
+            }
+        }
+
+        void build(DrawList<Draw>& drawList) const {
+            drawList.clear();
+            for (const auto& draw : std::views::values(draws)) {
+                drawList.add(*draw);
+            }
+            drawList.sort();
+        }
+
+        void record(const DrawList<Draw>& drawList, CountingCommandList& commandList) const {
+            drawList.record(
+                commandList,
+                pipelines,
+                [&](const Draw& draw) {
+                    // Global, samplers and scene sets shared by all the draws
+                    commandList.bindDescriptors({ sharedSet, sharedSet, sharedSet, draw.descriptorSet, sharedSet });
+                },
+                CountingCommandList::SET_PIPELINE,
+                20);
+        }
+    };
+
+    std::vector<pipeline_id> shuffledIds(const uint32 count, const uint32 seed) {
+        auto ids = std::vector<pipeline_id>(count);
+        std::iota(ids.begin(), ids.end(), 1);
+        std::ranges::shuffle(ids, std::mt19937{seed});
+        return ids;
+    }
+
+    void recordsInPipelineOrder() {
+        const auto pass = Pass{shuffledIds(50, 1)};
+        auto drawList = DrawList<Draw>{};
+        pass.build(drawList);
+        auto commandList = CountingCommandList{};
+        pass.record(drawList, commandList);
+        check(commandList.boundPipelines.size() == 50 && std::ranges::is_sorted(commandList.boundPipelines), "pipelines bound in id order");
+        check(commandList.bindDescriptorsCalls == 1, "shared sets bound once");
+        check(commandList.bindDescriptorCalls == 49 && commandList.perPipelineSetBound, "set of each other pipeline bound");
+        check(commandList.boundSets == 5 + 49, "sets bound");
+        check(commandList.drawnCommands.size() == 50, "one draw per pipeline");
+        check(std::ranges::equal(commandList.drawnCommands, commandList.boundPipelines, {}, {}, [](const pipeline_id id) { return id * 10; }),
+              "draws of each pipeline recorded after its bind");
+    }
+
+    void stableOrderAcrossFrames() {
+        // Same pipelines inserted in another order, like after materials changes
+        const auto first = Pass{shuffledIds(200, 2)};
+        const auto second = Pass{shuffledIds(200, 3)};
+        auto drawList = DrawList<Draw>{};
+        auto firstCommands = CountingCommandList{};
+        first.build(drawList);
+        first.record(drawList, firstCommands);
+        auto secondCommands = CountingCommandList{};
+        second.build(drawList);
+        second.record(drawList, secondCommands);
+        check(firstCommands.boundPipelines == secondCommands.boundPipelines, "same recording order");
+    }
+
+    void emptyListRecordsNothing() {
+        const auto pass = Pass{std::vector<pipeline_id>{}};
+        auto drawList = DrawList<Draw>{};
+        pass.build(drawList);
+        auto commandList = CountingCommandList{};
+        pass.record(drawList, commandList);
+        check(drawList.empty() && commandList.boundPipelines.empty(), "nothing bound");
+        check(commandList.bindDescriptorsCalls == 0 && commandList.drawnCommands.empty(), "nothing drawn");
+    }
+
+    void benchmarkRecording() {
+        constexpr auto pipelinesCount = 500u;
+        const auto pass = Pass{shuffledIds(pipelinesCount, 4)};
+        auto drawList = DrawList<Draw>{};
+        pass.build(drawList);
+        auto sorted = CountingCommandList{};
+        pass.record(drawList, sorted);
+        // Previous recording : all the sets bound with each pipeline, in the hash map order
+        auto unsorted = CountingCommandList{};
+        for (const auto& draw : std::views::values(pass.draws)) {
+            unsorted.bindPipeline(pass.pipelines.at(draw->pipelineId));
+            unsorted.bindDescriptors({ pass.sharedSet, pass.sharedSet, pass.sharedSet, draw->descriptorSet, pass.sharedSet });
+            unsorted.drawIndexedIndirectCount(draw->culledDrawCommandsBuffer, 0, draw->culledDrawCommandsCountBuffer, 0, draw->drawCommandsCount, 20, 4);
+        }
+        std::cout << "  " << pipelinesCount << " pipelines : " << sorted.boundSets << " descriptor sets bound ("
+                  << unsorted.boundSets << " when bound with each pipeline), "
+                  << sorted.bindDescriptorsCalls + sorted.bindDescriptorCalls << " bind calls, "
+                  << sorted.drawnCommands.size() << " draws" << std::endl;
+        check(sorted.drawnCommands.size() == unsorted.drawnCommands.size(), "same draws");
+        check(sorted.boundSets < unsorted.boundSets, "fewer sets bound");
+        auto commandList = CountingCommandList{};
+        commandList.boundPipelines.reserve(pipelinesCount * 1000);
+        commandList.drawnCommands.reserve(pipelinesCount * 1000);
+        benchmark("build & record 500 pipelines", 1000, [&] {
+            pass.build(drawList);
+            pass.record(drawList, commandList);
+        });
+    }
+
+}
+
+int main() {
+    return run({
+        { "records in pipeline order", recordsInPipelineOrder },
+        { "stable order across frames", stableOrderAcrossFrames },
+        { "empty list records nothing", emptyListRecordsNothing },
+        { "benchmark recording", benchmarkRecording },
+    });
+}
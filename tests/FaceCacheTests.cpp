@@ -0,0 +1,114 @@
+/*
+* Copyright (c) 2025-present Henri Michelon
+*
+* This software is released under the MIT License.
+* https://opensource.org/licenses/MIT
+*/
+import std;
+import lysa.tests;
+import lysa.types;
+import lysa.resources.face_cache;
+
+using namespace lysa;
+using namespace lysa::tests;
+
+namespace {
+
+    // Size of a typical TrueType font file, read in the HarfBuzz blob
+    constexpr auto FILE_SIZE = size_t{400 * 1024};
+
+    // Stand-in of the HarfBuzz blob & face of Font
+    struct FakeFace {
+        static inline auto destroyed = 0u;
+        std::string path;
+        std::vector<std::byte> blob;
+        ~FakeFace() { destroyed++; }
+    };
+
+    // Stand-in of Font : a shared face and its own scaled font
+    struct FakeFont {
+        FaceCache<FakeFace>& faces;
+        std::string path;
+        uint32 size;
+        std::shared_ptr<FakeFace> face;
+        int scale;
+
+        FakeFont(FaceCache<FakeFace>& faces, const std::string& path, const uint32 size) :
+            faces{faces}, path{path}, size{size} {
+            openFace();
+        }
+
+        FakeFont(const FakeFont& font) :
+            faces{font.faces}, path{font.path}, size{font.size} {
+            openFace();
+        }
+
+        // Font::openFace()
+        void openFace() {
+            face = faces.get(path, [&] {
+                return std::make_shared<FakeFace>(path, std::vector<std::byte>(FILE_SIZE));
+            });
+            scale = static_cast<int>(size * 64);
+        }
+    };
+
+    using Fonts = std::vector<std::shared_ptr<FakeFont>>;
+
+    // 20 sizes of a font, each one copied
+    Fonts createFonts(FaceCache<FakeFace>& faces, const std::string& path) {
+        auto fonts = Fonts{};
+        for (auto size = 8u; size < 28u; size++) {
+            fonts.push_back(std::make_shared<FakeFont>(faces, path, size));
+            fonts.push_back(std::make_shared<FakeFont>(*fonts.back()));
+        }
+        return fonts;
+    }
+
+    void sharesTheFaceBetweenSizesAndCopies() {
+        auto faces = FaceCache<FakeFace>{};
+        const auto fonts = createFonts(faces, "app://res/fonts/Signwood");
+        check(fonts.size() == 40, "20 sizes and their copies");
+        check(faces.getCount() == 1 && faces.getLoadsCount() == 1, "font file loaded once");
+        check(std::ranges::all_of(fonts, [&](const auto& font) { return font->face == fonts[0]->face; }), "one face shared");
+        check(fonts[0]->scale != fonts[2]->scale, "scale of each font kept");
+
+        const auto other = FakeFont{faces, "app://res/fonts/Other", 12};
+        check(faces.getCount() == 2 && other.face != fonts[0]->face, "one face per font file");
+    }
+
+    void releasesTheFaceWithTheLastFont() {
+        auto faces = FaceCache<FakeFace>{};
+        FakeFace::destroyed = 0;
+        auto fonts = createFonts(faces, "app://res/fonts/Signwood");
+        fonts.erase(fonts.begin() + 1, fonts.end());
+        check(faces.getCount() == 1 && FakeFace::destroyed == 0, "face kept while used");
+        fonts.clear();
+        check(faces.getCount() == 0 && FakeFace::destroyed == 1, "face released with the last font");
+
+        const auto font = FakeFont{faces, "app://res/fonts/Signwood", 12};
+        check(faces.getCount() == 1 && faces.getLoadsCount() == 2, "released face loaded again");
+    }
+
+    void benchmarkTwentySizes() {
+        auto faces = FaceCache<FakeFace>{};
+        auto fonts = Fonts{};
+        benchmark("open 20 sizes", 1, [&] {
+            fonts = createFonts(faces, "app://res/fonts/Signwood");
+        });
+        // Before : each font, and each copy, read and parsed the file
+        const auto previousMemory = fonts.size() * FILE_SIZE;
+        const auto memory = faces.getCount() * FILE_SIZE;
+        std::cout << "  before : " << fonts.size() << " files loaded, " << previousMemory / 1024 << " KB" << std::endl
+                  << "  after : " << faces.getLoadsCount() << " file loaded, " << memory / 1024 << " KB" << std::endl;
+        check(memory * fonts.size() == previousMemory, "one file in memory instead of one per font");
+    }
+
+}
+
+int main() {
+    return run({
+        { "shares the face between sizes and copies", sharesTheFaceBetweenSizesAndCopies },
+        { "releases the face with the last font", releasesTheFaceWithTheLastFont },
+        { "benchmark twenty sizes", benchmarkTwentySizes },
+    });
+}
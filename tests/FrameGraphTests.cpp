@@ -0,0 +1,269 @@
+/*
+* Copyright (c) 2025-present Henri Michelon
+*
+* This software is released under the MIT License.
+* https://opensource.org/licenses/MIT
+*/
+import std;
+import vireo;
+import lysa.tests;
+import lysa.types;
+import lysa.renderers.frame_graph;
+
+using namespace lysa;
+using namespace lysa::tests;
+
+namespace {
+
+    using State = vireo::ResourceState;
+    using Barrier = FrameGraph::Barrier;
+
+    bool hasBarrier(const std::vector<Barrier>& barriers, const FrameGraph::ResourceId resource, const State before, const State after) {
+        return std::ranges::any_of(barriers, [&](const Barrier& barrier) {
+            return barrier.resource == resource && barrier.before == before && barrier.after == after;
+        });
+    }
+
+    // Post-processing like chain : each pass reads the previous output and writes its own
+    struct Chain {
+        FrameGraph graph;
+        FrameGraph::ResourceId color;
+        std::vector<FrameGraph::PassId> passes;
+        std::vector<FrameGraph::ResourceId> outputs;
+
+        Chain(const uint32 length, const vireo::ImageFormat format = vireo::ImageFormat::R8G8B8A8_UNORM) {
+            color = graph.importResource("Color", State::SHADER_READ, State::SHADER_READ);
+            auto input = color;
+            for (auto i = 0u; i < length; i++) {
+                passes.push_back(graph.addPass("Pass " + std::to_string(i)));
+                outputs.push_back(graph.createResource("Output " + std::to_string(i), format));
+                graph.read(passes.back(), input);
+                graph.write(passes.back(), outputs.back());
+                input = outputs.back();
+            }
+            graph.setOutput(input);
+            graph.compile();
+        }
+    };
+
+    void cullsUnusedPasses() {
+        auto graph = FrameGraph{};
+        const auto imported = graph.importResource("Imported", State::UNDEFINED, State::RENDER_TARGET_COLOR);
+        const auto output = graph.createResource("Output", vireo::ImageFormat::R8G8B8A8_UNORM);
+        const auto unused = graph.createResource("Unused", vireo::ImageFormat::R8G8B8A8_UNORM);
+        const auto writesUnused = graph.addPass("Writes unused");
+        graph.write(writesUnused, unused);
+        const auto writesImported = graph.addPass("Writes imported");
+        graph.write(writesImported, imported);
+        const auto writesOutput = graph.addPass("Writes output");
+        graph.write(writesOutput, output);
+        graph.setOutput(output);
+        graph.compile();
+        check(graph.isCulled(writesUnused), "pass without contribution culled");
+        check(!graph.isCulled(writesImported), "pass writing an imported resource kept");
+        check(!graph.isCulled(writesOutput), "pass writing an output kept");
+        check(graph.getPhysicalResource(unused) == FrameGraph::NO_PHYSICAL_RESOURCE, "no physical resource for a culled write");
+        check(graph.getBarriers(writesUnused).empty(), "no barriers for a culled pass");
+    }
+
+    void placesChainBarriers() {
+        const auto chain = Chain{3};
+        const auto& graph = chain.graph;
+        const auto& outputs = chain.outputs;
+        check(graph.getBarriers(chain.passes[0]).size() == 1 &&
+              hasBarrier(graph.getBarriers(chain.passes[0]), outputs[0], State::UNDEFINED, State::RENDER_TARGET_COLOR),
+              "first write discards the content");
+        check(graph.getBarriers(chain.passes[1]).size() == 2 &&
+              hasBarrier(graph.getBarriers(chain.passes[1]), outputs[0], State::RENDER_TARGET_COLOR, State::SHADER_READ) &&
+              hasBarrier(graph.getBarriers(chain.passes[1]), outputs[1], State::UNDEFINED, State::RENDER_TARGET_COLOR),
+              "previous output read, new output written");
+        check(hasBarrier(graph.getBarriers(chain.passes[2]), outputs[2], State::UNDEFINED, State::RENDER_TARGET_COLOR),
+              "aliased output written with its content discarded");
+        check(graph.getFinalBarriers().size() == 2, "two final barriers");
+        check(hasBarrier(graph.getFinalBarriers(), outputs[2], State::RENDER_TARGET_COLOR, State::SHADER_READ),
+              "graph output left readable");
+        check(hasBarrier(graph.getFinalBarriers(), outputs[1], State::SHADER_READ, State::UNDEFINED),
+              "intermediate output released");
+    }
+
+    void bringsOutputsToTheirFinalState() {
+        auto graph = FrameGraph{};
+        const auto output = graph.createResource("Output", vireo::ImageFormat::R8G8B8A8_UNORM);
+        const auto pass = graph.addPass("Pass");
+        graph.write(pass, output);
+        graph.setOutput(output, State::COPY_SRC);
+        graph.compile();
+        check(graph.getFinalBarriers().size() == 1 &&
+              hasBarrier(graph.getFinalBarriers(), output, State::RENDER_TARGET_COLOR, State::COPY_SRC),
+              "output in the requested state");
+
+        graph.setOutput(output, State::RENDER_TARGET_COLOR);
+        graph.compile();
+        check(graph.getFinalBarriers().empty(), "no barrier when already in the final state");
+    }
+
+    void restoresImportedResources() {
+        auto graph = FrameGraph{};
+        const auto depth = graph.importResource("Depth", State::RENDER_TARGET_DEPTH, State::RENDER_TARGET_DEPTH);
+        const auto output = graph.createResource("Output", vireo::ImageFormat::R8G8B8A8_UNORM);
+        const auto first = graph.addPass("First");
+        graph.read(first, depth);
+        graph.write(first, output);
+        const auto second = graph.addPass("Second");
+        graph.read(second, depth);
+        graph.write(second, output);
+        graph.setOutput(output);
+        graph.compile();
+        check(hasBarrier(graph.getBarriers(first), depth, State::RENDER_TARGET_DEPTH, State::SHADER_READ),
+              "imported resource made readable");
+        check(!hasBarrier(graph.getBarriers(second), depth, State::RENDER_TARGET_DEPTH, State::SHADER_READ),
+              "imported resource already readable");
+        check(graph.getBarriers(second).empty(), "written output keeps its content");
+        check(hasBarrier(graph.getFinalBarriers(), depth, State::SHADER_READ, State::RENDER_TARGET_DEPTH),
+              "imported resource restored");
+    }
+
+    void aliasesDisjointLifetimes() {
+        const auto chain = Chain{8};
+        check(chain.graph.getPhysicalResourcesCount() == 2, "chain ping-pongs between two physical resources");
+        for (auto i = 0u; i < chain.outputs.size(); i++) {
+            check(chain.graph.getPhysicalResource(chain.outputs[i]) == i % 2, "alternate physical resources");
+        }
+
+        // Resources of different formats are never aliased, even with disjoint lifetimes
+        auto graph = FrameGraph{};
+        const auto first = graph.createResource("First", vireo::ImageFormat::R8G8B8A8_UNORM);
+        const auto second = graph.createResource("Second", vireo::ImageFormat::R8G8B8A8_UNORM);
+        const auto hdr = graph.createResource("HDR", vireo::ImageFormat::R16G16B16A16_SFLOAT);
+        graph.write(graph.addPass("Writes first"), first);
+        const auto readsFirst = graph.addPass("Reads first");
+        graph.read(readsFirst, first);
+        graph.write(readsFirst, second);
+        const auto readsSecond = graph.addPass("Reads second");
+        graph.read(readsSecond, second);
+        graph.write(readsSecond, hdr);
+        graph.setOutput(hdr);
+        graph.compile();
+        check(graph.getPhysicalResourcesCount() == 3, "no physical resource shared between formats");
+        check(graph.getPhysicalResourceFormat(graph.getPhysicalResource(hdr)) == vireo::ImageFormat::R16G16B16A16_SFLOAT,
+              "physical resource format");
+    }
+
+    void neverAliasesOutputs() {
+        auto graph = FrameGraph{};
+        const auto output = graph.createResource("Output", vireo::ImageFormat::R8G8B8A8_UNORM);
+        const auto other = graph.createResource("Other", vireo::ImageFormat::R8G8B8A8_UNORM);
+        const auto last = graph.createResource("Last", vireo::ImageFormat::R8G8B8A8_UNORM);
+        graph.write(graph.addPass("Writes output"), output);
+        const auto pass = graph.addPass("Writes other");
+        graph.write(pass, other);
+        const auto lastPass = graph.addPass("Writes last");
+        graph.read(lastPass, other);
+        graph.write(lastPass, last);
+        graph.setOutput(output);
+        graph.setOutput(last);
+        graph.compile();
+        check(graph.getPhysicalResource(output) != graph.getPhysicalResource(other) &&
+              graph.getPhysicalResource(output) != graph.getPhysicalResource(last),
+              "output not aliased after its last write");
+    }
+
+    // Replays the compiled barriers and checks the states seen by each access and the lifetimes of the aliases
+    void randomGraphsAreConsistent() {
+        auto random = std::mt19937{42};
+        constexpr vireo::ImageFormat FORMATS[] = { vireo::ImageFormat::R8G8B8A8_UNORM, vireo::ImageFormat::R16G16B16A16_SFLOAT };
+        struct Access { FrameGraph::ResourceId resource; State state; bool write; };
+        for (auto iteration = 0; iteration < 200; iteration++) {
+            auto graph = FrameGraph{};
+            const auto resourcesCount = 2 + random() % 10;
+            for (auto i = 0u; i < resourcesCount; i++) {
+                graph.createResource("Resource", FORMATS[random() % 2]);
+            }
+            // Each pass reads resources already written and writes one resource
+            auto accesses = std::vector<std::vector<Access>>{};
+            auto written = std::vector<bool>(resourcesCount, false);
+            const auto passesCount = 1 + random() % 12;
+            for (auto i = 0u; i < passesCount; i++) {
+                const auto pass = graph.addPass("Pass");
+                accesses.emplace_back();
+                for (auto resource = 0u; resource < resourcesCount; resource++) {
+                    if (written[resource] && random() % 3 == 0) {
+                        graph.read(pass, resource);
+                        accesses.back().push_back({ resource, State::SHADER_READ, false });
+                    }
+                }
+                const auto resource = static_cast<FrameGraph::ResourceId>(random() % resourcesCount);
+                if (std::ranges::none_of(accesses.back(), [&](const Access& access) { return access.resource == resource; })) {
+                    graph.write(pass, resource);
+                    accesses.back().push_back({ resource, State::RENDER_TARGET_COLOR, true });
+                    written[resource] = true;
+                }
+            }
+            auto outputs = std::vector<FrameGraph::ResourceId>{};
+            for (auto resource = 0u; resource < resourcesCount; resource++) {
+                if (written[resource] && random() % 3 == 0) {
+                    graph.setOutput(resource);
+                    outputs.push_back(resource);
+                }
+            }
+            graph.compile();
+
+            auto states = std::vector<State>(graph.getPhysicalResourcesCount(), State::UNDEFINED);
+            // Resource whose content is in each physical resource
+            auto holders = std::vector<FrameGraph::ResourceId>(graph.getPhysicalResourcesCount(), 0);
+            for (auto pass = 0u; pass < passesCount; pass++) {
+                if (graph.isCulled(pass)) { continue; }
+                for (const auto& barrier : graph.getBarriers(pass)) {
+                    const auto physical = graph.getPhysicalResource(barrier.resource);
+                    check(barrier.before == states[physical] || barrier.before == State::UNDEFINED, "barrier from the current state");
+                    states[physical] = barrier.after;
+                }
+                for (const auto& access : accesses[pass]) {
+                    const auto physical = graph.getPhysicalResource(access.resource);
+                    check(physical != FrameGraph::NO_PHYSICAL_RESOURCE, "accessed resource allocated");
+                    check(states[physical] == access.state, "resource in the state of the access");
+                    if (access.write) { holders[physical] = access.resource; }
+                    check(holders[physical] == access.resource, "content not overwritten by an alias");
+                }
+            }
+            for (const auto& barrier : graph.getFinalBarriers()) {
+                states[graph.getPhysicalResource(barrier.resource)] = barrier.after;
+            }
+            for (const auto output : outputs) {
+                const auto physical = graph.getPhysicalResource(output);
+                check(holders[physical] == output && states[physical] == State::SHADER_READ, "output readable after the graph");
+            }
+        }
+    }
+
+    void benchmarkCompile() {
+        auto graph = FrameGraph{};
+        benchmark("compile a 16 passes chain", 1000, [&] {
+            graph.clear();
+            auto input = graph.importResource("Color", State::SHADER_READ, State::SHADER_READ);
+            for (auto i = 0; i < 16; i++) {
+                const auto pass = graph.addPass("Pass");
+                const auto output = graph.createResource("Output", vireo::ImageFormat::R8G8B8A8_UNORM);
+                graph.read(pass, input);
+                graph.write(pass, output);
+                input = output;
+            }
+            graph.setOutput(input);
+            graph.compile();
+        });
+    }
+
+}
+
+int main() {
+    return run({
+        { "culls unused passes", cullsUnusedPasses },
+        { "places chain barriers", placesChainBarriers },
+        { "brings outputs to their final state", bringsOutputsToTheirFinalState },
+        { "restores imported resources", restoresImportedResources },
+        { "aliases disjoint lifetimes", aliasesDisjointLifetimes },
+        { "never aliases outputs", neverAliasesOutputs },
+        { "random graphs are consistent", randomGraphsAreConsistent },
+        { "benchmark compile", benchmarkCompile },
+    });
+}
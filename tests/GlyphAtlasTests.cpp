@@ -0,0 +1,185 @@
+/*
+* Copyright (c) 2025-present Henri Michelon
+*
+* This software is released under the MIT License.
+* https://opensource.org/licenses/MIT
+*/
+#include <msdfgen.h>
+import std;
+import lysa.job_system;
+import lysa.tests;
+import lysa.types;
+import lysa.resources.glyph_atlas;
+
+using namespace lysa;
+using namespace lysa::tests;
+
+namespace {
+
+    struct Rectangle {
+        uint32 x;
+        uint32 y;
+        uint32 width;
+        uint32 height;
+    };
+
+    // Packs the rectangles until the first one that does not fit, returns the packed ones
+    std::vector<Rectangle> pack(SkylinePacker& packer, const std::vector<std::pair<uint32, uint32>>& sizes) {
+        auto packed = std::vector<Rectangle>{};
+        for (const auto& [width, height] : sizes) {
+            auto rectangle = Rectangle{0, 0, width, height};
+            if (!packer.pack(width, height, rectangle.x, rectangle.y)) {
+                break;
+            }
+            packed.push_back(rectangle);
+        }
+        return packed;
+    }
+
+    std::vector<std::pair<uint32, uint32>> randomSizes(const uint32 count, const uint32 seed) {
+        auto random = std::mt19937{seed};
+        auto sizes = std::vector<std::pair<uint32, uint32>>{};
+        for (auto i = 0u; i < count; i++) {
+            sizes.push_back({ 8 + random() % 40, 8 + random() % 40 });
+        }
+        return sizes;
+    }
+
+    // Rectangle with a quadratic bump on the top edge, in em units
+    msdfgen::Shape createShape() {
+        auto shape = msdfgen::Shape{};
+        auto& contour = shape.addContour();
+        contour.addEdge(msdfgen::EdgeHolder(msdfgen::Point2(0.1, 0.0), msdfgen::Point2(0.63, 0.0)));
+        contour.addEdge(msdfgen::EdgeHolder(msdfgen::Point2(0.63, 0.0), msdfgen::Point2(0.63, 0.5)));
+        contour.addEdge(msdfgen::EdgeHolder(msdfgen::Point2(0.63, 0.5), msdfgen::Point2(0.365, 0.8), msdfgen::Point2(0.1, 0.5)));
+        contour.addEdge(msdfgen::EdgeHolder(msdfgen::Point2(0.1, 0.5), msdfgen::Point2(0.1, 0.0)));
+        return shape;
+    }
+
+    constexpr auto GLYPH_SIZE = 48.0f;
+    constexpr auto PIXEL_RANGE = 4.0f;
+
+    void packsInsideWithoutOverlap() {
+        auto packer = SkylinePacker{256, 256};
+        const auto packed = pack(packer, randomSizes(1000, 42));
+        check(packed.size() > 10 && packed.size() < 1000, "atlas filled");
+        auto covered = std::vector<bool>(256 * 256, false);
+        auto area = uint64{0};
+        auto overlap = false;
+        for (const auto& rectangle : packed) {
+            check(rectangle.x + rectangle.width <= 256 && rectangle.y + rectangle.height <= 256, "inside the atlas");
+            for (auto y = rectangle.y; y < rectangle.y + rectangle.height; y++) {
+                for (auto x = rectangle.x; x < rectangle.x + rectangle.width; x++) {
+                    overlap |= covered[y * 256 + x];
+                    covered[y * 256 + x] = true;
+                }
+            }
+            area += static_cast<uint64>(rectangle.width) * rectangle.height;
+        }
+        check(!overlap, "no overlap");
+        check(packer.getUsedArea() == area, "used area of the packed rectangles");
+        std::cout << "  atlas occupancy: " << area * 100 / (256 * 256) << "%" << std::endl;
+    }
+
+    void packsBottomLeft() {
+        auto packer = SkylinePacker{100, 100};
+        const auto packed = pack(packer, { {40, 10}, {40, 20}, {20, 5}, {30, 10} });
+        check(packed.size() == 4, "all packed");
+        check(packed[0].x == 0 && packed[0].y == 0, "first at the origin");
+        check(packed[1].x == 40 && packed[1].y == 0, "second on the right of the first");
+        check(packed[2].x == 80 && packed[2].y == 0, "third in the remaining columns");
+        check(packed[3].x == 0 && packed[3].y == 10, "fourth on the lowest segment");
+    }
+
+    void fillsWithIdenticalSquares() {
+        auto packer = SkylinePacker{256, 256};
+        auto sizes = std::vector<std::pair<uint32, uint32>>(257, {16, 16});
+        check(pack(packer, sizes).size() == 256, "256 squares of 16x16 in 256x256");
+        check(packer.getUsedArea() == 256 * 256, "atlas full");
+    }
+
+    void rejectsInvalidSizes() {
+        auto packer = SkylinePacker{64, 64};
+        auto x = 0u;
+        auto y = 0u;
+        check(!packer.pack(0, 10, x, y) && !packer.pack(10, 0, x, y), "empty rectangles rejected");
+        check(!packer.pack(65, 10, x, y) && !packer.pack(10, 65, x, y), "larger than the atlas rejected");
+        check(packer.pack(64, 64, x, y) && x == 0 && y == 0, "atlas sized rectangle packed");
+        check(!packer.pack(1, 1, x, y), "full atlas");
+        packer.clear();
+        check(packer.getUsedArea() == 0, "cleared");
+        check(packer.pack(64, 64, x, y), "packed again after clear");
+    }
+
+    void packingIsDeterministic() {
+        const auto sizes = randomSizes(500, 7);
+        auto first = SkylinePacker{512, 512};
+        auto second = SkylinePacker{512, 512};
+        const auto a = pack(first, sizes);
+        // Same result after a clear, like after an eviction
+        pack(second, randomSizes(100, 8));
+        second.clear();
+        const auto b = pack(second, sizes);
+        check(a.size() == b.size(), "same count");
+        check(std::ranges::equal(a, b, [](const Rectangle& l, const Rectangle& r) {
+            return l.x == r.x && l.y == r.y;
+        }), "same positions");
+    }
+
+    void generatesEmptyBitmapForEmptyOutline() {
+        const auto bitmap = GlyphAtlas::generate(msdfgen::Shape{}, GLYPH_SIZE, PIXEL_RANGE);
+        check(bitmap.width == 0 && bitmap.height == 0 && bitmap.pixels.empty(), "nothing to draw");
+    }
+
+    void generatesBitmapAroundOutline() {
+        const auto bitmap = GlyphAtlas::generate(createShape(), GLYPH_SIZE, PIXEL_RANGE);
+        const auto margin = 0.5f * PIXEL_RANGE / GLYPH_SIZE;
+        check(bitmap.width == static_cast<uint32>(std::ceil((0.53f + 2.0f * margin) * GLYPH_SIZE)), "width");
+        check(bitmap.pixels.size() == static_cast<std::size_t>(bitmap.width) * bitmap.height * 4, "4 channels");
+        check(std::abs(bitmap.left - (0.1f - margin)) < 1e-5f && std::abs(bitmap.bottom + margin) < 1e-5f,
+              "quad around the outline");
+        check(std::abs(bitmap.right - bitmap.left - bitmap.width / GLYPH_SIZE) < 1e-5f, "quad of the bitmap size");
+        // True distance in the alpha channel : inside and outside on both sides of the middle value
+        const auto alpha = [&](const uint32 x, const uint32 y) {
+            return bitmap.pixels[(static_cast<std::size_t>(y) * bitmap.width + x) * 4 + 3];
+        };
+        check((alpha(bitmap.width / 2, bitmap.height / 2) > 127) != (alpha(0, 0) > 127), "outline between center and corner");
+    }
+
+    void generationIsDeterministic() {
+        const auto reference = GlyphAtlas::generate(createShape(), GLYPH_SIZE, PIXEL_RANGE);
+        check(GlyphAtlas::generate(createShape(), GLYPH_SIZE, PIXEL_RANGE).pixels == reference.pixels, "same pixels");
+        // Generated concurrently, like in the atlas jobs
+        auto jobSystem = JobSystem{4};
+        auto bitmaps = std::vector<GlyphAtlas::Bitmap>(16);
+        jobSystem.parallelFor(static_cast<uint32>(bitmaps.size()), 1, [&](const uint32 index) {
+            bitmaps[index] = GlyphAtlas::generate(createShape(), GLYPH_SIZE, PIXEL_RANGE);
+        });
+        check(std::ranges::all_of(bitmaps, [&](const auto& bitmap) {
+            return bitmap.width == reference.width && bitmap.height == reference.height && bitmap.pixels == reference.pixels;
+        }), "same pixels in the jobs");
+    }
+
+    void benchmarkPacking() {
+        const auto sizes = randomSizes(2000, 42);
+        benchmark("pack glyphs in a 1024x1024 atlas", 20, [&] {
+            auto packer = SkylinePacker{1024, 1024};
+            pack(packer, sizes);
+        });
+    }
+
+}
+
+int main() {
+    return run({
+        { "packs inside without overlap", packsInsideWithoutOverlap },
+        { "packs bottom-left", packsBottomLeft },
+        { "fills with identical squares", fillsWithIdenticalSquares },
+        { "rejects invalid sizes", rejectsInvalidSizes },
+        { "packing is deterministic", packingIsDeterministic },
+        { "generates empty bitmap for empty outline", generatesEmptyBitmapForEmptyOutline },
+        { "generates bitmap around outline", generatesBitmapAroundOutline },
+        { "generation is deterministic", generationIsDeterministic },
+        { "benchmark packing", benchmarkPacking },
+    });
+}
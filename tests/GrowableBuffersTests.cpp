@@ -0,0 +1,121 @@
+/*
+* Copyright (c) 2025-present Henri Michelon
+*
+* This software is released under the MIT License.
+* https://opensource.org/licenses/MIT
+*/
+import std;
+import lysa.tests;
+import lysa.types;
+import lysa.renderers.growable_buffers;
+
+using namespace lysa;
+using namespace lysa::tests;
+
+namespace {
+
+    // Packed VectorRenderer vertex : float3 position, half2 UV, RGBA8 color, 2 x 16 bits indices
+    constexpr auto VERTEX_SIZE = uint32{24};
+    // Previous vertex : five alignas(16) fields
+    constexpr auto PREVIOUS_VERTEX_SIZE = uint32{80};
+    constexpr auto MIN_CAPACITY = uint32{1024};
+    constexpr auto FRAMES_IN_FLIGHT = uint32{2};
+
+    // Stand-in of the staging & vertex buffers of a frame
+    struct FakeBuffers {
+        uint32 capacity{0};
+        uint64 uploadedBytes{0};
+    };
+
+    // VectorRenderer::update() for a frame : returns true if the buffers of the frame were written
+    bool update(GrowableBuffers<FakeBuffers>& buffers, const uint32 frameIndex, const uint32 count) {
+        return buffers.upload(
+            frameIndex,
+            count,
+            [](const uint32 capacity) { return FakeBuffers{capacity, 0}; },
+            [&](const FakeBuffers& frameBuffers, const uint64 size, bool) {
+                check(size <= uint64{frameBuffers.capacity} * VERTEX_SIZE, "upload in the buffers capacity");
+            });
+    }
+
+    void growsByDoublingTheCapacity() {
+        auto buffers = GrowableBuffers<FakeBuffers>{FRAMES_IN_FLIGHT, VERTEX_SIZE, MIN_CAPACITY};
+        check(update(buffers, 0, 10) && buffers.getCapacity(0) == MIN_CAPACITY, "minimum capacity");
+        check(buffers.getCapacity(1) == 0, "buffers of the other frame created when it is used");
+        buffers.invalidate();
+        check(update(buffers, 0, MIN_CAPACITY) && buffers.getCapacity(0) == MIN_CAPACITY, "full buffers kept");
+        buffers.invalidate();
+        check(update(buffers, 0, 5000) && buffers.getCapacity(0) == 8192, "capacity doubled until large enough");
+        buffers.invalidate();
+        check(update(buffers, 0, 100) && buffers.getCapacity(0) == 8192, "buffers never shrunk");
+        check(buffers.get(0).capacity == 8192, "buffers created with the capacity");
+        check(buffers.getStatistics().reallocations == 2, "two allocations");
+        check(!update(buffers, 0, 0), "nothing uploaded without vertices");
+    }
+
+    void uploadsEachFrameOnce() {
+        auto buffers = GrowableBuffers<FakeBuffers>{FRAMES_IN_FLIGHT, VERTEX_SIZE, MIN_CAPACITY};
+        check(update(buffers, 0, 100) && update(buffers, 1, 100), "first upload in all the frames");
+        check(!update(buffers, 0, 100) && !update(buffers, 1, 100), "unchanged vertices not uploaded");
+        check(buffers.getStatistics().uploadedBytes == 2 * 100 * VERTEX_SIZE, "used part uploaded");
+
+        // Vertices changed while frame 1 is in flight : frame 1 is written when it is reused
+        buffers.invalidate();
+        check(update(buffers, 0, 200), "current frame uploaded");
+        check(!update(buffers, 0, 200), "current frame uploaded once");
+        check(update(buffers, 1, 200), "other frame uploaded when reused");
+        check(buffers.getStatistics().uploadedBytes == 2 * 300 * VERTEX_SIZE, "uploaded bytes");
+    }
+
+    void benchmarkDynamicDebugDraw() {
+        // Debug draw of moving bodies : between 20k and 60k lines vertices, changing each frame,
+        // with a static frame every 4 frames
+        constexpr auto framesCount = 600u;
+        auto counts = std::vector<uint32>{};
+        for (auto frame = 0u; frame < framesCount; frame++) {
+            const auto bodies = 10000.0 + 5000.0 * std::sin(frame * 0.05) + 5000.0 * std::sin(frame * 0.31);
+            counts.push_back(frame % 4 == 0 && frame > 0 ? counts.back() : static_cast<uint32>(bodies) * 2 * 2);
+        }
+
+        auto buffers = GrowableBuffers<FakeBuffers>{FRAMES_IN_FLIGHT, VERTEX_SIZE, MIN_CAPACITY};
+        auto frame = 0u;
+        benchmark("update 600 frames", 1, [&] {
+            for (; frame < framesCount; frame++) {
+                if (frame == 0 || frame % 4 != 0) {
+                    buffers.invalidate();
+                }
+                update(buffers, frame % FRAMES_IN_FLIGHT, counts[frame]);
+            }
+        });
+
+        // Before : one vertex buffer uploaded when the vertices changed,
+        // and recreated each time the vertex count changed
+        auto previousBytes = uint64{0};
+        auto previousReallocations = uint32{0};
+        auto previousCount = uint32{0};
+        for (frame = 0; frame < framesCount; frame++) {
+            if (frame == 0 || frame % 4 != 0) {
+                previousBytes += uint64{counts[frame]} * PREVIOUS_VERTEX_SIZE;
+            }
+            previousReallocations += counts[frame] != previousCount;
+            previousCount = counts[frame];
+        }
+        const auto& statistics = buffers.getStatistics();
+        std::cout << "  before : " << previousBytes / framesCount / 1024 << " KB uploaded per frame, "
+                  << previousReallocations << " reallocations" << std::endl
+                  << "  after : " << statistics.uploadedBytes / framesCount / 1024 << " KB uploaded per frame, "
+                  << statistics.reallocations << " reallocations" << std::endl;
+        check(statistics.reallocations <= 2 * FRAMES_IN_FLIGHT, "reallocations only while growing");
+        // 80 -> 24 bytes vertices, minus the static frames uploaded in the other frame in flight
+        check(statistics.uploadedBytes * 2 < previousBytes, "at least 2x less bytes uploaded");
+    }
+
+}
+
+int main() {
+    return run({
+        { "grows by doubling the capacity", growsByDoublingTheCapacity },
+        { "uploads each frame once", uploadsEachFrameOnce },
+        { "benchmark dynamic debug draw", benchmarkDynamicDebugDraw },
+    });
+}
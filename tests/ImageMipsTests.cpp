@@ -0,0 +1,128 @@
+/*
+* Copyright (c) 2025-present Henri Michelon
+*
+* This software is released under the MIT License.
+* https://opensource.org/licenses/MIT
+*/
+import std;
+import lysa.tests;
+import lysa.types;
+import lysa.resources.image;
+
+using namespace lysa;
+using namespace lysa::tests;
+
+namespace {
+
+    std::vector<uint8> createImage(const uint32 width, const uint32 height, const std::function<uint8(uint32, uint32, uint32)>& texel) {
+        auto data = std::vector<uint8>(static_cast<size_t>(width) * height * 4);
+        for (auto y = 0u; y < height; y++) {
+            for (auto x = 0u; x < width; x++) {
+                for (auto channel = 0u; channel < 4; channel++) {
+                    data[(static_cast<size_t>(y) * width + x) * 4 + channel] = texel(x, y, channel);
+                }
+            }
+        }
+        return data;
+    }
+
+    double toLinear(const double c) {
+        return c <= 0.04045 ? c / 12.92 : std::pow((c + 0.055) / 1.055, 2.4);
+    }
+
+    double toSRGB(const double c) {
+        return c <= 0.0031308 ? c * 12.92 : 1.055 * std::pow(c, 1.0 / 2.4) - 0.055;
+    }
+
+    void computesLevelsOffsets() {
+        auto data = createImage(5, 3, [](uint32, uint32, uint32) { return uint8{0}; });
+        const auto mipLevels = Image::getMipLevelsCount(5, 3);
+        check(mipLevels == 3, "5x3, 2x1 & 1x1 levels");
+        const auto offsets = Image::generateMips(data, 5, 3, mipLevels, true);
+        check(offsets.size() == 3, "one offset per level");
+        check(offsets[0] == 0 && offsets[1] == 5 * 3 * 4 && offsets[2] == offsets[1] + 2 * 1 * 4, "levels offsets");
+        check(data.size() == offsets[2] + 4, "levels appended to the image");
+    }
+
+    void preservesUniformColors() {
+        for (auto value = 0u; value < 256; value++) {
+            for (const auto sRGB : { true, false }) {
+                auto data = createImage(4, 4, [value](uint32, uint32, uint32) { return static_cast<uint8>(value); });
+                Image::generateMips(data, 4, 4, 3, sRGB);
+                check(std::ranges::all_of(data, [value](const uint8 texel) { return texel == value; }),
+                      "uniform color preserved in all the levels");
+            }
+        }
+    }
+
+    void averagesInLinearSpace() {
+        const auto checker = [](const uint32 x, const uint32 y, const uint32 channel) {
+            return channel == 3 ? uint8{255} : static_cast<uint8>((x + y) % 2 == 0 ? 0 : 255);
+        };
+        auto sRGB = createImage(2, 2, checker);
+        Image::generateMips(sRGB, 2, 2, 2, true);
+        const auto expected = static_cast<uint8>(std::lround(toSRGB(0.5) * 255.0));
+        check(sRGB[16] == expected && sRGB[17] == expected && sRGB[18] == expected, "sRGB black & white averaged in linear space");
+        check(sRGB[19] == 255, "alpha averaged without conversion");
+        auto unorm = createImage(2, 2, checker);
+        Image::generateMips(unorm, 2, 2, 2, false);
+        check(unorm[16] == 128, "unorm black & white averaged");
+    }
+
+    void matchesReferenceFilter() {
+        constexpr auto size = 256u;
+        auto random = std::mt19937{42};
+        auto data = createImage(size, size, [&](uint32, uint32, uint32) { return static_cast<uint8>(random() % 256); });
+        const auto source = data;
+        const auto mipLevels = Image::getMipLevelsCount(size, size);
+        const auto offsets = Image::generateMips(data, size, size, mipLevels, true);
+
+        // Double precision reference of the first level
+        auto squaredError = 0.0;
+        const auto levelSize = size / 2;
+        for (auto y = 0u; y < levelSize; y++) {
+            for (auto x = 0u; x < levelSize; x++) {
+                for (auto channel = 0u; channel < 4; channel++) {
+                    auto sum = 0.0;
+                    for (auto sy = y * 2; sy < y * 2 + 2; sy++) {
+                        for (auto sx = x * 2; sx < x * 2 + 2; sx++) {
+                            const auto value = source[(sy * size + sx) * 4 + channel] / 255.0;
+                            sum += channel < 3 ? toLinear(value) : value;
+                        }
+                    }
+                    const auto average = sum / 4.0;
+                    const auto reference = (channel < 3 ? toSRGB(average) : average) * 255.0;
+                    const auto error = data[offsets[1] + (y * levelSize + x) * 4 + channel] - reference;
+                    squaredError += error * error;
+                }
+            }
+        }
+        const auto mse = squaredError / (levelSize * levelSize * 4);
+        const auto psnr = 10.0 * std::log10(255.0 * 255.0 / mse);
+        std::cout << "  PSNR against the reference filter: " << psnr << " dB" << std::endl;
+        check(psnr > 50.0, "first level PSNR above 50 dB");
+    }
+
+    void benchmarkMips() {
+        constexpr auto size = 2048u;
+        const auto image = createImage(size, size, [](const uint32 x, const uint32 y, const uint32 channel) {
+            return static_cast<uint8>(x ^ y ^ channel);
+        });
+        const auto mipLevels = Image::getMipLevelsCount(size, size);
+        benchmark("2048x2048 sRGB mip chain", 3, [&] {
+            auto data = image;
+            Image::generateMips(data, size, size, mipLevels, true);
+        });
+    }
+
+}
+
+int main() {
+    return run({
+        { "computes levels offsets", computesLevelsOffsets },
+        { "preserves uniform colors", preservesUniformColors },
+        { "averages in linear space", averagesInLinearSpace },
+        { "matches reference filter", matchesReferenceFilter },
+        { "benchmark mips", benchmarkMips },
+    });
+}
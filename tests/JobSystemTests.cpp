@@ -0,0 +1,205 @@
+/*
+* Copyright (c) 2025-present Henri Michelon
+*
+* This software is released under the MIT License.
+* https://opensource.org/licenses/MIT
+*/
+import std;
+import lysa.tests;
+import lysa.types;
+import lysa.job_system;
+
+using namespace lysa;
+using namespace lysa::tests;
+
+namespace {
+
+    // Waits for a condition set by another thread, false after one second
+    bool waitFor(const std::function<bool()>& condition) {
+        const auto start = std::chrono::steady_clock::now();
+        while (!condition()) {
+            if (std::chrono::steady_clock::now() - start > std::chrono::seconds(1)) {
+                return false;
+            }
+            std::this_thread::sleep_for(std::chrono::microseconds(100));
+        }
+        return true;
+    }
+
+    void executesDependenciesFirst() {
+        auto jobSystem = JobSystem{4, 1};
+        auto order = std::atomic<uint32>{0};
+        auto first = uint32{0};
+        auto second = uint32{0};
+        auto last = uint32{0};
+        const auto a = jobSystem.schedule([&] { first = ++order; });
+        const auto b = jobSystem.schedule([&] { second = ++order; }, JobPriority::HIGH, { a });
+        const auto c = jobSystem.schedule([&] { last = ++order; }, JobPriority::LOW, { a, b, JobHandle{} });
+        jobSystem.wait(c);
+        check(a->isFinished() && b->isFinished(), "dependencies finished");
+        check(first == 1 && second == 2 && last == 3, "executed in the dependencies order");
+        const auto finished = jobSystem.schedule([&] { last = ++order; }, JobPriority::NORMAL, { c });
+        jobSystem.wait(finished);
+        check(last == 4, "finished dependency does not delay the job");
+    }
+
+    void waitSkipsLowerPriorities() {
+        auto jobSystem = JobSystem{1, 1};
+        const auto mainThread = std::this_thread::get_id();
+        auto released = std::atomic<bool>{false};
+        const auto blocker = jobSystem.schedule([&] {
+            while (!released.load()) { std::this_thread::yield(); }
+        });
+        auto lowThread = std::thread::id{};
+        const auto low = jobSystem.schedule([&] { lowThread = std::this_thread::get_id(); }, JobPriority::LOW);
+        // Only queued once the worker is released, the waiting thread has nothing to do until then
+        const auto high = jobSystem.schedule([] {}, JobPriority::HIGH, { blocker });
+        auto releaser = std::jthread{[&] {
+            std::this_thread::sleep_for(std::chrono::milliseconds(50));
+            released.store(true);
+        }};
+        jobSystem.wait(high);
+        check(waitFor([&] { return low->isFinished(); }), "low priority job executed");
+        check(lowThread != mainThread, "low priority job not executed while waiting for a high priority job");
+    }
+
+    void waitRunsLowerPrioritiesWhenAllWorkersWait() {
+        auto jobSystem = JobSystem{1, 1};
+        auto lowExecuted = std::atomic<bool>{false};
+        // The only worker waits for a high priority job queued after a low priority one
+        const auto outer = jobSystem.schedule([&] {
+            const auto low = jobSystem.schedule([&] { lowExecuted.store(true); }, JobPriority::LOW);
+            const auto high = jobSystem.schedule([] {}, JobPriority::HIGH, { low });
+            jobSystem.wait(high);
+        }, JobPriority::HIGH);
+        // Not waited with wait() : the main thread must not execute the low priority job instead of the worker
+        check(waitFor([&] { return outer->isFinished(); }), "waiting worker not deadlocked");
+        check(lowExecuted.load(), "low priority dependency executed by the waiting worker");
+    }
+
+    void blockingJobsRunOnIoThreads() {
+        constexpr auto ioThreadsCount = 2u;
+        auto jobSystem = JobSystem{2, ioThreadsCount};
+        check(jobSystem.getIoThreadsCount() == ioThreadsCount, "I/O threads started");
+        const auto mainThread = std::this_thread::get_id();
+        auto threadsMutex = std::mutex{};
+        auto threads = std::set<std::thread::id>{};
+        auto onWorker = std::atomic<uint32>{0};
+        auto jobs = std::vector<JobHandle>{};
+        for (auto i = 0; i < 100; i++) {
+            jobs.push_back(jobSystem.schedule([&] {
+                onWorker += jobSystem.isWorkerThread();
+                auto lock = std::lock_guard{threadsMutex};
+                threads.insert(std::this_thread::get_id());
+            }, JobPriority::BLOCKING));
+        }
+        jobSystem.wait(jobs);
+        check(onWorker == 0, "not executed by the workers");
+        check(!threads.contains(mainThread), "not executed by the waiting thread");
+        check(threads.size() <= ioThreadsCount, "executed by the I/O threads");
+    }
+
+    void blockingJobsDontBlockWorkers() {
+        auto jobSystem = JobSystem{1, 1};
+        auto computed = std::atomic<bool>{false};
+        // Waits for a computing job, like a read waiting for a file
+        const auto io = jobSystem.schedule([&] {
+            while (!computed.load()) { std::this_thread::yield(); }
+        }, JobPriority::BLOCKING);
+        jobSystem.schedule([&] { computed.store(true); }, JobPriority::LOW);
+        check(waitFor([&] { return computed.load(); }), "computing job executed by the worker");
+        check(waitFor([&] { return io->isFinished(); }), "blocking job finished");
+    }
+
+    void blockingDependenciesRunOnWorkers() {
+        auto jobSystem = JobSystem{2, 1};
+        auto read = std::atomic<bool>{false};
+        auto onWorker = std::atomic<bool>{false};
+        const auto io = jobSystem.schedule([&] { read.store(true); }, JobPriority::BLOCKING);
+        const auto compute = jobSystem.schedule([&] {
+            onWorker.store(jobSystem.isWorkerThread());
+        }, JobPriority::NORMAL, { io });
+        check(waitFor([&] { return compute->isFinished(); }), "dependent job executed");
+        check(read.load() && onWorker.load(), "dependent job executed by a worker");
+    }
+
+    void stressNestedJobs() {
+        auto jobSystem = JobSystem{4, 2};
+        auto executed = std::atomic<uint32>{0};
+        constexpr auto producersCount = 4u;
+        constexpr auto jobsPerProducer = 2000u;
+        // Jobs scheduled from external threads, from the workers and from the I/O threads
+        auto producers = std::vector<std::jthread>{};
+        for (auto producer = 0u; producer < producersCount; producer++) {
+            producers.emplace_back([&, producer] {
+                auto random = std::mt19937{producer};
+                auto jobs = std::vector<JobHandle>{};
+                for (auto i = 0u; i < jobsPerProducer; i++) {
+                    const auto priority = static_cast<JobPriority>(random() % 4);
+                    const auto dependency = jobs.empty() ? JobHandle{} : jobs[random() % jobs.size()];
+                    jobs.push_back(jobSystem.schedule([&jobSystem, &executed] {
+                        const auto child = jobSystem.schedule([&executed] { executed++; }, JobPriority::HIGH);
+                        jobSystem.wait(child);
+                        executed++;
+                    }, priority, { dependency }));
+                }
+                jobSystem.wait(jobs);
+            });
+        }
+        producers.clear();
+        check(executed == producersCount * jobsPerProducer * 2, "all jobs executed once");
+    }
+
+    void stressParallelFor() {
+        auto jobSystem = JobSystem{4, 1};
+        auto sums = std::vector<uint64>(64);
+        jobSystem.parallelFor(static_cast<uint32>(sums.size()), 1, [&](const uint32 index) {
+            // Nested parallel loops executed by the workers
+            auto sum = std::atomic<uint64>{0};
+            jobSystem.parallelFor(1000, 16, [&](const uint32 value) { sum += value; }, JobPriority::NORMAL);
+            sums[index] = sum;
+        });
+        check(std::ranges::all_of(sums, [](const uint64 sum) { return sum == 999 * 1000 / 2; }), "all indices visited once");
+    }
+
+    void stopsWithQueuedJobs() {
+        auto executed = std::atomic<uint32>{0};
+        {
+            auto jobSystem = JobSystem{2, 1};
+            for (auto i = 0; i < 1000; i++) {
+                jobSystem.schedule([&executed] { executed++; }, static_cast<JobPriority>(i % 4));
+            }
+        }
+        const auto executedBeforeStop = executed.load();
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+        check(executed == executedBeforeStop, "no job executed once stopped");
+    }
+
+    void benchmarkScheduling() {
+        auto jobSystem = JobSystem{};
+        benchmark("schedule & wait 10000 jobs", 20, [&] {
+            auto jobs = std::vector<JobHandle>{};
+            jobs.reserve(10000);
+            for (auto i = 0; i < 10000; i++) {
+                jobs.push_back(jobSystem.schedule([] {}));
+            }
+            jobSystem.wait(jobs);
+        });
+    }
+
+}
+
+int main() {
+    return run({
+        { "executes dependencies first", executesDependenciesFirst },
+        { "wait skips lower priorities", waitSkipsLowerPriorities },
+        { "wait runs lower priorities when all workers wait", waitRunsLowerPrioritiesWhenAllWorkersWait },
+        { "blocking jobs run on I/O threads", blockingJobsRunOnIoThreads },
+        { "blocking jobs don't block workers", blockingJobsDontBlockWorkers },
+        { "blocking dependencies run on workers", blockingDependenciesRunOnWorkers },
+        { "stress nested jobs", stressNestedJobs },
+        { "stress parallel for", stressParallelFor },
+        { "stops with queued jobs", stopsWithQueuedJobs },
+        { "benchmark scheduling", benchmarkScheduling },
+    });
+}
@@ -0,0 +1,106 @@
+/*
+* Copyright (c) 2025-present Henri Michelon
+*
+* This software is released under the MIT License.
+* https://opensource.org/licenses/MIT
+*/
+import std;
+import lysa.constants;
+import lysa.math;
+import lysa.memory;
+import lysa.tests;
+import lysa.types;
+import lysa.resources.material;
+
+using namespace lysa;
+using namespace lysa::tests;
+
+namespace {
+
+    using Ranges = std::vector<std::pair<size_t, size_t>>;
+
+    // Start of the chunk containing a field of the material data
+    size_t chunkOf(const MaterialData& data, const void* field) {
+        const auto offset = static_cast<size_t>(static_cast<const std::byte*>(field) - reinterpret_cast<const std::byte*>(&data));
+        return offset / MATERIAL_DATA_CHUNK_SIZE * MATERIAL_DATA_CHUNK_SIZE;
+    }
+
+    Ranges modifiedRanges(const MaterialData& current, const MaterialData& previous) {
+        auto ranges = Ranges{};
+        forEachModifiedRange(&current, &previous, sizeof(MaterialData), MATERIAL_DATA_CHUNK_SIZE,
+            [&](const size_t offset, const size_t size) {
+                ranges.push_back({offset, size});
+            });
+        return ranges;
+    }
+
+    void writesOnlyTheModifiedChunks() {
+        const auto previous = MaterialData{};
+        check(modifiedRanges(previous, previous).empty(), "nothing written when nothing changed");
+
+        auto current = previous;
+        current.albedoColor.y = 1.0f;
+        check(modifiedRanges(current, previous) == Ranges{{0, 16}}, "one modified chunk");
+
+        // One byte modified inside a chunk
+        current = previous;
+        current.roughnessFactor = 0.5f;
+        check(modifiedRanges(current, previous) == Ranges{{chunkOf(current, &current.roughnessFactor), 16}},
+              "whole chunk of the modified field");
+
+        current = previous;
+        current.parameters[0].x = 1.0f;
+        current.parameters[1].x = 1.0f;
+        const auto parameters = chunkOf(current, &current.parameters[0]);
+        check(modifiedRanges(current, previous) == Ranges{{parameters, 32}}, "adjacent chunks merged");
+
+        current.albedoColor.x = 0.0f;
+        check(modifiedRanges(current, previous) == Ranges{{0, 16}, {parameters, 32}}, "separated chunks in two ranges");
+
+        current = previous;
+        current.parameters[SHADER_MATERIAL_MAX_PARAMETERS - 1].w = 1.0f;
+        check(modifiedRanges(current, previous) == Ranges{{sizeof(MaterialData) - 16, 16}}, "last chunk written");
+    }
+
+    void benchmarkAnimatedMaterials() {
+        // 1000 materials with three parameters animated each frame, like the setters of StandardMaterial
+        constexpr auto materialsCount = 1000u;
+        constexpr auto framesCount = 100u;
+        auto uploaded = std::vector<MaterialData>(materialsCount);
+        auto current = uploaded;
+        auto bytes = size_t{0};
+        auto ranges = size_t{0};
+        auto frame = 0u;
+        benchmark("diff 1000 animated materials", framesCount, [&] {
+            const auto time = static_cast<float>(frame++) * 0.016f;
+            for (auto i = 0u; i < materialsCount; i++) {
+                auto& data = current[i];
+                data.albedoColor = float4{0.5f + 0.5f * std::sin(time + i), 0.2f, 0.2f, 1.0f};
+                data.emissiveFactor.w = std::abs(std::cos(time * 2.0f + i));
+                data.parameters[0].x = time;
+                // Once per frame, the changed chunks only
+                forEachModifiedRange(&data, &uploaded[i], sizeof(MaterialData), MATERIAL_DATA_CHUNK_SIZE,
+                    [&](const size_t, const size_t size) {
+                        bytes += size;
+                        ranges += 1;
+                    });
+                uploaded[i] = data;
+            }
+        });
+        // Before : each of the three setters uploaded the whole block, with 4x4 texture transforms
+        constexpr auto blockSize = sizeof(MaterialData) + 5 * (sizeof(float4) * 4 - sizeof(TextureInfoData::transform));
+        const auto fullBytes = size_t{3} * blockSize * materialsCount * framesCount;
+        std::cout << "  " << bytes / framesCount << " bytes in " << ranges / framesCount
+                  << " copy regions uploaded per frame, " << fullBytes / framesCount
+                  << " bytes with one whole " << blockSize << " bytes block per setter call" << std::endl;
+        check(bytes * 10 < fullBytes, "at least 10x less bytes uploaded");
+    }
+
+}
+
+int main() {
+    return run({
+        { "writes only the modified chunks", writesOnlyTheModifiedChunks },
+        { "benchmark animated materials", benchmarkAnimatedMaterials },
+    });
+}
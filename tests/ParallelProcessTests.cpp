@@ -0,0 +1,200 @@
+/*
+* Copyright (c) 2025-present Henri Michelon
+*
+* This software is released under the MIT License.
+* https://opensource.org/licenses/MIT
+*/
+import std;
+import lysa.job_system;
+import lysa.math;
+import lysa.parallel_process;
+import lysa.tests;
+import lysa.types;
+import lysa.nodes.node;
+
+using namespace lysa;
+using namespace lysa::tests;
+
+namespace {
+
+    // Node executing an action in onProcess(), processed without a viewport
+    class ActionNode : public Node {
+    public:
+        std::function<void(ActionNode&)> action;
+        std::atomic<uint32> processCount{0};
+
+        explicit ActionNode(std::function<void(ActionNode&)> action = {}) : action{std::move(action)} {
+            setProcessMode(ProcessMode::ALWAYS);
+        }
+
+        void onProcess(const float) override {
+            processCount++;
+            if (action) { action(*this); }
+        }
+    };
+
+    std::vector<std::shared_ptr<ActionNode>> createNodes(const uint32 count, const std::function<void(ActionNode&)>& action = {}) {
+        auto nodes = std::vector<std::shared_ptr<ActionNode>>{};
+        for (auto i = 0u; i < count; i++) {
+            nodes.push_back(std::make_shared<ActionNode>(action));
+        }
+        return nodes;
+    }
+
+    void processCallback(Node* node) {
+        node->onProcess(0.0f);
+    }
+
+    void addsAndRemovesNodes() {
+        auto jobSystem = JobSystem{2, 1};
+        auto parallelProcess = ParallelProcess{jobSystem, 1};
+        const auto nodes = createNodes(4);
+        for (const auto& node : nodes) {
+            parallelProcess.add(node.get());
+        }
+        parallelProcess.add(nodes[0].get());
+        check(parallelProcess.getNodesCount() == 4, "added once");
+        parallelProcess.remove(nodes[1].get());
+        parallelProcess.remove(nodes[1].get());
+        parallelProcess.remove(nodes[3].get());
+        check(parallelProcess.getNodesCount() == 2, "removed once");
+        parallelProcess.process(processCallback);
+        check(nodes[0]->processCount == 1 && nodes[2]->processCount == 1, "remaining nodes processed");
+        check(nodes[1]->processCount == 0 && nodes[3]->processCount == 0, "removed nodes not processed");
+        parallelProcess.add(nodes[1].get());
+        parallelProcess.process(processCallback);
+        check(nodes[1]->processCount == 1 && nodes[0]->processCount == 2, "added again");
+    }
+
+    void processesEachNodeOnce() {
+        auto jobSystem = JobSystem{4, 1};
+        auto parallelProcess = ParallelProcess{jobSystem, 16};
+        const auto nodes = createNodes(1000);
+        // Paused without a viewport
+        nodes[10]->setProcessMode(ProcessMode::PAUSABLE);
+        for (const auto& node : nodes) {
+            parallelProcess.add(node.get());
+        }
+        auto wrongCurrentNode = std::atomic<uint32>{0};
+        parallelProcess.process([&](Node* node) {
+            wrongCurrentNode += ParallelProcess::getCurrentNode() != node;
+            node->onProcess(0.0f);
+        });
+        check(wrongCurrentNode == 0, "current node of the callbacks");
+        check(ParallelProcess::getCurrentNode() == nullptr, "no current node after the process");
+        check(nodes[10]->processCount == 0, "paused node not processed");
+        check(std::ranges::count_if(nodes, [](const auto& node) { return node->processCount == 1; }) == 999, "all processed once");
+    }
+
+    void defersTransformPropagation() {
+        auto jobSystem = JobSystem{2, 1};
+        auto parallelProcess = ParallelProcess{jobSystem, 1};
+        auto readChild = float3{-1.0f};
+        auto readParent = float3{-1.0f};
+        const auto parent = std::make_shared<ActionNode>([](ActionNode& node) { node.translate(float3{1.0f, 0.0f, 0.0f}); });
+        const auto child = std::make_shared<Node>();
+        child->setPosition(0.0f, 2.0f, 0.0f);
+        parent->addChild(child);
+        // Reads the transforms written by the other thread-safe node
+        const auto reader = std::make_shared<ActionNode>([&](ActionNode&) {
+            readParent = parent->getPositionGlobal();
+            readChild = child->getPositionGlobal();
+        });
+        parallelProcess.add(parent.get());
+        parallelProcess.add(reader.get());
+        parallelProcess.process(processCallback);
+        check(all(readParent == float3{0.0f}) && all(readChild == float3{0.0f, 2.0f, 0.0f}), "global transforms unchanged during the process");
+        check(all(parent->getPosition() == float3{1.0f, 0.0f, 0.0f}), "local transform changed");
+        check(all(parent->getPositionGlobal() == float3{1.0f, 0.0f, 0.0f}), "global transform propagated");
+        check(all(child->getPositionGlobal() == float3{1.0f, 2.0f, 0.0f}), "global transform of the child propagated");
+        // Outside the parallel process the propagation is immediate
+        parent->translate(float3{1.0f, 0.0f, 0.0f});
+        check(all(child->getPositionGlobal() == float3{2.0f, 2.0f, 0.0f}), "immediate propagation");
+    }
+
+    void composesNestedNodes() {
+        auto jobSystem = JobSystem{4, 1};
+        auto parallelProcess = ParallelProcess{jobSystem, 1};
+        const auto translate = [](ActionNode& node) { node.translate(float3{0.0f, 1.0f, 0.0f}); };
+        // Chain of thread-safe nodes added in the reverse order of the tree
+        const auto nodes = createNodes(8, translate);
+        for (auto i = 1u; i < nodes.size(); i++) {
+            nodes[i - 1]->addChild(nodes[i]);
+        }
+        for (auto i = nodes.size(); i > 0; i--) {
+            parallelProcess.add(nodes[i - 1].get());
+        }
+        parallelProcess.process(processCallback);
+        parallelProcess.process(processCallback);
+        auto composed = true;
+        for (auto i = 0u; i < nodes.size(); i++) {
+            composed &= all(nodes[i]->getPositionGlobal() == float3{0.0f, 2.0f * (i + 1), 0.0f});
+        }
+        check(composed, "global transforms of the parents and children composed");
+    }
+
+    void callsAfterTheNodes() {
+        auto jobSystem = JobSystem{4, 1};
+        auto parallelProcess = ParallelProcess{jobSystem, 4};
+        const auto mainThread = std::this_thread::get_id();
+        auto processed = std::atomic<uint32>{0};
+        auto processedBeforeCalls = std::vector<uint32>{};
+        auto onMainThread = true;
+        const auto nodes = createNodes(100, [&](ActionNode&) {
+            processed++;
+            parallelProcess.callAfter([&] {
+                processedBeforeCalls.push_back(processed);
+                onMainThread &= std::this_thread::get_id() == mainThread;
+            });
+        });
+        for (const auto& node : nodes) {
+            parallelProcess.add(node.get());
+        }
+        parallelProcess.process(processCallback);
+        check(processedBeforeCalls.size() == 100, "all calls executed");
+        check(std::ranges::all_of(processedBeforeCalls, [](const uint32 count) { return count == 100; }), "executed once all nodes processed");
+        check(onMainThread, "executed by the calling thread");
+    }
+
+    void benchmarkProcess() {
+        constexpr auto count = 10000u;
+        // Some work per node, like a simple AI or animation update
+        const auto work = [](ActionNode& node) {
+            auto value = node.getPosition().x;
+            for (auto i = 0; i < 200; i++) {
+                value = std::sin(value + 0.1f);
+            }
+            node.translate(float3{value * 1e-3f, 0.0f, 0.0f});
+        };
+        const auto root = std::make_shared<Node>();
+        root->setProcessMode(ProcessMode::ALWAYS);
+        const auto nodes = createNodes(count, work);
+        for (const auto& node : nodes) {
+            root->addChild(node);
+        }
+        // Without a viewport the tree traversal calls all the callbacks
+        benchmark("process 10000 nodes in the tree traversal", 20, [&] {
+            root->process(0.0f);
+        });
+        auto jobSystem = JobSystem{};
+        auto parallelProcess = ParallelProcess{jobSystem, 256};
+        for (const auto& node : nodes) {
+            parallelProcess.add(node.get());
+        }
+        benchmark("process 10000 thread-safe nodes in parallel", 20, [&] {
+            parallelProcess.process(processCallback);
+        });
+    }
+
+}
+
+int main() {
+    return run({
+        { "adds and removes nodes", addsAndRemovesNodes },
+        { "processes each node once", processesEachNodeOnce },
+        { "defers transform propagation", defersTransformPropagation },
+        { "composes nested nodes", composesNestedNodes },
+        { "calls after the nodes", callsAfterTheNodes },
+        { "benchmark process", benchmarkProcess },
+    });
+}
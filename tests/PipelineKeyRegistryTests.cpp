@@ -0,0 +1,97 @@
+/*
+* Copyright (c) 2025-present Henri Michelon
+*
+* This software is released under the MIT License.
+* https://opensource.org/licenses/MIT
+*/
+import std;
+import vireo;
+import lysa.enums;
+import lysa.exception;
+import lysa.tests;
+import lysa.types;
+import lysa.resources.material;
+
+using namespace lysa;
+using namespace lysa::tests;
+
+namespace {
+
+    constexpr Transparency TRANSPARENCIES[] = { Transparency::DISABLED, Transparency::ALPHA };
+    constexpr vireo::CullMode CULL_MODES[] = { vireo::CullMode::NONE, vireo::CullMode::BACK };
+
+    void identicalStatesHaveIdenticalIds() {
+        for (const auto transparency : TRANSPARENCIES) {
+            for (const auto cullMode : CULL_MODES) {
+                const auto key = StandardMaterial::createPipelineKey(transparency, cullMode);
+                check(key == StandardMaterial::createPipelineKey(transparency, cullMode), "same key for the same state");
+                check(PipelineKeyRegistry::getPipelineId(key) == PipelineKeyRegistry::getPipelineId(key),
+                      "same id for the same key");
+            }
+        }
+        const auto vert = std::string{"shaders/water.vert"};
+        const auto frag = std::string{"shaders/water.frag"};
+        check(PipelineKeyRegistry::getPipelineId(ShaderMaterial::createPipelineKey(vert, frag)) ==
+              PipelineKeyRegistry::getPipelineId(ShaderMaterial::createPipelineKey(vert, frag)),
+              "same id for the same shaders");
+    }
+
+    void differentStatesHaveDifferentIds() {
+        auto ids = std::set<pipeline_id>{};
+        auto count = size_t{0};
+        for (const auto transparency : TRANSPARENCIES) {
+            for (const auto cullMode : CULL_MODES) {
+                ids.insert(PipelineKeyRegistry::getPipelineId(StandardMaterial::createPipelineKey(transparency, cullMode)));
+                count++;
+            }
+        }
+        // The separator keeps the file names boundaries
+        const auto shaderKeys = {
+            ShaderMaterial::createPipelineKey("a", "bc"),
+            ShaderMaterial::createPipelineKey("ab", "c"),
+            ShaderMaterial::createPipelineKey("", "abc"),
+            ShaderMaterial::createPipelineKey("abc", ""),
+        };
+        for (const auto& key : shaderKeys) {
+            ids.insert(PipelineKeyRegistry::getPipelineId(key));
+            count++;
+        }
+        check(ids.size() == count, "one id per state");
+    }
+
+    void detectsCollisions() {
+        // Different keys with the same XXH32 hash
+        const auto first = std::string{"key-28590"};
+        const auto second = std::string{"key-206528"};
+        const auto id = PipelineKeyRegistry::getPipelineId(first);
+        auto collision = false;
+        try {
+            PipelineKeyRegistry::getPipelineId(second);
+        } catch (const Exception&) {
+            collision = true;
+        }
+        check(collision, "collision detected");
+        check(PipelineKeyRegistry::getPipelineId(first) == id, "first key still registered");
+    }
+
+    void benchmarkPipelineIds() {
+        // Worst case of a pipeline-affecting property change : the key is built and hashed again
+        benchmark("1000 standard pipeline ids", 1000, [] {
+            for (auto i = 0; i < 1000; i++) {
+                PipelineKeyRegistry::getPipelineId(StandardMaterial::createPipelineKey(
+                    TRANSPARENCIES[i % 2],
+                    CULL_MODES[(i / 2) % 2]));
+            }
+        });
+    }
+
+}
+
+int main() {
+    return run({
+        { "identical states have identical ids", identicalStatesHaveIdenticalIds },
+        { "different states have different ids", differentStatesHaveDifferentIds },
+        { "detects collisions", detectsCollisions },
+        { "benchmark pipeline ids", benchmarkPipelineIds },
+    });
+}
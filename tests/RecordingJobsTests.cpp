@@ -0,0 +1,160 @@
+/*
+* Copyright (c) 2025-present Henri Michelon
+*
+* This software is released under the MIT License.
+* https://opensource.org/licenses/MIT
+*/
+import std;
+import lysa.job_system;
+import lysa.tests;
+import lysa.types;
+import lysa.renderers.recording_jobs;
+
+using namespace lysa;
+using namespace lysa::tests;
+
+namespace {
+
+    // Shadow casting light : the draws of one shadow map
+    struct Light {
+        uint32 id;
+        uint32 drawsCount;
+    };
+
+    // Encodes the commands in memory instead of sending them to a device
+    struct StubCommandList {
+        std::vector<uint32> commands;
+        std::vector<uint32> recordedLights;
+        std::thread::id thread;
+
+        void begin() {
+            commands.clear();
+            recordedLights.clear();
+            thread = std::this_thread::get_id();
+        }
+
+        void draw(const uint32 light, const uint32 index) {
+            // Some encoding work per command, like a command buffer packet
+            auto word = light * 2654435761u ^ index;
+            for (auto i = 0; i < 8; i++) {
+                word = (word ^ (word >> 15)) * 2246822519u;
+                commands.push_back(word);
+            }
+        }
+
+        void record(const Light& light) {
+            recordedLights.push_back(light.id);
+            for (auto index = 0u; index < light.drawsCount; index++) {
+                draw(light.id, index);
+            }
+        }
+    };
+
+    std::vector<Light> createLights(const uint32 count, const uint32 drawsCount) {
+        auto lights = std::vector<Light>{};
+        for (auto i = 0u; i < count; i++) {
+            lights.push_back({i, drawsCount});
+        }
+        return lights;
+    }
+
+    // Records the lights with one job per command list, like Renderer::beginShadowMaps()
+    uint32 recordLights(
+        JobSystem& jobSystem,
+        RecordingJobs<Light>& recordingJobs,
+        std::vector<StubCommandList>& commandLists,
+        std::vector<Light> lights) {
+        recordingJobs.start(
+            jobSystem,
+            std::move(lights),
+            static_cast<uint32>(commandLists.size()),
+            [&commandLists](const uint32 jobIndex, const std::span<const Light> passes) {
+                auto& commandList = commandLists[jobIndex];
+                commandList.begin();
+                for (const auto& light : passes) {
+                    commandList.record(light);
+                }
+            });
+        return recordingJobs.finish(jobSystem);
+    }
+
+    void keepsTheLightsOrder() {
+        auto jobSystem = JobSystem{4, 1};
+        auto recordingJobs = RecordingJobs<Light>{};
+        auto commandLists = std::vector<StubCommandList>(6);
+        const auto jobsCount = recordLights(jobSystem, recordingJobs, commandLists, createLights(20, 10));
+        check(jobsCount == 6, "one job per command list");
+        // Submitted in the jobs order
+        auto submitted = std::vector<uint32>{};
+        for (auto i = 0u; i < jobsCount; i++) {
+            submitted.insert(submitted.end(), commandLists[i].recordedLights.begin(), commandLists[i].recordedLights.end());
+        }
+        check(submitted.size() == 20 && std::ranges::is_sorted(submitted) &&
+              std::ranges::adjacent_find(submitted) == submitted.end(), "each light recorded once, in order");
+        check(std::ranges::all_of(commandLists, [](const auto& commandList) {
+            return commandList.recordedLights.size() <= 4 && !commandList.recordedLights.empty();
+        }), "lights spread over the jobs");
+    }
+
+    void fewerLightsThanCommandLists() {
+        auto jobSystem = JobSystem{4, 1};
+        auto recordingJobs = RecordingJobs<Light>{};
+        auto commandLists = std::vector<StubCommandList>(8);
+        check(recordLights(jobSystem, recordingJobs, commandLists, createLights(3, 10)) == 3, "one job per light");
+        check(recordLights(jobSystem, recordingJobs, commandLists, {}) == 0, "no job without lights");
+    }
+
+    void rethrowsJobsExceptions() {
+        auto jobSystem = JobSystem{2, 1};
+        auto recordingJobs = RecordingJobs<Light>{};
+        auto recorded = std::atomic<uint32>{0};
+        recordingJobs.start(jobSystem, createLights(4, 10), 4, [&](const uint32 jobIndex, const std::span<const Light>) {
+            if (jobIndex == 2) { throw std::runtime_error("recording failed"); }
+            recorded++;
+        });
+        auto thrown = false;
+        try {
+            recordingJobs.finish(jobSystem);
+        } catch (const std::runtime_error&) {
+            thrown = true;
+        }
+        check(thrown, "exception rethrown by finish()");
+        check(recorded == 3, "other jobs executed");
+        auto commandLists = std::vector<StubCommandList>(2);
+        check(recordLights(jobSystem, recordingJobs, commandLists, createLights(4, 10)) == 2, "restarted after an exception");
+    }
+
+    void benchmarkRecording() {
+        // 20 shadow casting lights with 2000 draws each, recorded like the shadow map passes
+        constexpr auto lightsCount = 20u;
+        const auto lights = createLights(lightsCount, 2000);
+        auto jobSystem = JobSystem{};
+        const auto threadsCount = jobSystem.getThreadsCount() + 1;
+        auto recordingJobs = RecordingJobs<Light>{};
+        for (const auto jobsCount : std::set{1u, 4u, threadsCount}) {
+            auto commandLists = std::vector<StubCommandList>(jobsCount);
+            for (auto& commandList : commandLists) {
+                commandList.commands.reserve(lightsCount * 2000 * 8);
+            }
+            const auto name = std::format("record {} lights with {} jobs", lightsCount, jobsCount);
+            benchmark(name, 50, [&] {
+                recordLights(jobSystem, recordingJobs, commandLists, lights);
+            });
+            auto threads = std::set<std::thread::id>{};
+            for (const auto& commandList : commandLists) {
+                threads.insert(commandList.thread);
+            }
+            std::cout << "  " << jobsCount << " jobs recorded by " << threads.size() << " threads" << std::endl;
+        }
+    }
+
+}
+
+int main() {
+    return run({
+        { "keeps the lights order", keepsTheLightsOrder },
+        { "fewer lights than command lists", fewerLightsThanCommandLists },
+        { "rethrows jobs exceptions", rethrowsJobsExceptions },
+        { "benchmark recording", benchmarkRecording },
+    });
+}
@@ -0,0 +1,158 @@
+/*
+* Copyright (c) 2025-present Henri Michelon
+*
+* This software is released under the MIT License.
+* https://opensource.org/licenses/MIT
+*/
+import std;
+import vireo;
+import lysa.exception;
+import lysa.tests;
+import lysa.types;
+import lysa.samplers;
+
+using namespace lysa;
+using namespace lysa::tests;
+
+namespace {
+
+    // Stands for the GPU samplers, only their lifetime is tested
+    struct Sampler {
+        uint32 id;
+    };
+
+    constexpr auto RING_SIZE = 3u;
+
+    SamplerInfo samplerInfo(const float maxLod) {
+        return {
+            vireo::Filter::LINEAR, vireo::Filter::LINEAR,
+            vireo::AddressMode::REPEAT, vireo::AddressMode::REPEAT,
+            0.0f, maxLod,
+            true,
+            vireo::MipMapMode::LINEAR,
+            vireo::CompareOp::NEVER};
+    }
+
+    struct Factory {
+        uint32 created{0};
+        std::shared_ptr<Sampler> last;
+
+        uint32 add(SamplersTable<Sampler>& table, const SamplerInfo& info) {
+            return table.add(info, [this] {
+                last = std::make_shared<Sampler>(created++);
+                return last;
+            });
+        }
+    };
+
+    void deduplicatesSamplers() {
+        auto table = SamplersTable<Sampler>{4, RING_SIZE};
+        auto factory = Factory{};
+        const auto a = factory.add(table, samplerInfo(1.0f));
+        const auto b = factory.add(table, samplerInfo(2.0f));
+        check(a != b, "different samplers in different slots");
+        check(factory.add(table, samplerInfo(1.0f)) == a, "same description, same slot");
+        check(factory.created == 2, "existing sampler not created again");
+        check(table.getReferences(a) == 2 && table.getReferences(b) == 1, "references counted");
+        check(table.isUpdated(), "descriptors to update");
+        table.next();
+        check(!table.isUpdated(), "descriptors updated");
+        factory.add(table, samplerInfo(2.0f));
+        check(!table.isUpdated(), "no descriptors update for an existing sampler");
+    }
+
+    void reusesReleasedSlots() {
+        auto table = SamplersTable<Sampler>{2, RING_SIZE};
+        auto factory = Factory{};
+        const auto a = factory.add(table, samplerInfo(1.0f));
+        factory.add(table, samplerInfo(1.0f));
+        factory.add(table, samplerInfo(2.0f));
+        check(!table.release(a), "slot still referenced");
+        check(table.release(a), "slot freed with the last reference");
+        check(factory.add(table, samplerInfo(3.0f)) == a, "free slot reused");
+        check(table.getSamplers()[a]->id == 2, "new sampler in the reused slot");
+        auto full = false;
+        try {
+            factory.add(table, samplerInfo(1.0f));
+        } catch (const Exception&) {
+            full = true;
+        }
+        check(full, "released sampler created again in a full table");
+    }
+
+    void keepsReleasedSamplersAlive() {
+        auto table = SamplersTable<Sampler>{2, RING_SIZE};
+        auto factory = Factory{};
+        const auto index = factory.add(table, samplerInfo(1.0f));
+        const auto released = std::weak_ptr{factory.last};
+        factory.last.reset();
+        // Written in the set used by the next frames
+        const auto set = table.next();
+        check(table.getSetSamplers(set)[index] == released.lock(), "sampler referenced by the set");
+
+        table.release(index);
+        check(factory.add(table, samplerInfo(2.0f)) == index, "released slot reused");
+        factory.last.reset();
+        check(!released.expired(), "released sampler alive while its set is in use");
+        for (auto i = 0u; i < RING_SIZE - 1; i++) {
+            table.next();
+            check(!released.expired(), "released sampler alive until its set is recycled");
+        }
+        check(table.next() == set, "set recycled");
+        check(released.expired(), "released sampler destroyed with the recycled set");
+        check(table.getSetSamplers(set)[index]->id == 1, "new sampler referenced by the recycled set");
+    }
+
+    void fillsEmptySlots() {
+        auto table = SamplersTable<Sampler>{4, RING_SIZE};
+        auto factory = Factory{};
+        const auto index = factory.add(table, samplerInfo(1.0f));
+        table.fillEmptySlots(table.getSamplers()[index]);
+        check(std::ranges::all_of(table.getSamplers(), [](const auto& sampler) { return sampler != nullptr; }),
+              "no null slot");
+        check(factory.add(table, samplerInfo(2.0f)) == index + 1, "filled slots still free");
+    }
+
+    void randomReferencesStayConsistent() {
+        auto table = SamplersTable<Sampler>{8, RING_SIZE};
+        auto factory = Factory{};
+        auto random = std::mt19937{42};
+        // Number of references per description
+        auto references = std::map<uint32, uint32>{};
+        auto indices = std::map<uint32, uint32>{};
+        for (auto step = 0; step < 10000; step++) {
+            const auto description = static_cast<uint32>(random() % 12);
+            if (references[description] > 0 && random() % 2 == 0) {
+                table.release(indices[description]);
+                references[description]--;
+            } else if (references[description] > 0 || indices.size() < 8) {
+                const auto index = factory.add(table, samplerInfo(static_cast<float>(description)));
+                if (references[description] > 0) {
+                    check(indices[description] == index, "existing sampler found");
+                }
+                indices[description] = index;
+                references[description]++;
+            }
+            if (references[description] == 0) {
+                indices.erase(description);
+            }
+            if (random() % 10 == 0) {
+                table.next();
+            }
+            for (const auto& [described, index] : indices) {
+                check(table.getReferences(index) == references[described], "references of the slot");
+            }
+        }
+    }
+
+}
+
+int main() {
+    return run({
+        { "deduplicates samplers", deduplicatesSamplers },
+        { "reuses released slots", reusesReleasedSlots },
+        { "keeps released samplers alive", keepsReleasedSamplersAlive },
+        { "fills empty slots", fillsEmptySlots },
+        { "random references stay consistent", randomReferencesStayConsistent },
+    });
+}
@@ -0,0 +1,159 @@
+/*
+* Copyright (c) 2025-present Henri Michelon
+*
+* This software is released under the MIT License.
+* https://opensource.org/licenses/MIT
+*/
+import std;
+import lysa.tests;
+import lysa.types;
+import lysa.shader_module_cache;
+
+using namespace lysa;
+using namespace lysa::tests;
+
+namespace {
+
+    // Stand-in of the device shader modules
+    struct FakeModule {
+        std::string shaderName;
+        uint32      version;
+    };
+
+    using WriteTime = ShaderModuleCache<FakeModule>::WriteTime;
+
+    // Mock shader module factory driven by the write times of the compiled shaders files
+    struct FakeFactory {
+        std::map<std::string, WriteTime> writeTimes;
+        std::map<std::string, uint32> versions;
+        std::set<std::string> brokenShaders;
+        ShaderModuleCache<FakeModule> cache{
+            [this](const std::string& shaderName) -> std::optional<WriteTime> {
+                if (const auto it = writeTimes.find(shaderName); it != writeTimes.end()) {
+                    return it->second;
+                }
+                return std::nullopt;
+            },
+            [this](const std::string& shaderName) {
+                if (brokenShaders.contains(shaderName)) {
+                    throw std::runtime_error("Syntax error in " + shaderName);
+                }
+                return std::make_shared<FakeModule>(shaderName, ++versions[shaderName]);
+            }
+        };
+
+        void write(const std::string& shaderName) {
+            writeTimes[shaderName] += std::chrono::seconds{1};
+        }
+    };
+
+    // Render pass stand-in with one pipeline made of a vertex & a fragment shader, like Renderpass
+    struct FakePass {
+        std::string name;
+        std::string vertexShader;
+        std::string fragmentShader;
+        FakeFactory& factory;
+        ShaderDependencies dependencies;
+        std::pair<std::shared_ptr<FakeModule>, std::shared_ptr<FakeModule>> pipeline;
+
+        FakePass(const std::string& name, const std::string& vertexShader, const std::string& fragmentShader, FakeFactory& factory) :
+            name{name}, vertexShader{vertexShader}, fragmentShader{fragmentShader}, factory{factory} {
+            createPipeline();
+        }
+
+        std::shared_ptr<FakeModule> loadShader(const std::string& shaderName) {
+            dependencies.add(shaderName);
+            return factory.cache.get(shaderName);
+        }
+
+        void createPipeline() {
+            pipeline = { loadShader(vertexShader), loadShader(fragmentShader) };
+        }
+
+        bool reloadPipelines() {
+            return reloadOrKeep(name, pipeline, [&] { createPipeline(); });
+        }
+    };
+
+    // Frame boundary of Application::reloadShaders() : reloads the passes using the modified shaders
+    std::set<std::string> reloadShaders(FakeFactory& factory, std::vector<FakePass*> passes, std::vector<std::string>& reloadedPasses) {
+        const auto shaderNames = factory.cache.getModifiedShaders();
+        auto reloadedShaders = std::set<std::string>{};
+        for (auto* pass : passes) {
+            if (pass->dependencies.isUsing(shaderNames, reloadedShaders)) {
+                pass->reloadPipelines();
+                reloadedPasses.push_back(pass->name);
+            }
+        }
+        // Modified shaders without a reloadable owner
+        auto notReloaded = std::set<std::string>{};
+        std::ranges::set_difference(shaderNames, reloadedShaders, std::inserter(notReloaded, notReloaded.end()));
+        return notReloaded;
+    }
+
+    void reloadsOnlyTheDependentPasses() {
+        auto factory = FakeFactory{};
+        for (const auto* shaderName : { "quad.vert", "lighting.frag", "ssao.frag", "smaa_blend.frag", "frustum_culling.comp" }) {
+            factory.write(shaderName);
+        }
+        auto lighting = FakePass{"Lighting", "quad.vert", "lighting.frag", factory};
+        auto ssao = FakePass{"SSAO", "quad.vert", "ssao.frag", factory};
+        auto smaa = FakePass{"SMAA", "quad.vert", "smaa_blend.frag", factory};
+        const auto passes = std::vector{ &lighting, &ssao, &smaa };
+        // Compute pipeline loading its shader without dependencies tracking
+        factory.cache.get("frustum_culling.comp");
+
+        auto reloaded = std::vector<std::string>{};
+        check(reloadShaders(factory, passes, reloaded).empty() && reloaded.empty(), "nothing reloaded without modifications");
+
+        factory.write("ssao.frag");
+        check(reloadShaders(factory, passes, reloaded).empty(), "modified shader reloaded");
+        check(reloaded == std::vector<std::string>{"SSAO"}, "only the pass using the modified shader");
+        check(ssao.pipeline.second->version == 2 && lighting.pipeline.second->version == 1, "new module in the reloaded pipeline");
+
+        reloaded.clear();
+        factory.write("quad.vert");
+        reloadShaders(factory, passes, reloaded);
+        check(reloaded == std::vector<std::string>{"Lighting", "SSAO", "SMAA"}, "all the passes sharing the modified shader");
+        check(lighting.pipeline.first == smaa.pipeline.first && lighting.pipeline.first->version == 2,
+              "modified shader loaded once for all the passes");
+
+        reloaded.clear();
+        factory.write("frustum_culling.comp");
+        factory.write("unknown.frag");
+        check(reloadShaders(factory, passes, reloaded) == std::set<std::string>{"frustum_culling.comp"},
+              "modified shader without reloadable owner reported");
+        check(reloaded.empty(), "no pass reloaded for the shaders they don't use");
+    }
+
+    void keepsThePreviousPipelinesOnFailure() {
+        auto factory = FakeFactory{};
+        factory.write("quad.vert");
+        factory.write("lighting.frag");
+        auto lighting = FakePass{"Lighting", "quad.vert", "lighting.frag", factory};
+        const auto previous = lighting.pipeline;
+
+        // Shader saved with an error
+        factory.write("lighting.frag");
+        factory.brokenShaders.insert("lighting.frag");
+        auto reloaded = std::vector<std::string>{};
+        reloadShaders(factory, { &lighting }, reloaded);
+        check(reloaded.size() == 1 && lighting.pipeline == previous, "previous pipeline kept");
+        check(!lighting.reloadPipelines(), "failure reported");
+
+        // Error fixed
+        factory.brokenShaders.clear();
+        factory.write("lighting.frag");
+        reloadShaders(factory, { &lighting }, reloaded);
+        check(lighting.pipeline.second != previous.second && lighting.pipeline.first == previous.first,
+              "pipeline recreated once the shader is fixed");
+    }
+
+}
+
+int main() {
+    return run({
+        { "reloads only the dependent passes", reloadsOnlyTheDependentPasses },
+        { "keeps the previous pipelines on failure", keepsThePreviousPipelinesOnFailure },
+    });
+}
@@ -0,0 +1,137 @@
+/*
+* Copyright (c) 2025-present Henri Michelon
+*
+* This software is released under the MIT License.
+* https://opensource.org/licenses/MIT
+*/
+import std;
+import lysa.tests;
+import lysa.types;
+import lysa.shader_module_cache;
+
+using namespace lysa;
+using namespace lysa::tests;
+
+namespace {
+
+    // Stand-in of the device shader modules
+    struct FakeModule {
+        std::string shaderName;
+        uint32      version;
+    };
+
+    using WriteTime = ShaderModuleCache<FakeModule>::WriteTime;
+
+    // Compiled shader files stand-in : write times of the files, and modules creations counters
+    struct FakeFiles {
+        std::map<std::string, WriteTime> writeTimes;
+        std::map<std::string, uint32> loadsCount;
+        std::set<std::string> brokenShaders;
+
+        void write(const std::string& shaderName) {
+            auto& writeTime = writeTimes[shaderName];
+            writeTime += std::chrono::seconds{1};
+        }
+
+        ShaderModuleCache<FakeModule> createCache() {
+            return {
+                [this](const std::string& shaderName) -> std::optional<WriteTime> {
+                    if (const auto it = writeTimes.find(shaderName); it != writeTimes.end()) {
+                        return it->second;
+                    }
+                    return std::nullopt;
+                },
+                [this](const std::string& shaderName) {
+                    if (!writeTimes.contains(shaderName) || brokenShaders.contains(shaderName)) {
+                        throw std::runtime_error("Can't load " + shaderName);
+                    }
+                    return std::make_shared<FakeModule>(shaderName, ++loadsCount[shaderName]);
+                }
+            };
+        }
+    };
+
+    void returnsTheCachedModules() {
+        auto files = FakeFiles{};
+        files.write("forward.vert");
+        files.write("forward.frag");
+        auto cache = files.createCache();
+        const auto vertex = cache.get("forward.vert");
+        check(vertex->shaderName == "forward.vert", "module loaded");
+        for (auto i = 0; i < 10; i++) {
+            check(cache.get("forward.vert") == vertex, "same module while the file is unchanged");
+        }
+        cache.get("forward.frag");
+        check(files.loadsCount["forward.vert"] == 1 && files.loadsCount["forward.frag"] == 1, "one load per shader");
+        cache.clear();
+        check(cache.get("forward.vert") != vertex && files.loadsCount["forward.vert"] == 2, "reloaded after a clear");
+    }
+
+    void reloadsTheModifiedFiles() {
+        auto files = FakeFiles{};
+        files.write("lighting.frag");
+        auto cache = files.createCache();
+        const auto previous = cache.get("lighting.frag");
+        files.write("lighting.frag");
+        const auto current = cache.get("lighting.frag");
+        check(current != previous && current->version == 2, "new module for the modified file");
+        check(cache.get("lighting.frag") == current, "new module cached");
+
+        // File removed or being written : the cached module is kept
+        files.writeTimes.erase("lighting.frag");
+        check(cache.get("lighting.frag") == current, "cached module while the file can't be checked");
+
+        auto thrown = false;
+        try {
+            cache.get("missing.frag");
+        } catch (const std::exception&) {
+            thrown = true;
+        }
+        check(thrown, "missing shader not cached");
+
+        // Failed load : the previous module stays in the cache
+        files.write("lighting.frag");
+        files.brokenShaders.insert("lighting.frag");
+        thrown = false;
+        try {
+            cache.get("lighting.frag");
+        } catch (const std::exception&) {
+            thrown = true;
+        }
+        files.brokenShaders.clear();
+        check(thrown, "load failure reported");
+        check(cache.get("lighting.frag")->version == 3, "loaded once fixed");
+    }
+
+    void reportsEachModificationOnce() {
+        auto files = FakeFiles{};
+        files.write("smaa_edge_detect.frag");
+        files.write("ssao.frag");
+        files.write("not_loaded.frag");
+        auto cache = files.createCache();
+        cache.get("smaa_edge_detect.frag");
+        cache.get("ssao.frag");
+        check(cache.getModifiedShaders().empty(), "nothing modified since the load");
+
+        files.write("ssao.frag");
+        files.write("not_loaded.frag");
+        check(cache.getModifiedShaders() == std::set<std::string>{"ssao.frag"}, "only the modified cached shaders");
+        check(cache.getModifiedShaders().empty(), "modification reported once");
+
+        // Reported once even if the module fails to load
+        files.write("ssao.frag");
+        files.brokenShaders.insert("ssao.frag");
+        check(cache.getModifiedShaders() == std::set<std::string>{"ssao.frag"}, "broken shader reported");
+        check(cache.getModifiedShaders().empty(), "broken shader reported once");
+        check(files.loadsCount["ssao.frag"] == 1, "the watcher does not load the modules");
+    }
+
+}
+
+int main() {
+    return run({
+        { "returns the cached modules", returnsTheCachedModules },
+        { "reloads the modified files", reloadsTheModifiedFiles },
+        { "reports each modification once", reportsEachModificationOnce },
+    });
+}
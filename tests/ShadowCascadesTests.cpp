@@ -0,0 +1,176 @@
+/*
+* Copyright (c) 2025-present Henri Michelon
+*
+* This software is released under the MIT License.
+* https://opensource.org/licenses/MIT
+*/
+import std;
+import lysa.math;
+import lysa.tests;
+import lysa.types;
+import lysa.renderers.shadow_cascades;
+
+using namespace lysa;
+using namespace lysa::tests;
+
+namespace {
+
+    constexpr auto NEAR = 0.1f;
+    constexpr auto FAR = 100.0f;
+    constexpr auto LAMBDA = 0.95f;
+    const auto LIGHT_DIRECTION = normalize(float3{0.3f, -1.0f, 0.2f});
+    const auto SHADOW_MAP_SIZES = std::vector<uint32>{2048, 2048, 1024, 1024};
+
+    float4x4 cameraProjection() {
+        return perspective(radians(75.0f), 16.0f / 9.0f, NEAR, FAR);
+    }
+
+    // Non-linear depth of a point in front of the camera
+    float toDepth(const float distance) {
+        const auto clip = mul(float4{0.0f, 0.0f, -distance, 1.0f}, cameraProjection());
+        return clip.z / clip.w;
+    }
+
+    std::vector<ShadowCascade> fit(const float3& cameraPosition, const std::optional<float2>& depthBounds) {
+        auto cascades = std::vector<ShadowCascade>{};
+        fitShadowCascades(
+            float4x4::translation(cameraPosition),
+            cameraProjection(),
+            NEAR, FAR,
+            LIGHT_DIRECTION,
+            LAMBDA,
+            depthBounds,
+            SHADOW_MAP_SIZES,
+            cascades);
+        return cascades;
+    }
+
+    bool equals(const float4x4& a, const float4x4& b) {
+        for (auto row = 0; row < 4; row++) {
+            if (any(a[row] != b[row])) { return false; }
+        }
+        return true;
+    }
+
+    bool equals(const std::vector<ShadowCascade>& a, const std::vector<ShadowCascade>& b) {
+        return std::ranges::equal(a, b, [](const ShadowCascade& l, const ShadowCascade& r) {
+            return equals(l.viewMatrix, r.viewMatrix) && equals(l.projection, r.projection) && l.splitDepth == r.splitDepth;
+        });
+    }
+
+    // Position of a world point in the shadow map of a cascade, in texels
+    float2 toTexels(const ShadowCascade& cascade, const float3& point, const uint32 size) {
+        const auto clip = mul(float4{point, 1.0f}, mul(cascade.viewMatrix, cascade.projection));
+        return (clip.xy / clip.w * 0.5f + 0.5f) * static_cast<float>(size);
+    }
+
+    void splitsTheClipRange() {
+        const auto cascades = fit(float3{0.0f}, std::nullopt);
+        check(cascades.size() == SHADOW_MAP_SIZES.size(), "one cascade per shadow map");
+        auto increasing = true;
+        for (auto i = 1u; i < cascades.size(); i++) {
+            increasing &= cascades[i].splitDepth > cascades[i - 1].splitDepth;
+        }
+        check(increasing && cascades[0].splitDepth > NEAR, "increasing splits");
+        check(std::abs(cascades.back().splitDepth - FAR) < 1e-3f, "last cascade ends at the far plane");
+    }
+
+    void fitsTheVisibleRange() {
+        const auto cascades = fit(float3{0.0f}, float2{toDepth(2.0f), toDepth(20.0f)});
+        const auto quantum = (FAR - NEAR) / 64.0f;
+        check(cascades.back().splitDepth >= 20.0f - 1e-3f, "visible range covered");
+        check(cascades.back().splitDepth <= 20.0f + quantum + 1e-3f, "cascades end at the quantized visible range");
+        // The range of a reversed depth buffer gives the same cascades
+        check(equals(cascades, fit(float3{0.0f}, float2{toDepth(20.0f), toDepth(2.0f)})), "same cascades with a reversed depth range");
+    }
+
+    void ignoresDepthBoundsJitter() {
+        const auto quantum = (FAR - NEAR) / 64.0f;
+        // Visible range inside a quantum on both sides
+        const auto minDistance = 3.0f * quantum + 0.1f * quantum;
+        const auto maxDistance = 20.0f * quantum + 0.1f * quantum;
+        const auto reference = fit(float3{0.0f}, float2{toDepth(minDistance), toDepth(maxDistance)});
+        auto random = std::mt19937{42};
+        auto jitter = std::uniform_real_distribution{0.0f, 0.8f * quantum};
+        auto changes = 0;
+        for (auto frame = 0; frame < 1000; frame++) {
+            const auto bounds = float2{toDepth(minDistance + jitter(random)), toDepth(maxDistance + jitter(random))};
+            changes += !equals(reference, fit(float3{0.0f}, bounds));
+        }
+        check(changes == 0, "cascades unchanged while the visible range stays in the same quanta");
+    }
+
+    void stableUnderCameraMotion() {
+        // World points seen by the cascades
+        const auto points = std::vector<float3>{ {0.5f, 0.0f, -1.0f}, {3.7f, 1.2f, -6.3f}, {-2.1f, 0.4f, -3.9f} };
+        const auto bounds = float2{toDepth(1.0f), toDepth(30.0f)};
+        auto reference = std::vector<std::vector<float2>>{};
+        auto previousProjections = std::vector<float4x4>{};
+        auto shimmering = 0;
+        auto scaleChanges = 0;
+        // The camera slides forward and sideways by a fraction of a texel per frame
+        for (auto frame = 0; frame < 500; frame++) {
+            const auto cameraPosition = float3{frame * 0.0013f, 0.0f, -frame * 0.0021f};
+            const auto cascades = fit(cameraPosition, bounds);
+            for (auto i = 0u; i < cascades.size(); i++) {
+                // Same scale : the radius of the cascades does not depend on the camera position
+                if (frame > 0 && (cascades[i].projection[0].x != previousProjections[i][0].x ||
+                                  cascades[i].projection[1].y != previousProjections[i][1].y)) {
+                    scaleChanges++;
+                }
+            }
+            previousProjections.clear();
+            for (const auto& cascade : cascades) {
+                previousProjections.push_back(cascade.projection);
+            }
+            // The texel grid moves by whole texels : a fixed point stays at the same place inside its texel
+            auto fractions = std::vector<float2>{};
+            for (auto i = 0u; i < cascades.size(); i++) {
+                for (const auto& point : points) {
+                    const auto texels = toTexels(cascades[i], point, SHADOW_MAP_SIZES[i]);
+                    fractions.push_back(texels - floor(texels));
+                }
+            }
+            if (reference.empty()) {
+                reference.push_back(fractions);
+                continue;
+            }
+            for (auto i = 0u; i < fractions.size(); i++) {
+                // Distance on the unit torus, a fraction of 0.999 is close to 0.001
+                const auto delta = abs(fractions[i] - reference[0][i]);
+                const auto distance = min(delta, 1.0f - delta);
+                shimmering += distance.x > 0.01f || distance.y > 0.01f;
+            }
+        }
+        check(scaleChanges == 0, "cascades scale unchanged");
+        check(shimmering == 0, "fixed points stay at the same sub-texel position");
+    }
+
+    void benchmarkFit() {
+        auto cascades = std::vector<ShadowCascade>{};
+        auto frame = 0;
+        const auto bounds = float2{toDepth(1.0f), toDepth(30.0f)};
+        benchmark("fit 4 cascades", 10000, [&] {
+            fitShadowCascades(
+                float4x4::translation(float3{frame++ * 0.01f, 0.0f, 0.0f}),
+                cameraProjection(),
+                NEAR, FAR,
+                LIGHT_DIRECTION,
+                LAMBDA,
+                bounds,
+                SHADOW_MAP_SIZES,
+                cascades);
+        });
+    }
+
+}
+
+int main() {
+    return run({
+        { "splits the clip range", splitsTheClipRange },
+        { "fits the visible range", fitsTheVisibleRange },
+        { "ignores depth bounds jitter", ignoresDepthBoundsJitter },
+        { "stable under camera motion", stableUnderCameraMotion },
+        { "benchmark fit", benchmarkFit },
+    });
+}
@@ -0,0 +1,127 @@
+/*
+* Copyright (c) 2025-present Henri Michelon
+*
+* This software is released under the MIT License.
+* https://opensource.org/licenses/MIT
+*/
+import std;
+import lysa.tests;
+import lysa.types;
+import lysa.renderers.shadow_map_budget;
+
+using namespace lysa;
+using namespace lysa::tests;
+
+namespace {
+
+    bool overlap(const ShadowMapBudget::Tile& a, const ShadowMapBudget::Tile& b) {
+        return a.x < b.x + b.size && b.x < a.x + a.size &&
+               a.y < b.y + b.size && b.y < a.y + a.size;
+    }
+
+    void roundsUpSizes() {
+        auto budget = ShadowMapBudget{1000, 100};
+        check(budget.getSize() == 1024, "budget size rounded up");
+        check(budget.getMinTileSize() == 128, "min tile size rounded up");
+        check(budget.allocate(300).size == 512, "tile size rounded up");
+        check(budget.allocate(1).size == 128, "tile size clamped to the min tile size");
+        budget.clear();
+        check(budget.allocate(4096).size == 1024, "tile size clamped to the budget size");
+        check(budget.getUsedTexels() == 1024 * 1024, "used texels of the whole budget");
+    }
+
+    void failsWhenFull() {
+        auto budget = ShadowMapBudget{1024, 128};
+        for (auto i = 0; i < 4; i++) {
+            check(budget.allocate(512).isValid(), "quadrant allocated");
+        }
+        check(!budget.allocate(512).isValid(), "no fifth quadrant");
+        check(!budget.allocate(128).isValid(), "no room for the smallest tile");
+    }
+
+    void fillsSplitQuadrantsFirst() {
+        auto budget = ShadowMapBudget{1024, 128};
+        const auto small = budget.allocate(128);
+        const auto other = budget.allocate(128);
+        // The second small tile goes in the quadrant already split by the first one
+        check(other.x < 512 && other.y < 512, "small tiles packed in the same quadrant");
+        // Three free quadrants left for the large tiles
+        for (auto i = 0; i < 3; i++) {
+            const auto large = budget.allocate(512);
+            check(large.isValid(), "large tile allocated");
+            check(!overlap(large, small) && !overlap(large, other), "large tile does not overlap the small tiles");
+        }
+    }
+
+    void mergesFreedTiles() {
+        auto budget = ShadowMapBudget{1024, 128};
+        auto tiles = std::vector<ShadowMapBudget::Tile>{};
+        while (true) {
+            const auto tile = budget.allocate(128);
+            if (!tile.isValid()) { break; }
+            tiles.push_back(tile);
+        }
+        check(tiles.size() == 64, "budget filled with the smallest tiles");
+        check(!budget.allocate(1024).isValid(), "no room for the whole budget");
+        for (const auto& tile : tiles) {
+            budget.free(tile);
+        }
+        check(budget.getUsedTexels() == 0, "all texels released");
+        check(budget.allocate(1024).isValid(), "freed tiles merged back into the root");
+    }
+
+    void randomAllocationsDoNotOverlap() {
+        auto budget = ShadowMapBudget{4096, 128};
+        auto random = std::mt19937{42};
+        auto tiles = std::vector<ShadowMapBudget::Tile>{};
+        for (auto step = 0; step < 10000; step++) {
+            if (!tiles.empty() && random() % 3 == 0) {
+                const auto index = random() % tiles.size();
+                budget.free(tiles[index]);
+                tiles.erase(tiles.begin() + index);
+            } else {
+                const auto tile = budget.allocate(128u << (random() % 6));
+                if (!tile.isValid()) { continue; }
+                check(tile.x + tile.size <= 4096 && tile.y + tile.size <= 4096, "tile inside the budget");
+                check(tile.x % tile.size == 0 && tile.y % tile.size == 0, "tile aligned on its size");
+                for (const auto& other : tiles) {
+                    check(!overlap(tile, other), "tiles do not overlap");
+                }
+                tiles.push_back(tile);
+            }
+            auto usedTexels = uint64{0};
+            for (const auto& tile : tiles) {
+                usedTexels += static_cast<uint64>(tile.size) * tile.size;
+            }
+            check(budget.getUsedTexels() == usedTexels, "used texels accounting");
+        }
+    }
+
+    void benchmarkAllocations() {
+        auto budget = ShadowMapBudget{8192, 128};
+        auto tiles = std::vector<ShadowMapBudget::Tile>{};
+        tiles.reserve(64);
+        // 20 lights with 6 cube faces each, re-allocated every frame in the worst case
+        benchmark("allocate & free 120 tiles", 1000, [&] {
+            for (auto i = 0; i < 120; i++) {
+                tiles.push_back(budget.allocate(128u << (i % 4)));
+            }
+            for (const auto& tile : tiles) {
+                budget.free(tile);
+            }
+            tiles.clear();
+        });
+    }
+
+}
+
+int main() {
+    return run({
+        { "rounds up sizes", roundsUpSizes },
+        { "fails when full", failsWhenFull },
+        { "fills split quadrants first", fillsSplitQuadrantsFirst },
+        { "merges freed tiles", mergesFreedTiles },
+        { "random allocations do not overlap", randomAllocationsDoNotOverlap },
+        { "benchmark allocations", benchmarkAllocations },
+    });
+}
@@ -0,0 +1,186 @@
+/*
+* Copyright (c) 2025-present Henri Michelon
+*
+* This software is released under the MIT License.
+* https://opensource.org/licenses/MIT
+*/
+import std;
+import lysa.tests;
+import lysa.types;
+import lysa.resources.shaped_text_cache;
+
+using namespace lysa;
+using namespace lysa::tests;
+
+namespace {
+
+    // Stand-in of Font::ShapedText
+    struct FakeShapedText {
+        std::vector<float> quads;
+        float width{0.0f};
+    };
+
+    using Cache = ShapedTextCache<FakeShapedText>;
+
+    // Shaper stand-in doing a lower bound of the per glyph work of Font::shape() without HarfBuzz
+    // and a font file : glyph metrics and kerning pair lookups, and the quad offset by the pen position
+    struct FakeShaper {
+        std::unordered_map<uint32, std::array<float, 5>> glyphs;
+        std::unordered_map<uint32, float> kerning;
+        uint32 shapedCount{0};
+
+        FakeShaper() {
+            for (auto codepoint = 32u; codepoint < 128u; codepoint++) {
+                const auto c = static_cast<float>(codepoint);
+                glyphs[codepoint] = { 0.5f + c / 1000.0f, 0.05f, -0.2f, 0.45f, 0.7f };
+                for (auto next = 32u; next < 128u; next += 7) {
+                    kerning[codepoint << 8 | next] = -0.01f;
+                }
+            }
+        }
+
+        std::shared_ptr<FakeShapedText> shape(const std::string& text) {
+            shapedCount += 1;
+            const auto shapedText = std::make_shared<FakeShapedText>();
+            shapedText->quads.reserve(text.size() * 4);
+            auto previous = 0u;
+            for (const auto c : text) {
+                const auto codepoint = static_cast<uint32>(c);
+                if (const auto it = kerning.find(previous << 8 | codepoint); it != kerning.end()) {
+                    shapedText->width += it->second;
+                }
+                const auto& [advance, left, bottom, right, top] = glyphs.at(codepoint);
+                shapedText->quads.insert(shapedText->quads.end(), {
+                    shapedText->width + left, bottom, shapedText->width + right, top });
+                shapedText->width += advance;
+                previous = codepoint;
+            }
+            return shapedText;
+        }
+
+        // Font::shape() : cache lookup then shaping on miss
+        std::shared_ptr<const FakeShapedText> shape(Cache& cache, const std::string& text, const uint32 generation, const uint64 budget) {
+            if (const auto cached = cache.get(text, generation)) {
+                return cached;
+            }
+            const auto shapedText = shape(text);
+            return cache.add(text, shapedText, memorySize(*shapedText), generation, budget);
+        }
+
+        static uint64 memorySize(const FakeShapedText& shapedText) {
+            return sizeof(FakeShapedText) + shapedText.quads.capacity() * sizeof(float);
+        }
+    };
+
+    std::string label(const uint32 index) {
+        return std::format("Label #{:05} : score {:03}", index, index * 37 % 1000);
+    }
+
+    void evictsTheLeastRecentlyUsedTexts() {
+        auto shaper = FakeShaper{};
+        auto cache = Cache{};
+        constexpr auto budget = uint64{4096};
+        // Same length labels : same memory size for all the entries
+        const auto first = shaper.shape(cache, label(100), 0, budget);
+        const auto entrySize = cache.getStatistics().memoryUsed;
+        const auto capacity = static_cast<uint32>(budget / entrySize);
+        check(capacity > 2, "several entries in the budget");
+        for (auto i = 101u; i < 100 + capacity; i++) {
+            shaper.shape(cache, label(i), 0, budget);
+        }
+        auto statistics = cache.getStatistics();
+        check(statistics.entries == capacity && statistics.memoryUsed == capacity * entrySize, "budget filled");
+        check(statistics.misses == capacity && statistics.hits == 0, "each new text is a miss");
+
+        // The first label becomes the most recently used, the second one is evicted
+        check(shaper.shape(cache, label(100), 0, budget) == first, "cached text returned");
+        shaper.shape(cache, label(100 + capacity), 0, budget);
+        statistics = cache.getStatistics();
+        check(statistics.entries == capacity && statistics.memoryUsed <= budget, "memory kept in the budget");
+        check(statistics.hits == 1, "hit counted");
+        check(cache.get(label(100), 0) == first, "recently used text kept");
+        check(cache.get(label(101), 0) == nullptr, "least recently used text evicted");
+
+        // Texts kept by the glyph atlas eviction, most recently used first
+        auto visited = std::vector<const FakeShapedText*>{};
+        cache.forEach([&](const FakeShapedText& shapedText) { visited.push_back(&shapedText); });
+        check(visited.size() == capacity && visited.front() == first.get(), "cached texts visited");
+
+        // Larger than the budget : shaped but not cached
+        const auto longText = std::string(budget, 'x');
+        const auto shapedText = shaper.shape(cache, longText, 0, budget);
+        check(shapedText && shapedText->quads.size() == budget * 4, "large text shaped");
+        check(cache.get(longText, 0) == nullptr && cache.getStatistics().entries == capacity, "large text not cached");
+    }
+
+    void invalidatesTheOtherGenerations() {
+        auto shaper = FakeShaper{};
+        auto cache = Cache{};
+        constexpr auto budget = uint64{256 * 1024};
+        const auto shapedText = shaper.shape(cache, "Hello", 1, budget);
+        const auto entrySize = cache.getStatistics().memoryUsed;
+        shaper.shape(cache, "World", 1, budget);
+        check(shaper.shape(cache, "Hello", 1, budget) == shapedText, "same generation hit");
+
+        // The atlas evicted or moved glyphs : the texts are shaped again with the new UVs
+        const auto reshaped = shaper.shape(cache, "Hello", 2, budget);
+        check(reshaped != shapedText && shaper.shapedCount == 3, "reshaped for a new generation");
+        const auto statistics = cache.getStatistics();
+        check(statistics.entries == 2 && statistics.hits == 1 && statistics.misses == 3, "stale entry replaced");
+        check(statistics.memoryUsed == 2 * entrySize, "stale entry memory released");
+        check(cache.get("Hello", 2) == reshaped, "new generation cached");
+        check(cache.get("World", 2) == nullptr && cache.getStatistics().entries == 1, "stale entry dropped on lookup");
+
+        // Shaped by another thread in the meantime : the first cached run is shared
+        const auto other = shaper.shape("Hello");
+        check(cache.add("Hello", other, FakeShaper::memorySize(*other), 2, budget) == reshaped, "concurrent shaping merged");
+    }
+
+    void benchmarkLabels() {
+        // 5000 labels redrawn each frame, 100 of them changing each frame
+        constexpr auto labelsCount = 5000u;
+        constexpr auto framesCount = 20;
+        constexpr auto budget = uint64{4 * 1024 * 1024};
+        auto shaper = FakeShaper{};
+        auto labels = std::vector<std::string>{};
+        for (auto i = 0u; i < labelsCount; i++) {
+            labels.push_back(label(i));
+        }
+        auto width = 0.0f;
+        std::cout << "  shaping without cache :" << std::endl;
+        benchmark("shape 5000 labels", framesCount, [&] {
+            for (const auto& text : labels) {
+                width += shaper.shape(text)->width;
+            }
+        });
+
+        auto cache = Cache{};
+        auto frame = 0u;
+        std::cout << "  shaping with the cache :" << std::endl;
+        shaper.shapedCount = 0;
+        benchmark("shape 5000 labels", framesCount, [&] {
+            for (auto i = 0u; i < 100; i++) {
+                labels[(frame * 100 + i) % labelsCount] = label(labelsCount + frame * 100 + i);
+            }
+            for (const auto& text : labels) {
+                width += shaper.shape(cache, text, 0, budget)->width;
+            }
+            frame += 1;
+        });
+        const auto statistics = cache.getStatistics();
+        std::cout << "  " << statistics.hits << " hits, " << statistics.misses << " misses, "
+                  << statistics.entries << " entries using " << statistics.memoryUsed / 1024 << " KB" << std::endl;
+        check(width > 0.0f, "labels shaped");
+        check(shaper.shapedCount == labelsCount + (framesCount - 1) * 100, "only the new labels shaped after the first frame");
+        check(statistics.memoryUsed <= budget, "cache in the budget");
+    }
+
+}
+
+int main() {
+    return run({
+        { "evicts the least recently used texts", evictsTheLeastRecentlyUsedTexts },
+        { "invalidates the other generations", invalidatesTheOtherGenerations },
+        { "benchmark labels", benchmarkLabels },
+    });
+}
@@ -0,0 +1,69 @@
+/*
+* Copyright (c) 2025-present Henri Michelon
+*
+* This software is released under the MIT License.
+* https://opensource.org/licenses/MIT
+*/
+export module lysa.tests;
+
+import std;
+
+/**
+ * Minimal unit tests harness for the engine modules that do not need a GPU device.
+ * Each test executable calls run() from its main() with its list of tests.
+ */
+export namespace lysa::tests {
+
+    struct Test {
+        std::string_view name;
+        void (*function)();
+    };
+
+    // Number of failed checks of the running test
+    inline int failedChecks{0};
+
+    /** Reports a failed check, the test continues */
+    void check(
+        const bool condition,
+        const std::string_view expression,
+        const std::source_location& location = std::source_location::current()) {
+        if (!condition) {
+            failedChecks += 1;
+            std::cerr << location.file_name() << ":" << location.line() << ": check failed: " << expression << std::endl;
+        }
+    }
+
+    /**
+     * Calls `function` `iterations` times and prints the mean duration.
+     * The durations are only printed, they are not checked.
+     */
+    template<typename Function>
+    void benchmark(const std::string_view name, const int iterations, Function&& function) {
+        const auto start = std::chrono::steady_clock::now();
+        for (auto i = 0; i < iterations; i++) {
+            function();
+        }
+        const auto duration = std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start);
+        std::cout << "  " << name << ": " << duration.count() / iterations << " us" << std::endl;
+    }
+
+    /** Runs the tests and returns the exit code of the executable */
+    int run(const std::initializer_list<Test> tests) {
+        auto failedTests = 0;
+        for (const auto& test : tests) {
+            failedChecks = 0;
+            try {
+                test.function();
+            } catch (const std::exception& exception) {
+                std::cerr << "exception: " << exception.what() << std::endl;
+                failedChecks += 1;
+            }
+            std::cout << (failedChecks == 0 ? "[PASS] " : "[FAIL] ") << test.name << std::endl;
+            if (failedChecks > 0) {
+                failedTests += 1;
+            }
+        }
+        return failedTests == 0 ? 0 : 1;
+    }
+
+}
@@ -0,0 +1,169 @@
+/*
+* Copyright (c) 2025-present Henri Michelon
+*
+* This software is released under the MIT License.
+* https://opensource.org/licenses/MIT
+*/
+import std;
+import lysa.tests;
+import lysa.types;
+import lysa.texture_streamer;
+
+using namespace lysa;
+using namespace lysa::tests;
+
+namespace {
+
+    // 8x8 texture, one byte per texel : 64, 16, 4 & 1 bytes
+    const auto MIP_SIZES = std::vector<uint64>{ 64, 16, 4, 1 };
+    constexpr auto UNUSED_DELAY = 10u;
+
+    struct Decisions {
+        std::vector<TextureResidency::Decision> loads;
+        std::vector<TextureResidency::Decision> evictions;
+    };
+
+    Decisions update(TextureResidency& residency, const uint64 frame, const uint32 maxPending = 8) {
+        auto decisions = Decisions{};
+        residency.update(frame, maxPending, decisions.loads, decisions.evictions);
+        return decisions;
+    }
+
+    void completeAll(TextureResidency& residency, const Decisions& decisions) {
+        for (const auto& decision : decisions.evictions) { residency.complete(decision.handle); }
+        for (const auto& decision : decisions.loads) { residency.complete(decision.handle); }
+    }
+
+    void accountsInitialMips() {
+        auto residency = TextureResidency{1000, UNUSED_DELAY};
+        const auto a = residency.add(MIP_SIZES, 2);
+        const auto b = residency.add(MIP_SIZES, 10);
+        check(residency.getResidentMip(a) == 2, "initial mip resident");
+        check(residency.getResidentMip(b) == 3, "initial mip clamped to the coarsest level");
+        check(residency.getUsedSize() == 5 + 1, "used size of the initial mips");
+        residency.remove(a);
+        residency.remove(a);
+        check(residency.getUsedSize() == 1, "removed texture budget released once");
+        const auto c = residency.add(MIP_SIZES, 1);
+        check(c == a, "handle reused");
+        check(residency.getUsedSize() == 1 + 21, "reused handle accounted");
+    }
+
+    void loadsRequestedMips() {
+        auto residency = TextureResidency{1000, UNUSED_DELAY};
+        const auto handle = residency.add(MIP_SIZES, 2);
+        residency.request(handle, 1, 1);
+        residency.request(handle, 0, 1);
+        residency.request(handle, 3, 1);
+        const auto decisions = update(residency, 1);
+        check(decisions.evictions.empty(), "no eviction");
+        check(decisions.loads.size() == 1 && decisions.loads[0].mip == 0, "finest request of the frame loaded");
+        check(residency.isPending(handle), "load in progress");
+        check(residency.getUsedSize() == 85, "budget reserved at decision time");
+        check(update(residency, 2).loads.empty(), "pending texture not loaded twice");
+        residency.complete(handle);
+        check(!residency.isPending(handle), "load completed");
+        check(residency.getResidentMip(handle) == 0, "requested mip resident");
+    }
+
+    void fallsBackToCoarserMips() {
+        auto residency = TextureResidency{30, UNUSED_DELAY};
+        const auto handle = residency.add(MIP_SIZES, 3);
+        residency.request(handle, 0, 1);
+        const auto decisions = update(residency, 1);
+        check(decisions.loads.size() == 1 && decisions.loads[0].mip == 1, "finest mip fitting in the budget");
+        check(residency.getUsedSize() == 21, "used size within the budget");
+    }
+
+    void evictsLeastRecentlyUsed() {
+        auto residency = TextureResidency{100, UNUSED_DELAY};
+        const auto old = residency.add(MIP_SIZES, 3);
+        const auto recent = residency.add(MIP_SIZES, 3);
+        residency.request(old, 0, 1);
+        completeAll(residency, update(residency, 1));
+        residency.request(recent, 0, 5);
+        completeAll(residency, update(residency, 5));
+        check(residency.getResidentMip(recent) == 2, "no room for the finer mips while the other texture is used");
+
+        // The old texture is no longer requested : it goes back to its initial mip
+        const auto frame = 1 + UNUSED_DELAY + 1;
+        residency.request(recent, 0, frame);
+        const auto decisions = update(residency, frame);
+        check(decisions.evictions.size() == 1 && decisions.evictions[0].handle == old, "unused texture evicted");
+        check(decisions.evictions[0].mip == 3, "evicted to its initial mip");
+        check(decisions.loads.size() == 1 && decisions.loads[0].mip == 0, "used texture loaded");
+        check(residency.getUsedSize() <= residency.getBudget(), "budget respected");
+    }
+
+    void limitsPendingLoads() {
+        auto residency = TextureResidency{1000, UNUSED_DELAY};
+        auto handles = std::vector<TextureResidency::Handle>{};
+        for (auto i = 0; i < 5; i++) {
+            handles.push_back(residency.add(MIP_SIZES, 3));
+            residency.request(handles.back(), 0, 1);
+        }
+        check(update(residency, 1, 2).loads.size() == 2, "loads limited");
+        for (const auto handle : handles) { residency.request(handle, 0, 2); }
+        check(update(residency, 2, 2).loads.empty(), "pending loads count towards the limit");
+    }
+
+    void cancelsFailedLoads() {
+        auto residency = TextureResidency{1000, UNUSED_DELAY};
+        const auto handle = residency.add(MIP_SIZES, 2);
+        residency.request(handle, 0, 1);
+        update(residency, 1);
+        residency.cancel(handle, 2);
+        check(!residency.isPending(handle), "cancelled load not pending");
+        check(residency.getResidentMip(handle) == 2, "resident mip restored");
+        check(residency.getUsedSize() == 5, "reserved budget released");
+    }
+
+    void shrinksWithTheBudget() {
+        auto residency = TextureResidency{1000, UNUSED_DELAY};
+        const auto handle = residency.add(MIP_SIZES, 3);
+        residency.request(handle, 0, 1);
+        completeAll(residency, update(residency, 1));
+        residency.setBudget(10);
+        const auto decisions = update(residency, 1 + UNUSED_DELAY + 1);
+        check(decisions.evictions.size() == 1 && decisions.evictions[0].mip == 3, "unused texture evicted");
+        check(residency.getUsedSize() <= 10, "new budget respected");
+    }
+
+    void randomRequestsStayInBudget() {
+        auto residency = TextureResidency{2000, UNUSED_DELAY};
+        auto random = std::mt19937{42};
+        auto handles = std::vector<TextureResidency::Handle>{};
+        for (auto i = 0; i < 50; i++) {
+            handles.push_back(residency.add(MIP_SIZES, 2));
+        }
+        for (auto frame = uint64{1}; frame < 500; frame++) {
+            for (auto i = 0; i < 10; i++) {
+                residency.request(handles[random() % handles.size()], random() % 4, frame);
+            }
+            const auto decisions = update(residency, frame, 4);
+            check(residency.getUsedSize() <= residency.getBudget(), "budget respected");
+            completeAll(residency, decisions);
+        }
+        auto usedSize = uint64{0};
+        for (const auto handle : handles) {
+            for (auto mip = residency.getResidentMip(handle); mip < MIP_SIZES.size(); mip++) {
+                usedSize += MIP_SIZES[mip];
+            }
+        }
+        check(residency.getUsedSize() == usedSize, "used size matches the resident mips");
+    }
+
+}
+
+int main() {
+    return run({
+        { "accounts initial mips", accountsInitialMips },
+        { "loads requested mips", loadsRequestedMips },
+        { "falls back to coarser mips", fallsBackToCoarserMips },
+        { "evicts least recently used", evictsLeastRecentlyUsed },
+        { "limits pending loads", limitsPendingLoads },
+        { "cancels failed loads", cancelsFailedLoads },
+        { "shrinks with the budget", shrinksWithTheBudget },
+        { "random requests stay in budget", randomRequestsStayInBudget },
+    });
+}
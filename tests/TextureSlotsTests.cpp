@@ -0,0 +1,159 @@
+/*
+* Copyright (c) 2025-present Henri Michelon
+*
+* This software is released under the MIT License.
+* https://opensource.org/licenses/MIT
+*/
+import std;
+import lysa.exception;
+import lysa.tests;
+import lysa.types;
+import lysa.texture_slots;
+
+using namespace lysa;
+using namespace lysa::tests;
+
+namespace {
+
+    // Stand-in of the device images, identified by their value
+    using Texture = std::shared_ptr<uint32>;
+
+    constexpr auto FRAMES_IN_FLIGHT = 2u;
+    // Frames in flight, plus the frame being recorded, plus the copy written by update()
+    constexpr auto RING_SIZE = FRAMES_IN_FLIGHT + 2;
+
+    const auto BLANK = std::make_shared<uint32>(0);
+
+    void allocatesAndFreesSlots() {
+        auto slots = TextureSlots<Texture>{RING_SIZE};
+        slots.reset(3, BLANK);
+        const auto a = slots.add(std::make_shared<uint32>(1));
+        const auto b = slots.add(std::make_shared<uint32>(2));
+        check(a == 0 && b == 1, "lowest slots first");
+        slots.remove(a);
+        check(slots.get(a) == BLANK, "removed slot bound to the blank texture");
+        check(slots.add(std::make_shared<uint32>(3)) == a, "freed slot reused");
+        slots.add(std::make_shared<uint32>(4));
+        auto thrown = false;
+        try {
+            slots.add(std::make_shared<uint32>(5));
+        } catch (const Exception&) {
+            thrown = true;
+        }
+        check(thrown && slots.getFreeCount() == 0, "exception when all the slots are used");
+    }
+
+    void patchesOnlyTheChangedSlots() {
+        auto slots = TextureSlots<Texture>{RING_SIZE};
+        slots.reset(4096, BLANK);
+        check(slots.update() == nullptr, "nothing written without changes");
+        const auto texture = std::make_shared<uint32>(1);
+        const auto index = slots.add(texture);
+        for (auto frame = 0u; frame < RING_SIZE; frame++) {
+            const auto* copy = slots.update();
+            if (frame == 0) {
+                check(copy != nullptr && (*copy)[index] == texture, "change written in the next copy");
+                check(slots.getLastCopiedCount() == 1, "only the changed slot copied");
+            } else {
+                check(copy == nullptr, "copy unchanged while nothing changes");
+            }
+        }
+        // Same slot changed more times than the number of slots : the whole array is copied
+        auto small = TextureSlots<Texture>{RING_SIZE};
+        small.reset(4, BLANK);
+        for (auto i = 0; i < 10; i++) {
+            small.set(0, std::make_shared<uint32>(i));
+        }
+        const auto* copy = small.update();
+        check(copy != nullptr && *(*copy)[0] == 9 && small.getLastCopiedCount() == 4, "whole array copied");
+    }
+
+    // Adds and removes thousands of textures like the streaming of a large scene, while
+    // checking that update() never writes a copy used by the frame recorded or the frames in flight
+    void neverWritesTheCopiesInFlight() {
+        auto slots = TextureSlots<Texture>{RING_SIZE};
+        slots.reset(2048, BLANK);
+        auto random = std::mt19937{11};
+        auto used = std::vector<uint32>{};
+        // Copy used by each frame in flight, and the textures it references
+        auto inFlight = std::deque<std::pair<uint32, std::vector<std::weak_ptr<uint32>>>>{};
+        const std::vector<Texture>* currentCopy{nullptr};
+        auto writesInFlight = 0;
+        auto wrongCopies = 0;
+        auto releasedInFlight = 0;
+        auto added = 0u;
+        for (auto frame = 0u; frame < 3000; frame++) {
+            for (auto i = random() % 16; i > 0; i--) {
+                if (!used.empty() && (random() % 2 == 0 || slots.getFreeCount() == 0)) {
+                    const auto position = random() % used.size();
+                    slots.remove(used[position]);
+                    used.erase(used.begin() + position);
+                } else {
+                    used.push_back(slots.add(std::make_shared<uint32>(++added)));
+                }
+            }
+            if (const auto* copy = slots.update()) {
+                writesInFlight += std::ranges::find(inFlight, slots.getCurrent(), &decltype(inFlight)::value_type::first) != inFlight.end();
+                auto equal = true;
+                for (auto index = 0u; index < slots.getCount(); index++) {
+                    equal &= (*copy)[index] == slots.get(index);
+                }
+                wrongCopies += !equal;
+                currentCopy = copy;
+            }
+            // The textures removed while used by the frames in flight are kept alive by their copies
+            for (const auto& textures : inFlight | std::views::values) {
+                releasedInFlight += std::ranges::count_if(textures, [](const auto& texture) { return texture.expired(); });
+            }
+            // The frame is recorded with the current copy and submitted
+            auto textures = std::vector<std::weak_ptr<uint32>>{};
+            if (currentCopy) {
+                textures.assign(currentCopy->begin(), currentCopy->end());
+            }
+            inFlight.push_back({slots.getCurrent(), std::move(textures)});
+            if (inFlight.size() > FRAMES_IN_FLIGHT + 1) {
+                inFlight.pop_front();
+            }
+        }
+        check(added > 10000, "thousands of textures added");
+        check(writesInFlight == 0, "no copy used by the frames in flight written : no idle wait needed");
+        check(wrongCopies == 0, "written copies equal the slots");
+        check(releasedInFlight == 0, "removed textures kept alive by the copies of the frames in flight");
+    }
+
+    void benchmarkUpdate() {
+        constexpr auto count = 4096u;
+        auto slots = TextureSlots<Texture>{RING_SIZE};
+        slots.reset(count, BLANK);
+        auto textures = std::vector<Texture>{};
+        for (auto i = 0u; i < count / 2; i++) {
+            textures.push_back(std::make_shared<uint32>(i));
+            slots.add(textures.back());
+        }
+        slots.update();
+        // Ten streamed textures replaced per frame
+        auto frame = 0u;
+        benchmark("update 4096 slots with 10 changes per frame", 1000, [&] {
+            for (auto i = 0u; i < 10; i++) {
+                const auto index = (frame * 10 + i) % (count / 2);
+                slots.set(index, textures[(index + frame) % textures.size()]);
+            }
+            slots.update();
+            frame++;
+        });
+        // Each copy is patched with the changes of the frames since it was written
+        std::cout << "  " << slots.getLastCopiedCount() << " slots copied per update (" << count
+                  << " when the whole array is copied)" << std::endl;
+        check(slots.getLastCopiedCount() == 10 * RING_SIZE, "only the slots changed since the copy was written");
+    }
+
+}
+
+int main() {
+    return run({
+        { "allocates and frees slots", allocatesAndFreesSlots },
+        { "patches only the changed slots", patchesOnlyTheChangedSlots },
+        { "never writes the copies in flight", neverWritesTheCopiesInFlight },
+        { "benchmark update", benchmarkUpdate },
+    });
+}
@@ -0,0 +1,155 @@
+/*
+* Copyright (c) 2025-present Henri Michelon
+*
+* This software is released under the MIT License.
+* https://opensource.org/licenses/MIT
+*/
+import std;
+import lysa.math;
+import lysa.tests;
+import lysa.types;
+import lysa.resources.mesh;
+
+using namespace lysa;
+using namespace lysa::tests;
+
+namespace {
+
+    constexpr auto PI = std::numbers::pi_v<double>;
+
+    std::array<double, 3> toArray(const float3& v) {
+        return { static_cast<float>(v.x), static_cast<float>(v.y), static_cast<float>(v.z) };
+    }
+
+    // Angle in degrees between two vectors, acos() is not precise enough for nearly parallel vectors
+    double angle(const float3& a, const float3& b) {
+        const auto u = toArray(a);
+        const auto v = toArray(b);
+        const auto dot = u[0] * v[0] + u[1] * v[1] + u[2] * v[2];
+        const auto cross = std::hypot(u[1] * v[2] - u[2] * v[1], u[2] * v[0] - u[0] * v[2], u[0] * v[1] - u[1] * v[0]);
+        return std::atan2(cross, dot) * 180.0 / PI;
+    }
+
+    // Unit vectors spread on the sphere, plus the axes and the octahedron edges & vertices
+    std::vector<float3> createDirections() {
+        auto directions = std::vector<float3>{};
+        constexpr auto count = 100000;
+        const auto goldenAngle = PI * (3.0 - std::sqrt(5.0));
+        for (auto i = 0; i < count; i++) {
+            const auto z = 1.0 - 2.0 * (i + 0.5) / count;
+            const auto radius = std::sqrt(1.0 - z * z);
+            const auto phi = goldenAngle * i;
+            directions.push_back(float3{
+                static_cast<float>(radius * std::cos(phi)),
+                static_cast<float>(radius * std::sin(phi)),
+                static_cast<float>(z)});
+        }
+        for (const auto x : { -1.0f, 0.0f, 1.0f }) {
+            for (const auto y : { -1.0f, 0.0f, 1.0f }) {
+                for (const auto z : { -1.0f, 0.0f, 1.0f }) {
+                    if (x == 0.0f && y == 0.0f && z == 0.0f) { continue; }
+                    const auto length = std::sqrt(x * x + y * y + z * z);
+                    directions.push_back(float3{x / length, y / length, z / length});
+                }
+            }
+        }
+        return directions;
+    }
+
+    void normalsWithinTheAngularErrorBound() {
+        auto worst = 0.0;
+        for (const auto& normal : createDirections()) {
+            worst = std::max(worst, angle(normal, VertexData::unpackNormal(VertexData::packNormal(normal))));
+        }
+        std::cout << "  normals maximum error " << worst << " degrees" << std::endl;
+        // 2 x 16 bits octahedral encoding
+        check(worst < 0.005, "normals angular error below 0.005 degree");
+    }
+
+    void tangentsWithinTheAngularErrorBound() {
+        auto worst = 0.0;
+        for (const auto& tangent : createDirections()) {
+            const auto decoded = VertexData::unpackTangent(VertexData::packTangent(float4{tangent, 1.0f}));
+            worst = std::max(worst, angle(tangent, float3{decoded.xyz}));
+        }
+        std::cout << "  tangents maximum error " << worst << " degrees" << std::endl;
+        // 2 x 15 bits octahedral encoding
+        check(worst < 0.01, "tangents angular error below 0.01 degree");
+    }
+
+    void keepsTheBitangentSign() {
+        auto wrongSigns = 0;
+        auto wrongDirections = 0;
+        for (const auto& tangent : createDirections()) {
+            for (const auto sign : { -1.0f, 1.0f }) {
+                const auto packed = VertexData::packTangent(float4{tangent, sign});
+                const auto decoded = VertexData::unpackTangent(packed);
+                wrongSigns += static_cast<float>(decoded.w) != sign;
+                wrongSigns += ((packed & 0x80000000u) != 0) != (sign < 0.0f);
+                // The sign bit does not leak into the direction
+                wrongDirections += angle(tangent, float3{decoded.xyz}) > 0.01;
+            }
+        }
+        check(wrongSigns == 0, "bitangent sign in the high bit");
+        check(wrongDirections == 0, "tangent direction independent of the sign");
+        const auto packed = VertexData::packTangent(float4{float3{0.0f, 0.0f, -1.0f}, -0.25f});
+        check(static_cast<float>(VertexData::unpackTangent(packed).w) == -1.0f, "negative w decoded as -1");
+    }
+
+    void roundTripsTheUV() {
+        // Values exactly representable as half floats
+        for (const auto value : { 0.0f, 0.5f, 1.0f, -1.0f, 0.25f, 2.0f, 1024.0f, 65504.0f, 0.000061035156f }) {
+            const auto uv = VertexData::unpackUV(VertexData::packUV(float2{value, -value}));
+            check(static_cast<float>(uv.x) == value && static_cast<float>(uv.y) == -value, "exact half float");
+        }
+        // 11 bits of precision, rounded to nearest : relative error below 2^-11
+        auto random = std::mt19937{5};
+        auto distribution = std::uniform_real_distribution{-64.0f, 64.0f};
+        auto worst = 0.0;
+        for (auto i = 0; i < 100000; i++) {
+            const auto u = distribution(random);
+            const auto v = distribution(random);
+            const auto uv = VertexData::unpackUV(VertexData::packUV(float2{u, v}));
+            for (const auto& [value, decoded] : { std::pair{u, static_cast<float>(uv.x)}, std::pair{v, static_cast<float>(uv.y)} }) {
+                if (std::abs(value) >= 0.000061035156f) {
+                    worst = std::max(worst, std::abs(static_cast<double>(decoded) - value) / std::abs(value));
+                }
+            }
+        }
+        std::cout << "  UV maximum relative error " << worst << std::endl;
+        check(worst <= std::ldexp(1.0, -11), "UV relative error below 2^-11");
+        // In [0, 1] the error stays below half a texel of a 2048 x 2048 texture
+        auto worstUnit = 0.0;
+        auto unit = std::uniform_real_distribution{0.0f, 1.0f};
+        for (auto i = 0; i < 100000; i++) {
+            const auto u = unit(random);
+            worstUnit = std::max(worstUnit, std::abs(static_cast<double>(VertexData::unpackUV(VertexData::packUV(float2{u, 0.0f})).x) - u));
+        }
+        check(worstUnit <= 1.0 / 4096.0, "UV error in [0, 1] below 1/4096");
+        const auto overflow = VertexData::unpackUV(VertexData::packUV(float2{70000.0f, -70000.0f}));
+        check(std::isinf(static_cast<float>(overflow.x)) && static_cast<float>(overflow.y) < 0.0f, "overflow to infinity");
+    }
+
+    void reportsTheVertexFootprint() {
+        // Before : position + uv.x, normal + uv.y, tangent + sign as three float4, read by all the passes
+        constexpr auto previousSize = size_t{3 * 4 * sizeof(float)};
+        check(previousSize == 48 && sizeof(VertexData) == 24, "color passes vertex from 48 to 24 bytes");
+        check(sizeof(VertexPositionData) == 16, "16 bytes depth & shadow maps vertex");
+        constexpr auto vertices = size_t{1000000};
+        std::cout << "  1M vertices : " << vertices * previousSize / 1000000 << " MB before, "
+                  << vertices * (sizeof(VertexData) + sizeof(VertexPositionData)) / 1000000 << " MB with the two streams" << std::endl
+                  << "  bytes read per vertex : color passes " << previousSize << " -> " << sizeof(VertexData)
+                  << ", depth pre-pass & shadow maps " << previousSize << " -> " << sizeof(VertexPositionData) << std::endl;
+    }
+
+}
+
+int main() {
+    return run({
+        { "normals within the angular error bound", normalsWithinTheAngularErrorBound },
+        { "tangents within the angular error bound", tangentsWithinTheAngularErrorBound },
+        { "keeps the bitangent sign", keepsTheBitangentSign },
+        { "round trips the UV", roundTripsTheUV },
+        { "reports the vertex footprint", reportsTheVertexFootprint },
+    });
+}
@@ -0,0 +1,138 @@
+/*
+* Copyright (c) 2025-present Henri Michelon
+*
+* This software is released under the MIT License.
+* https://opensource.org/licenses/MIT
+*/
+import std;
+import lysa.tests;
+import lysa.types;
+import lysa.renderers.ui;
+import lysa.ui.rect;
+import lysa.ui.resource;
+import lysa.ui.style;
+import lysa.ui.widget;
+import lysa.ui.window;
+
+using namespace lysa;
+using namespace lysa::tests;
+
+namespace {
+
+    // Counts the layouts of the widgets : the style is asked to resize a widget each time its children are laid out
+    class CountingStyle : public ui::Style {
+    public:
+        std::map<const ui::Widget*, uint32> layouts;
+
+        void addResource(ui::Widget& widget, const std::string& resources) override {
+            widget.setResource(std::make_shared<ui::Resource>(resources));
+        }
+
+        void draw(const ui::Widget&, ui::Resource&, UIRenderer&, bool) const override {}
+
+        void resize(ui::Widget& widget, ui::Rect&, ui::Resource&) override {
+            layouts[&widget]++;
+        }
+
+        auto relaid() const {
+            auto widgets = std::set<const ui::Widget*>{};
+            for (const auto& [widget, count] : layouts) {
+                widgets.insert(widget);
+            }
+            return widgets;
+        }
+
+    protected:
+        void updateOptions() override {}
+    };
+
+    // Root widget of a window not attached to a window manager
+    class Root : public ui::Widget {
+    public:
+        Root(ui::Window& window, CountingStyle& style) {
+            this->window = &window;
+            this->style = &style;
+            setResource(std::make_shared<ui::Resource>(""));
+            setFreezed(false);
+        }
+    };
+
+    constexpr auto LEAVES_COUNT = 10;
+
+    // A header panel and a content panel, with a row of leaves each
+    struct Tree {
+        ui::Window window{ui::Rect{0.0f, 0.0f, 1000.0f, 1000.0f}};
+        CountingStyle style;
+        Root root{window, style};
+        std::shared_ptr<ui::Widget> header;
+        std::shared_ptr<ui::Widget> content;
+        std::vector<std::shared_ptr<ui::Widget>> headerLeaves;
+        std::vector<std::shared_ptr<ui::Widget>> contentLeaves;
+
+        Tree() {
+            header = root.add(std::make_shared<ui::Widget>(), ui::Widget::TOP);
+            header->setSize(1000.0f, 100.0f);
+            content = root.add(std::make_shared<ui::Widget>(), ui::Widget::FILL);
+            for (auto i = 0; i < LEAVES_COUNT; i++) {
+                headerLeaves.push_back(header->add(std::make_shared<ui::Widget>(), ui::Widget::LEFT));
+                headerLeaves.back()->setSize(50.0f, 50.0f);
+                contentLeaves.push_back(content->add(std::make_shared<ui::Widget>(), ui::Widget::LEFT));
+                contentLeaves.back()->setSize(50.0f, 50.0f);
+            }
+            root.setSize(1000.0f, 1000.0f);
+            style.layouts.clear();
+        }
+    };
+
+    void unchangedSizeSkipsLayout() {
+        auto tree = Tree{};
+        tree.header->setSize(1000.0f, 100.0f);
+        tree.root.setSize(1000.0f, 1000.0f);
+        check(tree.style.layouts.empty(), "no widget laid out");
+    }
+
+    void leafChangeLaysOutItsBranchOnly() {
+        auto tree = Tree{};
+        tree.headerLeaves[3]->setSize(80.0f, 50.0f);
+        const auto relaid = tree.style.relaid();
+        std::cout << "  widgets laid out for a leaf change: " << relaid.size() << " of " << 3 + 2 * LEAVES_COUNT << std::endl;
+        check(relaid.contains(tree.header.get()), "parent laid out");
+        check(relaid.contains(tree.headerLeaves[3].get()), "changed leaf laid out");
+        check(relaid.size() == 2, "siblings and other branches skipped");
+    }
+
+    void rootChangeLaysOutResizedBranches() {
+        auto tree = Tree{};
+        tree.root.setSize(1000.0f, 800.0f);
+        const auto relaid = tree.style.relaid();
+        std::cout << "  widgets laid out for a root change: " << relaid.size() << " of " << 3 + 2 * LEAVES_COUNT << std::endl;
+        check(relaid.contains(&tree.root), "root laid out");
+        check(relaid.contains(tree.content.get()), "resized content panel laid out");
+        check(std::ranges::all_of(tree.contentLeaves, [&](const auto& leaf) { return relaid.contains(leaf.get()); }),
+              "resized content leaves laid out");
+        check(!relaid.contains(tree.header.get()), "moved but not resized header skipped");
+        check(std::ranges::none_of(tree.headerLeaves, [&](const auto& leaf) { return relaid.contains(leaf.get()); }),
+              "header leaves skipped");
+    }
+
+    void frozenLayoutIsNotLost() {
+        auto tree = Tree{};
+        tree.header->setFreezed(true);
+        tree.headerLeaves[3]->setSize(80.0f, 50.0f);
+        check(!tree.style.layouts.contains(tree.header.get()), "frozen parent not laid out");
+        tree.header->setFreezed(false);
+        // Same size, but the layout skipped while frozen is still pending
+        tree.header->setSize(1000.0f, 100.0f);
+        check(tree.style.layouts.contains(tree.header.get()), "pending layout done on the next size request");
+    }
+
+}
+
+int main() {
+    return run({
+        { "unchanged size skips layout", unchangedSizeSkipsLayout },
+        { "leaf change lays out its branch only", leafChangeLaysOutItsBranchOnly },
+        { "root change lays out resized branches", rootChangeLaysOutResizedBranches },
+        { "frozen layout is not lost", frozenLayoutIsNotLost },
+    });
+}
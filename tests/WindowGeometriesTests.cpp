@@ -0,0 +1,254 @@
+/*
+* Copyright (c) 2025-present Henri Michelon
+*
+* This software is released under the MIT License.
+* https://opensource.org/licenses/MIT
+*/
+import std;
+import lysa.tests;
+import lysa.types;
+import lysa.ui.window_geometries;
+
+using namespace lysa;
+using namespace lysa::tests;
+using namespace lysa::ui;
+
+namespace {
+
+    // Stand-in of the 24 bytes UIRenderer vertex : the drawing window and a value
+    struct FakeVertex {
+        uint32 window;
+        uint32 value;
+        float position[4]{};
+        bool operator==(const FakeVertex&) const = default;
+    };
+
+    // Stand-in of UIRenderer, with the same geometry functions
+    struct FakeRenderer {
+        struct Geometry {
+            std::vector<FakeVertex> linesVertices;
+            std::vector<FakeVertex> triangleVertices;
+            std::vector<FakeVertex> glyphVertices;
+        };
+
+        struct GeometryRange {
+            VerticesRange lines;
+            VerticesRange triangles;
+            VerticesRange glyphs;
+        };
+
+        std::vector<FakeVertex> linesVertices;
+        std::vector<FakeVertex> triangleVertices;
+        std::vector<FakeVertex> glyphVertices;
+        uint32 restarts{0};
+        uint64 writtenVertices{0};
+
+        void restart() {
+            linesVertices.clear();
+            triangleVertices.clear();
+            glyphVertices.clear();
+            restarts++;
+        }
+
+        void addGeometry(const Geometry& geometry, GeometryRange& range) {
+            range.lines = appendVertices(linesVertices, geometry.linesVertices);
+            range.triangles = appendVertices(triangleVertices, geometry.triangleVertices);
+            range.glyphs = appendVertices(glyphVertices, geometry.glyphVertices);
+            writtenVertices += range.lines.count + range.triangles.count + range.glyphs.count;
+        }
+
+        bool updateGeometry(const Geometry& geometry, const GeometryRange& range) {
+            if (!patchVertices(linesVertices, geometry.linesVertices, range.lines) ||
+                !patchVertices(triangleVertices, geometry.triangleVertices, range.triangles) ||
+                !patchVertices(glyphVertices, geometry.glyphVertices, range.glyphs)) {
+                return false;
+            }
+            writtenVertices += range.lines.count + range.triangles.count + range.glyphs.count;
+            return true;
+        }
+    };
+
+    // Window with a frame and labels, tessellated like the UI styles : two triangles for the
+    // background, four lines for the border and one quad per character
+    struct FakeWindow {
+        uint32 id;
+        std::vector<std::string> labels;
+        bool needRedraw{true};
+        bool visible{true};
+        uint32 drawCount{0};
+        FakeRenderer::Geometry geometry;
+        FakeRenderer::GeometryRange geometryRange;
+
+        void draw() {
+            drawCount++;
+            geometry.linesVertices.assign(8, FakeVertex{id, 0});
+            geometry.triangleVertices.assign(6, FakeVertex{id, 0});
+            geometry.glyphVertices.clear();
+            for (const auto& label : labels) {
+                for (const auto c : label) {
+                    geometry.glyphVertices.insert(geometry.glyphVertices.end(), 6, FakeVertex{id, static_cast<uint32>(c)});
+                }
+            }
+        }
+
+        void setLabel(const uint32 index, const std::string& label) {
+            labels[index] = label;
+            needRedraw = true;
+        }
+    };
+
+    using Windows = std::vector<std::shared_ptr<FakeWindow>>;
+
+    // WindowManager::drawFrame()
+    bool drawFrame(FakeRenderer& renderer, const Windows& windows, const bool needCompose) {
+        return drawWindows(
+            renderer,
+            windows,
+            needCompose,
+            [](const std::shared_ptr<FakeWindow>& window) {
+                return WindowGeometry<FakeRenderer::Geometry, FakeRenderer::GeometryRange> {
+                    window->needRedraw,
+                    window->visible,
+                    window->geometry,
+                    window->geometryRange };
+            },
+            [](const std::shared_ptr<FakeWindow>& window) {
+                window->draw();
+            });
+    }
+
+    Windows createWindows(const uint32 count, const uint32 labelsCount) {
+        auto windows = Windows{};
+        for (auto id = 0u; id < count; id++) {
+            auto window = std::make_shared<FakeWindow>(id);
+            for (auto i = 0u; i < labelsCount; i++) {
+                window->labels.push_back("Window " + std::to_string(id) + " label " + std::to_string(i));
+            }
+            windows.push_back(window);
+        }
+        return windows;
+    }
+
+    // The renderer vertices are the geometries of the visible windows, at their ranges
+    bool isComposed(const FakeRenderer& renderer, const Windows& windows) {
+        auto lines = size_t{0};
+        auto triangles = size_t{0};
+        auto glyphs = size_t{0};
+        for (const auto& window : windows) {
+            if (!window->visible) { continue; }
+            const auto& [linesRange, trianglesRange, glyphsRange] = window->geometryRange;
+            if (linesRange.first != lines || trianglesRange.first != triangles || glyphsRange.first != glyphs ||
+                !std::ranges::equal(window->geometry.linesVertices, std::span{renderer.linesVertices}.subspan(lines, linesRange.count)) ||
+                !std::ranges::equal(window->geometry.triangleVertices, std::span{renderer.triangleVertices}.subspan(triangles, trianglesRange.count)) ||
+                !std::ranges::equal(window->geometry.glyphVertices, std::span{renderer.glyphVertices}.subspan(glyphs, glyphsRange.count))) {
+                return false;
+            }
+            lines += linesRange.count;
+            triangles += trianglesRange.count;
+            glyphs += glyphsRange.count;
+        }
+        return lines == renderer.linesVertices.size() &&
+               triangles == renderer.triangleVertices.size() &&
+               glyphs == renderer.glyphVertices.size();
+    }
+
+    void patchesTheRedrawnWindowInPlace() {
+        auto renderer = FakeRenderer{};
+        auto windows = createWindows(3, 2);
+        check(drawFrame(renderer, windows, true) && isComposed(renderer, windows), "windows composed");
+
+        const auto previous = renderer.glyphVertices;
+        windows[1]->setLabel(0, "Window 1 label X");
+        check(!drawFrame(renderer, windows, false), "same vertices count : not composed again");
+        check(renderer.restarts == 1, "renderer not restarted");
+        check(windows[0]->drawCount == 1 && windows[1]->drawCount == 2 && windows[2]->drawCount == 1, "only the modified window drawn again");
+        check(isComposed(renderer, windows), "vertices patched at the window range");
+        const auto& glyphs = windows[1]->geometryRange.glyphs;
+        for (auto i = 0u; i < renderer.glyphVertices.size(); i++) {
+            if (i < glyphs.first || i >= glyphs.first + glyphs.count) {
+                check(renderer.glyphVertices[i] == previous[i], "vertices of the other windows untouched");
+            }
+        }
+        check(!drawFrame(renderer, windows, false) && windows[1]->drawCount == 2, "nothing drawn without changes");
+    }
+
+    void composesWhenAVerticesCountChanges() {
+        auto renderer = FakeRenderer{};
+        auto windows = createWindows(3, 2);
+        drawFrame(renderer, windows, true);
+
+        windows[0]->setLabel(1, "Window 0 longer label 1");
+        check(drawFrame(renderer, windows, false) && renderer.restarts == 2, "composed again");
+        check(windows[0]->drawCount == 2 && windows[1]->drawCount == 1 && windows[2]->drawCount == 1,
+              "clean windows composed from their cached geometry");
+        check(isComposed(renderer, windows), "ranges of the following windows moved");
+
+        // Patched then composed in the same frame : the composed vertices win
+        windows[0]->setLabel(0, "Window 0 label A");
+        windows[2]->setLabel(0, "Window 2 label 0 and more");
+        check(drawFrame(renderer, windows, false) && isComposed(renderer, windows), "composed after a patch");
+
+        // Hidden windows are not composed nor drawn, and are drawn when shown
+        windows[1]->visible = false;
+        windows[1]->setLabel(0, "Hidden");
+        check(drawFrame(renderer, windows, true) && isComposed(renderer, windows), "hidden window removed");
+        check(windows[1]->drawCount == 1 && windows[1]->needRedraw, "hidden window not drawn");
+        windows[1]->visible = true;
+        check(drawFrame(renderer, windows, true) && isComposed(renderer, windows), "shown window added");
+        check(windows[1]->drawCount == 2 && !windows[1]->needRedraw, "shown window drawn");
+    }
+
+    void benchmarkOneLabelPerFrame() {
+        // 50 windows of 10 labels, a counter label updated each frame in one of them
+        constexpr auto framesCount = 100;
+        auto windows = createWindows(50, 10);
+        auto counter = 0;
+        const auto updateCounter = [&] {
+            auto label = std::to_string(counter++);
+            windows[25]->setLabel(0, "Frame " + std::string(6 - label.size(), '0') + label);
+        };
+
+        auto renderer = FakeRenderer{};
+        drawFrame(renderer, windows, true);
+        renderer.writtenVertices = 0;
+        auto drawCount = 0u;
+        std::cout << "  redrawing all the windows :" << std::endl;
+        benchmark("one label per frame", framesCount, [&] {
+            updateCounter();
+            // Before : any window redraw restarted the renderer and drew all the windows
+            for (const auto& window : windows) {
+                window->needRedraw = true;
+            }
+            drawFrame(renderer, windows, true);
+        });
+        for (const auto& window : windows) { drawCount += window->drawCount; }
+        const auto allWrittenVertices = renderer.writtenVertices;
+        const auto allDrawCount = drawCount;
+        std::cout << "  " << allDrawCount / framesCount << " windows drawn and " << allWrittenVertices / framesCount
+                  << " vertices written per frame" << std::endl;
+
+        renderer.writtenVertices = 0;
+        for (const auto& window : windows) { window->drawCount = 0; }
+        std::cout << "  redrawing the dirty window :" << std::endl;
+        benchmark("one label per frame", framesCount, [&] {
+            updateCounter();
+            check(!drawFrame(renderer, windows, false), "window patched in place");
+        });
+        drawCount = 0;
+        for (const auto& window : windows) { drawCount += window->drawCount; }
+        std::cout << "  " << drawCount / framesCount << " windows drawn and " << renderer.writtenVertices / framesCount
+                  << " vertices written per frame" << std::endl;
+        check(drawCount == framesCount, "one window drawn per frame");
+        check(renderer.writtenVertices * 40 < allWrittenVertices, "at least 40x less vertices written");
+        check(isComposed(renderer, windows), "vertices up to date");
+    }
+
+}
+
+int main() {
+    return run({
+        { "patches the redrawn window in place", patchesTheRedrawnWindowInPlace },
+        { "composes when a vertices count changes", composesWhenAVerticesCountChanges },
+        { "benchmark one label per frame", benchmarkOneLabelPerFrame },
+    });
+}